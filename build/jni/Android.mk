@@ -51,6 +51,8 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
 	../../ouzel/audio/Node.cpp \
     ../../ouzel/audio/Panner.cpp \
 	../../ouzel/audio/Pitch.cpp \
+	../../ouzel/audio/Resampler.cpp \
+	../../ouzel/audio/SampleOperations.cpp \
     ../../ouzel/audio/Sound.cpp \
     ../../ouzel/audio/SoundData.cpp \
     ../../ouzel/audio/SoundDataVorbis.cpp \
@@ -58,13 +60,16 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/audio/SoundInput.cpp \
 	../../ouzel/audio/SoundOutput.cpp \
     ../../ouzel/audio/Stream.cpp \
+	../../ouzel/audio/StreamPrefetcher.cpp \
     ../../ouzel/audio/StreamVorbis.cpp \
     ../../ouzel/audio/StreamWave.cpp \
+    ../../ouzel/audio/VoiceManager.cpp \
     ../../ouzel/core/android/EngineAndroid.cpp \
     ../../ouzel/core/android/main.cpp \
     ../../ouzel/core/android/NativeWindowAndroid.cpp \
 	../../ouzel/core/android/SystemAndroid.cpp \
     ../../ouzel/core/Engine.cpp \
+    ../../ouzel/core/JobSystem.cpp \
 	../../ouzel/core/NativeWindow.cpp \
 	../../ouzel/core/System.cpp \
     ../../ouzel/core/Timer.cpp \
@@ -74,7 +79,12 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/files/Archive.cpp \
     ../../ouzel/files/File.cpp \
     ../../ouzel/files/FileSystem.cpp \
+    ../../ouzel/graphics/empty/BlendStateResourceEmpty.cpp \
+    ../../ouzel/graphics/empty/BufferResourceEmpty.cpp \
+    ../../ouzel/graphics/empty/DepthStencilStateResourceEmpty.cpp \
     ../../ouzel/graphics/empty/RenderDeviceEmpty.cpp \
+    ../../ouzel/graphics/empty/ShaderResourceEmpty.cpp \
+    ../../ouzel/graphics/empty/TextureResourceEmpty.cpp \
     ../../ouzel/graphics/opengl/android/RenderDeviceOGLAndroid.cpp \
     ../../ouzel/graphics/opengl/BlendStateResourceOGL.cpp \
     ../../ouzel/graphics/opengl/BufferResourceOGL.cpp \
@@ -145,23 +155,32 @@ LOCAL_SRC_FILES :=../../ouzel/animators/Animator.cpp \
     ../../ouzel/scene/ActorContainer.cpp \
     ../../ouzel/scene/Camera.cpp \
     ../../ouzel/scene/Component.cpp \
+    ../../ouzel/scene/DrawQueue.cpp \
+    ../../ouzel/scene/GPUParticleStore.cpp \
     ../../ouzel/scene/Layer.cpp \
     ../../ouzel/scene/Light.cpp \
+    ../../ouzel/scene/MeshInstancer.cpp \
+    ../../ouzel/scene/ParticleStore.cpp \
     ../../ouzel/scene/ParticleSystem.cpp \
     ../../ouzel/scene/ParticleSystemData.cpp \
+    ../../ouzel/scene/ParticleWorld.cpp \
     ../../ouzel/scene/Scene.cpp \
     ../../ouzel/scene/SceneManager.cpp \
     ../../ouzel/scene/ShapeRenderer.cpp \
     ../../ouzel/scene/SkinnedMeshData.cpp \
     ../../ouzel/scene/SkinnedMeshRenderer.cpp \
+    ../../ouzel/scene/SpatialIndex.cpp \
     ../../ouzel/scene/Sprite.cpp \
+    ../../ouzel/scene/SpriteBatcher.cpp \
     ../../ouzel/scene/SpriteData.cpp \
     ../../ouzel/scene/StaticMeshData.cpp \
     ../../ouzel/scene/StaticMeshRenderer.cpp \
     ../../ouzel/scene/TextRenderer.cpp \
+    ../../ouzel/scene/TransformHierarchy.cpp \
     ../../ouzel/utils/INI.cpp \
     ../../ouzel/utils/JSON.cpp \
     ../../ouzel/utils/Log.cpp \
+    ../../ouzel/utils/MemoryPool.cpp \
     ../../ouzel/utils/OBF.cpp \
     ../../ouzel/utils/Utils.cpp \
     ../../ouzel/utils/XML.cpp
@@ -27,10 +27,9 @@ namespace ouzel
             {
             }
 
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& position) override
+            void process(float*, uint32_t, uint16_t&,
+                         uint32_t&, Vector3&) override
             {
-                Node::process(samples, channels, sampleRate, position);
             }
         };
 
@@ -120,42 +119,194 @@ namespace ouzel
 
             sinkNodeId = initNode([]() { return std::unique_ptr<Node>(new Destination()); });
 
-            AudioDevice::Command command(AudioDevice::Command::Type::SET_DESTINATION_NODE);
-            command.nodeId = sinkNodeId;
-            device->addCommand(command);
+            streamPrefetcher = std::make_shared<StreamPrefetcher>();
         }
 
         Audio::~Audio()
         {
+            // stops the audio thread and deletes the nodes and graphs it still had
+            device.reset();
+
+            for (NodeEntry& entry : nodes)
+                delete entry.node;
+
+            for (Node* node : deletedNodes)
+                delete node;
         }
 
         void Audio::update()
         {
-            // TODO: handle events from the audio device
+            AudioDevice::Command command;
+
+            if (device->getDriver() == Driver::EMPTY)
+            {
+                // without an audio thread the commands are executed here, until none are left waiting
+                for (;;)
+                {
+                    bool flushed = device->flushCommands();
+                    device->process();
+
+                    while (device->getReleasedCommand(command))
+                        device->deleteReleased(command);
+
+                    if (flushed) break;
+                }
+            }
+            else
+            {
+                device->flushCommands();
+
+                while (device->getReleasedCommand(command))
+                    device->deleteReleased(command);
+            }
+
+            voiceManager.update();
+
+#if !OUZEL_MULTITHREADED
+            streamPrefetcher->update();
+#endif
+
+            if (graphDirty)
+            {
+                std::unique_ptr<AudioDevice::Graph> graph(new AudioDevice::Graph());
+                std::vector<uint32_t> indices(nodes.size());
+                std::vector<uint8_t> visited(nodes.size(), 0);
+
+                graph->inputOffsets.push_back(0);
+                buildGraph(sinkNodeId, indices, visited, *graph);
+                graph->allocateBuffers();
+
+                AudioDevice::Command graphCommand(AudioDevice::Command::Type::SET_GRAPH);
+                graphCommand.graph = graph.release();
+                device->addCommand(graphCommand);
+
+                graphDirty = false;
+            }
+
+            // sent after the graph, so the audio thread has stopped using the nodes by then
+            for (Node* node : deletedNodes)
+            {
+                AudioDevice::Command deleteCommand(AudioDevice::Command::Type::DELETE_NODE);
+                deleteCommand.node = node;
+                device->addCommand(deleteCommand);
+            }
+
+            deletedNodes.clear();
+        }
+
+        void Audio::buildGraph(uintptr_t nodeId, std::vector<uint32_t>& indices,
+                               std::vector<uint8_t>& visited, AudioDevice::Graph& graph) const
+        {
+            // 1 means that the node is being visited, so inputs that form a cycle are skipped
+            visited[nodeId - 1] = 1;
+
+            const NodeEntry& entry = nodes[nodeId - 1];
+
+            for (uintptr_t inputNodeId : entry.inputs)
+                if (!visited[inputNodeId - 1])
+                    buildGraph(inputNodeId, indices, visited, graph);
+
+            for (uintptr_t inputNodeId : entry.inputs)
+                if (visited[inputNodeId - 1] == 2)
+                    graph.inputs.push_back(indices[inputNodeId - 1]);
+
+            visited[nodeId - 1] = 2;
+            indices[nodeId - 1] = static_cast<uint32_t>(graph.nodes.size());
+            graph.nodes.push_back(entry.node);
+            graph.inputOffsets.push_back(static_cast<uint32_t>(graph.inputs.size()));
         }
 
         uintptr_t Audio::initNode(const std::function<std::unique_ptr<Node>(void)>& createFunction)
         {
-            uintptr_t nodeId = device->getNodeId();
-            AudioDevice::Command command(AudioDevice::Command::Type::INIT_NODE);
-            command.nodeId = nodeId;
-            command.createFunction = createFunction;
-            device->addCommand(command);
+            uintptr_t nodeId;
+
+            if (deletedNodeIds.empty())
+            {
+                nodes.push_back(NodeEntry());
+                nodeId = nodes.size();
+            }
+            else
+            {
+                nodeId = deletedNodeIds.back();
+                deletedNodeIds.pop_back();
+            }
+
+            nodes[nodeId - 1].node = createFunction().release();
+
             return nodeId;
         }
 
         void Audio::deleteNode(uintptr_t nodeId)
         {
-            AudioDevice::Command command(AudioDevice::Command::Type::DELETE_NODE);
-            command.nodeId = nodeId;
+            NodeEntry& entry = nodes[nodeId - 1];
+
+            for (NodeEntry& outputEntry : nodes)
+            {
+                auto i = std::find(outputEntry.inputs.begin(), outputEntry.inputs.end(), nodeId);
+                if (i != outputEntry.inputs.end()) outputEntry.inputs.erase(i);
+            }
+
+            deletedNodes.push_back(entry.node);
+            entry.node = nullptr;
+            entry.inputs.clear();
+            deletedNodeIds.push_back(nodeId);
+
+            graphDirty = true;
+        }
+
+        void Audio::connectNodes(uintptr_t nodeId, uintptr_t outputNodeId)
+        {
+            if (!nodeId || !outputNodeId) return;
+
+            std::vector<uintptr_t>& inputs = nodes[outputNodeId - 1].inputs;
+
+            if (std::find(inputs.begin(), inputs.end(), nodeId) == inputs.end())
+            {
+                inputs.push_back(nodeId);
+                graphDirty = true;
+            }
+        }
+
+        void Audio::disconnectNodes(uintptr_t nodeId, uintptr_t outputNodeId)
+        {
+            if (!nodeId || !outputNodeId) return;
+
+            std::vector<uintptr_t>& inputs = nodes[outputNodeId - 1].inputs;
+
+            auto i = std::find(inputs.begin(), inputs.end(), nodeId);
+            if (i != inputs.end())
+            {
+                inputs.erase(i);
+                graphDirty = true;
+            }
+        }
+
+        void Audio::setNodeParameter(uintptr_t nodeId, uint32_t parameter, float value)
+        {
+            AudioDevice::Command command(AudioDevice::Command::Type::SET_NODE_PARAMETER);
+            command.node = nodes[nodeId - 1].node;
+            command.parameter = parameter;
+            command.values[0] = value;
+            device->addCommand(command);
+        }
+
+        void Audio::setNodeParameter(uintptr_t nodeId, uint32_t parameter, const Vector3& value)
+        {
+            AudioDevice::Command command(AudioDevice::Command::Type::SET_NODE_PARAMETER);
+            command.node = nodes[nodeId - 1].node;
+            command.parameter = parameter;
+            command.values[0] = value.x;
+            command.values[1] = value.y;
+            command.values[2] = value.z;
             device->addCommand(command);
         }
 
-        void Audio::updateNode(uintptr_t nodeId, const std::function<void(Node*)>& updateFunction)
+        void Audio::setNodeObject(uintptr_t nodeId, uint32_t parameter, void* object)
         {
-            AudioDevice::Command command(AudioDevice::Command::Type::UPDATE_NODE);
-            command.nodeId = nodeId;
-            command.updateFunction = updateFunction;
+            AudioDevice::Command command(AudioDevice::Command::Type::SET_NODE_OBJECT);
+            command.node = nodes[nodeId - 1].node;
+            command.parameter = parameter;
+            command.object = object;
             device->addCommand(command);
         }
     } // namespace audio
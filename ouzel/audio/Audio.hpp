@@ -8,8 +8,11 @@
 #include <memory>
 #include <set>
 #include <vector>
+#include "audio/AudioDevice.hpp"
 #include "audio/Driver.hpp"
 #include "audio/SoundOutput.hpp"
+#include "audio/StreamPrefetcher.hpp"
+#include "audio/VoiceManager.hpp"
 #include "audio/Node.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector3.hpp"
@@ -39,15 +42,46 @@ namespace ouzel
 
             inline AudioDevice* getDevice() const { return device.get(); }
 
+            inline const std::shared_ptr<StreamPrefetcher>& getStreamPrefetcher() const { return streamPrefetcher; }
+
+            inline VoiceManager& getVoiceManager() { return voiceManager; }
+            inline const VoiceManager& getVoiceManager() const { return voiceManager; }
+
             void update();
 
+            uintptr_t getOutputNodeId() const override { return sinkNodeId; }
+
             uintptr_t initNode(const std::function<std::unique_ptr<Node>(void)>& createFunction);
             void deleteNode(uintptr_t nodeId);
-            void updateNode(uintptr_t nodeId, const std::function<void(Node*)>& updateFunction);
+
+            // the output node mixes the output of the node, changes are sent to the audio thread on update
+            void connectNodes(uintptr_t nodeId, uintptr_t outputNodeId);
+            void disconnectNodes(uintptr_t nodeId, uintptr_t outputNodeId);
+
+            void setNodeParameter(uintptr_t nodeId, uint32_t parameter, float value);
+            void setNodeParameter(uintptr_t nodeId, uint32_t parameter, const Vector3& value);
+            void setNodeObject(uintptr_t nodeId, uint32_t parameter, void* object);
 
         private:
+            struct NodeEntry
+            {
+                Node* node = nullptr;
+                std::vector<uintptr_t> inputs;
+            };
+
+            void buildGraph(uintptr_t nodeId, std::vector<uint32_t>& indices,
+                            std::vector<uint8_t>& visited, AudioDevice::Graph& graph) const;
+
             std::unique_ptr<AudioDevice> device;
             uintptr_t sinkNodeId;
+            VoiceManager voiceManager;
+            // shared with the streams, which can outlive the audio
+            std::shared_ptr<StreamPrefetcher> streamPrefetcher;
+
+            std::vector<NodeEntry> nodes;
+            std::vector<uintptr_t> deletedNodeIds;
+            std::vector<Node*> deletedNodes;
+            bool graphDirty = false;
         };
     } // namespace audio
 } // namespace ouzel
@@ -1,125 +1,321 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
 #include <algorithm>
+#include <cstddef>
 #include "AudioDevice.hpp"
-#include "math/MathUtils.hpp"
+#include "SampleOperations.hpp"
 #include "utils/Errors.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        static const size_t COMMAND_QUEUE_SIZE = 8192;
+
+        // adds the source to the destination, mono sources are copied to every channel,
+        // otherwise destination channels without a source channel are left as they are
+        static void mixChannels(const float* source, uint16_t sourceChannels,
+                                float* destination, uint16_t destinationChannels,
+                                uint32_t frames)
+        {
+            if (sourceChannels == 0) return; // silent node
+
+            if (sourceChannels == destinationChannels)
+                mixSamples(source, destination, frames * destinationChannels);
+            else if (sourceChannels == 1)
+            {
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                    for (uint16_t channel = 0; channel < destinationChannels; ++channel)
+                        destination[frame * destinationChannels + channel] += source[frame];
+            }
+            else
+            {
+                uint16_t mixedChannels = std::min(sourceChannels, destinationChannels);
+
+                for (uint32_t frame = 0; frame < frames; ++frame)
+                    for (uint16_t channel = 0; channel < mixedChannels; ++channel)
+                        destination[frame * destinationChannels + channel] += source[frame * sourceChannels + channel];
+            }
+        }
+
         AudioDevice::AudioDevice(Driver initDriver):
-            driver(initDriver)
+            driver(initDriver),
+            mixBuffer(Node::BLOCK_FRAMES * channels),
+            commandQueue(COMMAND_QUEUE_SIZE),
+            releaseQueue(COMMAND_QUEUE_SIZE)
         {
-            buffers.resize(1000);
         }
 
         AudioDevice::~AudioDevice()
         {
+            // the audio thread has already been stopped by the driver
+            Command command;
+
+            while (commandQueue.pop(command))
+            {
+                if (command.type == Command::Type::SET_GRAPH)
+                    delete command.graph;
+                else if (command.type == Command::Type::DELETE_NODE)
+                    delete command.node;
+            }
+
+            for (const Command& pendingCommand : pendingCommands)
+            {
+                if (pendingCommand.type == Command::Type::SET_GRAPH)
+                    delete pendingCommand.graph;
+                else if (pendingCommand.type == Command::Type::DELETE_NODE)
+                    delete pendingCommand.node;
+            }
+
+            while (releaseQueue.pop(command))
+                deleteReleased(command);
+
+            delete graph;
         }
 
         void AudioDevice::process()
         {
             Command command;
-            for (;;)
-            {
-                std::unique_lock<std::mutex> lock(commandMutex);
-                if (commandQueue.empty()) break;
-                command = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
 
+            // every command releases at most one object, stop if the game thread can not take it
+            while (!releaseQueue.isFull() && commandQueue.pop(command))
+            {
                 switch (command.type)
                 {
-                    case Command::Type::INIT_NODE:
+                    case Command::Type::SET_GRAPH:
                     {
-                        if (command.nodeId > nodes.size())
-                            nodes.resize(command.nodeId);
-
-                        nodes[command.nodeId - 1] = command.createFunction();
+                        Command releaseCommand(Command::Type::SET_GRAPH);
+                        releaseCommand.graph = graph;
+                        graph = command.graph;
+                        if (releaseCommand.graph) releaseQueue.push(releaseCommand);
                         break;
                     }
                     case Command::Type::DELETE_NODE:
                     {
-                        nodes[command.nodeId - 1].reset();
-                        break;
-                    }
-                    case Command::Type::UPDATE_NODE:
-                    {
-                        command.updateFunction(nodes[command.nodeId - 1].get());
+                        // the node was removed from the graph by an earlier command
+                        releaseQueue.push(command);
                         break;
                     }
-                    case Command::Type::ADD_OUTPUT_NODE:
+                    case Command::Type::SET_NODE_PARAMETER:
                     {
-                        nodes[command.nodeId - 1]->addOutputNode(nodes[command.destinationNodeId - 1].get());
+                        command.node->setParameter(command.parameter, command.values);
                         break;
                     }
-                    case Command::Type::SET_DESTINATION_NODE:
+                    case Command::Type::SET_NODE_OBJECT:
                     {
-                        destinationNode = command.nodeId ? nodes[command.nodeId - 1].get() : nullptr;
+                        command.node->setObject(command.parameter, command.object);
                         break;
                     }
                     default:
-                        throw SystemError("Invalid command");
+                        break;
                 }
             }
         }
 
-        void AudioDevice::getData(uint32_t frames, std::vector<uint8_t>& result)
+        void AudioDevice::addCommand(const Command& command)
         {
-            currentBuffer = 0;
-            uint32_t buffer = currentBuffer;
+            // the commands have to stay in order, so nothing skips the ones that are already waiting
+            if (!pendingCommands.empty() || !commandQueue.push(command))
+                pendingCommands.push_back(command);
+        }
 
-            if (++currentBuffer > buffers.size()) return; // out of buffers
+        bool AudioDevice::flushCommands()
+        {
+            size_t count = 0;
+            while (count < pendingCommands.size() && commandQueue.push(pendingCommands[count]))
+                ++count;
+
+            pendingCommands.erase(pendingCommands.begin(), pendingCommands.begin() + static_cast<std::ptrdiff_t>(count));
 
-            buffers[buffer].resize(frames * channels);
-            std::fill(buffers[buffer].begin(), buffers[buffer].end(), 0.0F);
+            return pendingCommands.empty();
+        }
+
+        bool AudioDevice::getReleasedCommand(Command& command)
+        {
+            return releaseQueue.pop(command);
+        }
+
+        void AudioDevice::deleteReleased(const Command& command)
+        {
+            if (command.type == Command::Type::SET_GRAPH)
+                delete command.graph;
+            else if (command.type == Command::Type::DELETE_NODE)
+                delete command.node;
+        }
 
-            if (destinationNode)
+        void AudioDevice::Graph::allocateBuffers()
+        {
+            uint32_t nodeCount = static_cast<uint32_t>(nodes.size());
+
+            firstInputs.assign(nodeCount, nodeCount);
+            outputOffsets.assign(nodeCount + 1, 0);
+
+            for (uint32_t i = 0; i < nodeCount; ++i)
             {
-                uint16_t inputChannels = channels;
-                uint32_t inputSampleRate = sampleRate;
-                Vector3 inputPosition;
+                for (uint32_t input = inputOffsets[i]; input < inputOffsets[i + 1]; ++input)
+                {
+                    firstInputs[i] = std::min(firstInputs[i], inputs[input]);
+                    ++outputOffsets[inputs[input] + 1];
+                }
+            }
 
-                destinationNode->process(buffers[buffer], inputChannels, inputSampleRate, inputPosition);
+            for (uint32_t i = 0; i < nodeCount; ++i)
+                outputOffsets[i + 1] += outputOffsets[i];
+
+            outputs.resize(inputs.size());
+            std::vector<uint32_t> outputCounts(nodeCount, 0);
+
+            for (uint32_t i = 0; i < nodeCount; ++i)
+            {
+                for (uint32_t input = inputOffsets[i]; input < inputOffsets[i + 1]; ++input)
+                {
+                    uint32_t inputNode = inputs[input];
+                    outputs[outputOffsets[inputNode] + outputCounts[inputNode]++] = i;
+                }
             }
 
-            for (float& f : buffers[buffer])
-                f = clamp(f, -1.0F, 1.0F);
+            // the nodes get a buffer when they are first written to and give it back after they are processed
+            std::vector<uint32_t> buffersByNode(nodeCount);
+            std::vector<uint32_t> freeBuffers;
+            uint32_t bufferCount = 0;
 
-            switch (sampleFormat)
+            auto getBuffer = [&freeBuffers, &bufferCount]() {
+                if (freeBuffers.empty()) return bufferCount++;
+                uint32_t buffer = freeBuffers.back();
+                freeBuffers.pop_back();
+                return buffer;
+            };
+
+            for (uint32_t i = 0; i < nodeCount; ++i)
             {
-                case SampleFormat::SINT16:
+                if (firstInputs[i] == nodeCount)
+                    buffersByNode[i] = getBuffer();
+
+                for (uint32_t output = outputOffsets[i]; output < outputOffsets[i + 1]; ++output)
+                    if (firstInputs[outputs[output]] == i)
+                        buffersByNode[outputs[output]] = getBuffer();
+
+                // the buffer of the destination node is read after all the nodes are processed
+                if (i + 1 < nodeCount)
+                    freeBuffers.push_back(buffersByNode[i]);
+            }
+
+            bufferOffsets.resize(nodeCount);
+            for (uint32_t i = 0; i < nodeCount; ++i)
+                bufferOffsets[i] = buffersByNode[i] * Node::MAX_FRAMES * Node::MAX_CHANNELS;
+
+            buffers.resize(bufferCount * Node::MAX_FRAMES * Node::MAX_CHANNELS);
+        }
+
+        void AudioDevice::clearNode(Node* node, float* samples) const
+        {
+            std::fill(samples, samples + std::max(node->inputFrames, node->frames) * channels, 0.0F);
+            node->sampleRate = sampleRate;
+            node->position = Vector3();
+        }
+
+        void AudioDevice::processGraph(uint32_t frames)
+        {
+            std::fill(mixBuffer.begin(), mixBuffer.begin() + frames * channels, 0.0F);
+
+            if (!graph || graph->nodes.empty()) return;
+
+            uint32_t nodeCount = static_cast<uint32_t>(graph->nodes.size());
+
+            // the outputs come after their inputs, so walking backwards gives every node its frame count before its inputs
+            for (Node* node : graph->nodes)
+                node->frames = 0;
+
+            graph->nodes.back()->frames = frames;
+
+            for (uint32_t i = nodeCount; i-- > 0;)
+            {
+                Node* node = graph->nodes[i];
+                node->inputFrames = std::min(node->getInputFrames(node->frames), Node::MAX_FRAMES);
+
+                // a node with several outputs produces enough frames for all of them
+                for (uint32_t input = graph->inputOffsets[i]; input < graph->inputOffsets[i + 1]; ++input)
+                {
+                    Node* inputNode = graph->nodes[graph->inputs[input]];
+                    inputNode->frames = std::max(inputNode->frames, node->inputFrames);
+                }
+            }
+
+            for (uint32_t i = 0; i < nodeCount; ++i)
+            {
+                Node* node = graph->nodes[i];
+                float* samples = graph->buffers.data() + graph->bufferOffsets[i];
+
+                // the buffers of the nodes with inputs are cleared when their first input is mixed in
+                if (graph->firstInputs[i] == nodeCount)
+                    clearNode(node, samples);
+
+                uint16_t nodeChannels = channels;
+                uint32_t nodeSampleRate = node->sampleRate;
+                Vector3 nodePosition = node->position;
+
+                node->process(samples, node->frames, nodeChannels, nodeSampleRate, nodePosition);
+
+                node->channels = std::min(nodeChannels, Node::MAX_CHANNELS);
+                node->sampleRate = nodeSampleRate;
+                node->position = nodePosition;
+
+                for (uint32_t output = graph->outputOffsets[i]; output < graph->outputOffsets[i + 1]; ++output)
                 {
-                    result.resize(frames * channels * sizeof(int16_t));
-                    int16_t* resultPtr = reinterpret_cast<int16_t*>(result.data());
+                    uint32_t outputIndex = graph->outputs[output];
+                    Node* outputNode = graph->nodes[outputIndex];
+                    float* outputSamples = graph->buffers.data() + graph->bufferOffsets[outputIndex];
 
-                    for (uint32_t i = 0; i < buffers[buffer].size(); ++i)
+                    if (graph->firstInputs[outputIndex] == i)
+                        clearNode(outputNode, outputSamples);
+
+                    mixChannels(samples, node->channels, outputSamples, channels, outputNode->inputFrames);
+
+                    // the sample rate and the position come from the node's first connected input
+                    if (graph->inputs[graph->inputOffsets[outputIndex]] == i)
                     {
-                        *resultPtr = static_cast<int16_t>(buffers[buffer][i] * 32767.0F);
-                        ++resultPtr;
+                        outputNode->sampleRate = node->sampleRate;
+                        outputNode->position = node->position;
                     }
-                    break;
                 }
-                case SampleFormat::FLOAT32:
-                {
-                    result.reserve(frames * channels * sizeof(float));
-                    result.assign(reinterpret_cast<uint8_t*>(buffers[buffer].data()),
-                                  reinterpret_cast<uint8_t*>(buffers[buffer].data()) + buffers[buffer].size() * sizeof(float));
-                    break;
-                }
-                default:
-                    throw DataError("Invalid sample format");
             }
+
+            mixChannels(graph->buffers.data() + graph->bufferOffsets[nodeCount - 1], graph->nodes.back()->channels,
+                        mixBuffer.data(), channels, frames);
         }
 
-        void AudioDevice::addCommand(const Command& command)
+        void AudioDevice::getData(uint32_t frames, std::vector<uint8_t>& result)
         {
-            std::unique_lock<std::mutex> lock(commandMutex);
-            commandQueue.push(command);
-            lock.unlock();
-            commandConditionVariable.notify_all();
+            uint32_t sampleSize;
+
+            switch (sampleFormat)
+            {
+                case SampleFormat::SINT16: sampleSize = sizeof(int16_t); break;
+                case SampleFormat::FLOAT32: sampleSize = sizeof(float); break;
+                default: throw DataError("Invalid sample format");
+            }
+
+            result.resize(frames * channels * sampleSize);
+
+            for (uint32_t offset = 0; offset < frames; offset += Node::BLOCK_FRAMES)
+            {
+                uint32_t blockFrames = std::min(frames - offset, Node::BLOCK_FRAMES);
+                uint32_t blockSamples = blockFrames * channels;
+
+                processGraph(blockFrames);
+
+                if (sampleFormat == SampleFormat::SINT16)
+                {
+                    int16_t* resultPtr = reinterpret_cast<int16_t*>(result.data()) + offset * channels;
+                    convertSamples(mixBuffer.data(), resultPtr, blockSamples);
+                }
+                else
+                {
+                    float* resultPtr = reinterpret_cast<float*>(result.data()) + offset * channels;
+                    clampSamples(mixBuffer.data(), blockSamples);
+                    std::copy(mixBuffer.begin(), mixBuffer.begin() + blockSamples, resultPtr);
+                }
+            }
         }
     } // namespace audio
 } // namespace ouzel
@@ -3,17 +3,15 @@
 #ifndef OUZEL_AUDIO_AUDIODEVICE_HPP
 #define OUZEL_AUDIO_AUDIODEVICE_HPP
 
-#include <condition_variable>
-#include <functional>
+#include <cstdint>
 #include <memory>
-#include <mutex>
-#include <queue>
 #include <vector>
 #include "audio/Driver.hpp"
 #include "audio/Node.hpp"
 #include "audio/SampleFormat.hpp"
 #include "math/Quaternion.hpp"
 #include "math/Vector3.hpp"
+#include "utils/SPSCQueue.hpp"
 
 namespace ouzel
 {
@@ -27,25 +25,49 @@ namespace ouzel
         {
             friend Audio;
         public:
+            // built on the game thread, after that used only by the audio thread
+            struct Graph
+            {
+                // every node comes after its inputs, the destination node is the last one
+                std::vector<Node*> nodes;
+                // the inputs of nodes[i] are inputs[inputOffsets[i]] to inputs[inputOffsets[i + 1] - 1], as indices to nodes
+                std::vector<uint32_t> inputOffsets;
+                std::vector<uint32_t> inputs;
+                // the same for the outputs, filled by allocateBuffers
+                std::vector<uint32_t> outputOffsets;
+                std::vector<uint32_t> outputs;
+                // the input of nodes[i] that is processed first, or nodes.size() if it has none
+                std::vector<uint32_t> firstInputs;
+
+                // a node is mixed into its outputs right after it is processed, so its buffer is only needed
+                // from its first input until then and is shared with the nodes that are processed at other times
+                std::vector<uint32_t> bufferOffsets;
+                std::vector<float> buffers;
+
+                // called on the game thread after the nodes and inputs are set
+                void allocateBuffers();
+            };
+
+            // plain data, so that it can be passed through the lock-free queues
             struct Command
             {
                 enum class Type
                 {
-                    INIT_NODE,
+                    SET_GRAPH,
                     DELETE_NODE,
-                    UPDATE_NODE,
-                    ADD_OUTPUT_NODE,
-                    SET_DESTINATION_NODE
+                    SET_NODE_PARAMETER,
+                    SET_NODE_OBJECT
                 };
 
                 Command() {}
                 explicit Command(Type initType): type(initType) {}
 
                 Type type;
-                uintptr_t nodeId;
-                uintptr_t destinationNodeId;
-                std::function<std::unique_ptr<Node>(void)> createFunction;
-                std::function<void(Node*)> updateFunction;
+                Node* node;
+                Graph* graph;
+                uint32_t parameter;
+                float values[4];
+                void* object;
             };
 
             explicit AudioDevice(Driver initDriver);
@@ -57,31 +79,21 @@ namespace ouzel
             AudioDevice(AudioDevice&&) = delete;
             AudioDevice& operator=(AudioDevice&&) = delete;
 
+            inline Driver getDriver() const { return driver; }
+            inline uint32_t getSampleRate() const { return sampleRate; }
+            inline uint16_t getChannels() const { return channels; }
+
             inline uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
             inline uint16_t getAPIMinorVersion() const { return apiMinorVersion; }
 
+            // called on the audio thread before getData
             virtual void process();
 
+            // called on the game thread, the commands that do not fit in the queue are kept until the next flushCommands
             void addCommand(const Command& command);
 
-            uintptr_t getNodeId()
-            {
-                if (deletedNodeIds.empty())
-                    return ++lastNodeId; // zero is reserved for null node
-                else
-                {
-                    uintptr_t nodeId = deletedNodeIds.front();
-                    deletedNodeIds.pop();
-                    return nodeId;
-                }
-            }
-
-            void deleteNodeId(uintptr_t nodeId)
-            {
-                deletedNodeIds.push(nodeId);
-            }
-
         protected:
+            // called on the audio thread, allocates only if the result has to grow
             void getData(uint32_t frames, std::vector<uint8_t>& result);
 
             uint16_t apiMajorVersion = 0;
@@ -89,24 +101,29 @@ namespace ouzel
             
             SampleFormat sampleFormat = SampleFormat::SINT16;
             const uint32_t bufferSize = 2 * 4096;
-            const uint32_t sampleRate = 44100;
+            // set by the drivers to the rate of the device before any nodes are created
+            uint32_t sampleRate = 44100;
             const uint16_t channels = 2;
 
         private:
-            std::vector<std::vector<float>> buffers;
-            uint32_t currentBuffer = 0;
-
-            uintptr_t lastNodeId = 0;
-            std::queue<uintptr_t> deletedNodeIds;
-
-            std::vector<std::unique_ptr<Node>> nodes;
+            // zeroes the samples the node's inputs are mixed into and resets the values it gets from them
+            void clearNode(Node* node, float* samples) const;
+            void processGraph(uint32_t frames);
+            // called on the game thread, moves the kept commands to the queue in order, returns false if some did not fit
+            bool flushCommands();
+            // the nodes and graphs the audio thread no longer uses, deleted by the game thread
+            bool getReleasedCommand(Command& command);
+            void deleteReleased(const Command& command);
 
             Driver driver;
 
-            Node* destinationNode = nullptr;
-            std::mutex commandMutex;
-            std::condition_variable commandConditionVariable;
-            std::queue<Command> commandQueue;
+            Graph* graph = nullptr;
+            std::vector<float> mixBuffer;
+
+            SPSCQueue<Command> commandQueue;
+            SPSCQueue<Command> releaseQueue;
+            // game thread only, the commands that were added while the queue was full
+            std::vector<Command> pendingCommands;
         };
     } // namespace audio
 } // namespace ouzel
@@ -23,6 +23,10 @@ namespace ouzel
 
             Delay(Delay&&) = delete;
             Delay& operator=(Delay&&) = delete;
+
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            float estimateGain(const Panner* panner) const override { return estimateOutputGain(panner); }
             
             float getDelay() const { return delay; }
             void setDelay(float newDelay);
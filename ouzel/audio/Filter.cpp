@@ -14,10 +14,9 @@ namespace ouzel
             {
             }
 
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& position) override
+            void process(float*, uint32_t, uint16_t&,
+                         uint32_t&, Vector3&) override
             {
-                Node::process(samples, channels, sampleRate, position);
             }
         };
 
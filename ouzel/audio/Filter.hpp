@@ -24,6 +24,10 @@ namespace ouzel
             Filter(Filter&&) = delete;
             Filter& operator=(Filter&&) = delete;
 
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            float estimateGain(const Panner* panner) const override { return estimateOutputGain(panner); }
+
         private:
             Audio& audio;
             uintptr_t nodeId = 0;
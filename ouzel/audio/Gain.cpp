@@ -2,6 +2,7 @@
 
 #include "Gain.hpp"
 #include "Audio.hpp"
+#include "SampleOperations.hpp"
 
 namespace ouzel
 {
@@ -10,22 +11,24 @@ namespace ouzel
         class GainProcessor final: public Node
         {
         public:
+            enum Parameter
+            {
+                GAIN
+            };
+
             GainProcessor()
             {
             }
 
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& position) override
+            void process(float* samples, uint32_t frames, uint16_t& channels,
+                         uint32_t&, Vector3&) override
             {
-                Node::process(samples, channels, sampleRate, position);
-
-                for (float& sample : samples)
-                    sample *= gain;
+                scaleSamples(samples, frames * channels, gain);
             }
 
-            void setGain(float newGain)
+            void setParameter(uint32_t parameter, const float* values) override
             {
-                gain = newGain;
+                if (parameter == GAIN) gain = values[0];
             }
 
         private:
@@ -47,10 +50,7 @@ namespace ouzel
         {
             gain = newGain;
 
-            audio.updateNode(nodeId, [newGain](Node* node) {
-                GainProcessor* gainProcessor = static_cast<GainProcessor*>(node);
-                gainProcessor->setGain(newGain);
-            });
+            audio.setNodeParameter(nodeId, GainProcessor::GAIN, newGain);
         }
     } // namespace audio
 } // namespace ouzel
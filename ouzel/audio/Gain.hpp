@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_GAIN_HPP
 #define OUZEL_AUDIO_GAIN_HPP
 
+#include <cmath>
 #include "audio/SoundInput.hpp"
 #include "audio/SoundOutput.hpp"
 
@@ -23,6 +24,10 @@ namespace ouzel
 
             Gain(Audio&&) = delete;
             Gain& operator=(Gain&&) = delete;
+
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            float estimateGain(const Panner* panner) const override { return std::fabs(gain) * estimateOutputGain(panner); }
             
             float getGain() const { return gain; }
             void setGain(float newGain);
@@ -30,7 +35,7 @@ namespace ouzel
         private:
             Audio& audio;
             uintptr_t nodeId = 0;
-            float gain = 0.0F;
+            float gain = 1.0F;
         };
     } // namespace audio
 } // namespace ouzel
@@ -2,6 +2,7 @@
 
 #include "Listener.hpp"
 #include "Audio.hpp"
+#include "Panner.hpp"
 #include "AudioDevice.hpp"
 #include "SoundInput.hpp"
 #include "scene/Actor.hpp"
@@ -18,10 +19,9 @@ namespace ouzel
             {
             }
 
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& position) override
+            void process(float*, uint32_t, uint16_t&,
+                         uint32_t&, Vector3&) override
             {
-                Node::process(samples, channels, sampleRate, position);
             }
         };
 
@@ -37,8 +37,26 @@ namespace ouzel
             if (nodeId) audio.deleteNode(nodeId);
         }
 
+        float Listener::estimateGain(const Panner* panner) const
+        {
+            float gain = estimateOutputGain(nullptr);
+
+            if (panner)
+            {
+                // inverse distance clamped model
+                float distance = clamp(panner->getPosition().distance(position),
+                                       panner->getMinDistance(), panner->getMaxDistance());
+                float denominator = panner->getMinDistance() + panner->getRolloffFactor() * (distance - panner->getMinDistance());
+
+                if (denominator > 0.0F) gain *= panner->getMinDistance() / denominator;
+            }
+
+            return gain;
+        }
+
         void Listener::updateTransform()
         {
+            position = actor->getWorldPosition();
             transformDirty = true;
         }
     } // namespace audio
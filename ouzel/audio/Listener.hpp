@@ -24,6 +24,11 @@ namespace ouzel
             Listener(Audio& initAudio);
             virtual ~Listener();
 
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            // applies the distance attenuation of the panner
+            float estimateGain(const Panner* panner) const override;
+
         protected:
             void updateTransform() override;
 
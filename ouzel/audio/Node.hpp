@@ -4,7 +4,6 @@
 #define OUZEL_AUDIO_NODE_HPP
 
 #include <cstdint>
-#include <vector>
 #include "math/Quaternion.hpp"
 #include "math/Vector3.hpp"
 
@@ -12,10 +11,20 @@ namespace ouzel
 {
     namespace audio
     {
+        class AudioDevice;
+
+        // Nodes are created on the game thread and after that used only by the audio thread.
+        // The device processes the nodes in blocks of at most BLOCK_FRAMES output frames, after their inputs.
+        // Nodes that change the playback speed can request up to MAX_FRAMES frames from their inputs.
         class Node
         {
+            friend AudioDevice;
         public:
-            Node() {}
+            static const uint32_t BLOCK_FRAMES = 256;
+            static const uint32_t MAX_FRAMES = BLOCK_FRAMES * 4;
+            static const uint16_t MAX_CHANNELS = 8;
+
+            Node();
             virtual ~Node();
 
             Node(const Node&) = delete;
@@ -24,20 +33,30 @@ namespace ouzel
             Node(Node&&) = delete;
             Node& operator=(Node&&) = delete;
 
-            virtual void process(std::vector<float>& samples, uint16_t& channels,
-                                 uint32_t& sampleRate, Vector3& position);
+            // the number of frames the inputs have to produce for the given number of output frames,
+            // called once before every process call, must not return more than MAX_FRAMES
+            virtual uint32_t getInputFrames(uint32_t frames);
 
-            void addOutputNode(Node* node);
-            void removeOutputNode(Node* node);
+            // samples contain getInputFrames(frames) frames of the mixed inputs and have to be replaced
+            // by frames frames of output in place, must not allocate or lock,
+            // setting channels to zero marks the output as silent, so that it is not mixed
+            virtual void process(float* samples, uint32_t frames, uint16_t& channels,
+                                 uint32_t& sampleRate, Vector3& position);
 
-        private:
-            void addInputNode(Node* node);
-            void removeInputNode(Node* node);
+            // called on the audio thread with the values sent by Audio::setNodeParameter
+            virtual void setParameter(uint32_t parameter, const float* values);
 
-            std::vector<Node*> inputNodes;
-            std::vector<Node*> outputNodes;
+            // called on the audio thread with the object sent by Audio::setNodeObject,
+            // the object is owned by the game thread, the node and the sender agree on when it is given back
+            virtual void setObject(uint32_t parameter, void* object);
 
-            std::vector<float> buffer;
+        private:
+            // the samples are in a buffer of the graph, see AudioDevice::Graph
+            uint32_t frames = 0;
+            uint32_t inputFrames = 0;
+            uint16_t channels = 0;
+            uint32_t sampleRate = 0;
+            Vector3 position;
         };
     } // namespace audio
 } // namespace ouzel
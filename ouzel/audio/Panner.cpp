@@ -11,36 +11,41 @@ namespace ouzel
         class PannerProcessor final: public Node
         {
         public:
-            PannerProcessor()
-            {
-            }
-
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& pos) override
-            {
-                Node::process(samples, channels, sampleRate, pos);
-
-                position = pos;
-            }
-
-            void setPosition(const Vector3& newPosition)
+            enum Parameter
             {
-                position = newPosition;
-            }
+                POSITION,
+                ROLLOFF_FACTOR,
+                MIN_DISTANCE,
+                MAX_DISTANCE
+            };
 
-            void setRolloffFactor(float newRolloffFactor)
+            PannerProcessor()
             {
-                rolloffFactor = newRolloffFactor;
             }
 
-            void setMinDistance(float newMinDistance)
+            void process(float*, uint32_t, uint16_t&,
+                         uint32_t&, Vector3& pos) override
             {
-                minDistance = newMinDistance;
+                pos = position;
             }
 
-            void setMaxDistance(float newMaxDistance)
+            void setParameter(uint32_t parameter, const float* values) override
             {
-                maxDistance = newMaxDistance;
+                switch (parameter)
+                {
+                    case POSITION:
+                        position = Vector3(values[0], values[1], values[2]);
+                        break;
+                    case ROLLOFF_FACTOR:
+                        rolloffFactor = values[0];
+                        break;
+                    case MIN_DISTANCE:
+                        minDistance = values[0];
+                        break;
+                    case MAX_DISTANCE:
+                        maxDistance = values[0];
+                        break;
+                }
             }
 
         private:
@@ -66,40 +71,28 @@ namespace ouzel
         {
             position = newPosition;
 
-            audio.updateNode(nodeId, [newPosition](Node* node) {
-                PannerProcessor* pannerProcessor = static_cast<PannerProcessor*>(node);
-                pannerProcessor->setPosition(newPosition);
-            });
+            audio.setNodeParameter(nodeId, PannerProcessor::POSITION, newPosition);
         }
 
         void Panner::setRolloffFactor(float newRolloffFactor)
         {
             rolloffFactor = newRolloffFactor;
 
-            audio.updateNode(nodeId, [newRolloffFactor](Node* node) {
-                PannerProcessor* pannerProcessor = static_cast<PannerProcessor*>(node);
-                pannerProcessor->setRolloffFactor(newRolloffFactor);
-            });
+            audio.setNodeParameter(nodeId, PannerProcessor::ROLLOFF_FACTOR, newRolloffFactor);
         }
 
         void Panner::setMinDistance(float newMinDistance)
         {
             minDistance = newMinDistance;
 
-            audio.updateNode(nodeId, [newMinDistance](Node* node) {
-                PannerProcessor* pannerProcessor = static_cast<PannerProcessor*>(node);
-                pannerProcessor->setMinDistance(newMinDistance);
-            });
+            audio.setNodeParameter(nodeId, PannerProcessor::MIN_DISTANCE, newMinDistance);
         }
 
         void Panner::setMaxDistance(float newMaxDistance)
         {
             maxDistance = newMaxDistance;
 
-            audio.updateNode(nodeId, [newMaxDistance](Node* node) {
-                PannerProcessor* pannerProcessor = static_cast<PannerProcessor*>(node);
-                pannerProcessor->setMaxDistance(newMaxDistance);
-            });
+            audio.setNodeParameter(nodeId, PannerProcessor::MAX_DISTANCE, newMaxDistance);
         }
 
         void Panner::updateTransform()
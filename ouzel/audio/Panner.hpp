@@ -27,6 +27,10 @@ namespace ouzel
             Panner(Panner&&) = delete;
             Panner& operator=(Panner&&) = delete;
 
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            float estimateGain(const Panner*) const override { return estimateOutputGain(this); }
+
             const Vector3& getPosition() const { return position; }
             void setPosition(const Vector3& newPosition);
 
@@ -1,29 +1,67 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Pitch.hpp"
 #include "Audio.hpp"
+#include "math/MathUtils.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        const float Pitch::MAX_PITCH = 4.0F;
+
         class PitchProcessor final: public Node
         {
         public:
-            PitchProcessor()
+            enum Parameter
+            {
+                PITCH,
+                QUALITY
+            };
+
+            PitchProcessor(Resampler::Quality quality):
+                resampler(quality, MAX_CHANNELS, MAX_FRAMES, Pitch::MAX_PITCH),
+                output(MAX_FRAMES * MAX_CHANNELS)
+            {
+            }
+
+            uint32_t getInputFrames(uint32_t frames) override
             {
+                // longer chains of pitch nodes are cut off at MAX_FRAMES and the resampler fills the rest with silence
+                inputFrames = std::min(resampler.getInputFrames(frames), MAX_FRAMES);
+                return inputFrames;
             }
 
-            void process(std::vector<float>& samples, uint16_t& channels,
-                         uint32_t& sampleRate, Vector3& position) override
+            void process(float* samples, uint32_t frames, uint16_t& channels,
+                         uint32_t&, Vector3&) override
             {
-                Node::process(samples, channels, sampleRate, position);
+                resampler.process(samples, inputFrames, output.data(), frames, channels);
+                std::copy(output.begin(), output.begin() + frames * channels, samples);
             }
+
+            void setParameter(uint32_t parameter, const float* values) override
+            {
+                switch (parameter)
+                {
+                    case PITCH:
+                        resampler.setRatio(values[0]);
+                        break;
+                    case QUALITY:
+                        resampler.setQuality(static_cast<Resampler::Quality>(static_cast<uint32_t>(values[0])));
+                        break;
+                }
+            }
+
+        private:
+            Resampler resampler;
+            std::vector<float> output;
+            uint32_t inputFrames = 0;
         };
 
         Pitch::Pitch(Audio& initAudio):
             audio(initAudio),
-            nodeId(audio.initNode([]() { return std::unique_ptr<Node>(new PitchProcessor()); }))
+            nodeId(audio.initNode([]() { return std::unique_ptr<Node>(new PitchProcessor(Resampler::Quality::MEDIUM)); }))
         {
         }
 
@@ -34,7 +72,16 @@ namespace ouzel
 
         void Pitch::setPitch(float newPitch)
         {
-            pitch = newPitch;
+            pitch = clamp(newPitch, 1.0F / MAX_PITCH, MAX_PITCH);
+
+            audio.setNodeParameter(nodeId, PitchProcessor::PITCH, pitch);
+        }
+
+        void Pitch::setQuality(Resampler::Quality newQuality)
+        {
+            quality = newQuality;
+
+            audio.setNodeParameter(nodeId, PitchProcessor::QUALITY, static_cast<float>(quality));
         }
     } // namespace audio
 } // namespace ouzel
@@ -3,6 +3,7 @@
 #ifndef OUZEL_AUDIO_PITCH_HPP
 #define OUZEL_AUDIO_PITCH_HPP
 
+#include "audio/Resampler.hpp"
 #include "audio/SoundInput.hpp"
 #include "audio/SoundOutput.hpp"
 
@@ -23,14 +24,25 @@ namespace ouzel
 
             Pitch(Pitch&&) = delete;
             Pitch& operator=(Pitch&&) = delete;
+
+            uintptr_t getInputNodeId() const override { return nodeId; }
+            uintptr_t getOutputNodeId() const override { return nodeId; }
+            float estimateGain(const Panner* panner) const override { return estimateOutputGain(panner); }
             
             float getPitch() const { return pitch; }
+            // clamped to [1 / MAX_PITCH, MAX_PITCH]
             void setPitch(float newPitch);
 
+            inline Resampler::Quality getQuality() const { return quality; }
+            void setQuality(Resampler::Quality newQuality);
+
+            static const float MAX_PITCH;
+
         private:
             Audio& audio;
             uintptr_t nodeId = 0;
             float pitch = 1.0f;
+            Resampler::Quality quality = Resampler::Quality::MEDIUM;
         };
     } // namespace audio
 } // namespace ouzel
@@ -0,0 +1,243 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include "Resampler.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Errors.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        static const uint32_t MEDIUM_TAPS = 16;
+        static const uint32_t MEDIUM_PHASES = 64;
+        static const uint32_t HIGH_TAPS = 32;
+        static const uint32_t HIGH_PHASES = 256;
+
+        // the filters are built for cutoffs this far apart, so the cutoff is never more than 2% off
+        static const float CUTOFF_STEP = 0.96F;
+
+        static uint32_t getCutoffLevel(float cutoff)
+        {
+            return static_cast<uint32_t>(std::lround(std::log(cutoff) / std::log(CUTOFF_STEP)));
+        }
+
+        static void buildFilter(uint32_t taps, uint32_t phases, float cutoff, float* filter)
+        {
+            const float halfTaps = static_cast<float>(taps / 2);
+            // leave a transition band below the cutoff
+            const float bandwidth = cutoff * 0.95F;
+
+            for (uint32_t phase = 0; phase <= phases; ++phase)
+            {
+                float* row = filter + phase * taps;
+                float fraction = static_cast<float>(phase) / static_cast<float>(phases);
+                float sum = 0.0F;
+
+                for (uint32_t tap = 0; tap < taps; ++tap)
+                {
+                    // distance of the tap's frame from the interpolated position
+                    float x = static_cast<float>(tap) - (halfTaps - 1.0F) - fraction;
+                    float sinc = (x == 0.0F) ? 1.0F : std::sin(PI * bandwidth * x) / (PI * bandwidth * x);
+                    // Blackman window
+                    float window = 0.42F + 0.5F * std::cos(PI * x / halfTaps) + 0.08F * std::cos(TAU * x / halfTaps);
+
+                    row[tap] = sinc * window;
+                    sum += row[tap];
+                }
+
+                // unity gain for constant signals
+                for (uint32_t tap = 0; tap < taps; ++tap)
+                    row[tap] /= sum;
+            }
+        }
+
+        // the filters are shared by all resamplers and built on the thread that creates the first one that needs them
+        static void getFilters(uint32_t taps, uint32_t phases, uint32_t levelCount, std::vector<const float*>& result)
+        {
+            static std::mutex mutex;
+            static std::vector<std::unique_ptr<float[]>> mediumFilters;
+            static std::vector<std::unique_ptr<float[]>> highFilters;
+
+            std::unique_lock<std::mutex> lock(mutex);
+
+            std::vector<std::unique_ptr<float[]>>& filters = (taps == HIGH_TAPS) ? highFilters : mediumFilters;
+
+            while (filters.size() < levelCount)
+            {
+                std::unique_ptr<float[]> filter(new float[(phases + 1) * taps]);
+                buildFilter(taps, phases, std::pow(CUTOFF_STEP, static_cast<float>(filters.size())), filter.get());
+                filters.push_back(std::move(filter));
+            }
+
+            result.clear();
+            for (uint32_t level = 0; level < levelCount; ++level)
+                result.push_back(filters[level].get());
+        }
+
+        Resampler::Resampler(Quality initQuality, uint16_t initMaxChannels,
+                             uint32_t initMaxOutputFrames, float initMaxRatio):
+            quality(initQuality),
+            maxChannels(initMaxChannels),
+            maxOutputFrames(initMaxOutputFrames),
+            maxRatio(initMaxRatio),
+            coefficients(HIGH_TAPS)
+        {
+            if (maxRatio <= 0.0F)
+                throw ConfigError("Invalid resampling ratio");
+
+            maxInputFrames = static_cast<uint32_t>(std::ceil(maxOutputFrames * maxRatio)) + HIGH_TAPS + 2;
+            history.resize((maxInputFrames + HIGH_TAPS + 2) * maxChannels);
+
+            // the quality can be changed on the audio thread, so the filters of all qualities are needed
+            uint32_t levelCount = getCutoffLevel(std::min(1.0F, 1.0F / maxRatio)) + 1;
+            getFilters(MEDIUM_TAPS, MEDIUM_PHASES, levelCount, mediumFilters);
+            getFilters(HIGH_TAPS, HIGH_PHASES, levelCount, highFilters);
+
+            setQuality(quality);
+        }
+
+        void Resampler::setQuality(Quality newQuality)
+        {
+            quality = newQuality;
+
+            switch (quality)
+            {
+                case Quality::LINEAR: taps = 2; phases = 1; break;
+                case Quality::MEDIUM: taps = MEDIUM_TAPS; phases = MEDIUM_PHASES; break;
+                case Quality::HIGH: taps = HIGH_TAPS; phases = HIGH_PHASES; break;
+                default: throw ConfigError("Invalid resampling quality");
+            }
+
+            selectFilter();
+            reset();
+        }
+
+        void Resampler::setRatio(float newRatio)
+        {
+            ratio = clamp(newRatio, 0.001F, maxRatio);
+
+            // only downsampling has to remove the frequencies above the new Nyquist frequency
+            uint32_t newCutoffLevel = std::min(getCutoffLevel(std::min(1.0F, 1.0F / ratio)),
+                                               static_cast<uint32_t>(mediumFilters.size() - 1));
+
+            if (newCutoffLevel != cutoffLevel)
+            {
+                cutoffLevel = newCutoffLevel;
+                selectFilter();
+            }
+        }
+
+        void Resampler::selectFilter()
+        {
+            switch (quality)
+            {
+                case Quality::MEDIUM: filter = mediumFilters[cutoffLevel]; break;
+                case Quality::HIGH: filter = highFilters[cutoffLevel]; break;
+                default: filter = nullptr; break;
+            }
+        }
+
+        uint32_t Resampler::getInputFrames(uint32_t outputFrames) const
+        {
+            if (outputFrames == 0) return 0;
+
+            outputFrames = std::min(outputFrames, maxOutputFrames);
+
+            double last = position + static_cast<double>(outputFrames - 1) * ratio;
+            uint32_t neededFrames = static_cast<uint32_t>(last) + taps / 2 + 1;
+
+            return (neededFrames > historyFrames) ? neededFrames - historyFrames : 0;
+        }
+
+        void Resampler::process(const float* input, uint32_t inputFrames,
+                                float* output, uint32_t outputFrames, uint16_t newChannels)
+        {
+            if (newChannels != channels)
+            {
+                channels = std::min(newChannels, maxChannels);
+                reset();
+            }
+
+            // a silent input has no channels, so there is nothing to resample
+            if (channels == 0) return;
+
+            uint32_t capacity = static_cast<uint32_t>(history.size() / channels);
+
+            inputFrames = std::min(inputFrames, capacity - historyFrames);
+            std::copy(input, input + inputFrames * channels, history.begin() + historyFrames * channels);
+            historyFrames += inputFrames;
+
+            uint32_t neededFrames = std::min(historyFrames + getInputFrames(outputFrames), capacity);
+            if (neededFrames > historyFrames)
+            {
+                std::fill(history.begin() + historyFrames * channels, history.begin() + neededFrames * channels, 0.0F);
+                historyFrames = neededFrames;
+            }
+
+            // the interpolated position is kept in the range of the history by getInputFrames
+            const uint32_t firstTap = taps / 2 - 1;
+            const float* frames = history.data();
+            outputFrames = std::min(outputFrames, maxOutputFrames);
+
+            for (uint32_t frame = 0; frame < outputFrames; ++frame)
+            {
+                double current = position + static_cast<double>(frame) * ratio;
+                uint32_t index = static_cast<uint32_t>(current);
+                float fraction = static_cast<float>(current - index);
+                float* result = output + frame * channels;
+
+                if (quality == Quality::LINEAR)
+                {
+                    const float* first = frames + index * channels;
+                    const float* second = first + channels;
+
+                    for (uint16_t channel = 0; channel < channels; ++channel)
+                        result[channel] = first[channel] + (second[channel] - first[channel]) * fraction;
+                }
+                else
+                {
+                    // interpolate the coefficients between the two nearest phases
+                    float phase = fraction * phases;
+                    uint32_t phaseIndex = std::min(static_cast<uint32_t>(phase), phases - 1);
+                    float phaseFraction = phase - phaseIndex;
+                    const float* row = filter + phaseIndex * taps;
+                    const float* nextRow = row + taps;
+
+                    for (uint32_t tap = 0; tap < taps; ++tap)
+                        coefficients[tap] = row[tap] + (nextRow[tap] - row[tap]) * phaseFraction;
+
+                    const float* first = frames + (index - firstTap) * channels;
+
+                    for (uint16_t channel = 0; channel < channels; ++channel)
+                    {
+                        float sum = 0.0F;
+                        for (uint32_t tap = 0; tap < taps; ++tap)
+                            sum += coefficients[tap] * first[tap * channels + channel];
+                        result[channel] = sum;
+                    }
+                }
+            }
+
+            // drop the frames that are no longer needed by the filter
+            position += static_cast<double>(outputFrames) * ratio;
+            uint32_t index = static_cast<uint32_t>(position);
+            uint32_t droppedFrames = std::min(index > firstTap ? index - firstTap : 0, historyFrames);
+
+            std::copy(history.begin() + droppedFrames * channels, history.begin() + historyFrames * channels, history.begin());
+            historyFrames -= droppedFrames;
+            position -= droppedFrames;
+        }
+
+        void Resampler::reset()
+        {
+            // start with silence before the first frame, so that the filter is centered on it
+            historyFrames = taps / 2 - 1;
+            std::fill(history.begin(), history.begin() + historyFrames * std::max(channels, static_cast<uint16_t>(1)), 0.0F);
+            position = static_cast<double>(historyFrames);
+        }
+    } // namespace audio
+} // namespace ouzel
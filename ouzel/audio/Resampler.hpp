@@ -0,0 +1,81 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_RESAMPLER_HPP
+#define OUZEL_AUDIO_RESAMPLER_HPP
+
+#include <cstdint>
+#include <vector>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // Streaming sample rate converter, the buffers are allocated in the constructor,
+        // so that the rest of the methods can be called on the audio thread
+        class Resampler final
+        {
+        public:
+            enum class Quality
+            {
+                LINEAR, // linear interpolation, cheapest, audible aliasing
+                MEDIUM, // 16-tap windowed sinc
+                HIGH // 32-tap windowed sinc
+            };
+
+            Resampler(Quality initQuality, uint16_t initMaxChannels,
+                      uint32_t initMaxOutputFrames, float initMaxRatio);
+
+            Resampler(const Resampler&) = delete;
+            Resampler& operator=(const Resampler&) = delete;
+
+            Resampler(Resampler&&) = delete;
+            Resampler& operator=(Resampler&&) = delete;
+
+            inline Quality getQuality() const { return quality; }
+            void setQuality(Quality newQuality);
+
+            // input frames per output frame, clamped to the maximum ratio
+            inline float getRatio() const { return ratio; }
+            void setRatio(float newRatio);
+
+            // the number of input frames the next process call needs for the given output frames
+            uint32_t getInputFrames(uint32_t outputFrames) const;
+            inline uint32_t getMaxInputFrames() const { return maxInputFrames; }
+
+            // missing input frames are treated as silence, the channel count must not exceed the maximum
+            void process(const float* input, uint32_t inputFrames,
+                         float* output, uint32_t outputFrames, uint16_t channels);
+
+            void reset();
+
+        private:
+            void selectFilter();
+
+            Quality quality;
+            uint16_t maxChannels;
+            uint32_t maxOutputFrames;
+            float maxRatio;
+            uint32_t maxInputFrames;
+
+            float ratio = 1.0F;
+            uint32_t taps = 2;
+            uint32_t phases = 1;
+
+            // phases + 1 rows of taps coefficients for every cutoff level up to the maximum ratio,
+            // shared by all resamplers, so that the audio thread only switches between them
+            std::vector<const float*> mediumFilters;
+            std::vector<const float*> highFilters;
+            uint32_t cutoffLevel = 0;
+            const float* filter = nullptr;
+            std::vector<float> coefficients;
+
+            // the frames that are still needed by the filter, interleaved
+            std::vector<float> history;
+            uint16_t channels = 0;
+            uint32_t historyFrames = 0;
+            double position = 0.0;
+        };
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_RESAMPLER_HPP
@@ -0,0 +1,143 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "core/Setup.h"
+#if OUZEL_SUPPORTS_SSE2
+#include <emmintrin.h>
+#elif OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+#include <arm_neon.h>
+#endif
+#include "SampleOperations.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        void mixSamples(const float* source, float* destination, uint32_t count)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_loadu_ps(source + i)));
+                _mm_storeu_ps(destination + i + 4, _mm_add_ps(_mm_loadu_ps(destination + i + 4), _mm_loadu_ps(source + i + 4)));
+            }
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+            for (; i + 8 <= count; i += 8)
+            {
+                vst1q_f32(destination + i, vaddq_f32(vld1q_f32(destination + i), vld1q_f32(source + i)));
+                vst1q_f32(destination + i + 4, vaddq_f32(vld1q_f32(destination + i + 4), vld1q_f32(source + i + 4)));
+            }
+#endif
+
+            for (; i < count; ++i)
+                destination[i] += source[i];
+        }
+
+        void mixSamples(const float* source, float* destination, uint32_t count, float gain)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            __m128 g = _mm_set1_ps(gain);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm_storeu_ps(destination + i, _mm_add_ps(_mm_loadu_ps(destination + i), _mm_mul_ps(_mm_loadu_ps(source + i), g)));
+                _mm_storeu_ps(destination + i + 4, _mm_add_ps(_mm_loadu_ps(destination + i + 4), _mm_mul_ps(_mm_loadu_ps(source + i + 4), g)));
+            }
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+            for (; i + 8 <= count; i += 8)
+            {
+                vst1q_f32(destination + i, vmlaq_n_f32(vld1q_f32(destination + i), vld1q_f32(source + i), gain));
+                vst1q_f32(destination + i + 4, vmlaq_n_f32(vld1q_f32(destination + i + 4), vld1q_f32(source + i + 4), gain));
+            }
+#endif
+
+            for (; i < count; ++i)
+                destination[i] += source[i] * gain;
+        }
+
+        void scaleSamples(float* samples, uint32_t count, float gain)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            __m128 g = _mm_set1_ps(gain);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                _mm_storeu_ps(samples + i, _mm_mul_ps(_mm_loadu_ps(samples + i), g));
+                _mm_storeu_ps(samples + i + 4, _mm_mul_ps(_mm_loadu_ps(samples + i + 4), g));
+            }
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+            for (; i + 8 <= count; i += 8)
+            {
+                vst1q_f32(samples + i, vmulq_n_f32(vld1q_f32(samples + i), gain));
+                vst1q_f32(samples + i + 4, vmulq_n_f32(vld1q_f32(samples + i + 4), gain));
+            }
+#endif
+
+            for (; i < count; ++i)
+                samples[i] *= gain;
+        }
+
+        void clampSamples(float* samples, uint32_t count)
+        {
+            uint32_t i = 0;
+
+#if OUZEL_SUPPORTS_SSE
+            __m128 minimum = _mm_set1_ps(-1.0F);
+            __m128 maximum = _mm_set1_ps(1.0F);
+
+            for (; i + 4 <= count; i += 4)
+                _mm_storeu_ps(samples + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(samples + i), minimum), maximum));
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+            float32x4_t minimum = vdupq_n_f32(-1.0F);
+            float32x4_t maximum = vdupq_n_f32(1.0F);
+
+            for (; i + 4 <= count; i += 4)
+                vst1q_f32(samples + i, vminq_f32(vmaxq_f32(vld1q_f32(samples + i), minimum), maximum));
+#endif
+
+            for (; i < count; ++i)
+                samples[i] = clamp(samples[i], -1.0F, 1.0F);
+        }
+
+        void convertSamples(const float* source, int16_t* destination, uint32_t count)
+        {
+            uint32_t i = 0;
+
+            // conversion truncates towards zero like the scalar cast
+#if OUZEL_SUPPORTS_SSE2
+            __m128 minimum = _mm_set1_ps(-1.0F);
+            __m128 maximum = _mm_set1_ps(1.0F);
+            __m128 scale = _mm_set1_ps(32767.0F);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                __m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i), minimum), maximum), scale);
+                __m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(source + i + 4), minimum), maximum), scale);
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + i),
+                                 _mm_packs_epi32(_mm_cvttps_epi32(a), _mm_cvttps_epi32(b)));
+            }
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+            float32x4_t minimum = vdupq_n_f32(-1.0F);
+            float32x4_t maximum = vdupq_n_f32(1.0F);
+
+            for (; i + 8 <= count; i += 8)
+            {
+                float32x4_t a = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(source + i), minimum), maximum), 32767.0F);
+                float32x4_t b = vmulq_n_f32(vminq_f32(vmaxq_f32(vld1q_f32(source + i + 4), minimum), maximum), 32767.0F);
+                vst1q_s16(destination + i, vcombine_s16(vqmovn_s32(vcvtq_s32_f32(a)), vqmovn_s32(vcvtq_s32_f32(b))));
+            }
+#endif
+
+            for (; i < count; ++i)
+                destination[i] = static_cast<int16_t>(clamp(source[i], -1.0F, 1.0F) * 32767.0F);
+        }
+    } // namespace audio
+} // namespace ouzel
@@ -0,0 +1,26 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_SAMPLEOPERATIONS_HPP
+#define OUZEL_AUDIO_SAMPLEOPERATIONS_HPP
+
+#include <cstdint>
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // Vectorized with SSE or NEON where available, the pointers do not have to be aligned
+
+        // destination += source
+        void mixSamples(const float* source, float* destination, uint32_t count);
+        // destination += source * gain
+        void mixSamples(const float* source, float* destination, uint32_t count, float gain);
+        void scaleSamples(float* samples, uint32_t count, float gain);
+        // clamps the samples to [-1, 1]
+        void clampSamples(float* samples, uint32_t count);
+        // clamps the samples to [-1, 1] and converts them to 16-bit integers
+        void convertSamples(const float* source, int16_t* destination, uint32_t count);
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_SAMPLEOPERATIONS_HPP
@@ -1,16 +1,179 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Sound.hpp"
 #include "Audio.hpp"
 #include "AudioDevice.hpp"
 #include "SoundData.hpp"
 #include "Stream.hpp"
 #include "core/Engine.hpp"
+#include "utils/Errors.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        class SoundProcessor final: public Node
+        {
+        public:
+            enum Parameter
+            {
+                QUALITY,
+                VIRTUAL,
+                VOICE_STATE // a VoiceState, sent before the voice becomes real if the sound is resampled
+            };
+
+            SoundProcessor(const std::shared_ptr<SoundData>& initSoundData,
+                           const std::shared_ptr<Stream>& initStream,
+                           Resampler::Quality initQuality):
+                soundData(initSoundData),
+                stream(initStream),
+                quality(initQuality)
+            {
+                if (soundData->getChannels() == 0 || soundData->getChannels() > MAX_CHANNELS)
+                    throw DataError("Unsupported channel count");
+            }
+
+            ~SoundProcessor()
+            {
+                // deleted on the game thread after the audio thread has stopped using the node
+                releaseVoiceState();
+            }
+
+            void process(float* samples, uint32_t frames, uint16_t& channels,
+                         uint32_t& sampleRate, Vector3&) override
+            {
+                channels = soundData->getChannels();
+
+                if (stream->getShouldReset())
+                {
+                    stream->setShouldReset(false);
+                    stream->reset();
+                    if (voiceState) voiceState->getResampler().reset();
+                    skippedFrames = 0.0;
+                }
+
+                if (!stream->isPlaying())
+                {
+                    std::fill(samples, samples + frames * channels, 0.0F);
+
+                    // there is nothing to fade out
+                    if (virtualVoice)
+                    {
+                        silent = true;
+                        releaseVoiceState();
+                    }
+                    return;
+                }
+
+                double ratio = static_cast<double>(soundData->getSampleRate()) / sampleRate;
+                bool resampled = (soundData->getSampleRate() != sampleRate);
+
+                if ((virtualVoice && silent) || (resampled && !voiceState))
+                {
+                    // only the playback cursor is advanced, no channels tell the device that there is nothing to mix
+                    skippedFrames += frames * ratio;
+                    uint32_t wholeFrames = static_cast<uint32_t>(skippedFrames);
+                    skippedFrames -= wholeFrames;
+                    soundData->skip(stream.get(), wholeFrames);
+                    channels = 0;
+                    silent = true;
+                    return;
+                }
+
+                float startGain = 1.0F;
+                float endGain = 1.0F;
+
+                // fade in and out, so that virtualization does not click
+                if (virtualVoice)
+                {
+                    endGain = 0.0F;
+                    silent = true;
+                }
+                else if (silent)
+                {
+                    startGain = 0.0F;
+                    silent = false;
+                    if (voiceState) voiceState->getResampler().reset();
+                }
+
+                // the output is converted to the sample rate the graph runs at
+                if (!resampled)
+                    soundData->getData(stream.get(), frames, samples);
+                else
+                {
+                    Resampler& resampler = voiceState->getResampler();
+                    resampler.setRatio(static_cast<float>(ratio));
+                    uint32_t inputFrames = resampler.getInputFrames(frames);
+                    soundData->getData(stream.get(), inputFrames, voiceState->getData());
+                    resampler.process(voiceState->getData(), inputFrames, samples, frames, channels);
+                }
+
+                if (startGain != endGain)
+                {
+                    for (uint32_t frame = 0; frame < frames; ++frame)
+                    {
+                        float gain = startGain + (endGain - startGain) * (frame + 1) / frames;
+                        for (uint16_t channel = 0; channel < channels; ++channel)
+                            samples[frame * channels + channel] *= gain;
+                    }
+                }
+
+                // faded out, the state can be given to another voice
+                if (virtualVoice) releaseVoiceState();
+            }
+
+            void setParameter(uint32_t parameter, const float* values) override
+            {
+                switch (parameter)
+                {
+                    case QUALITY:
+                        quality = static_cast<Resampler::Quality>(static_cast<uint32_t>(values[0]));
+                        if (voiceState) voiceState->getResampler().setQuality(quality);
+                        break;
+                    case VIRTUAL:
+                        virtualVoice = (values[0] != 0.0F);
+                        // nothing to fade out if the voice has not been heard yet
+                        if (virtualVoice && silent) releaseVoiceState();
+                        break;
+                }
+            }
+
+            void setObject(uint32_t parameter, void* object) override
+            {
+                switch (parameter)
+                {
+                    case VOICE_STATE:
+                        // the previous state can still be here if the voice had not faded out yet
+                        releaseVoiceState();
+                        voiceState = static_cast<VoiceState*>(object);
+                        voiceState->getResampler().setQuality(quality);
+                        voiceState->getResampler().reset();
+                        break;
+                }
+            }
+
+        private:
+            void releaseVoiceState()
+            {
+                if (voiceState)
+                {
+                    voiceState->release();
+                    voiceState = nullptr;
+                }
+            }
+
+            std::shared_ptr<SoundData> soundData;
+            std::shared_ptr<Stream> stream;
+            Resampler::Quality quality;
+            VoiceState* voiceState = nullptr;
+
+            // voices start virtual and get a state when the voice manager makes them real
+            bool virtualVoice = true;
+            bool silent = true; // virtual and faded out
+            double skippedFrames = 0.0;
+        };
+
         Sound::Sound()
         {
         }
@@ -23,13 +186,103 @@ namespace ouzel
             if (soundData)
             {
                 stream = soundData->createStream();
-                stream->setEventListener(this);
+
+                Audio* audio = engine->getAudio();
+                uint32_t sampleRate = audio->getDevice()->getSampleRate();
+                resampled = (soundData->getSampleRate() != sampleRate);
+                maxRatio = std::max(1.0F, static_cast<float>(soundData->getSampleRate()) / sampleRate);
+
+                std::shared_ptr<SoundData> processorSoundData = soundData;
+                std::shared_ptr<Stream> processorStream = stream;
+                Resampler::Quality processorQuality = quality;
+
+                nodeId = audio->initNode([processorSoundData, processorStream, processorQuality]() {
+                    return std::unique_ptr<Node>(new SoundProcessor(processorSoundData, processorStream, processorQuality));
+                });
+
+                audio->getVoiceManager().addSound(this);
             }
         }
 
         Sound::~Sound()
         {
-            if (stream) stream->setEventListener(nullptr);
+            if (nodeId)
+            {
+                if (Audio* audio = engine->getAudio())
+                {
+                    audio->getVoiceManager().removeSound(this);
+                    audio->deleteNode(nodeId);
+                }
+            }
+        }
+
+        Sound::Sound(Sound&& other)
+        {
+            *this = std::move(other);
+        }
+
+        Sound& Sound::operator=(Sound&& other)
+        {
+            if (&other == this) return *this;
+
+            // the connection is moved together with the node
+            SoundOutput* newOutput = other.output;
+            other.setOutput(nullptr);
+            setOutput(nullptr);
+
+            Audio* audio = engine->getAudio();
+
+            if (nodeId && audio)
+            {
+                audio->getVoiceManager().removeSound(this);
+                audio->deleteNode(nodeId);
+            }
+
+            if (other.nodeId && audio)
+                audio->getVoiceManager().removeSound(&other);
+
+            soundData = std::move(other.soundData);
+            stream = std::move(other.stream);
+            nodeId = other.nodeId;
+            other.nodeId = 0;
+            quality = other.quality;
+            priority = other.priority;
+            virtualVoice = other.virtualVoice;
+            resampled = other.resampled;
+            maxRatio = other.maxRatio;
+            playing = other.playing;
+            repeating = other.repeating;
+
+            if (nodeId && audio)
+                audio->getVoiceManager().addSound(this);
+
+            setOutput(newOutput);
+
+            return *this;
+        }
+
+        void Sound::setVirtual(bool newVirtual)
+        {
+            if (virtualVoice == newVirtual) return;
+
+            virtualVoice = newVirtual;
+
+            Audio* audio = engine->getAudio();
+
+            // the processor gives the state back after it has faded out
+            if (!virtualVoice && resampled)
+                audio->setNodeObject(nodeId, SoundProcessor::VOICE_STATE,
+                                     audio->getVoiceManager().getVoiceState(soundData->getChannels(), maxRatio));
+
+            audio->setNodeParameter(nodeId, SoundProcessor::VIRTUAL, virtualVoice ? 1.0F : 0.0F);
+        }
+
+        void Sound::setQuality(Resampler::Quality newQuality)
+        {
+            quality = newQuality;
+
+            if (nodeId)
+                engine->getAudio()->setNodeParameter(nodeId, SoundProcessor::QUALITY, static_cast<float>(quality));
         }
 
         void Sound::play(bool repeatSound)
@@ -65,24 +318,31 @@ namespace ouzel
             }
         }
 
-        // executed on audio thread
-        void Sound::onReset()
+        void Sound::handleStreamEvents()
         {
-            std::unique_ptr<SoundEvent> event(new SoundEvent());
-            event->type = Event::Type::SOUND_RESET;
-            event->sound = this;
-            engine->getEventDispatcher().postEvent(std::move(event));
-        }
+            if (!stream) return;
 
-        // executed on audio thread
-        void Sound::onStop()
-        {
-            playing = false;
+            Stream::Event streamEvent;
+            while (stream->getEvent(streamEvent))
+            {
+                std::unique_ptr<SoundEvent> event(new SoundEvent());
+                event->sound = this;
 
-            std::unique_ptr<SoundEvent> event(new SoundEvent());
-            event->type = Event::Type::SOUND_FINISH;
-            event->sound = this;
-            engine->getEventDispatcher().postEvent(std::move(event));
+                switch (streamEvent)
+                {
+                    case Stream::Event::RESET:
+                        event->type = Event::Type::SOUND_RESET;
+                        break;
+                    case Stream::Event::STOP:
+                        playing = false;
+                        event->type = Event::Type::SOUND_FINISH;
+                        break;
+                    default:
+                        continue;
+                }
+
+                engine->getEventDispatcher().postEvent(std::move(event));
+            }
         }
     } // namespace audio
 } // namespace ouzel
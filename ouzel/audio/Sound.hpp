@@ -4,6 +4,7 @@
 #define OUZEL_AUDIO_SOUND_HPP
 
 #include <memory>
+#include "audio/Resampler.hpp"
 #include "audio/SoundInput.hpp"
 #include "audio/Stream.hpp"
 #include "math/Vector3.hpp"
@@ -13,15 +14,25 @@ namespace ouzel
     namespace audio
     {
         class SoundData;
+        class VoiceManager;
 
-        class Sound: public SoundInput, public Stream::EventListener
+        class Sound: public SoundInput
         {
             friend Audio;
+            friend VoiceManager;
         public:
             Sound();
             explicit Sound(const std::shared_ptr<SoundData>& initSoundData);
             virtual ~Sound();
 
+            Sound(const Sound&) = delete;
+            Sound& operator=(const Sound&) = delete;
+
+            Sound(Sound&& other);
+            Sound& operator=(Sound&& other);
+
+            uintptr_t getInputNodeId() const override { return nodeId; }
+
             inline const std::shared_ptr<SoundData>& getSoundData() const { return soundData; }
 
             void play(bool repeatSound = false);
@@ -31,12 +42,30 @@ namespace ouzel
             bool isPlaying() const { return playing; }
             bool isRepeating() const { return repeating; }
 
-            void onReset() override;
-            void onStop() override;
+            // sounds with a higher priority get real voices before sounds with a lower one
+            inline int32_t getPriority() const { return priority; }
+            inline void setPriority(int32_t newPriority) { priority = newPriority; }
+
+            // virtual sounds keep playing, but are not decoded or mixed, see VoiceManager
+            inline bool isVirtual() const { return virtualVoice; }
+
+            // used if the sample rate of the sound data differs from the device's
+            inline Resampler::Quality getQuality() const { return quality; }
+            void setQuality(Resampler::Quality newQuality);
 
         private:
+            void setVirtual(bool newVirtual);
+            // posts the events the audio thread has sent through the stream
+            void handleStreamEvents();
+
             std::shared_ptr<SoundData> soundData;
             std::shared_ptr<Stream> stream;
+            uintptr_t nodeId = 0;
+            Resampler::Quality quality = Resampler::Quality::MEDIUM;
+            int32_t priority = 0;
+            bool virtualVoice = true;
+            bool resampled = false;
+            float maxRatio = 1.0F;
 
             bool playing = false;
             bool repeating = false;
@@ -15,15 +15,14 @@ namespace ouzel
         {
         }
 
-        void SoundData::getData(Stream* stream, uint32_t frames, uint32_t neededChannels, uint32_t neededSampleRate, std::vector<float>& result)
+        void SoundData::getData(Stream* stream, uint32_t frames, float* result)
         {
-            uint32_t neededFrames = static_cast<uint32_t>(frames * sampleRate / neededSampleRate);
-
-            readData(stream, neededFrames, tempData);
-
-            resampledData = tempData;
+            readData(stream, frames, result);
+        }
 
-            result = resampledData;
+        void SoundData::skip(Stream* stream, uint32_t frames)
+        {
+            skipData(stream, frames);
         }
     } // namespace audio
 } // namespace ouzel
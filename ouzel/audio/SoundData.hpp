@@ -29,19 +29,20 @@ namespace ouzel
             SoundData& operator=(SoundData&&) = delete;
 
             virtual std::shared_ptr<Stream> createStream() = 0;
-            void getData(Stream* stream, uint32_t frames, uint32_t neededChannels, uint32_t neededSampleRate, std::vector<float>& result);
+            // reads frames * getChannels() samples, without allocating, so that it can be called on the audio thread
+            void getData(Stream* stream, uint32_t frames, float* result);
+            void skip(Stream* stream, uint32_t frames);
 
             inline uint16_t getChannels() const { return channels; }
             inline uint32_t getSampleRate() const { return sampleRate; }
 
         protected:
-            virtual void readData(Stream* stream, uint32_t frames, std::vector<float>& result) = 0;
+            virtual void readData(Stream* stream, uint32_t frames, float* result) = 0;
+            // advances the stream like readData, but without producing the samples
+            virtual void skipData(Stream* stream, uint32_t frames) = 0;
 
             uint16_t channels = 0;
             uint32_t sampleRate = 0;
-
-            std::vector<float> tempData;
-            std::vector<float> resampledData;
         };
     } // namespace audio
 } // namespace ouzel
@@ -1,7 +1,10 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "SoundDataVorbis.hpp"
+#include "Audio.hpp"
 #include "StreamVorbis.hpp"
+#include "core/Engine.hpp"
 #include "utils/Errors.hpp"
 #include "utils/Utils.hpp"
 
@@ -16,9 +19,9 @@ namespace ouzel
         }
 
         SoundDataVorbis::SoundDataVorbis(const std::vector<uint8_t>& initData):
-            data(initData)
+            data(std::make_shared<const std::vector<uint8_t>>(initData))
         {
-            stb_vorbis* vorbisStream = stb_vorbis_open_memory(data.data(), static_cast<int>(data.size()), nullptr, nullptr);
+            stb_vorbis* vorbisStream = stb_vorbis_open_memory(data->data(), static_cast<int>(data->size()), nullptr, nullptr);
 
             if (!vorbisStream)
                 throw ParseError("Failed to load Vorbis stream");
@@ -27,41 +30,49 @@ namespace ouzel
 
             channels = static_cast<uint16_t>(info.channels);
             sampleRate = info.sample_rate;
+            frameCount = stb_vorbis_stream_length_in_samples(vorbisStream);
+            head = StreamVorbis::decodeHead(vorbisStream, channels);
 
             stb_vorbis_close(vorbisStream);
         }
 
         std::shared_ptr<Stream> SoundDataVorbis::createStream()
         {
-            return std::make_shared<StreamVorbis>(data);
+            return std::make_shared<StreamVorbis>(data, head, channels, engine->getAudio()->getStreamPrefetcher());
         }
 
-        void SoundDataVorbis::readData(Stream* stream, uint32_t frames, std::vector<float>& result)
+        void SoundDataVorbis::readData(Stream* stream, uint32_t frames, float* result)
         {
             StreamVorbis* streamVorbis = static_cast<StreamVorbis*>(stream);
 
-            uint32_t neededSize = frames * channels;
-            uint32_t totalSize = 0;
-            stb_vorbis* vorbisStream = streamVorbis->getVorbisStream();
+            // the rest is silence at the end of the data or if the prefetcher has not caught up yet
+            uint32_t resultFrames = streamVorbis->read(result, frames);
 
-            result.resize(neededSize);
+            std::fill(result + resultFrames * channels, result + frames * channels, 0.0F);
+        }
 
-            while (neededSize > 0)
-            {
-                if (vorbisStream->eof)
-                    stream->reset();
+        void SoundDataVorbis::skipData(Stream* stream, uint32_t frames)
+        {
+            StreamVorbis* streamVorbis = static_cast<StreamVorbis*>(stream);
 
-                int resultFrames = stb_vorbis_get_samples_float_interleaved(vorbisStream, channels, result.data(), static_cast<int>(neededSize));
-                totalSize += static_cast<uint32_t>(resultFrames) * channels;
-                neededSize -= static_cast<uint32_t>(resultFrames) * channels;
+            // seeking is deferred to the next read, so that skipping costs nothing while the voice is virtual
+            uint64_t offset = streamVorbis->getOffset() + static_cast<uint64_t>(frames);
 
-                if (!stream->isRepeating()) break;
+            if (offset < frameCount)
+            {
+                streamVorbis->setOffset(static_cast<uint32_t>(offset));
+                streamVorbis->setSeekPending(true);
             }
-
-            if (vorbisStream->eof)
+            else
+            {
                 stream->reset();
 
-            std::fill(result.begin() + totalSize, result.end(), 0.0F);
+                if (stream->isRepeating() && frameCount > 0)
+                {
+                    streamVorbis->setOffset(static_cast<uint32_t>((offset - frameCount) % frameCount));
+                    streamVorbis->setSeekPending(true);
+                }
+            }
         }
     } // namespace audio
 } // namespace ouzel
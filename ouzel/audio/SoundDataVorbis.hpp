@@ -4,6 +4,7 @@
 #define OUZEL_AUDIO_SOUNDDATAVORBIS_HPP
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "audio/SoundData.hpp"
 
@@ -20,9 +21,14 @@ namespace ouzel
             std::shared_ptr<Stream> createStream() override;
 
         private:
-            void readData(Stream* stream, uint32_t frames, std::vector<float>& result) override;
+            void readData(Stream* stream, uint32_t frames, float* result) override;
+            void skipData(Stream* stream, uint32_t frames) override;
 
-            std::vector<uint8_t> data;
+            // compressed, shared with the streams
+            std::shared_ptr<const std::vector<uint8_t>> data;
+            // decoded, so that the streams can start playing before the prefetcher catches up
+            std::shared_ptr<const std::vector<float>> head;
+            uint32_t frameCount = 0;
         };
     } // namespace audio
 } // namespace ouzel
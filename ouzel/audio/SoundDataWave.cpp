@@ -168,15 +168,13 @@ namespace ouzel
             return std::make_shared<StreamWave>();
         }
 
-        void SoundDataWave::readData(Stream* stream, uint32_t frames, std::vector<float>& result)
+        void SoundDataWave::readData(Stream* stream, uint32_t frames, float* result)
         {
             StreamWave* streamWave = static_cast<StreamWave*>(stream);
 
             uint32_t neededSize = frames * channels;
             uint32_t totalSize = 0;
 
-            result.resize(neededSize);
-
             while (neededSize > 0)
             {
                 if (stream->isRepeating() && (data.size() - streamWave->getOffset()) == 0) streamWave->reset();
@@ -185,7 +183,7 @@ namespace ouzel
                 {
                     std::copy(data.begin() + streamWave->getOffset(),
                               data.end(),
-                              result.begin() + totalSize);
+                              result + totalSize);
                     totalSize += static_cast<uint32_t>(data.size() - streamWave->getOffset());
                     neededSize -= static_cast<uint32_t>(data.size() - streamWave->getOffset());
                     streamWave->setOffset(static_cast<uint32_t>(data.size()));
@@ -194,7 +192,7 @@ namespace ouzel
                 {
                     std::copy(data.begin() + streamWave->getOffset(),
                               data.begin() + streamWave->getOffset() + neededSize,
-                              result.begin() + totalSize);
+                              result + totalSize);
                     totalSize += neededSize;
                     streamWave->setOffset(streamWave->getOffset() + neededSize);
                     neededSize = 0;
@@ -205,7 +203,25 @@ namespace ouzel
 
             if ((data.size() - streamWave->getOffset()) == 0) streamWave->reset();
 
-            std::fill(result.begin() + totalSize, result.end(), 0.0F);
+            std::fill(result + totalSize, result + frames * channels, 0.0F);
+        }
+
+        void SoundDataWave::skipData(Stream* stream, uint32_t frames)
+        {
+            StreamWave* streamWave = static_cast<StreamWave*>(stream);
+
+            uint64_t size = data.size();
+            uint64_t offset = streamWave->getOffset() + static_cast<uint64_t>(frames) * channels;
+
+            if (offset < size)
+                streamWave->setOffset(static_cast<uint32_t>(offset));
+            else
+            {
+                streamWave->reset();
+
+                if (stream->isRepeating() && size > 0)
+                    streamWave->setOffset(static_cast<uint32_t>((offset - size) % size));
+            }
         }
     } // namespace audio
 } // namespace ouzel
@@ -20,7 +20,8 @@ namespace ouzel
             std::shared_ptr<Stream> createStream() override;
 
         private:
-            void readData(Stream* stream, uint32_t frames, std::vector<float>& result) override;
+            void readData(Stream* stream, uint32_t frames, float* result) override;
+            void skipData(Stream* stream, uint32_t frames) override;
 
             std::vector<float> data;
         };
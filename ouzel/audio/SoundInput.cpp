@@ -2,6 +2,8 @@
 
 #include "SoundInput.hpp"
 #include "SoundOutput.hpp"
+#include "Audio.hpp"
+#include "core/Engine.hpp"
 
 namespace ouzel
 {
@@ -12,11 +14,28 @@ namespace ouzel
             if (output) output->removeInput(this);
         }
 
+        float SoundInput::estimateOutputGain(const Panner* panner) const
+        {
+            return output ? output->estimateGain(panner) : 0.0F;
+        }
+
         void SoundInput::setOutput(SoundOutput* newOutput)
         {
-            if (output) output->removeInput(this);
+            Audio* audio = engine->getAudio();
+
+            if (output)
+            {
+                if (audio) audio->disconnectNodes(getInputNodeId(), output->getOutputNodeId());
+                output->removeInput(this);
+            }
+
             output = newOutput;
-            if (output) output->addInput(this);
+
+            if (output)
+            {
+                output->addInput(this);
+                if (audio) audio->connectNodes(getInputNodeId(), output->getOutputNodeId());
+            }
         }
     } // namespace audio
 } // namespace ouzel
@@ -3,12 +3,14 @@
 #ifndef OUZEL_AUDIO_SOUNDINPUT_HPP
 #define OUZEL_AUDIO_SOUNDINPUT_HPP
 
+#include <cstdint>
 #include "audio/AudioDevice.hpp"
 
 namespace ouzel
 {
     namespace audio
     {
+        class Panner;
         class SoundOutput;
 
         class SoundInput
@@ -20,6 +22,12 @@ namespace ouzel
             inline SoundOutput* getOutput() const { return output; }
             void setOutput(SoundOutput* newOutput);
 
+            // the node whose output is mixed into the output's node
+            virtual uintptr_t getInputNodeId() const { return 0; }
+
+            // zero if the input is not connected
+            float estimateOutputGain(const Panner* panner) const;
+
         protected:
             SoundOutput* output = nullptr;
         };
@@ -3,12 +3,14 @@
 #ifndef OUZEL_AUDIO_SOUNDOUTPUT_HPP
 #define OUZEL_AUDIO_SOUNDOUTPUT_HPP
 
+#include <cstdint>
 #include <vector>
 
 namespace ouzel
 {
     namespace audio
     {
+        class Panner;
         class SoundInput;
 
         class SoundOutput
@@ -17,6 +19,13 @@ namespace ouzel
         public:
             virtual ~SoundOutput();
 
+            // the node that mixes the inputs
+            virtual uintptr_t getOutputNodeId() const { return 0; }
+
+            // estimated gain from this output to the device, used to rank the voices,
+            // panner is the closest panner before this output or null
+            virtual float estimateGain(const Panner*) const { return 1.0F; }
+
         private:
             void addInput(SoundInput* input);
             void removeInput(SoundInput* input);
@@ -6,12 +6,10 @@ namespace ouzel
 {
     namespace audio
     {
-        Stream::EventListener::~EventListener()
-        {
-        }
+        static const size_t EVENT_QUEUE_SIZE = 32;
 
         Stream::Stream():
-            playing(false), shouldReset(false)
+            playing(false), repeating(false), shouldReset(false), eventQueue(EVENT_QUEUE_SIZE)
         {
         }
 
@@ -21,19 +19,13 @@ namespace ouzel
 
         void Stream::reset()
         {
-            std::unique_lock<std::mutex> lock(listenerMutex);
-            if (eventListener) eventListener->onReset();
+            // the events are dropped if the game thread has not taken the earlier ones
+            eventQueue.push(Event::RESET);
             if (!repeating)
             {
                 playing = false;
-                if (eventListener) eventListener->onStop();
+                eventQueue.push(Event::STOP);
             }
         }
-
-        void Stream::setEventListener(EventListener* newEventListener)
-        {
-            std::unique_lock<std::mutex> lock(listenerMutex);
-            eventListener = newEventListener;
-        }
     } // namespace audio
 } // namespace ouzel
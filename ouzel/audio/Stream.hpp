@@ -5,7 +5,7 @@
 
 #include <cstdint>
 #include <atomic>
-#include <mutex>
+#include "utils/SPSCQueue.hpp"
 
 namespace ouzel
 {
@@ -14,12 +14,10 @@ namespace ouzel
         class Stream
         {
         public:
-            class EventListener
+            enum class Event
             {
-            public:
-                virtual ~EventListener() = 0;
-                virtual void onReset() = 0;
-                virtual void onStop() = 0;
+                RESET,
+                STOP
             };
 
             Stream();
@@ -33,6 +31,9 @@ namespace ouzel
 
             virtual void reset();
 
+            // called on the prefetch thread for the streams added to a StreamPrefetcher
+            virtual void decodeAhead() {}
+
             bool isPlaying() const { return playing; }
             void setPlaying(bool newPlaying) { playing = newPlaying; }
 
@@ -42,15 +43,16 @@ namespace ouzel
             inline bool getShouldReset() const { return shouldReset; }
             inline void setShouldReset(bool newReset) { shouldReset = newReset; }
 
-            void setEventListener(EventListener* newEventListener);
+            // called on the game thread, returns false if there are no more events
+            inline bool getEvent(Event& event) { return eventQueue.pop(event); }
 
         private:
             std::atomic_bool playing;
             std::atomic_bool repeating;
             std::atomic_bool shouldReset;
 
-            std::mutex listenerMutex;
-            EventListener* eventListener = nullptr;
+            // sent by the audio thread, which must not allocate or lock
+            SPSCQueue<Event> eventQueue;
         };
     } // namespace audio
 } // namespace ouzel
@@ -0,0 +1,106 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <chrono>
+#include "StreamPrefetcher.hpp"
+#include "Stream.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        // often enough to refill the decode-ahead buffers long before they run out
+        static const std::chrono::milliseconds PREFETCH_INTERVAL(10);
+
+        StreamPrefetcher::StreamPrefetcher():
+            underrunCount(0)
+        {
+#if OUZEL_MULTITHREADED
+            prefetchThread = std::thread(&StreamPrefetcher::run, this);
+#endif
+        }
+
+        StreamPrefetcher::~StreamPrefetcher()
+        {
+#if OUZEL_MULTITHREADED
+            std::unique_lock<std::mutex> lock(streamMutex);
+            running = false;
+            lock.unlock();
+            streamCondition.notify_all();
+
+            if (prefetchThread.joinable()) prefetchThread.join();
+#endif
+        }
+
+        void StreamPrefetcher::addStream(Stream* stream)
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+            streams.push_back(stream);
+
+#if OUZEL_MULTITHREADED
+            // decode the beginning of the new stream right away
+            lock.unlock();
+            streamCondition.notify_all();
+#endif
+        }
+
+        void StreamPrefetcher::removeStream(Stream* stream)
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+
+            auto i = std::find(streams.begin(), streams.end(), stream);
+            if (i != streams.end()) streams.erase(i);
+
+#if OUZEL_MULTITHREADED
+            ++removeCount;
+
+            while (decodingStream == stream)
+                decodeCondition.wait(lock);
+#endif
+        }
+
+        void StreamPrefetcher::update()
+        {
+            std::unique_lock<std::mutex> lock(streamMutex);
+
+            for (Stream* stream : streams)
+                stream->decodeAhead();
+        }
+
+        void StreamPrefetcher::run()
+        {
+#if OUZEL_MULTITHREADED
+            setCurrentThreadName("Audio prefetch");
+
+            std::unique_lock<std::mutex> lock(streamMutex);
+
+            while (running)
+            {
+                decodedStreams.assign(streams.begin(), streams.end());
+                uint32_t passRemoveCount = removeCount;
+
+                for (Stream* stream : decodedStreams)
+                {
+                    // the stream has been removed and can already be deleted
+                    if (removeCount != passRemoveCount &&
+                        std::find(streams.begin(), streams.end(), stream) == streams.end())
+                        continue;
+
+                    // removeStream waits for the decoding to finish, so that the stream is not deleted meanwhile
+                    decodingStream = stream;
+                    lock.unlock();
+
+                    stream->decodeAhead();
+
+                    lock.lock();
+                    decodingStream = nullptr;
+                    decodeCondition.notify_all();
+                }
+
+                streamCondition.wait_for(lock, PREFETCH_INTERVAL);
+            }
+#endif
+        }
+    } // namespace audio
+} // namespace ouzel
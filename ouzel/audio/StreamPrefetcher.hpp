@@ -0,0 +1,67 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_STREAMPREFETCHER_HPP
+#define OUZEL_AUDIO_STREAMPREFETCHER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "core/Setup.h"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        class Stream;
+
+        // Decodes the registered streams ahead of the audio thread on a worker thread
+        class StreamPrefetcher final
+        {
+        public:
+            StreamPrefetcher();
+            ~StreamPrefetcher();
+
+            StreamPrefetcher(const StreamPrefetcher&) = delete;
+            StreamPrefetcher& operator=(const StreamPrefetcher&) = delete;
+
+            StreamPrefetcher(StreamPrefetcher&&) = delete;
+            StreamPrefetcher& operator=(StreamPrefetcher&&) = delete;
+
+            void addStream(Stream* stream);
+            // waits until the worker thread is not decoding the stream
+            void removeStream(Stream* stream);
+
+            // decodes on the calling thread, used if there is no worker thread
+            void update();
+
+            // the number of times a stream ran out of decoded samples
+            inline uint32_t getUnderrunCount() const { return underrunCount; }
+            // called on the audio thread
+            inline void addUnderrun() { ++underrunCount; }
+
+        private:
+            void run();
+
+            std::mutex streamMutex;
+            std::vector<Stream*> streams;
+            std::atomic<uint32_t> underrunCount;
+
+#if OUZEL_MULTITHREADED
+            std::condition_variable streamCondition;
+            bool running = true;
+            std::thread prefetchThread;
+
+            // the worker thread decodes a copy of the streams without the mutex held
+            std::vector<Stream*> decodedStreams;
+            Stream* decodingStream = nullptr;
+            uint32_t removeCount = 0; // tells the worker thread to check if the streams of its copy are still there
+            std::condition_variable decodeCondition;
+#endif
+        };
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_STREAMPREFETCHER_HPP
@@ -1,6 +1,9 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "StreamVorbis.hpp"
+#include "StreamPrefetcher.hpp"
+#include "utils/Errors.hpp"
 
 #define STB_VORBIS_HEADER_ONLY
 #include "stb_vorbis.c"
@@ -9,13 +12,94 @@ namespace ouzel
 {
     namespace audio
     {
-        StreamVorbis::StreamVorbis(const std::vector<uint8_t>& data)
+        // 4 chunks of 2048 frames keep about 190 ms decoded ahead at 44.1 kHz
+        static const uint32_t CHUNK_FRAMES = 2048;
+        static const uint32_t CHUNK_COUNT = 4;
+        static const uint32_t NO_CHUNK = UINT32_MAX;
+        // the seek offset that tells the prefetcher that there is nothing left to decode
+        static const uint32_t NO_OFFSET = UINT32_MAX;
+
+        // returns the number of frames decoded, which is less than requested only at the end of the data
+        static uint32_t decodeFrames(stb_vorbis* vorbisStream, uint16_t channels, float* result, uint32_t frames)
+        {
+            uint32_t decodedFrames = 0;
+
+            while (decodedFrames < frames)
+            {
+                int decoded = stb_vorbis_get_samples_float_interleaved(vorbisStream, channels,
+                                                                       result + decodedFrames * channels,
+                                                                       static_cast<int>((frames - decodedFrames) * channels));
+                if (decoded == 0) break;
+                decodedFrames += static_cast<uint32_t>(decoded);
+            }
+
+            return decodedFrames;
+        }
+
+        static bool seekFrame(stb_vorbis* vorbisStream, uint32_t offset)
+        {
+            return (offset == 0) ? stb_vorbis_seek_start(vorbisStream) != 0 : stb_vorbis_seek(vorbisStream, offset) != 0;
+        }
+
+        std::shared_ptr<const std::vector<float>> StreamVorbis::decodeHead(stb_vorbis* vorbisStream, uint16_t channels)
         {
-            vorbisStream = stb_vorbis_open_memory(data.data(), static_cast<int>(data.size()), nullptr, nullptr);
+            std::shared_ptr<std::vector<float>> result = std::make_shared<std::vector<float>>(CHUNK_FRAMES * channels);
+            uint32_t frames = decodeFrames(vorbisStream, channels, result->data(), CHUNK_FRAMES);
+            result->resize(frames * channels);
+            return result;
+        }
+
+        StreamVorbis::StreamVorbis(const std::shared_ptr<const std::vector<uint8_t>>& initData,
+                                   const std::shared_ptr<const std::vector<float>>& initHead, uint16_t initChannels,
+                                   const std::shared_ptr<StreamPrefetcher>& initPrefetcher):
+            data(initData),
+            head(initHead),
+            channels(initChannels),
+            prefetcher(initPrefetcher),
+            chunks(CHUNK_COUNT),
+            decodedChunks(CHUNK_COUNT),
+            freeChunks(CHUNK_COUNT),
+            generation(0),
+            seekOffset(0),
+            currentChunk(NO_CHUNK),
+            underrunCount(0)
+        {
+            // the compressed data is shared by all the streams of the sound data
+            vorbisStream = stb_vorbis_open_memory(data->data(), static_cast<int>(data->size()), nullptr, nullptr);
+
+            if (!vorbisStream)
+                throw DataError("Failed to open Vorbis stream");
+
+            // the decoder of the prefetcher can not be used on the audio thread
+            seekStream = stb_vorbis_open_memory(data->data(), static_cast<int>(data->size()), nullptr, nullptr);
+
+            if (!seekStream)
+            {
+                stb_vorbis_close(vorbisStream);
+                throw DataError("Failed to open Vorbis stream");
+            }
+
+            seekSamples.resize(CHUNK_FRAMES * channels);
+
+            for (uint32_t i = 0; i < CHUNK_COUNT; ++i)
+            {
+                chunks[i].samples.resize(CHUNK_FRAMES * channels);
+                freeChunks.push(i);
+            }
+
+            // the prefetcher starts decoding after the head
+            seek(0);
+
+            prefetcher->addStream(this);
         }
 
         StreamVorbis::~StreamVorbis()
         {
+            prefetcher->removeStream(this);
+
+            if (seekStream)
+                stb_vorbis_close(seekStream);
+
             if (vorbisStream)
                 stb_vorbis_close(vorbisStream);
         }
@@ -24,7 +108,183 @@ namespace ouzel
         {
             Stream::reset();
 
-            stb_vorbis_seek_start(vorbisStream);
+            seek(0);
+        }
+
+        void StreamVorbis::seek(uint32_t newOffset)
+        {
+            if (currentChunk != NO_CHUNK)
+            {
+                freeChunks.push(currentChunk);
+                currentChunk = NO_CHUNK;
+            }
+
+            offset = newOffset;
+            seekPending = false;
+
+            uint32_t headFrames = static_cast<uint32_t>(head->size() / channels);
+
+            if (newOffset < headFrames)
+            {
+                startSamples = head->data();
+                startFrames = headFrames;
+                startEnd = (headFrames < CHUNK_FRAMES);
+                chunkOffset = newOffset;
+            }
+            else
+            {
+                // the prefetcher would not decode the frames before the next read
+                startSamples = seekSamples.data();
+                startFrames = seekFrame(seekStream, newOffset) ?
+                    decodeFrames(seekStream, channels, seekSamples.data(), CHUNK_FRAMES) : 0;
+                startEnd = (startFrames < CHUNK_FRAMES);
+                chunkOffset = 0;
+            }
+
+            seekOffset.store(startEnd ? NO_OFFSET : offset - chunkOffset + startFrames, std::memory_order_relaxed);
+            generation.store(++readGeneration, std::memory_order_release);
+        }
+
+        void StreamVorbis::decodeAhead()
+        {
+            uint32_t currentGeneration = generation.load(std::memory_order_acquire);
+
+            if (currentGeneration != decoderGeneration)
+            {
+                uint32_t newOffset = seekOffset.load(std::memory_order_relaxed);
+
+                decoderGeneration = currentGeneration;
+                // the audio thread has already got the last frames
+                decoderFinished = (newOffset == NO_OFFSET) || !seekFrame(vorbisStream, newOffset);
+            }
+
+            uint32_t index;
+            while (!decoderFinished && freeChunks.pop(index))
+            {
+                Chunk& chunk = chunks[index];
+                chunk.generation = decoderGeneration;
+                chunk.end = false;
+                chunk.wrapped = false;
+                chunk.frames = decodeFrames(vorbisStream, channels, chunk.samples.data(), CHUNK_FRAMES);
+
+                if (chunk.frames < CHUNK_FRAMES)
+                {
+                    chunk.end = true;
+
+                    // repeating streams are decoded without a gap
+                    if (isRepeating())
+                    {
+                        stb_vorbis_seek_start(vorbisStream);
+                        chunk.wrapped = true;
+                    }
+                    else
+                        decoderFinished = true;
+                }
+
+                decodedChunks.push(index);
+
+                // the audio thread has seeked meanwhile
+                if (generation.load(std::memory_order_acquire) != decoderGeneration) break;
+            }
+        }
+
+        uint32_t StreamVorbis::read(float* result, uint32_t frames)
+        {
+            // skipped while the voice was virtual
+            if (seekPending) seek(offset);
+
+            uint32_t totalFrames = 0;
+
+            while (totalFrames < frames)
+            {
+                const float* samples;
+                uint32_t chunkFrames;
+                bool end;
+                bool wrapped;
+
+                if (startSamples)
+                {
+                    samples = startSamples;
+                    chunkFrames = startFrames;
+                    end = startEnd;
+                    wrapped = false;
+                }
+                else
+                {
+                    if (currentChunk == NO_CHUNK)
+                    {
+                        uint32_t index;
+                        if (!decodedChunks.pop(index))
+                        {
+                            prefetcher->addUnderrun();
+                            ++underrunCount;
+                            break;
+                        }
+
+                        // decoded before the last seek
+                        if (chunks[index].generation != readGeneration)
+                        {
+                            freeChunks.push(index);
+                            continue;
+                        }
+
+                        currentChunk = index;
+                        chunkOffset = 0;
+                    }
+
+                    const Chunk& chunk = chunks[currentChunk];
+                    samples = chunk.samples.data();
+                    chunkFrames = chunk.frames;
+                    end = chunk.end;
+                    wrapped = chunk.wrapped;
+                }
+
+                uint32_t copyFrames = std::min(frames - totalFrames, chunkFrames - chunkOffset);
+
+                std::copy(samples + chunkOffset * channels,
+                          samples + (chunkOffset + copyFrames) * channels,
+                          result + totalFrames * channels);
+
+                totalFrames += copyFrames;
+                chunkOffset += copyFrames;
+                offset += copyFrames;
+
+                if (chunkOffset == chunkFrames)
+                {
+                    if (startSamples)
+                        startSamples = nullptr;
+                    else
+                    {
+                        freeChunks.push(currentChunk);
+                        currentChunk = NO_CHUNK;
+                    }
+
+                    chunkOffset = 0;
+
+                    if (end)
+                    {
+                        if (wrapped)
+                        {
+                            // the following chunks already start from the beginning
+                            Stream::reset();
+                            offset = 0;
+                        }
+                        else if (isRepeating() && !head->empty())
+                        {
+                            // the prefetcher did not get to the end, so it continues after the head
+                            Stream::reset();
+                            seek(0);
+                        }
+                        else
+                        {
+                            reset();
+                            break;
+                        }
+                    }
+                }
+            }
+
+            return totalFrames;
         }
     } // namespace audio
 } // namespace ouzel
@@ -3,9 +3,12 @@
 #ifndef OUZEL_AUDIO_STREAMVORBIS_HPP
 #define OUZEL_AUDIO_STREAMVORBIS_HPP
 
+#include <atomic>
 #include <cstdint>
+#include <memory>
 #include <vector>
 #include "Stream.hpp"
+#include "utils/SPSCQueue.hpp"
 
 struct stb_vorbis;
 
@@ -13,17 +16,82 @@ namespace ouzel
 {
     namespace audio
     {
+        class StreamPrefetcher;
+
+        // Decoded by the prefetcher into a ring of chunks, the audio thread only copies the decoded samples,
+        // except for the first chunk after seeking past the head, which it decodes itself
         class StreamVorbis final: public Stream
         {
         public:
-            explicit StreamVorbis(const std::vector<uint8_t>& data);
+            StreamVorbis(const std::shared_ptr<const std::vector<uint8_t>>& initData,
+                         const std::shared_ptr<const std::vector<float>>& initHead, uint16_t initChannels,
+                         const std::shared_ptr<StreamPrefetcher>& initPrefetcher);
             ~StreamVorbis();
+
+            // decodes the first chunk of the data, which is shared by all the streams of the sound data
+            static std::shared_ptr<const std::vector<float>> decodeHead(stb_vorbis* vorbisStream, uint16_t channels);
+
+            // called on the audio thread, starts decoding from the beginning
             void reset() override;
+            void decodeAhead() override;
+
+            // called on the audio thread, returns the number of frames read,
+            // which is less than requested at the end of the data or if the prefetcher is behind
+            uint32_t read(float* result, uint32_t frames);
+
+            // the frame the next read starts at
+            inline uint32_t getOffset() const { return offset; }
+            inline void setOffset(uint32_t newOffset) { offset = newOffset; }
+
+            inline bool isSeekPending() const { return seekPending; }
+            inline void setSeekPending(bool newSeekPending) { seekPending = newSeekPending; }
 
-            inline stb_vorbis* getVorbisStream() const { return vorbisStream; }
+            inline uint32_t getUnderrunCount() const { return underrunCount; }
 
         private:
+            struct Chunk
+            {
+                std::vector<float> samples;
+                uint32_t generation = 0;
+                uint32_t frames = 0;
+                bool end = false; // the last chunk of the data
+                bool wrapped = false; // the decoder continued from the beginning after this chunk
+            };
+
+            // called on the audio thread, chunks decoded before the seek are discarded,
+            // the frames after the new offset are taken from the head or decoded right away
+            void seek(uint32_t newOffset);
+
+            std::shared_ptr<const std::vector<uint8_t>> data;
+            std::shared_ptr<const std::vector<float>> head;
+            uint16_t channels;
+            std::shared_ptr<StreamPrefetcher> prefetcher;
+
+            // used only by the prefetch thread
             stb_vorbis* vorbisStream = nullptr;
+            uint32_t decoderGeneration = 0;
+            bool decoderFinished = false;
+
+            std::vector<Chunk> chunks;
+            SPSCQueue<uint32_t> decodedChunks; // prefetch thread to audio thread
+            SPSCQueue<uint32_t> freeChunks; // audio thread to prefetch thread
+
+            std::atomic<uint32_t> generation;
+            std::atomic<uint32_t> seekOffset;
+
+            // used only by the audio thread
+            stb_vorbis* seekStream = nullptr;
+            std::vector<float> seekSamples;
+            // the frames played after a seek before the chunks of the prefetcher, the head or the seek samples
+            const float* startSamples = nullptr;
+            uint32_t startFrames = 0;
+            bool startEnd = false; // the last frames of the data
+            uint32_t readGeneration = 0;
+            uint32_t currentChunk;
+            uint32_t chunkOffset = 0;
+            uint32_t offset = 0;
+            bool seekPending = false;
+            std::atomic<uint32_t> underrunCount;
         };
     } // namespace audio
 } // namespace ouzel
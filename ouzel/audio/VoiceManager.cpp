@@ -0,0 +1,107 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "VoiceManager.hpp"
+#include "Node.hpp"
+#include "Sound.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        VoiceState::VoiceState(uint16_t initChannels, float initMaxRatio):
+            channels(initChannels),
+            maxRatio(initMaxRatio),
+            resampler(Resampler::Quality::LINEAR, initChannels, Node::MAX_FRAMES, initMaxRatio),
+            used(false)
+        {
+            data.resize(resampler.getMaxInputFrames() * channels);
+        }
+
+        VoiceManager::VoiceManager()
+        {
+        }
+
+        void VoiceManager::update()
+        {
+            voices.clear();
+
+            for (const SoundEntry& entry : sounds)
+                entry.sound->handleStreamEvents();
+
+            for (const SoundEntry& entry : sounds)
+            {
+                Sound* sound = entry.sound;
+
+                if (sound->isPlaying())
+                {
+                    float gain = sound->estimateOutputGain(nullptr);
+                    if (!sound->isVirtual()) gain *= switchMargin;
+                    voices.push_back(Voice{sound, entry.id, gain});
+                }
+                else
+                    sound->setVirtual(true); // stopped sounds give their voice state back
+            }
+
+            std::sort(voices.begin(), voices.end(), [](const Voice& a, const Voice& b) {
+                if (a.sound->getPriority() != b.sound->getPriority())
+                    return a.sound->getPriority() > b.sound->getPriority();
+                if (a.gain != b.gain)
+                    return a.gain > b.gain;
+                return a.id < b.id;
+            });
+
+            playingVoiceCount = static_cast<uint32_t>(voices.size());
+            realVoiceCount = 0;
+            virtualVoiceCount = 0;
+
+            for (const Voice& voice : voices)
+            {
+                if (realVoiceCount < maxVoices && voice.gain > audibilityThreshold)
+                {
+                    voice.sound->setVirtual(false);
+                    ++realVoiceCount;
+                }
+                else
+                {
+                    voice.sound->setVirtual(true);
+                    ++virtualVoiceCount;
+                }
+            }
+        }
+
+        VoiceState* VoiceManager::getVoiceState(uint16_t channels, float maxRatio)
+        {
+            for (const std::unique_ptr<VoiceState>& voiceState : voiceStates)
+            {
+                if (!voiceState->used && voiceState->channels == channels && voiceState->maxRatio == maxRatio)
+                {
+                    voiceState->used = true;
+                    return voiceState.get();
+                }
+            }
+
+            voiceStates.emplace_back(new VoiceState(channels, maxRatio));
+            voiceStates.back()->used = true;
+            return voiceStates.back().get();
+        }
+
+        void VoiceManager::addSound(Sound* sound)
+        {
+            sounds.push_back(SoundEntry{sound, nextSoundId++});
+        }
+
+        void VoiceManager::removeSound(Sound* sound)
+        {
+            // the ranking does not depend on the order, so the last sound is moved in place of the removed one
+            auto i = std::find_if(sounds.begin(), sounds.end(), [sound](const SoundEntry& entry) {
+                return entry.sound == sound;
+            });
+            if (i != sounds.end())
+            {
+                *i = sounds.back();
+                sounds.pop_back();
+            }
+        }
+    } // namespace audio
+} // namespace ouzel
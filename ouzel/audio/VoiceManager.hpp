@@ -0,0 +1,117 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_AUDIO_VOICEMANAGER_HPP
+#define OUZEL_AUDIO_VOICEMANAGER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "audio/Resampler.hpp"
+
+namespace ouzel
+{
+    namespace audio
+    {
+        class Sound;
+        class VoiceManager;
+
+        // The resampler and the input buffer of a real voice that needs resampling. Taken from the voice manager
+        // on the game thread when the voice becomes real and given back by the audio thread once it has faded out.
+        class VoiceState final
+        {
+            friend VoiceManager;
+        public:
+            VoiceState(uint16_t initChannels, float initMaxRatio);
+
+            VoiceState(const VoiceState&) = delete;
+            VoiceState& operator=(const VoiceState&) = delete;
+
+            VoiceState(VoiceState&&) = delete;
+            VoiceState& operator=(VoiceState&&) = delete;
+
+            inline uint16_t getChannels() const { return channels; }
+            inline float getMaxRatio() const { return maxRatio; }
+
+            inline Resampler& getResampler() { return resampler; }
+            inline float* getData() { return data.data(); }
+
+            // called on the audio thread or after the audio thread has stopped using the state
+            inline void release() { used = false; }
+
+        private:
+            uint16_t channels;
+            float maxRatio;
+            Resampler resampler;
+            std::vector<float> data;
+            std::atomic<bool> used;
+        };
+
+        // Keeps at most maxVoices playing sounds real, ranked by priority and the estimated gain to the device.
+        // The rest are virtual, they only advance their playback position and are not decoded or mixed.
+        class VoiceManager final
+        {
+            friend Sound;
+        public:
+            VoiceManager();
+
+            VoiceManager(const VoiceManager&) = delete;
+            VoiceManager& operator=(const VoiceManager&) = delete;
+
+            VoiceManager(VoiceManager&&) = delete;
+            VoiceManager& operator=(VoiceManager&&) = delete;
+
+            inline uint32_t getMaxVoices() const { return maxVoices; }
+            inline void setMaxVoices(uint32_t newMaxVoices) { maxVoices = newMaxVoices; }
+
+            // sounds with a lower estimated gain are virtual even if the budget is not used up
+            inline float getAudibilityThreshold() const { return audibilityThreshold; }
+            inline void setAudibilityThreshold(float newAudibilityThreshold) { audibilityThreshold = newAudibilityThreshold; }
+
+            // the estimated gain of real voices is multiplied by this when they are ranked, so that voices with
+            // close gains do not keep switching, every switch restarts the decoding of a streamed sound
+            inline float getSwitchMargin() const { return switchMargin; }
+            inline void setSwitchMargin(float newSwitchMargin) { switchMargin = newSwitchMargin; }
+
+            inline uint32_t getPlayingVoiceCount() const { return playingVoiceCount; }
+            inline uint32_t getRealVoiceCount() const { return realVoiceCount; }
+            inline uint32_t getVirtualVoiceCount() const { return virtualVoiceCount; }
+
+            void update();
+
+        private:
+            struct SoundEntry
+            {
+                Sound* sound;
+                uint64_t id; // the order the sounds were added in, breaks ties between equal voices
+            };
+
+            struct Voice
+            {
+                Sound* sound;
+                uint64_t id;
+                float gain;
+            };
+
+            void addSound(Sound* sound);
+            void removeSound(Sound* sound);
+            // reuses a released state with the same format, so the pool does not grow past the real voices
+            VoiceState* getVoiceState(uint16_t channels, float maxRatio);
+
+            uint32_t maxVoices = 64;
+            float audibilityThreshold = 0.001F; // -60 dB
+            float switchMargin = 1.41F; // 3 dB
+
+            uint64_t nextSoundId = 0;
+            std::vector<SoundEntry> sounds;
+            std::vector<Voice> voices;
+            std::vector<std::unique_ptr<VoiceState>> voiceStates;
+
+            uint32_t playingVoiceCount = 0;
+            uint32_t realVoiceCount = 0;
+            uint32_t virtualVoiceCount = 0;
+        };
+    } // namespace audio
+} // namespace ouzel
+
+#endif // OUZEL_AUDIO_VOICEMANAGER_HPP
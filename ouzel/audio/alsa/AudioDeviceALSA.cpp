@@ -49,9 +49,13 @@ namespace ouzel
             else
                 throw SystemError("No supported format");
 
-            if ((err = snd_pcm_hw_params_set_rate(playbackHandle, hwParams, sampleRate, 0)) < 0)
+            // the graph runs at the rate that the hardware supports, so that ALSA does not have to resample
+            unsigned int rate = sampleRate;
+            if ((err = snd_pcm_hw_params_set_rate_near(playbackHandle, hwParams, &rate, nullptr)) < 0)
                 throw SystemError("Failed to set sample rate, error: " + std::to_string(err));
 
+            sampleRate = rate;
+
             if ((err = snd_pcm_hw_params_set_channels(playbackHandle, hwParams, channels)) < 0)
                 throw SystemError("Failed to set channel count, error: " + std::to_string(err));
 
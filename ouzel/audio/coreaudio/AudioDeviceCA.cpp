@@ -145,11 +145,30 @@ namespace ouzel
 
                 CFRelease(tempStringRef);
             }
+
+            static const AudioObjectPropertyAddress sampleRateAddress = {
+                kAudioDevicePropertyNominalSampleRate,
+                kAudioDevicePropertyScopeOutput,
+                kAudioObjectPropertyElementMaster
+            };
+
+            // the graph runs at the rate of the device, so that the output unit does not have to resample
+            Float64 deviceSampleRate = 0.0;
+            size = sizeof(deviceSampleRate);
+            result = AudioObjectGetPropertyData(deviceId, &sampleRateAddress, 0, nullptr, &size, &deviceSampleRate);
+
+            if (result != noErr)
+                throw SystemError("Failed to get CoreAudio device sample rate, error: " + std::to_string(result));
+
+            if (deviceSampleRate > 0.0) sampleRate = static_cast<uint32_t>(deviceSampleRate);
 #endif // OUZEL_PLATFORM_MACOS
 
 #if OUZEL_PLATFORM_IOS || OUZEL_PLATFORM_TVOS
             id audioSession = reinterpret_cast<id (*)(Class, SEL)>(&objc_msgSend)(objc_getClass("AVAudioSession"), sel_getUid("sharedInstance"));
             reinterpret_cast<BOOL (*)(id, SEL, id, id)>(&objc_msgSend)(audioSession, sel_getUid("setCategory:error:"), AVAudioSessionCategoryAmbient, nil);
+
+            double sessionSampleRate = reinterpret_cast<double (*)(id, SEL)>(&objc_msgSend)(audioSession, sel_getUid("sampleRate"));
+            if (sessionSampleRate > 0.0) sampleRate = static_cast<uint32_t>(sessionSampleRate);
 #endif
 
             AudioComponentDescription desc;
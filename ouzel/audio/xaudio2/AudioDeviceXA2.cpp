@@ -76,6 +76,24 @@ namespace ouzel
                     throw SystemError("Failed to initialize XAudio2, error: " + std::to_string(hr));
             }
 
+            if (apiMajorVersion == 2 && apiMinorVersion == 7)
+            {
+                HRESULT hr = IXAudio2CreateMasteringVoice(xAudio, &masteringVoice);
+                if (FAILED(hr))
+                    throw SystemError("Failed to create XAudio2 mastering voice, error: " + std::to_string(hr));
+            }
+            else
+            {
+                HRESULT hr = xAudio->CreateMasteringVoice(&masteringVoice);
+                if (FAILED(hr))
+                    throw SystemError("Failed to create XAudio2 mastering voice, error: " + std::to_string(hr));
+            }
+
+            // the mastering voice runs at the rate of the device, so the source voice does not have to resample
+            XAUDIO2_VOICE_DETAILS voiceDetails;
+            masteringVoice->GetVoiceDetails(&voiceDetails);
+            sampleRate = voiceDetails.InputSampleRate;
+
             WAVEFORMATEX waveFormat;
             waveFormat.wFormatTag = WAVE_FORMAT_IEEE_FLOAT;
             waveFormat.nChannels = channels;
@@ -87,21 +105,13 @@ namespace ouzel
 
             if (apiMajorVersion == 2 && apiMinorVersion == 7)
             {
-                HRESULT hr = IXAudio2CreateMasteringVoice(xAudio, &masteringVoice);
-                if (FAILED(hr))
-                    throw SystemError("Failed to create XAudio2 mastering voice, error: " + std::to_string(hr));
-
-                hr = IXAudio2CreateSourceVoice(xAudio, &sourceVoice, &waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+                HRESULT hr = IXAudio2CreateSourceVoice(xAudio, &sourceVoice, &waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
                 if (FAILED(hr))
                     throw SystemError("Failed to create source voice, error: " + std::to_string(hr));
             }
             else
             {
-                HRESULT hr = xAudio->CreateMasteringVoice(&masteringVoice);
-                if (FAILED(hr))
-                    throw SystemError("Failed to create XAudio2 mastering voice, error: " + std::to_string(hr));
-
-                hr = xAudio->CreateSourceVoice(&sourceVoice, &waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
+                HRESULT hr = xAudio->CreateSourceVoice(&sourceVoice, &waveFormat, 0, XAUDIO2_DEFAULT_FREQ_RATIO, this);
                 if (FAILED(hr))
                     throw SystemError("Failed to create source voice, error: " + std::to_string(hr));
             }
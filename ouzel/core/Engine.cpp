@@ -8,6 +8,7 @@
 #include "utils/Log.hpp"
 #include "utils/Utils.hpp"
 #include "graphics/Renderer.hpp"
+#include "graphics/empty/RenderDeviceEmpty.hpp"
 #include "audio/Audio.hpp"
 
 #if OUZEL_COMPILE_OPENGL
@@ -16,23 +17,33 @@
 #    include "opengl/ColorVSGLES2.h"
 #    include "opengl/TexturePSGLES2.h"
 #    include "opengl/TextureVSGLES2.h"
+#    include "opengl/TextureInstancedVSGLES2.h"
+#    include "opengl/ParticleVSGLES2.h"
 #    include "opengl/ColorPSGLES3.h"
 #    include "opengl/ColorVSGLES3.h"
 #    include "opengl/TexturePSGLES3.h"
 #    include "opengl/TextureVSGLES3.h"
+#    include "opengl/TextureInstancedVSGLES3.h"
+#    include "opengl/ParticleVSGLES3.h"
 #  else
 #    include "opengl/ColorPSGL2.h"
 #    include "opengl/ColorVSGL2.h"
 #    include "opengl/TexturePSGL2.h"
 #    include "opengl/TextureVSGL2.h"
+#    include "opengl/TextureInstancedVSGL2.h"
+#    include "opengl/ParticleVSGL2.h"
 #    include "opengl/ColorPSGL3.h"
 #    include "opengl/ColorVSGL3.h"
 #    include "opengl/TexturePSGL3.h"
 #    include "opengl/TextureVSGL3.h"
+#    include "opengl/TextureInstancedVSGL3.h"
+#    include "opengl/ParticleVSGL3.h"
 #    include "opengl/ColorPSGL4.h"
 #    include "opengl/ColorVSGL4.h"
 #    include "opengl/TexturePSGL4.h"
 #    include "opengl/TextureVSGL4.h"
+#    include "opengl/TextureInstancedVSGL4.h"
+#    include "opengl/ParticleVSGL4.h"
 #  endif
 #endif
 
@@ -130,6 +141,9 @@ namespace ouzel
         bool verticalSync = true;
         bool depth = false;
         bool debugRenderer = false;
+        graphics::Renderer::FrameMode frameMode = graphics::Renderer::FrameMode::LATENCY;
+        uint32_t framesInFlight = 2;
+        bool softwareRasterizer = false; // rasterize the frames on the CPU if there is no render driver
         bool exclusiveFullscreen = false;
         bool highDpi = true; // should high DPI resolution be used
         audio::Driver audioDriver = audio::Driver::DEFAULT;
@@ -212,6 +226,28 @@ namespace ouzel
         std::string debugRendererValue = userEngineSection.getValue("debugRenderer", defaultEngineSection.getValue("debugRenderer"));
         if (!debugRendererValue.empty()) debugRenderer = (debugRendererValue == "true" || debugRendererValue == "1" || debugRendererValue == "yes");
 
+        std::string frameModeValue = userEngineSection.getValue("frameMode", defaultEngineSection.getValue("frameMode"));
+        if (!frameModeValue.empty())
+        {
+            if (frameModeValue == "latency")
+                frameMode = graphics::Renderer::FrameMode::LATENCY;
+            else if (frameModeValue == "throughput")
+                frameMode = graphics::Renderer::FrameMode::THROUGHPUT;
+            else
+                throw ConfigError("Invalid frame mode specified");
+        }
+
+        std::string framesInFlightValue = userEngineSection.getValue("framesInFlight", defaultEngineSection.getValue("framesInFlight"));
+        if (!framesInFlightValue.empty())
+        {
+            framesInFlight = static_cast<uint32_t>(std::stoul(framesInFlightValue));
+            if (framesInFlight < 1 || framesInFlight > graphics::Renderer::MAX_FRAMES_IN_FLIGHT)
+                throw ConfigError("Invalid frames in flight count specified");
+        }
+
+        std::string softwareRasterizerValue = userEngineSection.getValue("softwareRasterizer", defaultEngineSection.getValue("softwareRasterizer"));
+        if (!softwareRasterizerValue.empty()) softwareRasterizer = (softwareRasterizerValue == "true" || softwareRasterizerValue == "1" || softwareRasterizerValue == "yes");
+
         std::string highDpiValue = userEngineSection.getValue("highDpi", defaultEngineSection.getValue("highDpi"));
         if (!highDpiValue.empty()) highDpi = (highDpiValue == "true" || highDpiValue == "1" || highDpiValue == "yes");
 
@@ -275,6 +311,12 @@ namespace ouzel
                                               depth,
                                               debugRenderer));
 
+        renderer->setFrameMode(frameMode);
+        renderer->setMaxFramesInFlight(framesInFlight);
+
+        if (renderer->getDevice()->getDriver() == graphics::Driver::EMPTY)
+            static_cast<graphics::RenderDeviceEmpty*>(renderer->getDevice())->setRasterizationEnabled(softwareRasterizer);
+
         if (audioDriver == audio::Driver::DEFAULT)
         {
             auto availableDrivers = audio::Audio::getAvailableAudioDrivers();
@@ -300,107 +342,69 @@ namespace ouzel
         inputManager.reset(new input::InputManager());
 
         // default assets
+        std::vector<uint8_t> texturePixelShader;
+        std::vector<uint8_t> textureVertexShader;
+        std::vector<uint8_t> textureInstancedVertexShader;
+        std::vector<uint8_t> particleVertexShader;
+        std::vector<uint8_t> colorPixelShader;
+        std::vector<uint8_t> colorVertexShader;
+        uint32_t shaderDataAlignment = 0;
+        std::string pixelShaderFunction;
+        std::string vertexShaderFunction;
+
         switch (graphicsDriver)
         {
 #if OUZEL_COMPILE_OPENGL
             case graphics::Driver::OPENGL:
             {
-                std::shared_ptr<graphics::Shader> textureShader = std::make_shared<graphics::Shader>(*renderer);
-
-                switch (renderer->getDevice()->getAPIMajorVersion())
-                {
-#  if OUZEL_SUPPORTS_OPENGLES
-                    case 2:
-                        textureShader->init(std::vector<uint8_t>(std::begin(TexturePSGLES2_glsl), std::end(TexturePSGLES2_glsl)),
-                                            std::vector<uint8_t>(std::begin(TextureVSGLES2_glsl), std::end(TextureVSGLES2_glsl)),
-                                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-                        break;
-                    case 3:
-                        textureShader->init(std::vector<uint8_t>(std::begin(TexturePSGLES3_glsl), std::end(TexturePSGLES3_glsl)),
-                                            std::vector<uint8_t>(std::begin(TextureVSGLES3_glsl), std::end(TextureVSGLES3_glsl)),
-                                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-                        break;
-#  else
-                    case 2:
-                        textureShader->init(std::vector<uint8_t>(std::begin(TexturePSGL2_glsl), std::end(TexturePSGL2_glsl)),
-                                            std::vector<uint8_t>(std::begin(TextureVSGL2_glsl), std::end(TextureVSGL2_glsl)),
-                                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-                        break;
-                    case 3:
-                        textureShader->init(std::vector<uint8_t>(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl)),
-                                            std::vector<uint8_t>(std::begin(TextureVSGL3_glsl), std::end(TextureVSGL3_glsl)),
-                                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-                        break;
-                    case 4:
-                        textureShader->init(std::vector<uint8_t>(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl)),
-                                            std::vector<uint8_t>(std::begin(TextureVSGL4_glsl), std::end(TextureVSGL4_glsl)),
-                                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-                        break;
-#  endif
-                    default:
-                        throw SystemError("Unsupported OpenGL version");
-                }
-
-                assetBundle.setShader(SHADER_TEXTURE, textureShader);
-
-                std::shared_ptr<graphics::Shader> colorShader = std::make_shared<graphics::Shader>(*renderer);
-
                 switch (renderer->getDevice()->getAPIMajorVersion())
                 {
 #  if OUZEL_SUPPORTS_OPENGLES
                     case 2:
-                        colorShader->init(std::vector<uint8_t>(std::begin(ColorPSGLES2_glsl), std::end(ColorPSGLES2_glsl)),
-                                          std::vector<uint8_t>(std::begin(ColorVSGLES2_glsl), std::end(ColorVSGLES2_glsl)),
-                                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-
+                        texturePixelShader.assign(std::begin(TexturePSGLES2_glsl), std::end(TexturePSGLES2_glsl));
+                        textureVertexShader.assign(std::begin(TextureVSGLES2_glsl), std::end(TextureVSGLES2_glsl));
+                        textureInstancedVertexShader.assign(std::begin(TextureInstancedVSGLES2_glsl), std::end(TextureInstancedVSGLES2_glsl));
+                        particleVertexShader.assign(std::begin(ParticleVSGLES2_glsl), std::end(ParticleVSGLES2_glsl));
+                        colorPixelShader.assign(std::begin(ColorPSGLES2_glsl), std::end(ColorPSGLES2_glsl));
+                        colorVertexShader.assign(std::begin(ColorVSGLES2_glsl), std::end(ColorVSGLES2_glsl));
                         break;
                     case 3:
-                        colorShader->init(std::vector<uint8_t>(std::begin(ColorPSGLES3_glsl), std::end(ColorPSGLES3_glsl)),
-                                          std::vector<uint8_t>(std::begin(ColorVSGLES3_glsl), std::end(ColorVSGLES3_glsl)),
-                                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+                        texturePixelShader.assign(std::begin(TexturePSGLES3_glsl), std::end(TexturePSGLES3_glsl));
+                        textureVertexShader.assign(std::begin(TextureVSGLES3_glsl), std::end(TextureVSGLES3_glsl));
+                        textureInstancedVertexShader.assign(std::begin(TextureInstancedVSGLES3_glsl), std::end(TextureInstancedVSGLES3_glsl));
+                        particleVertexShader.assign(std::begin(ParticleVSGLES3_glsl), std::end(ParticleVSGLES3_glsl));
+                        colorPixelShader.assign(std::begin(ColorPSGLES3_glsl), std::end(ColorPSGLES3_glsl));
+                        colorVertexShader.assign(std::begin(ColorVSGLES3_glsl), std::end(ColorVSGLES3_glsl));
                         break;
 #  else
                     case 2:
-                        colorShader->init(std::vector<uint8_t>(std::begin(ColorPSGL2_glsl), std::end(ColorPSGL2_glsl)),
-                                          std::vector<uint8_t>(std::begin(ColorVSGL2_glsl), std::end(ColorVSGL2_glsl)),
-                                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+                        texturePixelShader.assign(std::begin(TexturePSGL2_glsl), std::end(TexturePSGL2_glsl));
+                        textureVertexShader.assign(std::begin(TextureVSGL2_glsl), std::end(TextureVSGL2_glsl));
+                        textureInstancedVertexShader.assign(std::begin(TextureInstancedVSGL2_glsl), std::end(TextureInstancedVSGL2_glsl));
+                        particleVertexShader.assign(std::begin(ParticleVSGL2_glsl), std::end(ParticleVSGL2_glsl));
+                        colorPixelShader.assign(std::begin(ColorPSGL2_glsl), std::end(ColorPSGL2_glsl));
+                        colorVertexShader.assign(std::begin(ColorVSGL2_glsl), std::end(ColorVSGL2_glsl));
                         break;
                     case 3:
-                        colorShader->init(std::vector<uint8_t>(std::begin(ColorPSGL3_glsl), std::end(ColorPSGL3_glsl)),
-                                          std::vector<uint8_t>(std::begin(ColorVSGL3_glsl), std::end(ColorVSGL3_glsl)),
-                                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+                        texturePixelShader.assign(std::begin(TexturePSGL3_glsl), std::end(TexturePSGL3_glsl));
+                        textureVertexShader.assign(std::begin(TextureVSGL3_glsl), std::end(TextureVSGL3_glsl));
+                        textureInstancedVertexShader.assign(std::begin(TextureInstancedVSGL3_glsl), std::end(TextureInstancedVSGL3_glsl));
+                        particleVertexShader.assign(std::begin(ParticleVSGL3_glsl), std::end(ParticleVSGL3_glsl));
+                        colorPixelShader.assign(std::begin(ColorPSGL3_glsl), std::end(ColorPSGL3_glsl));
+                        colorVertexShader.assign(std::begin(ColorVSGL3_glsl), std::end(ColorVSGL3_glsl));
                         break;
                     case 4:
-                        colorShader->init(std::vector<uint8_t>(std::begin(ColorPSGL4_glsl), std::end(ColorPSGL4_glsl)),
-                                          std::vector<uint8_t>(std::begin(ColorVSGL4_glsl), std::end(ColorVSGL4_glsl)),
-                                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+                        texturePixelShader.assign(std::begin(TexturePSGL4_glsl), std::end(TexturePSGL4_glsl));
+                        textureVertexShader.assign(std::begin(TextureVSGL4_glsl), std::end(TextureVSGL4_glsl));
+                        textureInstancedVertexShader.assign(std::begin(TextureInstancedVSGL4_glsl), std::end(TextureInstancedVSGL4_glsl));
+                        particleVertexShader.assign(std::begin(ParticleVSGL4_glsl), std::end(ParticleVSGL4_glsl));
+                        colorPixelShader.assign(std::begin(ColorPSGL4_glsl), std::end(ColorPSGL4_glsl));
+                        colorVertexShader.assign(std::begin(ColorVSGL4_glsl), std::end(ColorVSGL4_glsl));
                         break;
 #  endif
                     default:
                         throw SystemError("Unsupported OpenGL version");
                 }
-
-                assetBundle.setShader(SHADER_COLOR, colorShader);
                 break;
             }
 #endif
@@ -408,23 +412,10 @@ namespace ouzel
 #if OUZEL_COMPILE_DIRECT3D11
             case graphics::Driver::DIRECT3D11:
             {
-                std::shared_ptr<graphics::Shader> textureShader = std::make_shared<graphics::Shader>(*renderer);
-                textureShader->init(std::vector<uint8_t>(std::begin(TEXTURE_PIXEL_SHADER_D3D11), std::end(TEXTURE_PIXEL_SHADER_D3D11)),
-                                    std::vector<uint8_t>(std::begin(TEXTURE_VERTEX_SHADER_D3D11), std::end(TEXTURE_VERTEX_SHADER_D3D11)),
-                                    {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                    {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                    {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-
-                assetBundle.setShader(SHADER_TEXTURE, textureShader);
-
-                std::shared_ptr<graphics::Shader> colorShader = std::make_shared<graphics::Shader>(*renderer);
-                colorShader->init(std::vector<uint8_t>(std::begin(COLOR_PIXEL_SHADER_D3D11), std::end(COLOR_PIXEL_SHADER_D3D11)),
-                                  std::vector<uint8_t>(std::begin(COLOR_VERTEX_SHADER_D3D11), std::end(COLOR_VERTEX_SHADER_D3D11)),
-                                  {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                  {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                  {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
-
-                assetBundle.setShader(SHADER_COLOR, colorShader);
+                texturePixelShader.assign(std::begin(TEXTURE_PIXEL_SHADER_D3D11), std::end(TEXTURE_PIXEL_SHADER_D3D11));
+                textureVertexShader.assign(std::begin(TEXTURE_VERTEX_SHADER_D3D11), std::end(TEXTURE_VERTEX_SHADER_D3D11));
+                colorPixelShader.assign(std::begin(COLOR_PIXEL_SHADER_D3D11), std::end(COLOR_PIXEL_SHADER_D3D11));
+                colorVertexShader.assign(std::begin(COLOR_VERTEX_SHADER_D3D11), std::end(COLOR_VERTEX_SHADER_D3D11));
                 break;
             }
 #endif
@@ -432,56 +423,103 @@ namespace ouzel
 #if OUZEL_COMPILE_METAL
             case graphics::Driver::METAL:
             {
-                std::shared_ptr<graphics::Shader> textureShader = std::make_shared<graphics::Shader>(*renderer);
-                textureShader->init(std::vector<uint8_t>(std::begin(TEXTURE_PIXEL_SHADER_METAL), std::end(TEXTURE_PIXEL_SHADER_METAL)),
-                                    std::vector<uint8_t>(std::begin(TEXTURE_VERTEX_SHADER_METAL), std::end(TEXTURE_VERTEX_SHADER_METAL)),
-                                    {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                    {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                    {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
-                                    256, 256,
-                                    "mainPS", "mainVS");
-
-                assetBundle.setShader(SHADER_TEXTURE, textureShader);
-
-                std::shared_ptr<graphics::Shader> colorShader = std::make_shared<graphics::Shader>(*renderer);
-                colorShader->init(std::vector<uint8_t>(std::begin(COLOR_PIXEL_SHADER_METAL), std::end(COLOR_PIXEL_SHADER_METAL)),
-                                  std::vector<uint8_t>(std::begin(COLOR_VERTEX_SHADER_METAL), std::end(COLOR_VERTEX_SHADER_METAL)),
-                                  {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                  {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                  {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
-                                  256, 256,
-                                  "mainPS", "mainVS");
-
-                assetBundle.setShader(SHADER_COLOR, colorShader);
+                texturePixelShader.assign(std::begin(TEXTURE_PIXEL_SHADER_METAL), std::end(TEXTURE_PIXEL_SHADER_METAL));
+                textureVertexShader.assign(std::begin(TEXTURE_VERTEX_SHADER_METAL), std::end(TEXTURE_VERTEX_SHADER_METAL));
+                colorPixelShader.assign(std::begin(COLOR_PIXEL_SHADER_METAL), std::end(COLOR_PIXEL_SHADER_METAL));
+                colorVertexShader.assign(std::begin(COLOR_VERTEX_SHADER_METAL), std::end(COLOR_VERTEX_SHADER_METAL));
+                shaderDataAlignment = 256;
+                pixelShaderFunction = "mainPS";
+                vertexShaderFunction = "mainVS";
                 break;
             }
 #endif
 
             default:
-            {
-                std::shared_ptr<graphics::Shader> textureShader = std::make_shared<graphics::Shader>(*renderer);
-
-                textureShader->init(std::vector<uint8_t>(),
-                                    std::vector<uint8_t>(),
-                                    {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
-                                    {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                    {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+                break;
+        }
 
-                assetBundle.setShader(SHADER_TEXTURE, textureShader);
+        std::shared_ptr<graphics::Shader> textureShader = std::make_shared<graphics::Shader>(*renderer);
+        textureShader->init(texturePixelShader,
+                            textureVertexShader,
+                            {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0},
+                            {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                            {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
+                            shaderDataAlignment, shaderDataAlignment,
+                            pixelShaderFunction, vertexShaderFunction);
 
-                std::shared_ptr<graphics::Shader> colorShader = std::make_shared<graphics::Shader>(*renderer);
+        assetBundle.setShader(SHADER_TEXTURE, textureShader);
 
-                colorShader->init(std::vector<uint8_t>(),
-                                  std::vector<uint8_t>(),
-                                  {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
-                                  {{"color", graphics::DataType::FLOAT_VECTOR4}},
-                                  {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}});
+        // the empty render device does not need shader code
+        if (renderer->getDevice()->isInstancingSupported() &&
+            (!textureInstancedVertexShader.empty() || graphicsDriver == graphics::Driver::EMPTY))
+        {
+            std::shared_ptr<graphics::Shader> textureInstancedShader = std::make_shared<graphics::Shader>(*renderer);
+            textureInstancedShader->init(texturePixelShader,
+                                         textureInstancedVertexShader,
+                                         {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR, graphics::Vertex::Attribute::Usage::TEXTURE_COORDINATES0,
+                                          graphics::Vertex::Attribute::Usage::INSTANCE_TRANSFORM0, graphics::Vertex::Attribute::Usage::INSTANCE_TRANSFORM1,
+                                          graphics::Vertex::Attribute::Usage::INSTANCE_TRANSFORM2, graphics::Vertex::Attribute::Usage::INSTANCE_TRANSFORM3,
+                                          graphics::Vertex::Attribute::Usage::INSTANCE_COLOR, graphics::Vertex::Attribute::Usage::INSTANCE_TEXTURE_RECTANGLE},
+                                         {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                                         {{"viewProj", graphics::DataType::FLOAT_MATRIX4}},
+                                         shaderDataAlignment, shaderDataAlignment,
+                                         pixelShaderFunction, vertexShaderFunction);
+
+            assetBundle.setShader(SHADER_TEXTURE_INSTANCED, textureInstancedShader);
+            textureShader->setInstancedShader(textureInstancedShader);
+        }
 
-                assetBundle.setShader(SHADER_COLOR, colorShader);
-                break;
-            }
+        std::shared_ptr<graphics::Shader> colorShader = std::make_shared<graphics::Shader>(*renderer);
+        colorShader->init(colorPixelShader,
+                          colorVertexShader,
+                          {graphics::Vertex::Attribute::Usage::POSITION, graphics::Vertex::Attribute::Usage::COLOR},
+                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
+                          shaderDataAlignment, shaderDataAlignment,
+                          pixelShaderFunction, vertexShaderFunction);
+
+        assetBundle.setShader(SHADER_COLOR, colorShader);
+
+        // the same shaders reading the compact vertex layouts
+        std::shared_ptr<graphics::Shader> spriteShader = std::make_shared<graphics::Shader>(*renderer);
+        spriteShader->init(texturePixelShader,
+                           textureVertexShader,
+                           graphics::SpriteVertex::ATTRIBUTES,
+                           {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                           {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
+                           shaderDataAlignment, shaderDataAlignment,
+                           pixelShaderFunction, vertexShaderFunction);
+
+        assetBundle.setShader(SHADER_SPRITE, spriteShader);
+
+        // particles simulated by the vertex shader, the particle systems fall back to the CPU without it
+        if (!particleVertexShader.empty() || graphicsDriver == graphics::Driver::EMPTY)
+        {
+            std::shared_ptr<graphics::Shader> particleShader = std::make_shared<graphics::Shader>(*renderer);
+            particleShader->init(texturePixelShader,
+                                 particleVertexShader,
+                                 graphics::ParticleVertex::ATTRIBUTES,
+                                 {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                                 {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4},
+                                  {"parameters", graphics::DataType::FLOAT_VECTOR4},
+                                  {"gravity", graphics::DataType::FLOAT_VECTOR4}},
+                                 shaderDataAlignment, shaderDataAlignment,
+                                 pixelShaderFunction, vertexShaderFunction);
+
+            assetBundle.setShader(SHADER_PARTICLE, particleShader);
         }
 
+        std::shared_ptr<graphics::Shader> shapeShader = std::make_shared<graphics::Shader>(*renderer);
+        shapeShader->init(colorPixelShader,
+                          colorVertexShader,
+                          graphics::ShapeVertex::ATTRIBUTES,
+                          {{"color", graphics::DataType::FLOAT_VECTOR4}},
+                          {{"modelViewProj", graphics::DataType::FLOAT_MATRIX4}},
+                          shaderDataAlignment, shaderDataAlignment,
+                          pixelShaderFunction, vertexShaderFunction);
+
+        assetBundle.setShader(SHADER_SHAPE, shapeShader);
+
         std::shared_ptr<graphics::BlendState> noBlendState = std::make_shared<graphics::BlendState>(*renderer);
 
         noBlendState->init(false,
@@ -547,6 +585,7 @@ namespace ouzel
 
             active = true;
             paused = false;
+            previousUpdateTime = std::chrono::steady_clock::now();
 
 #if OUZEL_MULTITHREADED
             updateThread = std::thread(&Engine::main, this);
@@ -618,9 +657,33 @@ namespace ouzel
 
         if (diff > std::chrono::milliseconds(1)) // at least one millisecond has passed
         {
-            if (diff > std::chrono::seconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
-
             previousUpdateTime = currentTime;
+
+            fixedUpdateTime += std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
+
+            uint32_t fixedUpdateCount = static_cast<uint32_t>(fixedUpdateTime / fixedUpdateStep);
+            fixedUpdateTime -= fixedUpdateCount * fixedUpdateStep;
+
+            if (fixedUpdateCount > maxFixedUpdates)
+            {
+                droppedFixedUpdates += fixedUpdateCount - maxFixedUpdates;
+                fixedUpdateCount = maxFixedUpdates;
+            }
+
+            for (uint32_t i = 0; i < fixedUpdateCount; ++i)
+            {
+                sceneManager.beginFixedUpdate();
+
+                std::unique_ptr<UpdateEvent> fixedUpdateEvent(new UpdateEvent());
+                fixedUpdateEvent->type = Event::Type::FIXED_UPDATE;
+                fixedUpdateEvent->delta = fixedUpdateStep;
+                eventDispatcher.dispatchEvent(std::move(fixedUpdateEvent));
+            }
+
+            fixedUpdateAlpha = fixedUpdateTime / fixedUpdateStep;
+
+            if (diff > std::chrono::milliseconds(1000 / 20)) diff = std::chrono::milliseconds(1000 / 20); // limit the update rate to a minimum 20 FPS
+
             float delta = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
 
             std::unique_ptr<UpdateEvent> updateEvent(new UpdateEvent());
@@ -657,6 +720,9 @@ namespace ouzel
                     std::unique_lock<std::mutex> lock(updateMutex);
                     while (active && paused)
                         updateCondition.wait(lock);
+
+                    // the time spent paused is not simulated
+                    previousUpdateTime = std::chrono::steady_clock::now();
                 }
             }
 
@@ -670,6 +736,16 @@ namespace ouzel
         }
     }
 
+    void Engine::setFixedUpdateStep(float newFixedUpdateStep)
+    {
+        if (newFixedUpdateStep <= 0.0F)
+            throw ConfigError("Invalid fixed update step");
+
+        fixedUpdateStep = newFixedUpdateStep;
+        fixedUpdateTime = 0.0F;
+        fixedUpdateAlpha = 0.0F;
+    }
+
     void Engine::openURL(const std::string&)
     {
     }
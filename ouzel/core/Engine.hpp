@@ -12,6 +12,7 @@
 #include <vector>
 #include "core/Setup.h"
 #include "core/Application.hpp"
+#include "core/JobSystem.hpp"
 #include "core/Timer.hpp"
 #include "core/Window.hpp"
 #include "graphics/Renderer.hpp"
@@ -32,7 +33,11 @@ namespace ouzel
     std::unique_ptr<Application> main(const std::vector<std::string>& args);
 
     const std::string SHADER_TEXTURE = "shaderTexture";
+    const std::string SHADER_TEXTURE_INSTANCED = "shaderTextureInstanced";
     const std::string SHADER_COLOR = "shaderColor";
+    const std::string SHADER_SPRITE = "shaderSprite";
+    const std::string SHADER_PARTICLE = "shaderParticle";
+    const std::string SHADER_SHAPE = "shaderShape";
 
     const std::string BLEND_NO_BLEND = "blendNoBlend";
     const std::string BLEND_ADD = "blendAdd";
@@ -63,6 +68,7 @@ namespace ouzel
         inline void setLogThreshold(Log::Level newThreshold) { logThreshold = newThreshold; }
 
         inline FileSystem& getFileSystem() { return fileSystem; }
+        inline JobSystem& getJobSystem() { return jobSystem; }
         inline EventDispatcher& getEventDispatcher() { return eventDispatcher; }
         inline assets::Cache& getCache() { return cache; }
         inline Window* getWindow() { return window.get(); }
@@ -96,10 +102,24 @@ namespace ouzel
         bool isOneUpdatePerFrame() const { return oneUpdatePerFrame; }
         void setOneUpdatePerFrame(bool value) { oneUpdatePerFrame = value; }
 
+        // the delta of the fixed update events
+        float getFixedUpdateStep() const { return fixedUpdateStep; }
+        void setFixedUpdateStep(float newFixedUpdateStep);
+
+        // fixed updates over this count in one frame are dropped, so that slow frames do not need more and more updates
+        uint32_t getMaxFixedUpdates() const { return maxFixedUpdates; }
+        void setMaxFixedUpdates(uint32_t newMaxFixedUpdates) { maxFixedUpdates = newMaxFixedUpdates; }
+
+        // fraction of the fixed update step that has passed since the last fixed update, used to interpolate the rendered state
+        float getFixedUpdateAlpha() const { return fixedUpdateAlpha; }
+        // total number of fixed updates dropped because of the limit
+        uint64_t getDroppedFixedUpdates() const { return droppedFixedUpdates; }
+
     protected:
         virtual void main();
 
         std::atomic<Log::Level> logThreshold;
+        JobSystem jobSystem;
         FileSystem fileSystem;
         EventDispatcher eventDispatcher;
         std::unique_ptr<Window> window;
@@ -122,6 +142,12 @@ namespace ouzel
 #endif
         std::chrono::steady_clock::time_point previousUpdateTime;
 
+        float fixedUpdateStep = 1.0F / 60.0F;
+        uint32_t maxFixedUpdates = 5;
+        float fixedUpdateTime = 0.0F;
+        float fixedUpdateAlpha = 0.0F;
+        uint64_t droppedFixedUpdates = 0;
+
         std::atomic_bool active;
         std::atomic_bool paused;
         std::atomic_bool oneUpdatePerFrame;
@@ -0,0 +1,302 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "core/Setup.h"
+#include "JobSystem.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    static thread_local void* currentWorker = nullptr;
+
+    JobSystem::JobSystem():
+        queuedTaskCount(0)
+    {
+#if OUZEL_MULTITHREADED
+        // the thread that waits for the tasks works too
+        uint32_t cpuCount = std::thread::hardware_concurrency();
+        uint32_t workerCount = (cpuCount > 1) ? cpuCount - 1 : 0;
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            std::unique_ptr<Worker> worker(new Worker());
+            worker->jobSystem = this;
+            worker->index = i;
+            workers.push_back(std::move(worker));
+        }
+
+        // the workers can steal from each other only after all of them have been created
+        for (const std::unique_ptr<Worker>& worker : workers)
+            worker->thread = std::thread(&JobSystem::main, this, worker.get());
+#endif
+    }
+
+    JobSystem::~JobSystem()
+    {
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        running = false;
+        lock.unlock();
+        wakeCondition.notify_all();
+
+        for (const std::unique_ptr<Worker>& worker : workers)
+            worker->thread.join();
+    }
+
+    std::shared_ptr<JobSystem::Task> JobSystem::createTask(const std::function<void()>& function) const
+    {
+        return std::make_shared<Task>(function);
+    }
+
+    void JobSystem::addDependency(const std::shared_ptr<Task>& task, const std::shared_ptr<Task>& dependency) const
+    {
+        std::unique_lock<std::mutex> lock(dependency->mutex);
+
+        if (dependency->finished)
+        {
+            if (dependency->exception)
+            {
+                std::unique_lock<std::mutex> taskLock(task->mutex);
+                if (!task->exception) task->exception = dependency->exception;
+            }
+        }
+        else
+        {
+            ++task->pendingDependencies;
+            dependency->dependents.push_back(task);
+        }
+    }
+
+    void JobSystem::schedule(const std::shared_ptr<Task>& task)
+    {
+        if (--task->pendingDependencies == 0)
+            enqueue(task);
+    }
+
+    void JobSystem::wait(const std::shared_ptr<Task>& task)
+    {
+        Worker* worker = getCurrentWorker();
+
+        while (!task->finished)
+        {
+            std::shared_ptr<Task> queuedTask;
+
+            if (takeTask(worker, queuedTask))
+                execute(queuedTask);
+            else
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                while (!task->finished && !queuedTaskCount)
+                    wakeCondition.wait(lock);
+            }
+        }
+
+        if (task->exception) std::rethrow_exception(task->exception);
+    }
+
+    void JobSystem::run(const std::vector<std::function<void()>>& jobs)
+    {
+        if (jobs.empty()) return;
+
+        if (jobs.size() == 1)
+        {
+            jobs.front()();
+            return;
+        }
+
+        std::vector<std::shared_ptr<Task>> tasks;
+        tasks.reserve(jobs.size());
+
+        for (const std::function<void()>& job : jobs)
+        {
+            tasks.push_back(createTask(job));
+            schedule(tasks.back());
+        }
+
+        // the jobs can reference the caller's stack, so all of them must finish before throwing
+        std::exception_ptr exception;
+
+        for (const std::shared_ptr<Task>& task : tasks)
+        {
+            try
+            {
+                wait(task);
+            }
+            catch (...)
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+
+        if (exception) std::rethrow_exception(exception);
+    }
+
+    void JobSystem::parallelFor(size_t count, size_t minRangeSize, const std::function<void(size_t, size_t)>& function)
+    {
+        if (!count) return;
+        if (!minRangeSize) minRangeSize = 1;
+
+        // a few ranges per thread, so that the threads that finish early can steal the rest
+        size_t rangeCount = std::min((count + minRangeSize - 1) / minRangeSize,
+                                     static_cast<size_t>(workers.size() + 1) * 4);
+
+        if (rangeCount < 2 || workers.empty())
+        {
+            function(0, count);
+            return;
+        }
+
+        std::vector<std::function<void()>> jobs;
+        jobs.reserve(rangeCount);
+
+        for (size_t i = 0; i < rangeCount; ++i)
+        {
+            size_t begin = count * i / rangeCount;
+            size_t end = count * (i + 1) / rangeCount;
+            jobs.push_back([&function, begin, end]() { function(begin, end); });
+        }
+
+        run(jobs);
+    }
+
+    void JobSystem::main(Worker* worker)
+    {
+        currentWorker = worker;
+        setCurrentThreadName("Worker " + std::to_string(worker->index + 1));
+
+        for (;;)
+        {
+            std::shared_ptr<Task> task;
+
+            if (takeTask(worker, task))
+                execute(task);
+            else
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                while (running && !queuedTaskCount)
+                    wakeCondition.wait(lock);
+
+                if (!running) break;
+            }
+        }
+    }
+
+    JobSystem::Worker* JobSystem::getCurrentWorker() const
+    {
+        Worker* worker = static_cast<Worker*>(currentWorker);
+        return (worker && worker->jobSystem == this) ? worker : nullptr;
+    }
+
+    void JobSystem::enqueue(const std::shared_ptr<Task>& task)
+    {
+        // tasks queued by a worker are kept on its own queue, because they probably use the data it has just used
+        if (Worker* worker = getCurrentWorker())
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+            worker->tasks.push_back(task);
+        }
+        else
+        {
+            std::unique_lock<std::mutex> lock(sharedTaskMutex);
+            sharedTasks.push_back(task);
+        }
+
+        ++queuedTaskCount;
+
+        // sleeping threads check the queued task count with the wake mutex locked
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        lock.unlock();
+        wakeCondition.notify_all();
+    }
+
+    bool JobSystem::takeTask(Worker* worker, std::shared_ptr<Task>& task)
+    {
+        if (!queuedTaskCount) return false;
+
+        if (worker)
+        {
+            std::unique_lock<std::mutex> lock(worker->mutex);
+
+            if (!worker->tasks.empty())
+            {
+                task = std::move(worker->tasks.back());
+                worker->tasks.pop_back();
+                --queuedTaskCount;
+                return true;
+            }
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(sharedTaskMutex);
+
+            if (!sharedTasks.empty())
+            {
+                task = std::move(sharedTasks.front());
+                sharedTasks.pop_front();
+                --queuedTaskCount;
+                return true;
+            }
+        }
+
+        // steal the oldest task of another worker, starting from the next one to spread the thieves
+        uint32_t workerCount = static_cast<uint32_t>(workers.size());
+        uint32_t first = worker ? worker->index + 1 : 0;
+
+        for (uint32_t i = 0; i < workerCount; ++i)
+        {
+            Worker* victim = workers[(first + i) % workerCount].get();
+            if (victim == worker) continue;
+
+            std::unique_lock<std::mutex> lock(victim->mutex);
+
+            if (!victim->tasks.empty())
+            {
+                task = std::move(victim->tasks.front());
+                victim->tasks.pop_front();
+                --queuedTaskCount;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void JobSystem::execute(const std::shared_ptr<Task>& task)
+    {
+        // a task whose dependency has thrown is not run
+        if (!task->exception)
+        {
+            try
+            {
+                task->function();
+            }
+            catch (...)
+            {
+                task->exception = std::current_exception();
+            }
+        }
+
+        std::vector<std::shared_ptr<Task>> dependents;
+
+        std::unique_lock<std::mutex> taskLock(task->mutex);
+        task->finished = true;
+        dependents.swap(task->dependents);
+        taskLock.unlock();
+
+        for (const std::shared_ptr<Task>& dependent : dependents)
+        {
+            if (task->exception)
+            {
+                std::unique_lock<std::mutex> dependentLock(dependent->mutex);
+                if (!dependent->exception) dependent->exception = task->exception;
+            }
+
+            if (--dependent->pendingDependencies == 0)
+                enqueue(dependent);
+        }
+
+        // wake the threads that wait for the task
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        lock.unlock();
+        wakeCondition.notify_all();
+    }
+}
@@ -0,0 +1,106 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_CORE_JOBSYSTEM_HPP
+#define OUZEL_CORE_JOBSYSTEM_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ouzel
+{
+    // Runs tasks on a worker thread per core.
+    // Every worker has its own task queue and steals tasks from the other workers when its queue is empty.
+    // Threads that wait for a task run the queued tasks too, so tasks can wait for other tasks.
+    class JobSystem final
+    {
+    public:
+        class Task final
+        {
+            friend JobSystem;
+        public:
+            explicit Task(const std::function<void()>& initFunction):
+                function(initFunction), pendingDependencies(1), finished(false)
+            {
+            }
+
+            Task(const Task&) = delete;
+            Task& operator=(const Task&) = delete;
+
+            Task(Task&&) = delete;
+            Task& operator=(Task&&) = delete;
+
+            inline bool isFinished() const { return finished; }
+
+        private:
+            std::function<void()> function;
+            std::atomic<uint32_t> pendingDependencies; // one more than the unfinished dependencies until the task is scheduled
+            std::atomic_bool finished;
+            std::mutex mutex;
+            std::vector<std::shared_ptr<Task>> dependents;
+            std::exception_ptr exception;
+        };
+
+        JobSystem();
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        std::shared_ptr<Task> createTask(const std::function<void()>& function) const;
+        // the task does not start before the dependency has finished, must be called before the task is scheduled,
+        // if the dependency throws, the task is skipped and waiting for it rethrows the dependency's exception
+        void addDependency(const std::shared_ptr<Task>& task, const std::shared_ptr<Task>& dependency) const;
+        // queues the task after all of its dependencies have finished
+        void schedule(const std::shared_ptr<Task>& task);
+        // runs queued tasks until the task has finished and rethrows the exception thrown by the task
+        void wait(const std::shared_ptr<Task>& task);
+
+        // runs the jobs and returns after all of them have finished,
+        // the first exception thrown by a job is rethrown
+        void run(const std::vector<std::function<void()>>& jobs);
+        // splits [0, count) in ranges of at least minRangeSize elements and calls the function for them in parallel
+        void parallelFor(size_t count, size_t minRangeSize, const std::function<void(size_t, size_t)>& function);
+
+        inline uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+
+    private:
+        struct Worker final
+        {
+            JobSystem* jobSystem = nullptr;
+            uint32_t index = 0;
+            std::thread thread;
+            std::deque<std::shared_ptr<Task>> tasks; // the worker takes from the back, thieves from the front
+            std::mutex mutex;
+        };
+
+        void main(Worker* worker);
+        Worker* getCurrentWorker() const;
+        void enqueue(const std::shared_ptr<Task>& task);
+        bool takeTask(Worker* worker, std::shared_ptr<Task>& task);
+        void execute(const std::shared_ptr<Task>& task);
+
+        std::vector<std::unique_ptr<Worker>> workers;
+
+        // tasks queued by threads that are not workers
+        std::deque<std::shared_ptr<Task>> sharedTasks;
+        std::mutex sharedTaskMutex;
+
+        std::atomic<uint32_t> queuedTaskCount;
+        std::mutex wakeMutex;
+        std::condition_variable wakeCondition;
+        bool running = true;
+    };
+}
+
+#endif // OUZEL_CORE_JOBSYSTEM_HPP
@@ -198,4 +198,8 @@
 #  define OUZEL_SUPPORTS_SSE 1
 #endif
 
+#if defined(__SSE2__)
+#  define OUZEL_SUPPORTS_SSE2 1
+#endif
+
 #endif // OUZEL_PLATFORM_H
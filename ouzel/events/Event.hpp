@@ -85,6 +85,7 @@ namespace ouzel
             SOUND_FINISH,
 
             UPDATE,
+            FIXED_UPDATE, // dispatched with the fixed update step, zero or more times per frame
 
             USER // user defined event
         };
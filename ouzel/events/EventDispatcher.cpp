@@ -158,6 +158,10 @@ namespace ouzel
                         if (eventHandler->updateHandler)
                             handled = eventHandler->updateHandler(*static_cast<UpdateEvent*>(event.get()));
                         break;
+                    case Event::Type::FIXED_UPDATE:
+                        if (eventHandler->fixedUpdateHandler)
+                            handled = eventHandler->fixedUpdateHandler(*static_cast<UpdateEvent*>(event.get()));
+                        break;
                     case Event::Type::USER:
                         if (eventHandler->userHandler)
                             handled = eventHandler->userHandler(*static_cast<UserEvent*>(event.get()));
@@ -32,20 +32,20 @@ namespace ouzel
             colorMask(initColorMask),
             enableBlending(initEnableBlending)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new InitBlendStateCommand(resource,
-                                                                                   initEnableBlending,
-                                                                                   initColorBlendSource, initColorBlendDest,
-                                                                                   initColorOperation,
-                                                                                   initAlphaBlendSource, initAlphaBlendDest,
-                                                                                   initAlphaOperation,
-                                                                                   initColorMask)));
+            renderer.addCommand<InitBlendStateCommand>(resource,
+                                                       initEnableBlending,
+                                                       initColorBlendSource, initColorBlendDest,
+                                                       initColorOperation,
+                                                       initAlphaBlendSource, initAlphaBlendDest,
+                                                       initAlphaOperation,
+                                                       initColorMask);
         }
 
         BlendState::~BlendState()
         {
             if (resource)
             {
-                renderer.addCommand(std::unique_ptr<Command>(new DeleteResourceCommand(resource)));
+                renderer.addCommand<DeleteResourceCommand>(resource);
                 RenderDevice* renderDevice = renderer.getDevice();
                 renderDevice->deleteResourceId(resource);
             }
@@ -67,13 +67,13 @@ namespace ouzel
             alphaOperation = newAlphaOperation;
             colorMask = newColorMask;
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitBlendStateCommand(resource,
-                                                                                   newEnableBlending,
-                                                                                   newColorBlendSource, newColorBlendDest,
-                                                                                   newColorOperation,
-                                                                                   newAlphaBlendSource, newAlphaBlendDest,
-                                                                                   newAlphaOperation,
-                                                                                   newColorMask)));
+            renderer.addCommand<InitBlendStateCommand>(resource,
+                                                       newEnableBlending,
+                                                       newColorBlendSource, newColorBlendDest,
+                                                       newColorOperation,
+                                                       newAlphaBlendSource, newAlphaBlendDest,
+                                                       newAlphaOperation,
+                                                       newColorMask);
         }
     } // namespace graphics
 } // namespace ouzel
@@ -1,5 +1,6 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include "Buffer.hpp"
 #include "Renderer.hpp"
 #include "RenderDevice.hpp"
@@ -22,11 +23,11 @@ namespace ouzel
             flags(initFlags),
             size(initSize)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new InitBufferCommand(resource,
-                                                                               initUsage,
-                                                                               initFlags,
-                                                                               std::vector<uint8_t>(),
-                                                                               initSize)));
+            renderer.addCommand<InitBufferCommand>(resource,
+                                                   initUsage,
+                                                   initFlags,
+                                                   std::vector<uint8_t>(),
+                                                   initSize);
         }
 
         Buffer::Buffer(Renderer& initRenderer, Usage initUsage, uint32_t initFlags, const void* initData, uint32_t initSize):
@@ -36,12 +37,12 @@ namespace ouzel
             flags(initFlags),
             size(initSize)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new InitBufferCommand(resource,
-                                                                               initUsage,
-                                                                               initFlags,
-                                                                               std::vector<uint8_t>(static_cast<const uint8_t*>(initData),
-                                                                                                    static_cast<const uint8_t*>(initData) + initSize),
-                                                                               initSize)));
+            renderer.addCommand<InitBufferCommand>(resource,
+                                                   initUsage,
+                                                   initFlags,
+                                                   std::vector<uint8_t>(static_cast<const uint8_t*>(initData),
+                                                                        static_cast<const uint8_t*>(initData) + initSize),
+                                                   initSize);
         }
 
         Buffer::Buffer(Renderer& initRenderer, Usage initUsage, uint32_t initFlags, const std::vector<uint8_t>& initData, uint32_t initSize):
@@ -54,18 +55,18 @@ namespace ouzel
             if (!initData.empty() && initSize != initData.size())
                 throw DataError("Invalid buffer data");
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitBufferCommand(resource,
-                                                                               initUsage,
-                                                                               initFlags,
-                                                                               initData,
-                                                                               initSize)));
+            renderer.addCommand<InitBufferCommand>(resource,
+                                                   initUsage,
+                                                   initFlags,
+                                                   initData,
+                                                   initSize);
         }
 
         Buffer::~Buffer()
         {
             if (resource)
             {
-                renderer.addCommand(std::unique_ptr<Command>(new DeleteResourceCommand(resource)));
+                renderer.addCommand<DeleteResourceCommand>(resource);
                 RenderDevice* renderDevice = renderer.getDevice();
                 renderDevice->deleteResourceId(resource);
             }
@@ -77,11 +78,11 @@ namespace ouzel
             flags = newFlags;
             size = newSize;
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitBufferCommand(resource,
-                                                                               newUsage,
-                                                                               newFlags,
-                                                                               std::vector<uint8_t>(),
-                                                                               newSize)));
+            renderer.addCommand<InitBufferCommand>(resource,
+                                                   newUsage,
+                                                   newFlags,
+                                                   std::vector<uint8_t>(),
+                                                   newSize);
         }
 
         void Buffer::init(Usage newUsage, uint32_t newFlags, const void* newData, uint32_t newSize)
@@ -102,32 +103,37 @@ namespace ouzel
             flags = newFlags;
             size = newSize;
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitBufferCommand(resource,
-                                                                               newUsage,
-                                                                               newFlags,
-                                                                               newData,
-                                                                               newSize)));
+            renderer.addCommand<InitBufferCommand>(resource,
+                                                   newUsage,
+                                                   newFlags,
+                                                   newData,
+                                                   newSize);
         }
 
         void Buffer::setData(const void* newData, uint32_t newSize)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new SetBufferDataCommand(resource,
-                                                                                  std::vector<uint8_t>(static_cast<const uint8_t*>(newData),
-                                                                                                       static_cast<const uint8_t*>(newData) + newSize))));
+            void* data = map(newSize);
+            std::copy(static_cast<const uint8_t*>(newData),
+                      static_cast<const uint8_t*>(newData) + newSize,
+                      static_cast<uint8_t*>(data));
         }
 
         void Buffer::setData(const std::vector<uint8_t>& newData)
+        {
+            setData(newData.data(), static_cast<uint32_t>(newData.size()));
+        }
+
+        void* Buffer::map(uint32_t newSize)
         {
             if (!(flags & Buffer::DYNAMIC))
                 throw DataError("Buffer is not dynamic");
 
-            if (newData.empty())
+            if (!newSize)
                 throw DataError("Invalid buffer data");
 
-            if (newData.size() > size) size = static_cast<uint32_t>(newData.size());
+            if (newSize > size) size = newSize;
 
-            renderer.addCommand(std::unique_ptr<Command>(new SetBufferDataCommand(resource,
-                                                                                  newData)));
+            return renderer.mapBuffer(resource, newSize);
         }
     } // namespace graphics
 } // namespace ouzel
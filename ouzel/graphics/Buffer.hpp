@@ -46,6 +46,9 @@ namespace ouzel
             void setData(const void* newData, uint32_t newSize);
             void setData(const std::vector<uint8_t>& newData);
 
+            // returns memory for newSize bytes of new data, the data must be written before the next buffer is updated
+            void* map(uint32_t newSize);
+
             inline uintptr_t getResource() const { return resource; }
 
             inline Usage getUsage() const { return usage; }
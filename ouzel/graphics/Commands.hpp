@@ -3,8 +3,13 @@
 #ifndef OUZEL_GRAPHICS_COMMANDS_HPP
 #define OUZEL_GRAPHICS_COMMANDS_HPP
 
-#include <queue>
+#include <cstddef>
+#include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
 #include "graphics/DepthStencilState.hpp"
@@ -40,6 +45,7 @@ namespace ouzel
                 SET_DEPTH_STENCIL_STATE,
                 SET_PIPELINE_STATE,
                 DRAW,
+                DRAW_INSTANCED,
                 PUSH_DEBUG_MARKER,
                 POP_DEBUG_MARKER,
                 INIT_BLEND_STATE,
@@ -50,7 +56,8 @@ namespace ouzel
                 INIT_TEXTURE,
                 SET_TEXTURE_DATA,
                 SET_TEXTURE_PARAMETERS,
-                SET_TEXTURES
+                SET_TEXTURES,
+                EXECUTE_COMMANDS
             };
 
             explicit Command(Type initType):
@@ -58,8 +65,6 @@ namespace ouzel
             {
             }
 
-            virtual ~Command() {}
-
             const Type type;
         };
 
@@ -331,6 +336,39 @@ namespace ouzel
             uint32_t startIndex;
         };
 
+        class DrawInstancedCommand: public Command
+        {
+        public:
+            DrawInstancedCommand(uintptr_t initIndexBuffer,
+                                 uint32_t initIndexCount,
+                                 uint32_t initIndexSize,
+                                 uintptr_t initVertexBuffer,
+                                 uintptr_t initInstanceBuffer,
+                                 uint32_t initInstanceCount,
+                                 DrawMode initDrawMode,
+                                 uint32_t initStartIndex):
+                Command(Command::Type::DRAW_INSTANCED),
+                indexBuffer(initIndexBuffer),
+                indexCount(initIndexCount),
+                indexSize(initIndexSize),
+                vertexBuffer(initVertexBuffer),
+                instanceBuffer(initInstanceBuffer),
+                instanceCount(initInstanceCount),
+                drawMode(initDrawMode),
+                startIndex(initStartIndex)
+            {
+            }
+
+            uintptr_t indexBuffer;
+            uint32_t indexCount;
+            uint32_t indexSize;
+            uintptr_t vertexBuffer;
+            uintptr_t instanceBuffer; // buffer of graphics::Instance structures
+            uint32_t instanceCount;
+            DrawMode drawMode;
+            uint32_t startIndex;
+        };
+
         class PushDebugMarkerCommand: public Command
         {
         public:
@@ -414,15 +452,18 @@ namespace ouzel
         {
         public:
             SetBufferDataCommand(uintptr_t initBuffer,
-                                 const std::vector<uint8_t>& initData):
+                                 uint32_t initDataOffset,
+                                 uint32_t initDataSize):
                 Command(Command::Type::SET_BUFFER_DATA),
                 buffer(initBuffer),
-                data(initData)
+                dataOffset(initDataOffset),
+                dataSize(initDataSize)
             {
             }
 
             uintptr_t buffer;
-            std::vector<uint8_t> data;
+            uint32_t dataOffset; // offset in the command buffer's buffer data
+            uint32_t dataSize;
         };
 
         class InitShaderCommand: public Command
@@ -432,6 +473,7 @@ namespace ouzel
                               const std::vector<uint8_t>& initFragmentShader,
                               const std::vector<uint8_t>& initVertexShader,
                               const std::set<Vertex::Attribute::Usage>& initVertexAttributes,
+                              const std::vector<Vertex::Attribute>& initVertexLayout,
                               const std::vector<Shader::ConstantInfo>& initFragmentShaderConstantInfo,
                               const std::vector<Shader::ConstantInfo>& initVertexShaderConstantInfo,
                               uint32_t initFragmentShaderDataAlignment,
@@ -443,6 +485,7 @@ namespace ouzel
                 fragmentShader(initFragmentShader),
                 vertexShader(initVertexShader),
                 vertexAttributes(initVertexAttributes),
+                vertexLayout(initVertexLayout),
                 fragmentShaderConstantInfo(initFragmentShaderConstantInfo),
                 vertexShaderConstantInfo(initVertexShaderConstantInfo),
                 fragmentShaderDataAlignment(initFragmentShaderDataAlignment),
@@ -455,7 +498,8 @@ namespace ouzel
             uintptr_t shader;
             std::vector<uint8_t> fragmentShader;
             std::vector<uint8_t> vertexShader;
-            std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::set<Vertex::Attribute::Usage> vertexAttributes; // attributes used by the shader
+            std::vector<Vertex::Attribute> vertexLayout; // attributes of the vertex buffer
             std::vector<Shader::ConstantInfo> fragmentShaderConstantInfo;
             std::vector<Shader::ConstantInfo> vertexShaderConstantInfo;
             uint32_t fragmentShaderDataAlignment;
@@ -464,19 +508,27 @@ namespace ouzel
             std::string vertexShaderFunction;
         };
 
+        // constants are packed in the order of the shader's constant info,
+        // offsets and sizes are in floats and refer to the command buffer's shader constant data
         class SetShaderConstantsCommand: public Command
         {
         public:
-            SetShaderConstantsCommand(std::vector<std::vector<float>> initFragmentShaderConstants,
-                                      std::vector<std::vector<float>> initVertexShaderConstants):
+            SetShaderConstantsCommand(uint32_t initFragmentShaderConstantOffset,
+                                      uint32_t initFragmentShaderConstantSize,
+                                      uint32_t initVertexShaderConstantOffset,
+                                      uint32_t initVertexShaderConstantSize):
                 Command(Command::Type::SET_SHADER_CONSTANTS),
-                fragmentShaderConstants(initFragmentShaderConstants),
-                vertexShaderConstants(initVertexShaderConstants)
+                fragmentShaderConstantOffset(initFragmentShaderConstantOffset),
+                fragmentShaderConstantSize(initFragmentShaderConstantSize),
+                vertexShaderConstantOffset(initVertexShaderConstantOffset),
+                vertexShaderConstantSize(initVertexShaderConstantSize)
             {
             }
 
-            std::vector<std::vector<float>> fragmentShaderConstants;
-            std::vector<std::vector<float>> vertexShaderConstants;
+            uint32_t fragmentShaderConstantOffset;
+            uint32_t fragmentShaderConstantSize;
+            uint32_t vertexShaderConstantOffset;
+            uint32_t vertexShaderConstantSize;
         };
 
         class InitTextureCommand: public Command
@@ -555,11 +607,282 @@ namespace ouzel
             uintptr_t textures[Texture::LAYERS];
         };
 
+        // Commands are constructed in place in memory blocks owned by the command buffer,
+        // the blocks are kept after clear, so that a recycled command buffer does not allocate
         class CommandBuffer
         {
+            struct Record
+            {
+                Record* next;
+                Command* command;
+                void (*destroy)(Command*);
+            };
+
         public:
+            class ConstIterator
+            {
+            public:
+                explicit ConstIterator(const Record* initRecord): record(initRecord) {}
+
+                inline const Command* operator*() const { return record->command; }
+                inline ConstIterator& operator++() { record = record->next; return *this; }
+                inline bool operator==(const ConstIterator& other) const { return record == other.record; }
+                inline bool operator!=(const ConstIterator& other) const { return record != other.record; }
+
+            private:
+                const Record* record;
+            };
+
+            static const size_t BLOCK_SIZE = 64 * 1024;
+            static const size_t BUFFER_DATA_ALIGNMENT = 16;
+
+            CommandBuffer() {}
+            explicit CommandBuffer(const std::string& initName): name(initName) {}
+
+            ~CommandBuffer()
+            {
+                clear();
+            }
+
+            CommandBuffer(const CommandBuffer&) = delete;
+            CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+            CommandBuffer(CommandBuffer&& other):
+                name(std::move(other.name)),
+                blocks(std::move(other.blocks)),
+                blockIndex(other.blockIndex),
+                blockOffset(other.blockOffset),
+                shaderConstantData(std::move(other.shaderConstantData)),
+                bufferData(std::move(other.bufferData)),
+                first(other.first),
+                last(other.last),
+                count(other.count)
+            {
+                other.reset();
+            }
+
+            CommandBuffer& operator=(CommandBuffer&& other)
+            {
+                if (&other != this)
+                {
+                    clear();
+
+                    name = std::move(other.name);
+                    blocks = std::move(other.blocks);
+                    blockIndex = other.blockIndex;
+                    blockOffset = other.blockOffset;
+                    shaderConstantData = std::move(other.shaderConstantData);
+                    bufferData = std::move(other.bufferData);
+                    first = other.first;
+                    last = other.last;
+                    count = other.count;
+
+                    other.reset();
+                }
+
+                return *this;
+            }
+
+            template<class T, class ...Args>
+            T* pushCommand(Args&&... args)
+            {
+                static_assert(std::is_base_of<Command, T>::value, "T must be a command");
+
+                const size_t alignment = alignof(T) > alignof(Record) ? alignof(T) : alignof(Record);
+                const size_t recordSize = (sizeof(Record) + alignment - 1) & ~(alignment - 1);
+
+                uint8_t* memory = allocate(recordSize + sizeof(T), alignment);
+                T* command = new (memory + recordSize) T(std::forward<Args>(args)...);
+
+                Record* record = reinterpret_cast<Record*>(memory);
+                record->next = nullptr;
+                record->command = command;
+                record->destroy = std::is_trivially_destructible<T>::value ? nullptr : &destroyCommand<T>;
+
+                if (last)
+                    last->next = record;
+                else
+                    first = record;
+
+                last = record;
+                ++count;
+
+                return command;
+            }
+
+            // copies the constants to the shader constant data and returns their offset
+            uint32_t pushShaderConstants(const float* data, uint32_t size)
+            {
+                uint32_t offset = static_cast<uint32_t>(shaderConstantData.size());
+                shaderConstantData.insert(shaderConstantData.end(), data, data + size);
+                return offset;
+            }
+
+            inline const float* getShaderConstants(uint32_t offset) const
+            {
+                return shaderConstantData.data() + offset;
+            }
+
+            // reserves space for buffer data and returns its offset, the space is aligned to BUFFER_DATA_ALIGNMENT
+            uint32_t allocateBufferData(uint32_t size)
+            {
+                uint32_t offset = static_cast<uint32_t>((bufferData.size() + BUFFER_DATA_ALIGNMENT - 1) & ~(BUFFER_DATA_ALIGNMENT - 1));
+                bufferData.resize(offset + size);
+                return offset;
+            }
+
+            // the returned pointer is valid until the next call to allocateBufferData
+            inline uint8_t* getBufferData(uint32_t offset)
+            {
+                return bufferData.data() + offset;
+            }
+
+            inline const uint8_t* getBufferData(uint32_t offset) const
+            {
+                return bufferData.data() + offset;
+            }
+
+            // destroys all commands, but keeps the allocated memory
+            void clear()
+            {
+                for (Record* record = first; record; record = record->next)
+                    if (record->destroy) record->destroy(record->command);
+
+                shaderConstantData.clear();
+                bufferData.clear();
+
+                first = nullptr;
+                last = nullptr;
+                count = 0;
+                blockIndex = 0;
+                blockOffset = 0;
+            }
+
+            inline bool empty() const { return first == nullptr; }
+            inline size_t size() const { return count; }
+
+            inline ConstIterator begin() const { return ConstIterator(first); }
+            inline ConstIterator end() const { return ConstIterator(nullptr); }
+
             std::string name;
-            std::queue<std::unique_ptr<Command>> commands;
+
+        private:
+            struct Block
+            {
+                std::unique_ptr<uint8_t[]> data;
+                size_t size;
+            };
+
+            template<class T>
+            static void destroyCommand(Command* command)
+            {
+                static_cast<T*>(command)->~T();
+            }
+
+            void reset()
+            {
+                blocks.clear();
+                shaderConstantData.clear();
+                bufferData.clear();
+                blockIndex = 0;
+                blockOffset = 0;
+                first = nullptr;
+                last = nullptr;
+                count = 0;
+            }
+
+            uint8_t* allocate(size_t size, size_t alignment)
+            {
+                // the block data is allocated with new[], so it is aligned for any fundamental type
+                for (; blockIndex < blocks.size(); ++blockIndex, blockOffset = 0)
+                {
+                    size_t offset = (blockOffset + alignment - 1) & ~(alignment - 1);
+
+                    if (offset + size <= blocks[blockIndex].size)
+                    {
+                        blockOffset = offset + size;
+                        return blocks[blockIndex].data.get() + offset;
+                    }
+                }
+
+                Block block;
+                block.size = (size > BLOCK_SIZE) ? size : BLOCK_SIZE;
+                block.data.reset(new uint8_t[block.size]);
+                blocks.push_back(std::move(block));
+
+                blockIndex = blocks.size() - 1;
+                blockOffset = size;
+                return blocks[blockIndex].data.get();
+            }
+
+            std::vector<Block> blocks;
+            size_t blockIndex = 0;
+            size_t blockOffset = 0;
+            std::vector<float> shaderConstantData;
+            std::vector<uint8_t> bufferData;
+            Record* first = nullptr;
+            Record* last = nullptr;
+            size_t count = 0;
+        };
+
+        // runs the commands of a command buffer that was recorded separately, e.g. on another thread
+        class ExecuteCommandsCommand: public Command
+        {
+        public:
+            explicit ExecuteCommandsCommand(CommandBuffer&& initCommandBuffer):
+                Command(Command::Type::EXECUTE_COMMANDS),
+                commandBuffer(std::move(initCommandBuffer))
+            {
+            }
+
+            // mutable, so that the render device can recycle the command buffer after processing it
+            mutable CommandBuffer commandBuffer;
+        };
+
+        // Iterates the commands of a command buffer and the command buffers executed by it in recording order.
+        // Data offsets of a command refer to the command buffer returned by getCommandBuffer.
+        class CommandReader final
+        {
+        public:
+            explicit CommandReader(const CommandBuffer& initCommandBuffer):
+                commandBuffer(&initCommandBuffer),
+                iterator(initCommandBuffer.begin())
+            {
+            }
+
+            // returns nullptr after the last command
+            const Command* next()
+            {
+                for (;;)
+                {
+                    if (iterator == commandBuffer->end())
+                    {
+                        if (stack.empty()) return nullptr;
+
+                        commandBuffer = stack.back().first;
+                        iterator = stack.back().second;
+                        stack.pop_back();
+                        continue;
+                    }
+
+                    const Command* command = *iterator;
+                    ++iterator;
+
+                    if (command->type != Command::Type::EXECUTE_COMMANDS)
+                        return command;
+
+                    stack.push_back(std::make_pair(commandBuffer, iterator));
+                    commandBuffer = &static_cast<const ExecuteCommandsCommand*>(command)->commandBuffer;
+                    iterator = commandBuffer->begin();
+                }
+            }
+
+            inline const CommandBuffer& getCommandBuffer() const { return *commandBuffer; }
+
+        private:
+            const CommandBuffer* commandBuffer;
+            CommandBuffer::ConstIterator iterator;
+            std::vector<std::pair<const CommandBuffer*, CommandBuffer::ConstIterator>> stack;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -24,17 +24,17 @@ namespace ouzel
             depthWrite(initDepthWrite),
             compareFunction(initCompareFunction)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new InitDepthStencilStateCommand(resource,
-                                                                                          initDepthTest,
-                                                                                          initDepthWrite,
-                                                                                          initCompareFunction)));
+            renderer.addCommand<InitDepthStencilStateCommand>(resource,
+                                                              initDepthTest,
+                                                              initDepthWrite,
+                                                              initCompareFunction);
         }
 
         DepthStencilState::~DepthStencilState()
         {
             if (resource)
             {
-                renderer.addCommand(std::unique_ptr<Command>(new DeleteResourceCommand(resource)));
+                renderer.addCommand<DeleteResourceCommand>(resource);
                 RenderDevice* renderDevice = renderer.getDevice();
                 renderDevice->deleteResourceId(resource);
             }
@@ -48,10 +48,10 @@ namespace ouzel
             depthWrite = newDepthWrite;
             compareFunction = newCompareFunction;
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitDepthStencilStateCommand(resource,
-                                                                                          newDepthTest,
-                                                                                          newDepthWrite,
-                                                                                          newCompareFunction)));
+            renderer.addCommand<InitDepthStencilStateCommand>(resource,
+                                                              newDepthTest,
+                                                              newDepthWrite,
+                                                              newCompareFunction);
         }
     } // namespace graphics
 } // namespace ouzel
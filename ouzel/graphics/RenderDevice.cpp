@@ -13,8 +13,11 @@ namespace ouzel
             callback(initCallback),
             projectionTransform(Matrix4::identity()),
             renderTargetProjectionTransform(Matrix4::identity()),
+            drawCallCount(0),
             currentFPS(0.0F),
-            accumulatedFPS(0.0F)
+            accumulatedFPS(0.0F),
+            currentStallTime(std::chrono::steady_clock::duration::zero()),
+            stallTime(0.0F)
         {
         }
 
@@ -46,10 +49,6 @@ namespace ouzel
 
         void RenderDevice::process()
         {
-            Event event;
-            event.type = Event::Type::FRAME;
-            callback(event);
-
             std::chrono::steady_clock::time_point currentTime = std::chrono::steady_clock::now();
             auto diff = std::chrono::duration_cast<std::chrono::nanoseconds>(currentTime - previousFrameTime);
             previousFrameTime = currentTime;
@@ -70,6 +69,32 @@ namespace ouzel
             }
         }
 
+        CommandBuffer RenderDevice::waitForCommandBuffer()
+        {
+            std::unique_lock<std::mutex> lock(commandQueueMutex);
+
+            if (commandQueue.empty())
+            {
+                std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+                while (commandQueue.empty()) commandQueueCondition.wait(lock);
+                currentStallTime += std::chrono::steady_clock::now() - waitStartTime;
+            }
+
+            CommandBuffer commandBuffer = std::move(commandQueue.front());
+            commandQueue.pop();
+            return commandBuffer;
+        }
+
+        void RenderDevice::finishFrame()
+        {
+            stallTime = std::chrono::duration_cast<std::chrono::microseconds>(currentStallTime).count() / 1000000.0F;
+            currentStallTime = std::chrono::steady_clock::duration::zero();
+
+            Event event;
+            event.type = Event::Type::FRAME;
+            callback(event);
+        }
+
         void RenderDevice::setSize(const Size2& newSize)
         {
             size = newSize;
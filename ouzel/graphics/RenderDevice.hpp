@@ -4,8 +4,12 @@
 #define OUZEL_GRAPHICS_RENDERDEVICE_HPP
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
+#include <queue>
+#include <vector>
 #include "graphics/Commands.hpp"
 #include "graphics/Driver.hpp"
 #include "graphics/Texture.hpp"
@@ -36,7 +40,7 @@ namespace ouzel
             {
                 enum class Type
                 {
-                    FRAME
+                    FRAME // a frame was processed by the render thread
                 };
 
                 Type type;
@@ -69,6 +73,33 @@ namespace ouzel
                 commandQueueCondition.notify_all();
             }
 
+            // returns a command buffer that was already processed by the render thread (or a new one)
+            CommandBuffer getFreeCommandBuffer()
+            {
+                std::unique_lock<std::mutex> lock(commandQueueMutex);
+                if (freeCommandBuffers.empty()) return CommandBuffer();
+
+                CommandBuffer commandBuffer = std::move(freeCommandBuffers.back());
+                freeCommandBuffers.pop_back();
+                return commandBuffer;
+            }
+
+            // returns the command buffer to the free command buffers, so that its memory can be reused
+            void recycleCommandBuffer(CommandBuffer&& commandBuffer)
+            {
+                // keep the memory of the executed command buffers too
+                for (const Command* command : commandBuffer)
+                    if (command->type == Command::Type::EXECUTE_COMMANDS)
+                        recycleCommandBuffer(std::move(static_cast<const ExecuteCommandsCommand*>(command)->commandBuffer));
+
+                commandBuffer.clear();
+
+                std::unique_lock<std::mutex> lock(commandQueueMutex);
+                if (freeCommandBuffers.size() < MAX_FREE_COMMAND_BUFFERS)
+                    freeCommandBuffers.push_back(std::forward<CommandBuffer>(commandBuffer));
+            }
+
+            // number of draw calls in the last processed frame
             inline uint32_t getDrawCallCount() const { return drawCallCount; }
 
             inline uint16_t getAPIMajorVersion() const { return apiMajorVersion; }
@@ -78,6 +109,7 @@ namespace ouzel
             inline bool isMultisamplingSupported() const { return multisamplingSupported; }
             inline bool isAnisotropicFilteringSupported() const { return anisotropicFilteringSupported; }
             inline bool isRenderTargetsSupported() const { return renderTargetsSupported; }
+            inline bool isInstancingSupported() const { return instancingSupported; }
 
             const Matrix4& getProjectionTransform(bool renderTarget) const
             {
@@ -87,10 +119,16 @@ namespace ouzel
             inline float getFPS() const { return currentFPS; }
             inline float getAccumulatedFPS() const { return accumulatedFPS; }
 
+            // time in seconds the render thread spent waiting for commands during the last frame
+            inline float getStallTime() const { return stallTime; }
+
             void executeOnRenderThread(const std::function<void()>& func);
 
+            // resources can be created while the scene is recorded on worker threads
             uintptr_t getResourceId()
             {
+                std::unique_lock<std::mutex> lock(resourceIdMutex);
+
                 if (deletedResourceIds.empty())
                     return ++lastResourceId; // zero is reserved for null resource
                 else
@@ -103,6 +141,7 @@ namespace ouzel
 
             void deleteResourceId(uintptr_t resourceId)
             {
+                std::unique_lock<std::mutex> lock(resourceIdMutex);
                 deletedResourceIds.push(resourceId);
             }
 
@@ -120,6 +159,10 @@ namespace ouzel
                               bool newDebugRenderer);
 
             void executeAll();
+
+            CommandBuffer waitForCommandBuffer();
+            void finishFrame();
+
             virtual void setSize(const Size2& newSize);
 
             virtual void generateScreenshot(const std::string& filename);
@@ -144,6 +187,7 @@ namespace ouzel
             bool multisamplingSupported = true;
             bool anisotropicFilteringSupported = true;
             bool renderTargetsSupported = true;
+            bool instancingSupported = false;
 
             Matrix4 projectionTransform;
             Matrix4 renderTargetProjectionTransform;
@@ -154,9 +198,12 @@ namespace ouzel
             bool clearColorBuffer = true;
             bool clearDepthBuffer = false;
 
-            uint32_t drawCallCount = 0;
+            std::atomic<uint32_t> drawCallCount;
+
+            static const size_t MAX_FREE_COMMAND_BUFFERS = 16;
 
             std::queue<CommandBuffer> commandQueue;
+            std::vector<CommandBuffer> freeCommandBuffers;
             std::mutex commandQueueMutex;
             std::condition_variable commandQueueCondition;
 
@@ -167,9 +214,13 @@ namespace ouzel
             float currentAccumulatedFPS = 0.0F;
             std::atomic<float> accumulatedFPS;
 
+            std::chrono::steady_clock::duration currentStallTime;
+            std::atomic<float> stallTime;
+
             std::queue<std::function<void()>> executeQueue;
             std::mutex executeMutex;
 
+            std::mutex resourceIdMutex;
             uintptr_t lastResourceId = 0;
             std::queue<uintptr_t> deletedResourceIds;
         };
@@ -18,7 +18,7 @@ namespace ouzel
         {
             if (resource)
             {
-                renderer.addCommand(std::unique_ptr<Command>(new DeleteResourceCommand(resource)));
+                renderer.addCommand<DeleteResourceCommand>(resource);
                 RenderDevice* renderDevice = renderer.getDevice();
                 renderDevice->deleteResourceId(resource);
             }
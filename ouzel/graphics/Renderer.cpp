@@ -1,5 +1,8 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <cassert>
+#include <iterator>
 #include "core/Setup.h"
 #include "Renderer.hpp"
 #include "Commands.hpp"
@@ -43,6 +46,8 @@ namespace ouzel
 {
     namespace graphics
     {
+        thread_local std::vector<Renderer::Recording> Renderer::threadRecordings;
+
         std::set<Driver> Renderer::getAvailableRenderDrivers()
         {
             static std::set<Driver> availableDrivers;
@@ -77,8 +82,14 @@ namespace ouzel
                            bool newVerticalSync,
                            bool newDepth,
                            bool newDebugRenderer):
+            executedRecordedCommandCount(0),
+            executedElidedCommandCount(0),
+            framesInFlight(0),
+            stallTime(0.0F),
             refillQueue(true)
         {
+            frameRecording.commandBuffer = &commandBuffer;
+
             for (uint32_t i = 0; i < 256; ++i)
             {
                 GAMMA_ENCODE[i] = static_cast<uint8_t>(roundf(powf(i / 255.0F, 1.0F / GAMMA) * 255.0F));
@@ -150,8 +161,8 @@ namespace ouzel
             if (event.type == RenderDevice::Event::Type::FRAME)
             {
                 std::unique_lock<std::mutex> lock(frameMutex);
-                newFrame = true;
-                refillQueue = true;
+                if (framesInFlight > 0) --framesInFlight;
+                updateRefillQueue();
                 lock.unlock();
                 frameCondition.notify_all();
             }
@@ -161,44 +172,44 @@ namespace ouzel
         {
             clearColorBuffer = clear;
 
-            addCommand(std::unique_ptr<Command>(new SetRenderTargetParametersCommand(0,
-                                                                                     clearColorBuffer,
-                                                                                     clearDepthBuffer,
-                                                                                     clearColor,
-                                                                                     clearDepth)));
+            addCommand<SetRenderTargetParametersCommand>(0,
+                                                         clearColorBuffer,
+                                                         clearDepthBuffer,
+                                                         clearColor,
+                                                         clearDepth);
         }
 
         void Renderer::setClearDepthBuffer(bool clear)
         {
             clearDepthBuffer = clear;
 
-            addCommand(std::unique_ptr<Command>(new SetRenderTargetParametersCommand(0,
-                                                                                     clearColorBuffer,
-                                                                                     clearDepthBuffer,
-                                                                                     clearColor,
-                                                                                     clearDepth)));
+            addCommand<SetRenderTargetParametersCommand>(0,
+                                                         clearColorBuffer,
+                                                         clearDepthBuffer,
+                                                         clearColor,
+                                                         clearDepth);
         }
 
         void Renderer::setClearColor(Color color)
         {
             clearColor = color;
 
-            addCommand(std::unique_ptr<Command>(new SetRenderTargetParametersCommand(0,
-                                                                                     clearColorBuffer,
-                                                                                     clearDepthBuffer,
-                                                                                     clearColor,
-                                                                                     clearDepth)));
+            addCommand<SetRenderTargetParametersCommand>(0,
+                                                         clearColorBuffer,
+                                                         clearDepthBuffer,
+                                                         clearColor,
+                                                         clearDepth);
         }
 
         void Renderer::setClearDepth(float newClearDepth)
         {
             clearDepth = newClearDepth;
 
-            addCommand(std::unique_ptr<Command>(new SetRenderTargetParametersCommand(0,
-                                                                                     clearColorBuffer,
-                                                                                     clearDepthBuffer,
-                                                                                     clearColor,
-                                                                                     clearDepth)));
+            addCommand<SetRenderTargetParametersCommand>(0,
+                                                         clearColorBuffer,
+                                                         clearDepthBuffer,
+                                                         clearColor,
+                                                         clearDepth);
         }
 
         void Renderer::setSize(const Size2& newSize)
@@ -215,43 +226,120 @@ namespace ouzel
 
         void Renderer::setRenderTarget(uintptr_t renderTarget)
         {
-            addCommand(std::unique_ptr<Command>(new SetRenderTargetCommand(renderTarget)));
+            addCommand<SetRenderTargetCommand>(renderTarget);
         }
 
         void Renderer::clearRenderTarget(uintptr_t renderTarget)
         {
-            addCommand(std::unique_ptr<Command>(new ClearRenderTargetCommand(renderTarget)));
+            addCommand<ClearRenderTargetCommand>(renderTarget);
         }
 
         void Renderer::setCullMode(CullMode cullMode)
         {
-            addCommand(std::unique_ptr<Command>(new SetCullModeCommad(cullMode)));
+            Recording& recording = getRecording();
+
+            if (recording.recordedState.cullModeValid &&
+                recording.recordedState.cullMode == cullMode)
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetCullModeCommad>(cullMode);
+
+            recording.recordedState.cullModeValid = true;
+            recording.recordedState.cullMode = cullMode;
         }
 
         void Renderer::setFillMode(FillMode fillMode)
         {
-            addCommand(std::unique_ptr<Command>(new SetFillModeCommad(fillMode)));
+            Recording& recording = getRecording();
+
+            if (recording.recordedState.fillModeValid &&
+                recording.recordedState.fillMode == fillMode)
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetFillModeCommad>(fillMode);
+
+            recording.recordedState.fillModeValid = true;
+            recording.recordedState.fillMode = fillMode;
         }
 
         void Renderer::setScissorTest(bool enabled, const Rect& rectangle)
         {
-            addCommand(std::unique_ptr<Command>(new SetScissorTestCommand(enabled, rectangle)));
+            Recording& recording = getRecording();
+
+            // the rectangle does not matter while the scissor test is disabled
+            if (recording.recordedState.scissorTestValid &&
+                recording.recordedState.scissorTestEnabled == enabled &&
+                (!enabled || recording.recordedState.scissorRectangle == rectangle))
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetScissorTestCommand>(enabled, rectangle);
+
+            recording.recordedState.scissorTestValid = true;
+            recording.recordedState.scissorTestEnabled = enabled;
+            recording.recordedState.scissorRectangle = rectangle;
         }
 
         void Renderer::setViewport(const Rect& viewport)
         {
-            addCommand(std::unique_ptr<Command>(new SetViewportCommand(viewport)));
+            Recording& recording = getRecording();
+
+            if (recording.recordedState.viewportValid &&
+                recording.recordedState.viewport == viewport)
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetViewportCommand>(viewport);
+
+            recording.recordedState.viewportValid = true;
+            recording.recordedState.viewport = viewport;
         }
 
         void Renderer::setDepthStencilState(uintptr_t depthStencilState)
         {
-            addCommand(std::unique_ptr<Command>(new SetDepthStencilStateCommand(depthStencilState)));
+            Recording& recording = getRecording();
+
+            if (recording.recordedState.depthStencilStateValid &&
+                recording.recordedState.depthStencilState == depthStencilState)
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetDepthStencilStateCommand>(depthStencilState);
+
+            recording.recordedState.depthStencilStateValid = true;
+            recording.recordedState.depthStencilState = depthStencilState;
         }
 
         void Renderer::setPipelineState(uintptr_t blendState,
                                         uintptr_t shader)
         {
-            addCommand(std::unique_ptr<Command>(new SetPipelineStateCommand(blendState, shader)));
+            Recording& recording = getRecording();
+
+            if (recording.recordedState.pipelineStateValid &&
+                recording.recordedState.blendState == blendState &&
+                recording.recordedState.shader == shader)
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
+
+            addCommand<SetPipelineStateCommand>(blendState, shader);
+
+            recording.recordedState.pipelineStateValid = true;
+            recording.recordedState.blendState = blendState;
+            recording.recordedState.shader = shader;
         }
 
         void Renderer::draw(uintptr_t indexBuffer,
@@ -264,59 +352,211 @@ namespace ouzel
             if (!indexBuffer || !vertexBuffer)
                 throw DataError("Invalid mesh buffer passed to render queue");
 
-            addCommand(std::unique_ptr<Command>(new DrawCommand(indexBuffer,
-                                                                indexCount,
-                                                                indexSize,
-                                                                vertexBuffer,
-                                                                drawMode,
-                                                                startIndex)));
+            addCommand<DrawCommand>(indexBuffer,
+                                    indexCount,
+                                    indexSize,
+                                    vertexBuffer,
+                                    drawMode,
+                                    startIndex);
+        }
+
+        void Renderer::drawInstanced(uintptr_t indexBuffer,
+                                     uint32_t indexCount,
+                                     uint32_t indexSize,
+                                     uintptr_t vertexBuffer,
+                                     uintptr_t instanceBuffer,
+                                     uint32_t instanceCount,
+                                     DrawMode drawMode,
+                                     uint32_t startIndex)
+        {
+            if (!indexBuffer || !vertexBuffer || !instanceBuffer)
+                throw DataError("Invalid mesh buffer passed to render queue");
+
+            if (!instanceCount) return;
+
+            addCommand<DrawInstancedCommand>(indexBuffer,
+                                             indexCount,
+                                             indexSize,
+                                             vertexBuffer,
+                                             instanceBuffer,
+                                             instanceCount,
+                                             drawMode,
+                                             startIndex);
         }
 
         void Renderer::pushDebugMarker(const std::string& name)
         {
-            addCommand(std::unique_ptr<Command>(new PushDebugMarkerCommand(name)));
+            addCommand<PushDebugMarkerCommand>(name);
         }
 
         void Renderer::popDebugMarker()
         {
-            addCommand(std::unique_ptr<Command>(new PopDebugMarkerCommand()));
+            addCommand<PopDebugMarkerCommand>();
         }
 
-        void Renderer::setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                          std::vector<std::vector<float>> vertexShaderConstants)
+        void Renderer::setShaderConstants(const float* fragmentShaderConstants,
+                                          uint32_t fragmentShaderConstantSize,
+                                          const float* vertexShaderConstants,
+                                          uint32_t vertexShaderConstantSize)
         {
-            addCommand(std::unique_ptr<Command>(new SetShaderConstantsCommand(fragmentShaderConstants,
-                                                                              vertexShaderConstants)));
+            CommandBuffer& commandBuffer = *getRecording().commandBuffer;
+            uint32_t fragmentShaderConstantOffset = commandBuffer.pushShaderConstants(fragmentShaderConstants,
+                                                                                      fragmentShaderConstantSize);
+            uint32_t vertexShaderConstantOffset = commandBuffer.pushShaderConstants(vertexShaderConstants,
+                                                                                    vertexShaderConstantSize);
+
+            addCommand<SetShaderConstantsCommand>(fragmentShaderConstantOffset,
+                                                  fragmentShaderConstantSize,
+                                                  vertexShaderConstantOffset,
+                                                  vertexShaderConstantSize);
+        }
+
+        void* Renderer::mapBuffer(uintptr_t buffer, uint32_t size)
+        {
+            CommandBuffer& commandBuffer = *getRecording().commandBuffer;
+            uint32_t dataOffset = commandBuffer.allocateBufferData(size);
+            addCommand<SetBufferDataCommand>(buffer, dataOffset, size);
+            return commandBuffer.getBufferData(dataOffset);
         }
 
         void Renderer::setTextures(const std::vector<uintptr_t>& textures)
         {
+            setTextures(textures.data(), static_cast<uint32_t>(textures.size()));
+        }
+
+        void Renderer::setTextures(const uintptr_t* textures, uint32_t textureCount)
+        {
+            Recording& recording = getRecording();
+
             uintptr_t newTextures[Texture::LAYERS];
 
             for (uint32_t i = 0; i < Texture::LAYERS; ++i)
-                newTextures[i] = (i < textures.size()) ? textures[i] : 0;
+                newTextures[i] = (i < textureCount) ? textures[i] : 0;
+
+            if (recording.recordedState.texturesValid &&
+                std::equal(std::begin(newTextures), std::end(newTextures), std::begin(recording.recordedState.textures)))
+            {
+                ++recording.elidedCommandCount;
+                return;
+            }
 
-            addCommand(std::unique_ptr<Command>(new SetTexturesCommand(newTextures)));
+            addCommand<SetTexturesCommand>(newTextures);
+
+            recording.recordedState.texturesValid = true;
+            std::copy(std::begin(newTextures), std::end(newTextures), std::begin(recording.recordedState.textures));
         }
 
         void Renderer::present()
         {
-            refillQueue = false;
-            addCommand(std::unique_ptr<Command>(new PresentCommand()));
+            std::unique_lock<std::mutex> lock(frameMutex);
+            ++framesInFlight;
+            updateRefillQueue();
+            lock.unlock();
+
+            addCommand<PresentCommand>();
             device->submitCommandBuffer(std::move(commandBuffer));
-            commandBuffer = CommandBuffer();
+            commandBuffer = device->getFreeCommandBuffer();
+
+            lastRecordedCommandCount = frameRecording.recordedCommandCount + executedRecordedCommandCount.exchange(0);
+            lastElidedCommandCount = frameRecording.elidedCommandCount + executedElidedCommandCount.exchange(0);
+            frameRecording.recordedCommandCount = 0;
+            frameRecording.elidedCommandCount = 0;
+        }
+
+        void Renderer::beginRecording(CommandBuffer& newCommandBuffer)
+        {
+            // the outer recording continues with its own state after the nested one has ended
+            threadRecordings.push_back(Recording());
+            threadRecordings.back().commandBuffer = &newCommandBuffer;
+        }
+
+        void Renderer::endRecording()
+        {
+            assert(!threadRecordings.empty());
+
+            executedRecordedCommandCount += threadRecordings.back().recordedCommandCount;
+            executedElidedCommandCount += threadRecordings.back().elidedCommandCount;
+            threadRecordings.pop_back();
+        }
+
+        void Renderer::executeCommands(CommandBuffer&& executedCommandBuffer)
+        {
+            if (executedCommandBuffer.empty())
+                device->recycleCommandBuffer(std::move(executedCommandBuffer));
+            else
+                addCommand<ExecuteCommandsCommand>(std::move(executedCommandBuffer));
+        }
+
+        void Renderer::invalidateState(RecordedState& recordedState, Command::Type commandType)
+        {
+            switch (commandType)
+            {
+                // render devices may start a new render pass or re-derive state from the bound render target,
+                // the state left by executed command buffers is not known
+                case Command::Type::PRESENT:
+                case Command::Type::SET_RENDER_TARGET:
+                case Command::Type::CLEAR_RENDER_TARGET:
+                case Command::Type::COMPUTE:
+                case Command::Type::EXECUTE_COMMANDS:
+                    recordedState = RecordedState();
+                    break;
+
+                // resource ids can be reused and resources can be recreated, so bound objects are not known anymore
+                case Command::Type::DELETE_RESOURCE:
+                case Command::Type::INIT_RENDER_TARGET:
+                case Command::Type::INIT_DEPTH_STENCIL_STATE:
+                case Command::Type::INIT_BLEND_STATE:
+                case Command::Type::INIT_SHADER:
+                case Command::Type::INIT_TEXTURE:
+                case Command::Type::SET_TEXTURE_DATA:
+                case Command::Type::SET_TEXTURE_PARAMETERS:
+                    recordedState.depthStencilStateValid = false;
+                    recordedState.pipelineStateValid = false;
+                    recordedState.texturesValid = false;
+                    break;
+
+                default:
+                    break;
+            }
         }
 
-        void Renderer::addCommand(std::unique_ptr<Command>&& command)
+        void Renderer::setFrameMode(FrameMode newFrameMode)
         {
-            commandBuffer.commands.push(std::forward<std::unique_ptr<Command>>(command));
+            std::unique_lock<std::mutex> lock(frameMutex);
+            frameMode = newFrameMode;
+            updateRefillQueue();
+            lock.unlock();
+            frameCondition.notify_all();
+        }
+
+        void Renderer::setMaxFramesInFlight(uint32_t newMaxFramesInFlight)
+        {
+            if (newMaxFramesInFlight < 1 || newMaxFramesInFlight > MAX_FRAMES_IN_FLIGHT)
+                throw DataError("Invalid frames in flight count");
+
+            std::unique_lock<std::mutex> lock(frameMutex);
+            maxFramesInFlight = newMaxFramesInFlight;
+            updateRefillQueue();
+            lock.unlock();
+            frameCondition.notify_all();
+        }
+
+        void Renderer::updateRefillQueue()
+        {
+            uint32_t frameLimit = (frameMode == FrameMode::LATENCY) ? 1 : maxFramesInFlight;
+            refillQueue = framesInFlight < frameLimit;
         }
 
         void Renderer::waitForNextFrame()
         {
+            std::chrono::steady_clock::time_point waitStartTime = std::chrono::steady_clock::now();
+
             std::unique_lock<std::mutex> lock(frameMutex);
-            while (!newFrame) frameCondition.wait(lock);
-            newFrame = false;
+            while (!refillQueue) frameCondition.wait(lock);
+            lock.unlock();
+
+            auto diff = std::chrono::steady_clock::now() - waitStartTime;
+            stallTime = std::chrono::duration_cast<std::chrono::microseconds>(diff).count() / 1000000.0F;
         }
     } // namespace graphics
 } // namespace ouzel
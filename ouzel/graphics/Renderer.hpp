@@ -27,6 +27,14 @@ namespace ouzel
         {
             friend Window;
         public:
+            enum class FrameMode
+            {
+                LATENCY, // the game thread records the next frame only after the previous one was processed
+                THROUGHPUT // the game thread can record up to the max frames in flight ahead of the render thread
+            };
+
+            static const uint32_t MAX_FRAMES_IN_FLIGHT = 3;
+
             Renderer(Driver driver,
                      Window* newWindow,
                      const Size2& newSize,
@@ -78,13 +86,63 @@ namespace ouzel
                       uintptr_t vertexBuffer,
                       DrawMode drawMode,
                       uint32_t startIndex);
+            // draws the mesh once for every graphics::Instance in the instance buffer,
+            // the shader has to read the instance attributes, see RenderDevice::isInstancingSupported
+            void drawInstanced(uintptr_t indexBuffer,
+                               uint32_t indexCount,
+                               uint32_t indexSize,
+                               uintptr_t vertexBuffer,
+                               uintptr_t instanceBuffer,
+                               uint32_t instanceCount,
+                               DrawMode drawMode,
+                               uint32_t startIndex);
             void pushDebugMarker(const std::string& name);
             void popDebugMarker();
-            void setShaderConstants(std::vector<std::vector<float>> fragmentShaderConstants,
-                                    std::vector<std::vector<float>> vertexShaderConstants);
+            // constants must be packed in the order of the shader's constant info, sizes are in floats
+            void setShaderConstants(const float* fragmentShaderConstants,
+                                    uint32_t fragmentShaderConstantSize,
+                                    const float* vertexShaderConstants,
+                                    uint32_t vertexShaderConstantSize);
             void setTextures(const std::vector<uintptr_t>& textures);
+            void setTextures(const uintptr_t* textures, uint32_t textureCount);
+            // records a buffer data update and returns the memory the caller has to write the data to,
+            // the memory is valid until the next buffer data update is recorded
+            void* mapBuffer(uintptr_t buffer, uint32_t size);
             void present();
-            void addCommand(std::unique_ptr<Command>&& command);
+
+            // records the commands of the calling thread to the command buffer until endRecording is called,
+            // this lets worker threads record parts of the frame in parallel,
+            // recordings can be nested, because a thread that waits for a job can run another recording job
+            void beginRecording(CommandBuffer& newCommandBuffer);
+            void endRecording();
+            // records a command that runs the commands of a separately recorded command buffer
+            void executeCommands(CommandBuffer&& executedCommandBuffer);
+            inline CommandBuffer getCommandBuffer() { return device->getFreeCommandBuffer(); }
+
+            template<class T, class ...Args>
+            void addCommand(Args&&... args)
+            {
+                Recording& recording = getRecording();
+                T* command = recording.commandBuffer->pushCommand<T>(std::forward<Args>(args)...);
+                ++recording.recordedCommandCount;
+                invalidateState(recording.recordedState, command->type);
+            }
+
+            // command counts of the last presented frame
+            inline uint32_t getRecordedCommandCount() const { return lastRecordedCommandCount; }
+            inline uint32_t getElidedCommandCount() const { return lastElidedCommandCount; }
+
+            inline FrameMode getFrameMode() const { return frameMode; }
+            void setFrameMode(FrameMode newFrameMode);
+
+            inline uint32_t getMaxFramesInFlight() const { return maxFramesInFlight; }
+            void setMaxFramesInFlight(uint32_t newMaxFramesInFlight);
+
+            // number of presented frames that were not processed by the render thread yet
+            inline uint32_t getFramesInFlight() const { return framesInFlight; }
+
+            // time in seconds the game thread spent waiting for the render thread during the last frame
+            inline float getStallTime() const { return stallTime; }
 
             void waitForNextFrame();
             inline bool getRefillQueue() const { return refillQueue; }
@@ -104,6 +162,9 @@ namespace ouzel
         private:
             void handleEvent(const RenderDevice::Event& event);
             void setSize(const Size2& newSize);
+            struct RecordedState;
+            void invalidateState(RecordedState& recordedState, Command::Type commandType);
+            void updateRefillQueue();
 
             std::unique_ptr<RenderDevice> device;
 
@@ -114,7 +175,49 @@ namespace ouzel
             bool clearDepthBuffer = false;
             CommandBuffer commandBuffer;
 
-            bool newFrame = false;
+            // state recorded to the command buffer, used to drop state changes that would not change anything
+            struct RecordedState final
+            {
+                bool cullModeValid = false;
+                CullMode cullMode = CullMode::NONE;
+                bool fillModeValid = false;
+                FillMode fillMode = FillMode::SOLID;
+                bool scissorTestValid = false;
+                bool scissorTestEnabled = false;
+                Rect scissorRectangle;
+                bool viewportValid = false;
+                Rect viewport;
+                bool depthStencilStateValid = false;
+                uintptr_t depthStencilState = 0;
+                bool pipelineStateValid = false;
+                uintptr_t blendState = 0;
+                uintptr_t shader = 0;
+                bool texturesValid = false;
+                uintptr_t textures[Texture::LAYERS] = {};
+            };
+
+            struct Recording final
+            {
+                CommandBuffer* commandBuffer = nullptr;
+                RecordedState recordedState;
+                uint32_t recordedCommandCount = 0;
+                uint32_t elidedCommandCount = 0;
+            };
+
+            // commands are recorded to the frame's command buffer, unless the thread has started its own recording
+            inline Recording& getRecording() { return threadRecordings.empty() ? frameRecording : threadRecordings.back(); }
+
+            Recording frameRecording;
+            static thread_local std::vector<Recording> threadRecordings;
+            std::atomic<uint32_t> executedRecordedCommandCount;
+            std::atomic<uint32_t> executedElidedCommandCount;
+            uint32_t lastRecordedCommandCount = 0;
+            uint32_t lastElidedCommandCount = 0;
+
+            FrameMode frameMode = FrameMode::LATENCY;
+            uint32_t maxFramesInFlight = 2; // used in throughput mode
+            std::atomic<uint32_t> framesInFlight;
+            std::atomic<float> stallTime;
             std::mutex frameMutex;
             std::condition_variable frameCondition;
             std::atomic_bool refillQueue;
@@ -28,23 +28,48 @@ namespace ouzel
             resource(renderer.getDevice()->getResourceId()),
             vertexAttributes(initVertexAttributes)
         {
-            renderer.addCommand(std::unique_ptr<Command>(new InitShaderCommand(resource,
-                                                                               initFragmentShader,
-                                                                               initVertexShader,
-                                                                               initVertexAttributes,
-                                                                               initFragmentShaderConstantInfo,
-                                                                               initVertexShaderConstantInfo,
-                                                                               initFragmentShaderDataAlignment,
-                                                                               initVertexShaderDataAlignment,
-                                                                               fragmentShaderFunction,
-                                                                               vertexShaderFunction)));
+            renderer.addCommand<InitShaderCommand>(resource,
+                                                   initFragmentShader,
+                                                   initVertexShader,
+                                                   initVertexAttributes,
+                                                   vertexLayout,
+                                                   initFragmentShaderConstantInfo,
+                                                   initVertexShaderConstantInfo,
+                                                   initFragmentShaderDataAlignment,
+                                                   initVertexShaderDataAlignment,
+                                                   fragmentShaderFunction,
+                                                   vertexShaderFunction);
+        }
+
+        Shader::Shader(Renderer& initRenderer,
+                       const std::vector<uint8_t>& initFragmentShader,
+                       const std::vector<uint8_t>& initVertexShader,
+                       const std::vector<Vertex::Attribute>& initVertexLayout,
+                       const std::vector<ConstantInfo>& initFragmentShaderConstantInfo,
+                       const std::vector<ConstantInfo>& initVertexShaderConstantInfo,
+                       uint32_t initFragmentShaderDataAlignment,
+                       uint32_t initVertexShaderDataAlignment,
+                       const std::string& fragmentShaderFunction,
+                       const std::string& vertexShaderFunction):
+            renderer(initRenderer),
+            resource(renderer.getDevice()->getResourceId())
+        {
+            init(initFragmentShader,
+                 initVertexShader,
+                 initVertexLayout,
+                 initFragmentShaderConstantInfo,
+                 initVertexShaderConstantInfo,
+                 initFragmentShaderDataAlignment,
+                 initVertexShaderDataAlignment,
+                 fragmentShaderFunction,
+                 vertexShaderFunction);
         }
 
         Shader::~Shader()
         {
             if (resource)
             {
-                renderer.addCommand(std::unique_ptr<Command>(new DeleteResourceCommand(resource)));
+                renderer.addCommand<DeleteResourceCommand>(resource);
                 RenderDevice* renderDevice = renderer.getDevice();
                 renderDevice->deleteResourceId(resource);
             }
@@ -61,17 +86,47 @@ namespace ouzel
                           const std::string& vertexShaderFunction)
         {
             vertexAttributes = newVertexAttributes;
+            vertexLayout = Vertex::ATTRIBUTES;
+
+            renderer.addCommand<InitShaderCommand>(resource,
+                                                   newFragmentShader,
+                                                   newVertexShader,
+                                                   newVertexAttributes,
+                                                   vertexLayout,
+                                                   newFragmentShaderConstantInfo,
+                                                   newVertexShaderConstantInfo,
+                                                   newFragmentShaderDataAlignment,
+                                                   newVertexShaderDataAlignment,
+                                                   fragmentShaderFunction,
+                                                   vertexShaderFunction);
+        }
+
+        void Shader::init(const std::vector<uint8_t>& newFragmentShader,
+                          const std::vector<uint8_t>& newVertexShader,
+                          const std::vector<Vertex::Attribute>& newVertexLayout,
+                          const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
+                          const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
+                          uint32_t newFragmentShaderDataAlignment,
+                          uint32_t newVertexShaderDataAlignment,
+                          const std::string& fragmentShaderFunction,
+                          const std::string& vertexShaderFunction)
+        {
+            vertexAttributes.clear();
+            for (const Vertex::Attribute& vertexAttribute : newVertexLayout)
+                vertexAttributes.insert(vertexAttribute.usage);
+            vertexLayout = newVertexLayout;
 
-            renderer.addCommand(std::unique_ptr<Command>(new InitShaderCommand(resource,
-                                                                               newFragmentShader,
-                                                                               newVertexShader,
-                                                                               newVertexAttributes,
-                                                                               newFragmentShaderConstantInfo,
-                                                                               newVertexShaderConstantInfo,
-                                                                               newFragmentShaderDataAlignment,
-                                                                               newVertexShaderDataAlignment,
-                                                                               fragmentShaderFunction,
-                                                                               vertexShaderFunction)));
+            renderer.addCommand<InitShaderCommand>(resource,
+                                                   newFragmentShader,
+                                                   newVertexShader,
+                                                   vertexAttributes,
+                                                   vertexLayout,
+                                                   newFragmentShaderConstantInfo,
+                                                   newVertexShaderConstantInfo,
+                                                   newFragmentShaderDataAlignment,
+                                                   newVertexShaderDataAlignment,
+                                                   fragmentShaderFunction,
+                                                   vertexShaderFunction);
         }
 
         const std::set<Vertex::Attribute::Usage>& Shader::getVertexAttributes() const
@@ -4,6 +4,7 @@
 #define OUZEL_GRAPHICS_SHADER_HPP
 
 #include <cstdint>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -41,6 +42,16 @@ namespace ouzel
                    uint32_t initVertexShaderDataAlignment = 0,
                    const std::string& fragmentShaderFunction = "",
                    const std::string& vertexShaderFunction = "");
+            Shader(Renderer& initRenderer,
+                   const std::vector<uint8_t>& initFragmentShader,
+                   const std::vector<uint8_t>& initVertexShader,
+                   const std::vector<Vertex::Attribute>& initVertexLayout,
+                   const std::vector<ConstantInfo>& initFragmentShaderConstantInfo,
+                   const std::vector<ConstantInfo>& initVertexShaderConstantInfo,
+                   uint32_t initFragmentShaderDataAlignment = 0,
+                   uint32_t initVertexShaderDataAlignment = 0,
+                   const std::string& fragmentShaderFunction = "",
+                   const std::string& vertexShaderFunction = "");
             ~Shader();
 
             Shader(const Shader&) = delete;
@@ -49,6 +60,7 @@ namespace ouzel
             Shader(Shader&&) = delete;
             Shader& operator=(Shader&&) = delete;
 
+            // the shader uses the given attributes of the standard Vertex
             void init(const std::vector<uint8_t>& newFragmentShader,
                       const std::vector<uint8_t>& newVertexShader,
                       const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
@@ -58,16 +70,34 @@ namespace ouzel
                       uint32_t newVertexShaderDataAlignment = 0,
                       const std::string& fragmentShaderFunction = "",
                       const std::string& vertexShaderFunction = "");
+            // the shader uses all attributes of the vertex layout, e.g. SpriteVertex::ATTRIBUTES
+            void init(const std::vector<uint8_t>& newFragmentShader,
+                      const std::vector<uint8_t>& newVertexShader,
+                      const std::vector<Vertex::Attribute>& newVertexLayout,
+                      const std::vector<ConstantInfo>& newFragmentShaderConstantInfo,
+                      const std::vector<ConstantInfo>& newVertexShaderConstantInfo,
+                      uint32_t newFragmentShaderDataAlignment = 0,
+                      uint32_t newVertexShaderDataAlignment = 0,
+                      const std::string& fragmentShaderFunction = "",
+                      const std::string& vertexShaderFunction = "");
 
             inline uintptr_t getResource() const { return resource; }
 
             const std::set<Vertex::Attribute::Usage>& getVertexAttributes() const;
+            inline const std::vector<Vertex::Attribute>& getVertexLayout() const { return vertexLayout; }
+
+            // variant of the shader that reads the transform and the color from the instance attributes,
+            // it receives the view projection as the vertex shader constant instead of the model view projection
+            inline const std::shared_ptr<Shader>& getInstancedShader() const { return instancedShader; }
+            inline void setInstancedShader(const std::shared_ptr<Shader>& newInstancedShader) { instancedShader = newInstancedShader; }
 
         private:
             Renderer& renderer;
             uintptr_t resource = 0;
 
             std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::vector<Vertex::Attribute> vertexLayout = Vertex::ATTRIBUTES;
+            std::shared_ptr<Shader> instancedShader;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -13,5 +13,45 @@ namespace ouzel
             Vertex::Attribute(Vertex::Attribute::Usage::TEXTURE_COORDINATES1, DataType::FLOAT_VECTOR2),
             Vertex::Attribute(Vertex::Attribute::Usage::NORMAL, DataType::FLOAT_VECTOR3)
         };
+
+        const std::vector<Vertex::Attribute> SpriteVertex::ATTRIBUTES = {
+            Vertex::Attribute(Vertex::Attribute::Usage::POSITION, DataType::FLOAT_VECTOR3),
+            Vertex::Attribute(Vertex::Attribute::Usage::COLOR, DataType::UNSIGNED_BYTE_VECTOR4_NORM),
+            Vertex::Attribute(Vertex::Attribute::Usage::TEXTURE_COORDINATES0, DataType::UNSIGNED_SHORT_VECTOR2_NORM)
+        };
+
+        const std::vector<Vertex::Attribute> ShapeVertex::ATTRIBUTES = {
+            Vertex::Attribute(Vertex::Attribute::Usage::POSITION, DataType::FLOAT_VECTOR3),
+            Vertex::Attribute(Vertex::Attribute::Usage::COLOR, DataType::UNSIGNED_BYTE_VECTOR4_NORM)
+        };
+
+        // the shader reads the attributes by the names of these usages
+        const std::vector<Vertex::Attribute> ParticleVertex::ATTRIBUTES = {
+            Vertex::Attribute(Vertex::Attribute::Usage::POSITION, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::NORMAL, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::COLOR, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::TANGENT, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::BINORMAL, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::TEXTURE_COORDINATES0, DataType::UNSIGNED_SHORT_VECTOR2_NORM)
+        };
+
+        const std::vector<Vertex::Attribute> Instance::ATTRIBUTES = {
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_TRANSFORM0, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_TRANSFORM1, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_TRANSFORM2, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_TRANSFORM3, DataType::FLOAT_VECTOR4),
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_COLOR, DataType::UNSIGNED_BYTE_VECTOR4_NORM),
+            Vertex::Attribute(Vertex::Attribute::Usage::INSTANCE_TEXTURE_RECTANGLE, DataType::FLOAT_VECTOR4)
+        };
+
+        uint32_t Vertex::getSize(const std::vector<Attribute>& attributes)
+        {
+            uint32_t size = 0;
+
+            for (const Attribute& attribute : attributes)
+                size += getDataTypeSize(attribute.dataType);
+
+            return size;
+        }
     } // namespace graphics
 } // namespace ouzel
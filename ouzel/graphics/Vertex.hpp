@@ -3,11 +3,15 @@
 #ifndef OUZEL_GRAPHICS_VERTEX_HPP
 #define OUZEL_GRAPHICS_VERTEX_HPP
 
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include "graphics/DataType.hpp"
 #include "math/Vector2.hpp"
 #include "math/Vector3.hpp"
 #include "math/Color.hpp"
+#include "math/MathUtils.hpp"
+#include "math/Matrix4.hpp"
 
 namespace ouzel
 {
@@ -32,7 +36,14 @@ namespace ouzel
                     POINT_SIZE,
                     TANGENT,
                     TEXTURE_COORDINATES0,
-                    TEXTURE_COORDINATES1
+                    TEXTURE_COORDINATES1,
+                    // per-instance attributes, read from the instance buffer of instanced draws
+                    INSTANCE_TRANSFORM0,
+                    INSTANCE_TRANSFORM1,
+                    INSTANCE_TRANSFORM2,
+                    INSTANCE_TRANSFORM3,
+                    INSTANCE_COLOR,
+                    INSTANCE_TEXTURE_RECTANGLE
                 };
 
                 Attribute(Usage initUsage, DataType initDataType):
@@ -43,6 +54,9 @@ namespace ouzel
 
             static const std::vector<Attribute> ATTRIBUTES;
 
+            // size of a vertex with the given attributes
+            static uint32_t getSize(const std::vector<Attribute>& attributes);
+
             Vertex() {}
             Vertex(const Vector3& initPosition, Color initColor, const Vector2& initTexCoord, const Vector3& initNormal):
                 position(initPosition), color(initColor), normal(initNormal)
@@ -55,6 +69,82 @@ namespace ouzel
             Vector2 texCoords[2];
             Vector3 normal;
         };
+
+        // position, color and 16-bit normalized texture coordinates (20 bytes), used by sprites, particles and text
+        class SpriteVertex final
+        {
+        public:
+            static const std::vector<Vertex::Attribute> ATTRIBUTES;
+
+            SpriteVertex() {}
+            SpriteVertex(const Vector3& initPosition, Color initColor, const Vector2& initTexCoord):
+                position(initPosition), color(initColor)
+            {
+                setTexCoord(initTexCoord);
+            }
+
+            // texture coordinates are clamped to the [0, 1] range
+            inline void setTexCoord(const Vector2& newTexCoord)
+            {
+                texCoord[0] = static_cast<uint16_t>(clamp(newTexCoord.x, 0.0F, 1.0F) * 65535.0F + 0.5F);
+                texCoord[1] = static_cast<uint16_t>(clamp(newTexCoord.y, 0.0F, 1.0F) * 65535.0F + 0.5F);
+            }
+
+            Vector3 position;
+            Color color;
+            uint16_t texCoord[2] = {0, 0};
+        };
+
+        // position and color (16 bytes), used by shapes
+        class ShapeVertex final
+        {
+        public:
+            static const std::vector<Vertex::Attribute> ATTRIBUTES;
+
+            ShapeVertex() {}
+            ShapeVertex(const Vector3& initPosition, Color initColor):
+                position(initPosition), color(initColor)
+            {
+            }
+
+            Vector3 position;
+            Color color;
+        };
+
+        // spawn state of a particle simulated by the particle vertex shader (84 bytes), all four corners of a particle carry the same state
+        class ParticleVertex final
+        {
+        public:
+            static const std::vector<Vertex::Attribute> ATTRIBUTES;
+
+            float position[4] = {0.0F, 0.0F, 0.0F, 0.0F}; // start position and direction, or angle and radius of radius emitters
+            float motion[4] = {0.0F, 0.0F, 0.0F, 0.0F}; // angle and radius per step, start rotation and rotation per step
+            float color[4] = {0.0F, 0.0F, 0.0F, 0.0F};
+            float deltaColor[4] = {0.0F, 0.0F, 0.0F, 0.0F}; // per step
+            float life[4] = {0.0F, 0.0F, 0.0F, 0.0F}; // emit step, end step, half of the size and its change per step
+            uint16_t texCoord[2] = {0, 0};
+        };
+
+        // per-instance data of instanced draws (84 bytes), the transform columns are stored as separate attributes
+        class Instance final
+        {
+        public:
+            static const std::vector<Vertex::Attribute> ATTRIBUTES;
+
+            Instance() {}
+            Instance(const Matrix4& initTransform, Color initColor):
+                color(initColor)
+            {
+                std::copy(initTransform.m, initTransform.m + 16, transform);
+            }
+
+            float transform[16] = {1.0F, 0.0F, 0.0F, 0.0F,
+                                   0.0F, 1.0F, 0.0F, 0.0F,
+                                   0.0F, 0.0F, 1.0F, 0.0F,
+                                   0.0F, 0.0F, 0.0F, 1.0F};
+            Color color;
+            float texCoordRectangle[4] = {0.0F, 0.0F, 1.0F, 1.0F}; // offset and scale of the texture coordinates
+        };
     } // namespace graphics
 } // namespace ouzel
 
@@ -21,7 +21,7 @@ namespace ouzel
             flags(newFlags),
             size(static_cast<UINT>(newSize))
         {
-            createBuffer(newSize, data);
+            createBuffer(newSize, data.empty() ? nullptr : data.data());
         }
 
         BufferResourceD3D11::~BufferResourceD3D11()
@@ -29,37 +29,34 @@ namespace ouzel
             if (buffer) buffer->Release();
         }
 
-        void BufferResourceD3D11::setData(const std::vector<uint8_t>& data)
+        void BufferResourceD3D11::setData(const uint8_t* data, uint32_t dataSize)
         {
             if (!(flags & Buffer::DYNAMIC))
                 throw DataError("Buffer is not dynamic");
 
-            if (data.empty())
+            if (!dataSize)
                 throw DataError("Data is empty");
 
-            if (!buffer || data.size() > size)
-                createBuffer(static_cast<UINT>(data.size()), data);
+            if (!buffer || dataSize > size)
+                createBuffer(static_cast<UINT>(dataSize), data);
             else
             {
-                if (!data.empty())
-                {
-                    D3D11_MAPPED_SUBRESOURCE mappedSubresource;
-                    mappedSubresource.pData = nullptr;
-                    mappedSubresource.RowPitch = 0;
-                    mappedSubresource.DepthPitch = 0;
+                D3D11_MAPPED_SUBRESOURCE mappedSubresource;
+                mappedSubresource.pData = nullptr;
+                mappedSubresource.RowPitch = 0;
+                mappedSubresource.DepthPitch = 0;
 
-                    HRESULT hr = renderDevice.getContext()->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
-                    if (FAILED(hr))
-                        throw DataError("Failed to lock Direct3D 11 buffer, error: " + std::to_string(hr));
+                HRESULT hr = renderDevice.getContext()->Map(buffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedSubresource);
+                if (FAILED(hr))
+                    throw DataError("Failed to lock Direct3D 11 buffer, error: " + std::to_string(hr));
 
-                    std::copy(data.begin(), data.end(), static_cast<uint8_t*>(mappedSubresource.pData));
+                std::copy(data, data + dataSize, static_cast<uint8_t*>(mappedSubresource.pData));
 
-                    renderDevice.getContext()->Unmap(buffer, 0);
-                }
+                renderDevice.getContext()->Unmap(buffer, 0);
             }
         }
 
-        void BufferResourceD3D11::createBuffer(UINT newSize, const std::vector<uint8_t>& data)
+        void BufferResourceD3D11::createBuffer(UINT newSize, const uint8_t* data)
         {
             if (buffer)
             {
@@ -93,12 +90,12 @@ namespace ouzel
 
                 HRESULT hr;
 
-                if (data.empty())
+                if (!data)
                     hr = renderDevice.getDevice()->CreateBuffer(&bufferDesc, nullptr, &buffer);
                 else
                 {
                     D3D11_SUBRESOURCE_DATA bufferResourceData;
-                    bufferResourceData.pSysMem = data.data();
+                    bufferResourceData.pSysMem = data;
                     bufferResourceData.SysMemPitch = 0;
                     bufferResourceData.SysMemSlicePitch = 0;
 
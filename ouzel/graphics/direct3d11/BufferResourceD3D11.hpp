@@ -26,7 +26,7 @@ namespace ouzel
                                 uint32_t newSize);
             ~BufferResourceD3D11();
 
-            void setData(const std::vector<uint8_t>& data);
+            void setData(const uint8_t* data, uint32_t dataSize);
 
             inline uint32_t getFlags() const { return flags; }
             inline Buffer::Usage getUsage() const { return usage; }
@@ -35,7 +35,7 @@ namespace ouzel
             ID3D11Buffer* getBuffer() const { return buffer; }
 
         private:
-            void createBuffer(UINT newSize, const std::vector<uint8_t>& data);
+            void createBuffer(UINT newSize, const uint8_t* data);
 
             Buffer::Usage usage;
             uint32_t flags = 0;
@@ -38,7 +38,7 @@ namespace ouzel
         {
             running = false;
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
 
             if (renderThread.joinable()) renderThread.join();
@@ -340,8 +340,6 @@ namespace ouzel
             RenderDevice::process();
             executeAll();
 
-            std::vector<float> shaderData;
-
             uint32_t fillModeIndex = 0;
             uint32_t scissorEnableIndex = 0;
             uint32_t cullModeIndex = 0;
@@ -351,19 +349,14 @@ namespace ouzel
 
             for (;;)
             {
-                std::unique_lock<std::mutex> lock(commandQueueMutex);
-                while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                commandBuffer = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
+                commandBuffer = waitForCommandBuffer();
 
-                std::unique_ptr<Command> command;
+                bool presented = false;
 
-                while (!commandBuffer.commands.empty())
-                {
-                    command = std::move(commandBuffer.commands.front());
-                    commandBuffer.commands.pop();
+                CommandReader commandReader(commandBuffer);
 
+                while (const Command* command = commandReader.next())
+                {
                     switch (command->type)
                     {
                         case Command::Type::PRESENT:
@@ -374,14 +367,14 @@ namespace ouzel
 
                         case Command::Type::DELETE_RESOURCE:
                         {
-                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                             resources[deleteResourceCommand->resource - 1].reset();
                             break;
                         }
 
                         case Command::Type::SET_RENDER_TARGET:
                         {
-                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                             ID3D11RenderTargetView* newRenderTargetView = nullptr;
                             ID3D11DepthStencilView* newDepthStencilView = nullptr;
@@ -408,7 +401,7 @@ namespace ouzel
 
                         case Command::Type::SET_RENDER_TARGET_PARAMETERS:
                         {
-                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command.get());
+                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command);
 
                             if (setRenderTargetParametersCommand->renderTarget)
                             {
@@ -431,7 +424,7 @@ namespace ouzel
 
                         case Command::Type::CLEAR_RENDER_TARGET:
                         {
-                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                             ID3D11RenderTargetView* newRenderTargetView = nullptr;
                             ID3D11DepthStencilView* newDepthStencilView = nullptr;
@@ -490,7 +483,7 @@ namespace ouzel
 
                         case Command::Type::BLIT:
                         {
-                            const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command.get());
+                            const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command);
 
                             TextureResourceD3D11* sourceTextureD3D11 = static_cast<TextureResourceD3D11*>(resources[blitCommand->sourceTexture - 1].get());
                             TextureResourceD3D11* destinationTextureD3D11 = static_cast<TextureResourceD3D11*>(resources[blitCommand->destinationTexture - 1].get());
@@ -516,7 +509,7 @@ namespace ouzel
 
                         case Command::Type::SET_CULL_MODE:
                         {
-                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command.get());
+                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command);
 
                             switch (setCullModeCommad->cullMode)
                             {
@@ -534,7 +527,7 @@ namespace ouzel
 
                         case Command::Type::SET_FILL_MODE:
                         {
-                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command.get());
+                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command);
 
                             switch (setFillModeCommad->fillMode)
                             {
@@ -551,7 +544,7 @@ namespace ouzel
 
                         case Command::Type::SET_SCISSOR_TEST:
                         {
-                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                             if (setScissorTestCommand->enabled)
                             {
@@ -573,7 +566,7 @@ namespace ouzel
 
                         case Command::Type::SET_VIEWPORT:
                         {
-                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                             D3D11_VIEWPORT viewport;
                             viewport.MinDepth = 0.0F;
@@ -589,7 +582,7 @@ namespace ouzel
 
                         case Command::Type::INIT_DEPTH_STENCIL_STATE:
                         {
-                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                             std::unique_ptr<DepthStencilStateResourceD3D11> depthStencilStateResourceD3D11(new DepthStencilStateResourceD3D11(*this,
                                                                                                                                             initDepthStencilStateCommand->depthTest,
                                                                                                                                             initDepthStencilStateCommand->depthWrite,
@@ -603,7 +596,7 @@ namespace ouzel
 
                         case Command::Type::SET_DEPTH_STENCIL_STATE:
                         {
-                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                             if (setDepthStencilStateCommand->depthStencilState)
                             {
@@ -618,7 +611,7 @@ namespace ouzel
 
                         case Command::Type::SET_PIPELINE_STATE:
                         {
-                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                             BlendStateResourceD3D11* blendStateD3D11 = static_cast<BlendStateResourceD3D11*>(resources[setPipelineStateCommand->blendState - 1].get());
                             ShaderResourceD3D11* shaderD3D11 = static_cast<ShaderResourceD3D11*>(resources[setPipelineStateCommand->shader - 1].get());
@@ -651,7 +644,7 @@ namespace ouzel
 
                         case Command::Type::DRAW:
                         {
-                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command.get());
+                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command);
 
                             // draw mesh buffer
                             BufferResourceD3D11* indexBufferD3D11 = static_cast<BufferResourceD3D11*>(resources[drawCommand->indexBuffer - 1].get());
@@ -663,7 +656,7 @@ namespace ouzel
                             assert(vertexBufferD3D11->getBuffer());
 
                             ID3D11Buffer* buffers[] = {vertexBufferD3D11->getBuffer()};
-                            UINT strides[] = {sizeof(Vertex)};
+                            UINT strides[] = {currentShader ? currentShader->getVertexSize() : static_cast<UINT>(sizeof(Vertex))};
                             UINT offsets[] = {0};
                             context->IASetVertexBuffers(0, 1, buffers, strides, offsets);
 
@@ -717,7 +710,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BLEND_STATE:
                         {
-                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                             std::unique_ptr<BlendStateResourceD3D11> blendStateResourceD3D11(new BlendStateResourceD3D11(*this,
                                                                                                                         initBlendStateCommand->enableBlending,
@@ -737,7 +730,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BUFFER:
                         {
-                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                             std::unique_ptr<BufferResourceD3D11> bufferResourceD3D11(new BufferResourceD3D11(*this,
                                                                                                             initBufferCommand->usage,
@@ -753,21 +746,23 @@ namespace ouzel
 
                         case Command::Type::SET_BUFFER_DATA:
                         {
-                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                             BufferResourceD3D11* bufferResourceD3D11 = static_cast<BufferResourceD3D11*>(resources[setBufferDataCommand->buffer - 1].get());
-                            bufferResourceD3D11->setData(setBufferDataCommand->data);
+                            bufferResourceD3D11->setData(commandReader.getCommandBuffer().getBufferData(setBufferDataCommand->dataOffset),
+                                                         setBufferDataCommand->dataSize);
                             break;
                         }
 
                         case Command::Type::INIT_SHADER:
                         {
-                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                             std::unique_ptr<ShaderResourceD3D11> shaderResourceD3D11(new ShaderResourceD3D11(*this,
                                                                                                             initShaderCommand->fragmentShader,
                                                                                                             initShaderCommand->vertexShader,
                                                                                                             initShaderCommand->vertexAttributes,
+                                                                                                            initShaderCommand->vertexLayout,
                                                                                                             initShaderCommand->fragmentShaderConstantInfo,
                                                                                                             initShaderCommand->vertexShaderConstantInfo,
                                                                                                             initShaderCommand->fragmentShaderDataAlignment,
@@ -783,59 +778,45 @@ namespace ouzel
 
                         case Command::Type::SET_SHADER_CONSTANTS:
                         {
-                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                             if (!currentShader)
                                 throw SystemError("No shader set");
 
                             // pixel shader constants
                             const std::vector<ShaderResourceD3D11::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
+                            const float* fragmentShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                            uint32_t fragmentShaderConstantSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->fragmentShaderConstantSize);
+                            uint32_t fragmentShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                                throw SystemError("Invalid pixel shader constant size");
-
-                            shaderData.clear();
-
-                            for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
-                            {
-                                const ShaderResourceD3D11::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
-
-                                if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
-                                    throw SystemError("Invalid pixel shader constant size");
+                            for (size_t i = 0; i < fragmentShaderConstantLocations.size() && fragmentShaderConstantOffset < fragmentShaderConstantSize; ++i)
+                                fragmentShaderConstantOffset += fragmentShaderConstantLocations[i].size;
 
-                                shaderData.insert(shaderData.end(), fragmentShaderConstant.begin(), fragmentShaderConstant.end());
-                            }
+                            if (fragmentShaderConstantOffset != fragmentShaderConstantSize)
+                                throw SystemError("Invalid pixel shader constant size");
 
                             uploadBuffer(currentShader->getFragmentShaderConstantBuffer(),
-                                            shaderData.data(),
-                                            static_cast<uint32_t>(sizeof(float) * shaderData.size()));
+                                            fragmentShaderConstants,
+                                            fragmentShaderConstantSize);
 
                             ID3D11Buffer* fragmentShaderConstantBuffers[1] = {currentShader->getFragmentShaderConstantBuffer()};
                             context->PSSetConstantBuffers(0, 1, fragmentShaderConstantBuffers);
 
                             // vertex shader constants
                             const std::vector<ShaderResourceD3D11::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
+                            const float* vertexShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->vertexShaderConstantOffset);
+                            uint32_t vertexShaderConstantSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->vertexShaderConstantSize);
+                            uint32_t vertexShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                                throw SystemError("Invalid vertex shader constant size");
-
-                            shaderData.clear();
+                            for (size_t i = 0; i < vertexShaderConstantLocations.size() && vertexShaderConstantOffset < vertexShaderConstantSize; ++i)
+                                vertexShaderConstantOffset += vertexShaderConstantLocations[i].size;
 
-                            for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
-                            {
-                                const ShaderResourceD3D11::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
-
-                                if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
-                                    throw SystemError("Invalid pixel shader constant size");
-
-                                shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
-                            }
+                            if (vertexShaderConstantOffset != vertexShaderConstantSize)
+                                throw SystemError("Invalid vertex shader constant size");
 
                             uploadBuffer(currentShader->getVertexShaderConstantBuffer(),
-                                            shaderData.data(),
-                                            static_cast<uint32_t>(sizeof(float) * shaderData.size()));
+                                            vertexShaderConstants,
+                                            vertexShaderConstantSize);
 
                             ID3D11Buffer* vertexShaderConstantBuffers[1] = {currentShader->getVertexShaderConstantBuffer()};
                             context->VSSetConstantBuffers(0, 1, vertexShaderConstantBuffers);
@@ -845,7 +826,7 @@ namespace ouzel
 
                         case Command::Type::INIT_TEXTURE:
                         {
-                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                             std::unique_ptr<TextureResourceD3D11> textureResourceD3D11(new TextureResourceD3D11(*this,
                                                                                                                 initTextureCommand->levels,
@@ -861,7 +842,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_DATA:
                         {
-                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                             TextureResourceD3D11* textureResourceD3D11 = static_cast<TextureResourceD3D11*>(resources[setTextureDataCommand->texture - 1].get());
                             textureResourceD3D11->setData(setTextureDataCommand->levels);
@@ -871,7 +852,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_PARAMETERS:
                         {
-                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                             TextureResourceD3D11* textureResourceD3D11 = static_cast<TextureResourceD3D11*>(resources[setTextureParametersCommand->texture - 1].get());
                             textureResourceD3D11->setFilter(setTextureParametersCommand->filter);
@@ -884,7 +865,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURES:
                         {
-                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                             ID3D11ShaderResourceView* resourceViews[Texture::LAYERS];
                             ID3D11SamplerState* samplers[Texture::LAYERS];
@@ -914,7 +895,19 @@ namespace ouzel
                             throw SystemError("Invalid command");
                     }
 
-                    if (command->type == Command::Type::PRESENT) return;
+                    if (command->type == Command::Type::PRESENT)
+                    {
+                        presented = true;
+                        break;
+                    }
+                }
+
+                recycleCommandBuffer(std::move(commandBuffer));
+
+                if (presented)
+                {
+                    finishFrame();
+                    return;
                 }
             }
         }
@@ -85,6 +85,7 @@ namespace ouzel
                                                  const std::vector<uint8_t>& fragmentShaderData,
                                                  const std::vector<uint8_t>& vertexShaderData,
                                                  const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                                 const std::vector<Vertex::Attribute>& newVertexLayout,
                                                  const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                                                  const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                                                  uint32_t,
@@ -93,6 +94,8 @@ namespace ouzel
                                                  const std::string&):
             RenderResourceD3D11(renderDeviceD3D11),
             vertexAttributes(newVertexAttributes),
+            vertexLayout(newVertexLayout),
+            vertexSize(Vertex::getSize(newVertexLayout)),
             fragmentShaderConstantInfo(newFragmentShaderConstantInfo),
             vertexShaderConstantInfo(newVertexShaderConstantInfo)
         {
@@ -110,7 +113,7 @@ namespace ouzel
 
             UINT offset = 0;
 
-            for (const Vertex::Attribute& vertexAttribute : Vertex::ATTRIBUTES)
+            for (const Vertex::Attribute& vertexAttribute : vertexLayout)
             {
                 if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
                 {
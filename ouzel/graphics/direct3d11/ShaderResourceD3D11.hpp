@@ -25,6 +25,7 @@ namespace ouzel
                                 const std::vector<uint8_t>& fragmentShaderData,
                                 const std::vector<uint8_t>& vertexShaderData,
                                 const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                const std::vector<Vertex::Attribute>& newVertexLayout,
                                 const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                                 const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                                 uint32_t,
@@ -40,6 +41,8 @@ namespace ouzel
             };
 
             inline const std::set<Vertex::Attribute::Usage>& getVertexAttributes() const { return vertexAttributes; }
+            inline const std::vector<Vertex::Attribute>& getVertexLayout() const { return vertexLayout; }
+            inline uint32_t getVertexSize() const { return vertexSize; }
 
             const std::vector<Location>& getFragmentShaderConstantLocations() const { return fragmentShaderConstantLocations; }
             const std::vector<Location>& getVertexShaderConstantLocations() const { return vertexShaderConstantLocations; }
@@ -53,6 +56,8 @@ namespace ouzel
 
         private:
             std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::vector<Vertex::Attribute> vertexLayout;
+            uint32_t vertexSize = 0;
 
             std::vector<Shader::ConstantInfo> fragmentShaderConstantInfo;
             std::vector<Shader::ConstantInfo> vertexShaderConstantInfo;
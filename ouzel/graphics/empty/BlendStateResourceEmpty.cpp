@@ -0,0 +1,29 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "BlendStateResourceEmpty.hpp"
+#include "RenderDeviceEmpty.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        BlendStateResourceEmpty::BlendStateResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                                         bool newEnableBlending,
+                                                         BlendState::Factor newColorBlendSource, BlendState::Factor newColorBlendDest,
+                                                         BlendState::Operation newColorOperation,
+                                                         BlendState::Factor newAlphaBlendSource, BlendState::Factor newAlphaBlendDest,
+                                                         BlendState::Operation newAlphaOperation,
+                                                         uint8_t newColorMask):
+            RenderResourceEmpty(renderDeviceEmpty),
+            enableBlending(newEnableBlending),
+            colorBlendSource(newColorBlendSource),
+            colorBlendDest(newColorBlendDest),
+            colorOperation(newColorOperation),
+            alphaBlendSource(newAlphaBlendSource),
+            alphaBlendDest(newAlphaBlendDest),
+            alphaOperation(newAlphaOperation),
+            colorMask(newColorMask)
+        {
+        }
+    } // namespace graphics
+} // namespace ouzel
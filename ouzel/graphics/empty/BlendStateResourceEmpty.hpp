@@ -0,0 +1,51 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_BLENDSTATERESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_BLENDSTATERESOURCEEMPTY_HPP
+
+#include <cstdint>
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "graphics/BlendState.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        class BlendStateResourceEmpty final: public RenderResourceEmpty
+        {
+        public:
+            BlendStateResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                    bool newEnableBlending,
+                                    BlendState::Factor newColorBlendSource, BlendState::Factor newColorBlendDest,
+                                    BlendState::Operation newColorOperation,
+                                    BlendState::Factor newAlphaBlendSource, BlendState::Factor newAlphaBlendDest,
+                                    BlendState::Operation newAlphaOperation,
+                                    uint8_t newColorMask);
+
+            inline bool isBlendingEnabled() const { return enableBlending; }
+
+            inline BlendState::Factor getColorBlendSource() const { return colorBlendSource; }
+            inline BlendState::Factor getColorBlendDest() const { return colorBlendDest; }
+            inline BlendState::Operation getColorOperation() const { return colorOperation; }
+            inline BlendState::Factor getAlphaBlendSource() const { return alphaBlendSource; }
+            inline BlendState::Factor getAlphaBlendDest() const { return alphaBlendDest; }
+            inline BlendState::Operation getAlphaOperation() const { return alphaOperation; }
+
+            inline uint8_t getColorMask() const { return colorMask; }
+
+        private:
+            bool enableBlending = false;
+            BlendState::Factor colorBlendSource = BlendState::Factor::ONE;
+            BlendState::Factor colorBlendDest = BlendState::Factor::ZERO;
+            BlendState::Operation colorOperation = BlendState::Operation::ADD;
+            BlendState::Factor alphaBlendSource = BlendState::Factor::ONE;
+            BlendState::Factor alphaBlendDest = BlendState::Factor::ZERO;
+            BlendState::Operation alphaOperation = BlendState::Operation::ADD;
+            uint8_t colorMask = BlendState::COLOR_MASK_ALL;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_BLENDSTATERESOURCEEMPTY_HPP
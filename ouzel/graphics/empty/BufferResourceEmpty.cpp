@@ -0,0 +1,40 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "BufferResourceEmpty.hpp"
+#include "RenderDeviceEmpty.hpp"
+#include "utils/Errors.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        BufferResourceEmpty::BufferResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                                 Buffer::Usage newUsage, uint32_t newFlags,
+                                                 const std::vector<uint8_t>& newData,
+                                                 uint32_t newSize):
+            RenderResourceEmpty(renderDeviceEmpty),
+            usage(newUsage),
+            flags(newFlags),
+            data(newData)
+        {
+            if (usage != Buffer::Usage::INDEX && usage != Buffer::Usage::VERTEX)
+                throw DataError("Unsupported buffer type");
+
+            if (data.size() < newSize) data.resize(newSize);
+        }
+
+        void BufferResourceEmpty::setData(const uint8_t* newData, uint32_t newSize)
+        {
+            if (!(flags & Buffer::DYNAMIC))
+                throw DataError("Buffer is not dynamic");
+
+            if (!newSize)
+                throw DataError("Data is empty");
+
+            // like a GPU buffer, the contents past the uploaded data are kept
+            if (newSize > data.size()) data.resize(newSize);
+            std::copy(newData, newData + newSize, data.begin());
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,41 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_BUFFERRESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_BUFFERRESOURCEEMPTY_HPP
+
+#include <cstdint>
+#include <vector>
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "graphics/Buffer.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        class BufferResourceEmpty final: public RenderResourceEmpty
+        {
+        public:
+            BufferResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                Buffer::Usage newUsage, uint32_t newFlags,
+                                const std::vector<uint8_t>& newData,
+                                uint32_t newSize);
+
+            void setData(const uint8_t* newData, uint32_t newSize);
+
+            inline uint32_t getFlags() const { return flags; }
+            inline Buffer::Usage getUsage() const { return usage; }
+            inline uint32_t getSize() const { return static_cast<uint32_t>(data.size()); }
+
+            inline const std::vector<uint8_t>& getData() const { return data; }
+
+        private:
+            Buffer::Usage usage;
+            uint32_t flags = 0;
+            std::vector<uint8_t> data;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_BUFFERRESOURCEEMPTY_HPP
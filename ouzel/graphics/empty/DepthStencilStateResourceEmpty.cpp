@@ -0,0 +1,21 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "DepthStencilStateResourceEmpty.hpp"
+#include "RenderDeviceEmpty.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        DepthStencilStateResourceEmpty::DepthStencilStateResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                                                       bool initDepthTest,
+                                                                       bool initDepthWrite,
+                                                                       DepthStencilState::CompareFunction initCompareFunction):
+            RenderResourceEmpty(renderDeviceEmpty),
+            depthTest(initDepthTest),
+            depthWrite(initDepthWrite),
+            compareFunction(initCompareFunction)
+        {
+        }
+    } // namespace graphics
+} // namespace ouzel
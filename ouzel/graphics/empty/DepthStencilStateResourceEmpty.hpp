@@ -0,0 +1,35 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_DEPTHSTENCILSTATERESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_DEPTHSTENCILSTATERESOURCEEMPTY_HPP
+
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "graphics/DepthStencilState.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        class DepthStencilStateResourceEmpty final: public RenderResourceEmpty
+        {
+        public:
+            DepthStencilStateResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                           bool initDepthTest,
+                                           bool initDepthWrite,
+                                           DepthStencilState::CompareFunction initCompareFunction);
+
+            inline bool getDepthTest() const { return depthTest; }
+            inline bool getDepthWrite() const { return depthWrite; }
+            inline DepthStencilState::CompareFunction getCompareFunction() const { return compareFunction; }
+
+        private:
+            bool depthTest = false;
+            bool depthWrite = false;
+            DepthStencilState::CompareFunction compareFunction = DepthStencilState::CompareFunction::LESS;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_DEPTHSTENCILSTATERESOURCEEMPTY_HPP
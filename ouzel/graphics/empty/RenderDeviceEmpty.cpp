@@ -1,18 +1,1281 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 #include "RenderDeviceEmpty.hpp"
+#include "BlendStateResourceEmpty.hpp"
+#include "BufferResourceEmpty.hpp"
+#include "DepthStencilStateResourceEmpty.hpp"
+#include "ShaderResourceEmpty.hpp"
+#include "TextureResourceEmpty.hpp"
+#include "core/Engine.hpp"
+#include "utils/Errors.hpp"
+#include "utils/Log.hpp"
+#include "utils/Utils.hpp"
+#include "stb_image_write.h"
 
 namespace ouzel
 {
     namespace graphics
     {
         RenderDeviceEmpty::RenderDeviceEmpty(const std::function<void(const Event&)>& initCallback):
-            RenderDevice(Driver::EMPTY, initCallback)
+            RenderDevice(Driver::EMPTY, initCallback),
+            rasterizationEnabled(false)
+#if OUZEL_MULTITHREADED
+            , running(false)
+#endif
         {
         }
 
+        RenderDeviceEmpty::~RenderDeviceEmpty()
+        {
+#if OUZEL_MULTITHREADED
+            running = false;
+            CommandBuffer commandBuffer;
+            commandBuffer.pushCommand<PresentCommand>();
+            submitCommandBuffer(std::move(commandBuffer));
+
+            if (renderThread.joinable()) renderThread.join();
+#endif
+
+            resources.clear();
+        }
+
+        void RenderDeviceEmpty::init(Window* newWindow,
+                                     const Size2& newSize,
+                                     uint32_t newSampleCount,
+                                     Texture::Filter newTextureFilter,
+                                     uint32_t newMaxAnisotropy,
+                                     bool newVerticalSync,
+                                     bool newDepth,
+                                     bool newDebugRenderer)
+        {
+            RenderDevice::init(newWindow,
+                               newSize,
+                               newSampleCount,
+                               newTextureFilter,
+                               newMaxAnisotropy,
+                               newVerticalSync,
+                               newDepth,
+                               newDebugRenderer);
+
+            instancingSupported = true;
+
+#if OUZEL_MULTITHREADED
+            running = true;
+            renderThread = std::thread(&RenderDeviceEmpty::main, this);
+#endif
+        }
+
+        template<class T> T* RenderDeviceEmpty::getResource(uintptr_t id) const
+        {
+            if (!id) return nullptr;
+
+            if (id > resources.size())
+                throw DataError("Invalid resource");
+
+            return static_cast<T*>(resources[id - 1].get());
+        }
+
         void RenderDeviceEmpty::process()
         {
+            RenderDevice::process();
+            executeAll();
+
+            CommandBuffer commandBuffer;
+
+            for (;;)
+            {
+                commandBuffer = waitForCommandBuffer();
+
+                bool presented = false;
+
+                CommandReader commandReader(commandBuffer);
+
+                while (const Command* command = commandReader.next())
+                {
+                    switch (command->type)
+                    {
+                        case Command::Type::PRESENT:
+                        {
+                            drawCallCount = frameDrawCallCount;
+                            frameDrawCallCount = 0;
+                            break;
+                        }
+
+                        case Command::Type::DELETE_RESOURCE:
+                        {
+                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
+
+                            RenderResourceEmpty* resource = getResource<RenderResourceEmpty>(deleteResourceCommand->resource);
+
+                            // the pipeline state must not point to deleted resources
+                            if (resource == depthStencilState) depthStencilState = nullptr;
+                            if (resource == blendState) blendState = nullptr;
+                            if (resource == shader) shader = nullptr;
+                            for (TextureResourceEmpty*& texture : textures)
+                                if (resource == texture) texture = nullptr;
+                            if (deleteResourceCommand->resource == renderTarget) renderTarget = 0;
+
+                            resources[deleteResourceCommand->resource - 1].reset();
+                            break;
+                        }
+
+                        case Command::Type::INIT_RENDER_TARGET:
+                        {
+                            const InitRenderTargetCommand* initRenderTargetCommand = static_cast<const InitRenderTargetCommand*>(command);
+
+                            Texture::Level level;
+                            level.size = Size2(static_cast<float>(initRenderTargetCommand->width),
+                                               static_cast<float>(initRenderTargetCommand->height));
+                            level.pitch = 0;
+
+                            std::unique_ptr<TextureResourceEmpty> textureResourceEmpty(new TextureResourceEmpty(*this,
+                                                                                                                {level},
+                                                                                                                Texture::RENDER_TARGET,
+                                                                                                                initRenderTargetCommand->sampleCount,
+                                                                                                                initRenderTargetCommand->pixelFormat));
+
+                            if (initRenderTargetCommand->renderTarget > resources.size())
+                                resources.resize(initRenderTargetCommand->renderTarget);
+                            resources[initRenderTargetCommand->renderTarget - 1] = std::move(textureResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::SET_RENDER_TARGET_PARAMETERS:
+                        {
+                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command);
+
+                            if (setRenderTargetParametersCommand->renderTarget)
+                            {
+                                TextureResourceEmpty* renderTargetEmpty = getResource<TextureResourceEmpty>(setRenderTargetParametersCommand->renderTarget);
+                                renderTargetEmpty->setClearColorBuffer(setRenderTargetParametersCommand->clearColorBuffer);
+                                renderTargetEmpty->setClearDepthBuffer(setRenderTargetParametersCommand->clearDepthBuffer);
+                                renderTargetEmpty->setClearColor(setRenderTargetParametersCommand->clearColor);
+                                renderTargetEmpty->setClearDepth(setRenderTargetParametersCommand->clearDepth);
+                            }
+                            else
+                            {
+                                clearColorBuffer = setRenderTargetParametersCommand->clearColorBuffer;
+                                clearDepthBuffer = setRenderTargetParametersCommand->clearDepthBuffer;
+                                clearColor = setRenderTargetParametersCommand->clearColor;
+                                clearDepth = setRenderTargetParametersCommand->clearDepth;
+                            }
+
+                            break;
+                        }
+
+                        case Command::Type::SET_RENDER_TARGET:
+                        {
+                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
+                            renderTarget = setRenderTargetCommand->renderTarget;
+                            break;
+                        }
+
+                        case Command::Type::CLEAR_RENDER_TARGET:
+                        {
+                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
+                            clear(clearCommand->renderTarget);
+                            break;
+                        }
+
+                        case Command::Type::BLIT:
+                        {
+                            const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command);
+                            blit(*blitCommand);
+                            break;
+                        }
+
+                        case Command::Type::COMPUTE:
+                        {
+                            const ComputeCommand* computeCommand = static_cast<const ComputeCommand*>(command);
+
+                            // compute shaders can not be run on the CPU
+                            if (!getResource<ShaderResourceEmpty>(computeCommand->shader))
+                                throw DataError("Invalid compute shader");
+
+                            break;
+                        }
+
+                        case Command::Type::SET_CULL_MODE:
+                        {
+                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command);
+
+                            if (setCullModeCommad->cullMode != CullMode::NONE &&
+                                setCullModeCommad->cullMode != CullMode::FRONT &&
+                                setCullModeCommad->cullMode != CullMode::BACK)
+                                throw DataError("Invalid cull mode");
+
+                            cullMode = setCullModeCommad->cullMode;
+                            break;
+                        }
+
+                        case Command::Type::SET_FILL_MODE:
+                        {
+                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command);
+
+                            if (setFillModeCommad->fillMode != FillMode::SOLID &&
+                                setFillModeCommad->fillMode != FillMode::WIREFRAME)
+                                throw DataError("Invalid fill mode");
+
+                            fillMode = setFillModeCommad->fillMode;
+                            break;
+                        }
+
+                        case Command::Type::SET_SCISSOR_TEST:
+                        {
+                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
+                            scissorTestEnabled = setScissorTestCommand->enabled;
+                            scissorRectangle = setScissorTestCommand->rectangle;
+                            break;
+                        }
+
+                        case Command::Type::SET_VIEWPORT:
+                        {
+                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command);
+                            viewport = setViewportCommand->viewport;
+                            break;
+                        }
+
+                        case Command::Type::INIT_DEPTH_STENCIL_STATE:
+                        {
+                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
+                            std::unique_ptr<DepthStencilStateResourceEmpty> depthStencilStateResourceEmpty(new DepthStencilStateResourceEmpty(*this,
+                                                                                                                                              initDepthStencilStateCommand->depthTest,
+                                                                                                                                              initDepthStencilStateCommand->depthWrite,
+                                                                                                                                              initDepthStencilStateCommand->compareFunction));
+
+                            if (initDepthStencilStateCommand->depthStencilState > resources.size())
+                                resources.resize(initDepthStencilStateCommand->depthStencilState);
+                            resources[initDepthStencilStateCommand->depthStencilState - 1] = std::move(depthStencilStateResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::SET_DEPTH_STENCIL_STATE:
+                        {
+                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
+                            depthStencilState = getResource<DepthStencilStateResourceEmpty>(setDepthStencilStateCommand->depthStencilState);
+                            break;
+                        }
+
+                        case Command::Type::SET_PIPELINE_STATE:
+                        {
+                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
+                            blendState = getResource<BlendStateResourceEmpty>(setPipelineStateCommand->blendState);
+                            shader = getResource<ShaderResourceEmpty>(setPipelineStateCommand->shader);
+                            break;
+                        }
+
+                        case Command::Type::DRAW:
+                        {
+                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command);
+                            draw(drawCommand->indexBuffer,
+                                 drawCommand->indexCount,
+                                 drawCommand->indexSize,
+                                 drawCommand->vertexBuffer,
+                                 drawCommand->drawMode,
+                                 drawCommand->startIndex,
+                                 0, 1);
+                            ++frameDrawCallCount;
+                            break;
+                        }
+
+                        case Command::Type::DRAW_INSTANCED:
+                        {
+                            const DrawInstancedCommand* drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command);
+                            draw(drawInstancedCommand->indexBuffer,
+                                 drawInstancedCommand->indexCount,
+                                 drawInstancedCommand->indexSize,
+                                 drawInstancedCommand->vertexBuffer,
+                                 drawInstancedCommand->drawMode,
+                                 drawInstancedCommand->startIndex,
+                                 drawInstancedCommand->instanceBuffer,
+                                 drawInstancedCommand->instanceCount);
+                            ++frameDrawCallCount;
+                            break;
+                        }
+
+                        case Command::Type::PUSH_DEBUG_MARKER:
+                        case Command::Type::POP_DEBUG_MARKER:
+                            break;
+
+                        case Command::Type::INIT_BLEND_STATE:
+                        {
+                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
+
+                            std::unique_ptr<BlendStateResourceEmpty> blendStateResourceEmpty(new BlendStateResourceEmpty(*this,
+                                                                                                                         initBlendStateCommand->enableBlending,
+                                                                                                                         initBlendStateCommand->colorBlendSource,
+                                                                                                                         initBlendStateCommand->colorBlendDest,
+                                                                                                                         initBlendStateCommand->colorOperation,
+                                                                                                                         initBlendStateCommand->alphaBlendSource,
+                                                                                                                         initBlendStateCommand->alphaBlendDest,
+                                                                                                                         initBlendStateCommand->alphaOperation,
+                                                                                                                         initBlendStateCommand->colorMask));
+
+                            if (initBlendStateCommand->blendState > resources.size())
+                                resources.resize(initBlendStateCommand->blendState);
+                            resources[initBlendStateCommand->blendState - 1] = std::move(blendStateResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::INIT_BUFFER:
+                        {
+                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command);
+
+                            std::unique_ptr<BufferResourceEmpty> bufferResourceEmpty(new BufferResourceEmpty(*this,
+                                                                                                             initBufferCommand->usage,
+                                                                                                             initBufferCommand->flags,
+                                                                                                             initBufferCommand->data,
+                                                                                                             initBufferCommand->size));
+
+                            if (initBufferCommand->buffer > resources.size())
+                                resources.resize(initBufferCommand->buffer);
+                            resources[initBufferCommand->buffer - 1] = std::move(bufferResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::SET_BUFFER_DATA:
+                        {
+                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
+
+                            BufferResourceEmpty* bufferResourceEmpty = getResource<BufferResourceEmpty>(setBufferDataCommand->buffer);
+                            bufferResourceEmpty->setData(commandReader.getCommandBuffer().getBufferData(setBufferDataCommand->dataOffset),
+                                                         setBufferDataCommand->dataSize);
+                            break;
+                        }
+
+                        case Command::Type::INIT_SHADER:
+                        {
+                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
+
+                            std::unique_ptr<ShaderResourceEmpty> shaderResourceEmpty(new ShaderResourceEmpty(*this,
+                                                                                                             initShaderCommand->vertexAttributes,
+                                                                                                             initShaderCommand->vertexLayout,
+                                                                                                             initShaderCommand->fragmentShaderConstantInfo,
+                                                                                                             initShaderCommand->vertexShaderConstantInfo));
+
+                            if (initShaderCommand->shader > resources.size())
+                                resources.resize(initShaderCommand->shader);
+                            resources[initShaderCommand->shader - 1] = std::move(shaderResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::SET_SHADER_CONSTANTS:
+                        {
+                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
+
+                            if (!shader)
+                                throw DataError("No shader set");
+
+                            // pixel shader constants
+                            const std::vector<Shader::ConstantInfo>& fragmentShaderConstantInfo = shader->getFragmentShaderConstantInfo();
+                            const float* fragmentShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                            uint32_t fragmentShaderConstantOffset = 0;
+
+                            for (size_t i = 0; i < fragmentShaderConstantInfo.size() &&
+                                 fragmentShaderConstantOffset < setShaderConstantsCommand->fragmentShaderConstantSize; ++i)
+                            {
+                                uint32_t size = fragmentShaderConstantInfo[i].size / sizeof(float);
+
+                                if (fragmentShaderConstantOffset + size > setShaderConstantsCommand->fragmentShaderConstantSize)
+                                    throw DataError("Invalid pixel shader constant size");
+
+                                shader->setFragmentShaderConstant(i, fragmentShaderConstants + fragmentShaderConstantOffset, size);
+                                fragmentShaderConstantOffset += size;
+                            }
+
+                            if (fragmentShaderConstantOffset != setShaderConstantsCommand->fragmentShaderConstantSize)
+                                throw DataError("Invalid pixel shader constant size");
+
+                            // vertex shader constants
+                            const std::vector<Shader::ConstantInfo>& vertexShaderConstantInfo = shader->getVertexShaderConstantInfo();
+                            const float* vertexShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->vertexShaderConstantOffset);
+                            uint32_t vertexShaderConstantOffset = 0;
+
+                            for (size_t i = 0; i < vertexShaderConstantInfo.size() &&
+                                 vertexShaderConstantOffset < setShaderConstantsCommand->vertexShaderConstantSize; ++i)
+                            {
+                                uint32_t size = vertexShaderConstantInfo[i].size / sizeof(float);
+
+                                if (vertexShaderConstantOffset + size > setShaderConstantsCommand->vertexShaderConstantSize)
+                                    throw DataError("Invalid vertex shader constant size");
+
+                                shader->setVertexShaderConstant(i, vertexShaderConstants + vertexShaderConstantOffset, size);
+                                vertexShaderConstantOffset += size;
+                            }
+
+                            if (vertexShaderConstantOffset != setShaderConstantsCommand->vertexShaderConstantSize)
+                                throw DataError("Invalid vertex shader constant size");
+
+                            break;
+                        }
+
+                        case Command::Type::INIT_TEXTURE:
+                        {
+                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command);
+
+                            std::unique_ptr<TextureResourceEmpty> textureResourceEmpty(new TextureResourceEmpty(*this,
+                                                                                                                initTextureCommand->levels,
+                                                                                                                initTextureCommand->flags,
+                                                                                                                initTextureCommand->sampleCount,
+                                                                                                                initTextureCommand->pixelFormat));
+
+                            if (initTextureCommand->texture > resources.size())
+                                resources.resize(initTextureCommand->texture);
+                            resources[initTextureCommand->texture - 1] = std::move(textureResourceEmpty);
+                            break;
+                        }
+
+                        case Command::Type::SET_TEXTURE_DATA:
+                        {
+                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
+
+                            TextureResourceEmpty* textureResourceEmpty = getResource<TextureResourceEmpty>(setTextureDataCommand->texture);
+                            textureResourceEmpty->setData(setTextureDataCommand->levels);
+                            break;
+                        }
+
+                        case Command::Type::SET_TEXTURE_PARAMETERS:
+                        {
+                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
+
+                            TextureResourceEmpty* textureResourceEmpty = getResource<TextureResourceEmpty>(setTextureParametersCommand->texture);
+                            textureResourceEmpty->setFilter(setTextureParametersCommand->filter);
+                            textureResourceEmpty->setAddressX(setTextureParametersCommand->addressX);
+                            textureResourceEmpty->setAddressY(setTextureParametersCommand->addressY);
+                            textureResourceEmpty->setMaxAnisotropy(setTextureParametersCommand->maxAnisotropy);
+                            break;
+                        }
+
+                        case Command::Type::SET_TEXTURES:
+                        {
+                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
+
+                            for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
+                                textures[layer] = getResource<TextureResourceEmpty>(setTexturesCommand->textures[layer]);
+
+                            break;
+                        }
+
+                        default:
+                            throw SystemError("Invalid command");
+                    }
+
+                    if (command->type == Command::Type::PRESENT)
+                    {
+                        presented = true;
+                        break;
+                    }
+                }
+
+                recycleCommandBuffer(std::move(commandBuffer));
+
+                if (presented)
+                {
+                    finishFrame();
+                    return;
+                }
+            }
+        }
+
+        void RenderDeviceEmpty::generateScreenshot(const std::string& filename)
+        {
+            if (!rasterizationEnabled)
+                engine->log(Log::Level::WARN) << "Software rasterization is disabled, the screenshot will be empty";
+
+            Surface surface;
+            getSurface(0, surface);
+
+            if (!stbi_write_png(filename.c_str(),
+                                static_cast<int>(surface.width),
+                                static_cast<int>(surface.height), 4,
+                                surface.colorData,
+                                static_cast<int>(surface.width * 4)))
+                throw FileError("Failed to save image to file");
+        }
+
+#if OUZEL_MULTITHREADED
+        void RenderDeviceEmpty::main()
+        {
+            setCurrentThreadName("Render");
+
+            while (running)
+            {
+                try
+                {
+                    process();
+                }
+                catch (const std::exception& e)
+                {
+                    engine->log(Log::Level::ERR) << e.what();
+                }
+            }
+        }
+#endif
+
+        bool RenderDeviceEmpty::getSurface(uintptr_t surfaceRenderTarget, Surface& surface)
+        {
+            if (surfaceRenderTarget)
+            {
+                TextureResourceEmpty* renderTargetEmpty = getResource<TextureResourceEmpty>(surfaceRenderTarget);
+
+                // only RGBA8 render targets can be rasterized to
+                if (!renderTargetEmpty ||
+                    !(renderTargetEmpty->getFlags() & Texture::RENDER_TARGET) ||
+                    renderTargetEmpty->getPixelFormat() != PixelFormat::RGBA8_UNORM)
+                    return false;
+
+                surface.width = renderTargetEmpty->getWidth();
+                surface.height = renderTargetEmpty->getHeight();
+                surface.colorData = renderTargetEmpty->getLevels().front().data.data();
+                surface.depthData = renderTargetEmpty->getDepthBuffer().empty() ? nullptr : renderTargetEmpty->getDepthBuffer().data();
+            }
+            else
+            {
+                // the back buffer is allocated on first use and follows the size of the window
+                surface.width = static_cast<uint32_t>(size.width);
+                surface.height = static_cast<uint32_t>(size.height);
+
+                if (frameBufferData.size() != surface.width * surface.height * 4)
+                {
+                    frameBufferData.assign(surface.width * surface.height * 4, 0);
+                    if (depth) frameBufferDepth.assign(surface.width * surface.height, clearDepth);
+                }
+
+                surface.colorData = frameBufferData.data();
+                surface.depthData = frameBufferDepth.empty() ? nullptr : frameBufferDepth.data();
+            }
+
+            return surface.width && surface.height;
+        }
+
+        void RenderDeviceEmpty::clear(uintptr_t clearRenderTarget)
+        {
+            if (!rasterizationEnabled) return;
+
+            Surface surface;
+            if (!getSurface(clearRenderTarget, surface)) return;
+
+            bool newClearColorBuffer = clearColorBuffer;
+            bool newClearDepthBuffer = clearDepthBuffer;
+            Color newClearColor = clearColor;
+            float newClearDepth = clearDepth;
+
+            if (clearRenderTarget)
+            {
+                TextureResourceEmpty* renderTargetEmpty = getResource<TextureResourceEmpty>(clearRenderTarget);
+                newClearColorBuffer = renderTargetEmpty->getClearColorBuffer();
+                newClearDepthBuffer = renderTargetEmpty->getClearDepthBuffer();
+                newClearColor = renderTargetEmpty->getClearColor();
+                newClearDepth = renderTargetEmpty->getClearDepth();
+            }
+
+            uint32_t pixelCount = surface.width * surface.height;
+
+            if (newClearColorBuffer)
+            {
+                const uint8_t pixel[4] = {newClearColor.r, newClearColor.g, newClearColor.b, newClearColor.a};
+
+                for (uint32_t i = 0; i < pixelCount; ++i)
+                    std::memcpy(surface.colorData + i * 4, pixel, sizeof(pixel));
+            }
+
+            if (newClearDepthBuffer && surface.depthData)
+                std::fill(surface.depthData, surface.depthData + pixelCount, newClearDepth);
+        }
+
+        void RenderDeviceEmpty::blit(const BlitCommand& blitCommand)
+        {
+            TextureResourceEmpty* sourceTexture = getResource<TextureResourceEmpty>(blitCommand.sourceTexture);
+            TextureResourceEmpty* destinationTexture = getResource<TextureResourceEmpty>(blitCommand.destinationTexture);
+
+            if (!sourceTexture || !destinationTexture)
+                throw DataError("Invalid blit texture");
+
+            if (sourceTexture->getPixelFormat() != destinationTexture->getPixelFormat())
+                throw DataError("Blit textures must have the same pixel format");
+
+            if (blitCommand.sourceLevel >= sourceTexture->getLevels().size() ||
+                blitCommand.destinationLevel >= destinationTexture->getLevels().size())
+                throw DataError("Invalid blit level");
+
+            const Texture::Level& sourceLevel = sourceTexture->getLevels()[blitCommand.sourceLevel];
+            Texture::Level& destinationLevel = destinationTexture->getLevels()[blitCommand.destinationLevel];
+
+            if (sourceLevel.data.empty() || destinationLevel.data.empty()) return;
+
+            uint32_t pixelSize = getPixelSize(sourceTexture->getPixelFormat());
+            uint32_t sourceWidth = static_cast<uint32_t>(sourceLevel.size.width);
+            uint32_t sourceHeight = static_cast<uint32_t>(sourceLevel.size.height);
+            uint32_t destinationWidth = static_cast<uint32_t>(destinationLevel.size.width);
+            uint32_t destinationHeight = static_cast<uint32_t>(destinationLevel.size.height);
+
+            if (blitCommand.sourceX + blitCommand.sourceWidth > sourceWidth ||
+                blitCommand.sourceY + blitCommand.sourceHeight > sourceHeight ||
+                blitCommand.destinationX + blitCommand.sourceWidth > destinationWidth ||
+                blitCommand.destinationY + blitCommand.sourceHeight > destinationHeight)
+                throw DataError("Blit region out of bounds");
+
+            uint32_t sourcePitch = sourceLevel.pitch ? sourceLevel.pitch : sourceWidth * pixelSize;
+            uint32_t destinationPitch = destinationLevel.pitch ? destinationLevel.pitch : destinationWidth * pixelSize;
+
+            for (uint32_t row = 0; row < blitCommand.sourceHeight; ++row)
+                std::memcpy(destinationLevel.data.data() + (blitCommand.destinationY + row) * destinationPitch + blitCommand.destinationX * pixelSize,
+                            sourceLevel.data.data() + (blitCommand.sourceY + row) * sourcePitch + blitCommand.sourceX * pixelSize,
+                            blitCommand.sourceWidth * pixelSize);
+        }
+
+        void RenderDeviceEmpty::readAttribute(const uint8_t* data, DataType dataType, float* result, uint32_t count)
+        {
+            uint32_t components;
+
+            switch (dataType)
+            {
+                case DataType::FLOAT: components = 1; break;
+                case DataType::FLOAT_VECTOR2: components = 2; break;
+                case DataType::FLOAT_VECTOR3: components = 3; break;
+                case DataType::FLOAT_VECTOR4: components = 4; break;
+                case DataType::UNSIGNED_BYTE_NORM: components = 1; break;
+                case DataType::UNSIGNED_BYTE_VECTOR2_NORM: components = 2; break;
+                case DataType::UNSIGNED_BYTE_VECTOR3_NORM: components = 3; break;
+                case DataType::UNSIGNED_BYTE_VECTOR4_NORM: components = 4; break;
+                case DataType::UNSIGNED_SHORT_NORM: components = 1; break;
+                case DataType::UNSIGNED_SHORT_VECTOR2_NORM: components = 2; break;
+                case DataType::UNSIGNED_SHORT_VECTOR3_NORM: components = 3; break;
+                case DataType::UNSIGNED_SHORT_VECTOR4_NORM: components = 4; break;
+                default: throw DataError("Unsupported vertex attribute data type");
+            }
+
+            uint32_t componentSize = getDataTypeSize(dataType) / components;
+
+            for (uint32_t i = 0; i < count && i < components; ++i)
+            {
+                const uint8_t* component = data + i * componentSize;
+
+                if (componentSize == sizeof(float))
+                    std::memcpy(&result[i], component, sizeof(float));
+                else if (componentSize == sizeof(uint16_t))
+                {
+                    uint16_t value;
+                    std::memcpy(&value, component, sizeof(value));
+                    result[i] = value / 65535.0F;
+                }
+                else
+                    result[i] = *component / 255.0F;
+            }
+        }
+
+        void RenderDeviceEmpty::draw(uintptr_t indexBufferId,
+                                     uint32_t indexCount,
+                                     uint32_t indexSize,
+                                     uintptr_t vertexBufferId,
+                                     DrawMode drawMode,
+                                     uint32_t startIndex,
+                                     uintptr_t instanceBufferId,
+                                     uint32_t instanceCount)
+        {
+            BufferResourceEmpty* indexBuffer = getResource<BufferResourceEmpty>(indexBufferId);
+            BufferResourceEmpty* vertexBuffer = getResource<BufferResourceEmpty>(vertexBufferId);
+
+            if (!indexBuffer || !vertexBuffer)
+                throw DataError("Invalid mesh buffer");
+
+            if (indexSize != 2 && indexSize != 4)
+                throw DataError("Invalid index size");
+
+            if (static_cast<uint64_t>(startIndex + indexCount) * indexSize > indexBuffer->getSize())
+                throw DataError("Index buffer is too small");
+
+            BufferResourceEmpty* instanceBuffer = nullptr;
+
+            if (instanceBufferId)
+            {
+                instanceBuffer = getResource<BufferResourceEmpty>(instanceBufferId);
+
+                if (!instanceBuffer)
+                    throw DataError("Invalid instance buffer");
+
+                if (static_cast<uint64_t>(instanceCount) * sizeof(Instance) > instanceBuffer->getSize())
+                    throw DataError("Instance buffer is too small");
+            }
+
+            if (!shader)
+                throw DataError("No shader set");
+
+            if (!rasterizationEnabled) return;
+
+            Surface surface;
+            if (!getSurface(renderTarget, surface)) return;
+
+            // pixels are drawn if their centers are inside the intersection of the surface, viewport and scissor rectangle
+            float minX = std::max(0.0F, viewport.position.x);
+            float minY = std::max(0.0F, viewport.position.y);
+            float maxX = std::min(static_cast<float>(surface.width), viewport.position.x + viewport.size.width);
+            float maxY = std::min(static_cast<float>(surface.height), viewport.position.y + viewport.size.height);
+
+            if (scissorTestEnabled)
+            {
+                minX = std::max(minX, scissorRectangle.position.x);
+                minY = std::max(minY, scissorRectangle.position.y);
+                maxX = std::min(maxX, scissorRectangle.position.x + scissorRectangle.size.width);
+                maxY = std::min(maxY, scissorRectangle.position.y + scissorRectangle.size.height);
+            }
+
+            clipMinX = static_cast<int32_t>(std::ceil(minX - 0.5F));
+            clipMinY = static_cast<int32_t>(std::ceil(minY - 0.5F));
+            clipMaxX = static_cast<int32_t>(std::ceil(maxX - 0.5F));
+            clipMaxY = static_cast<int32_t>(std::ceil(maxY - 0.5F));
+
+            if (clipMinX >= clipMaxX || clipMinY >= clipMaxY) return;
+
+            // the engine's built-in shaders multiply the vertex color by the color constant and the first texture
+            Matrix4 modelViewProjection = Matrix4::identity();
+            if (const float* matrix = shader->getModelViewProjection())
+                std::copy(matrix, matrix + 16, modelViewProjection.m);
+
+            if (const float* color = shader->getColor())
+                std::copy(color, color + 4, shaderColor);
+            else
+                std::fill(std::begin(shaderColor), std::end(shaderColor), 1.0F);
+
+            const std::set<Vertex::Attribute::Usage>& vertexAttributes = shader->getVertexAttributes();
+
+            // offsets of the attributes the rasterizer consumes in the shader's vertex layout
+            const Vertex::Attribute* positionAttribute = nullptr;
+            const Vertex::Attribute* colorAttribute = nullptr;
+            const Vertex::Attribute* texCoordAttribute = nullptr;
+            uint32_t positionOffset = 0;
+            uint32_t colorOffset = 0;
+            uint32_t texCoordOffset = 0;
+            uint32_t attributeOffset = 0;
+
+            for (const Vertex::Attribute& vertexAttribute : shader->getVertexLayout())
+            {
+                if (vertexAttribute.usage == Vertex::Attribute::Usage::POSITION)
+                {
+                    positionAttribute = &vertexAttribute;
+                    positionOffset = attributeOffset;
+                }
+                else if (vertexAttribute.usage == Vertex::Attribute::Usage::COLOR &&
+                         vertexAttributes.find(Vertex::Attribute::Usage::COLOR) != vertexAttributes.end())
+                {
+                    colorAttribute = &vertexAttribute;
+                    colorOffset = attributeOffset;
+                }
+                else if (vertexAttribute.usage == Vertex::Attribute::Usage::TEXTURE_COORDINATES0)
+                {
+                    texCoordAttribute = &vertexAttribute;
+                    texCoordOffset = attributeOffset;
+                }
+
+                attributeOffset += getDataTypeSize(vertexAttribute.dataType);
+            }
+
+            if (!positionAttribute)
+                throw DataError("Shader has no position attribute");
+
+            currentTexture = nullptr;
+
+            if (texCoordAttribute &&
+                vertexAttributes.find(Vertex::Attribute::Usage::TEXTURE_COORDINATES0) != vertexAttributes.end() &&
+                textures[0] &&
+                textures[0]->getPixelFormat() == PixelFormat::RGBA8_UNORM &&
+                !textures[0]->getLevels().empty())
+            {
+                const Texture::Level& level = textures[0]->getLevels().front();
+                uint32_t width = static_cast<uint32_t>(level.size.width);
+                uint32_t height = static_cast<uint32_t>(level.size.height);
+
+                if (width && height && level.data.size() >= std::max(level.pitch, width * 4) * height)
+                    currentTexture = textures[0];
+            }
+
+            const uint8_t* indexData = indexBuffer->getData().data() + startIndex * indexSize;
+            const std::vector<uint8_t>& vertexData = vertexBuffer->getData();
+            uint32_t vertexSize = shader->getVertexSize();
+            size_t vertexCount = vertexSize ? vertexData.size() / vertexSize : 0;
+
+            rasterVertices.resize(indexCount);
+
+            for (uint32_t instanceIndex = 0; instanceIndex < instanceCount; ++instanceIndex)
+            {
+                Matrix4 transform = modelViewProjection;
+                float instanceColor[4] = {1.0F, 1.0F, 1.0F, 1.0F};
+                float texCoordRectangle[4] = {0.0F, 0.0F, 1.0F, 1.0F};
+
+                if (instanceBuffer)
+                {
+                    Instance instance;
+                    std::memcpy(&instance, instanceBuffer->getData().data() + instanceIndex * sizeof(Instance), sizeof(Instance));
+
+                    Matrix4 instanceTransform;
+                    std::copy(std::begin(instance.transform), std::end(instance.transform), instanceTransform.m);
+                    transform = modelViewProjection * instanceTransform;
+
+                    instanceColor[0] = instance.color.normR();
+                    instanceColor[1] = instance.color.normG();
+                    instanceColor[2] = instance.color.normB();
+                    instanceColor[3] = instance.color.normA();
+                    std::copy(std::begin(instance.texCoordRectangle), std::end(instance.texCoordRectangle), texCoordRectangle);
+                }
+
+                for (uint32_t i = 0; i < indexCount; ++i)
+                {
+                    uint32_t index;
+
+                    if (indexSize == 2)
+                    {
+                        uint16_t shortIndex;
+                        std::memcpy(&shortIndex, indexData + i * 2, sizeof(shortIndex));
+                        index = shortIndex;
+                    }
+                    else
+                        std::memcpy(&index, indexData + i * 4, sizeof(index));
+
+                    if (index >= vertexCount)
+                        throw DataError("Vertex index out of range");
+
+                    const uint8_t* vertex = vertexData.data() + index * vertexSize;
+
+                    Vector4 position(0.0F, 0.0F, 0.0F, 1.0F);
+                    readAttribute(vertex + positionOffset, positionAttribute->dataType, &position.x, 3);
+                    transform.transformVector(position);
+
+                    RasterVertex& rasterVertex = rasterVertices[i];
+
+                    if (position.w > 0.0F)
+                    {
+                        // viewport transform with the origin in the top left corner
+                        rasterVertex.w = 1.0F / position.w;
+                        rasterVertex.x = viewport.position.x + (position.x * rasterVertex.w + 1.0F) * 0.5F * viewport.size.width;
+                        rasterVertex.y = viewport.position.y + (1.0F - position.y * rasterVertex.w) * 0.5F * viewport.size.height;
+                        rasterVertex.z = position.z * rasterVertex.w;
+                    }
+                    else // behind the eye, primitives using it are skipped
+                        rasterVertex.w = 0.0F;
+
+                    std::fill(std::begin(rasterVertex.color), std::end(rasterVertex.color), 1.0F);
+                    if (colorAttribute)
+                        readAttribute(vertex + colorOffset, colorAttribute->dataType, rasterVertex.color, 4);
+
+                    for (uint32_t component = 0; component < 4; ++component)
+                        rasterVertex.color[component] *= instanceColor[component];
+
+                    std::fill(std::begin(rasterVertex.texCoord), std::end(rasterVertex.texCoord), 0.0F);
+                    if (texCoordAttribute)
+                        readAttribute(vertex + texCoordOffset, texCoordAttribute->dataType, rasterVertex.texCoord, 2);
+
+                    rasterVertex.texCoord[0] = texCoordRectangle[0] + rasterVertex.texCoord[0] * texCoordRectangle[2];
+                    rasterVertex.texCoord[1] = texCoordRectangle[1] + rasterVertex.texCoord[1] * texCoordRectangle[3];
+                }
+
+                switch (drawMode)
+                {
+                    case DrawMode::POINT_LIST:
+                        for (uint32_t i = 0; i < indexCount; ++i)
+                            if (rasterVertices[i].w > 0.0F)
+                                drawPoint(surface, rasterVertices[i]);
+                        break;
+                    case DrawMode::LINE_LIST:
+                        for (uint32_t i = 0; i + 1 < indexCount; i += 2)
+                            if (rasterVertices[i].w > 0.0F && rasterVertices[i + 1].w > 0.0F)
+                                drawLine(surface, rasterVertices[i], rasterVertices[i + 1]);
+                        break;
+                    case DrawMode::LINE_STRIP:
+                        for (uint32_t i = 0; i + 1 < indexCount; ++i)
+                            if (rasterVertices[i].w > 0.0F && rasterVertices[i + 1].w > 0.0F)
+                                drawLine(surface, rasterVertices[i], rasterVertices[i + 1]);
+                        break;
+                    case DrawMode::TRIANGLE_LIST:
+                        for (uint32_t i = 0; i + 2 < indexCount; i += 3)
+                            if (rasterVertices[i].w > 0.0F && rasterVertices[i + 1].w > 0.0F && rasterVertices[i + 2].w > 0.0F)
+                                drawTriangle(surface, rasterVertices[i], rasterVertices[i + 1], rasterVertices[i + 2]);
+                        break;
+                    case DrawMode::TRIANGLE_STRIP:
+                        for (uint32_t i = 0; i + 2 < indexCount; ++i)
+                            if (rasterVertices[i].w > 0.0F && rasterVertices[i + 1].w > 0.0F && rasterVertices[i + 2].w > 0.0F)
+                            {
+                                // every second triangle of a strip has a reversed winding
+                                if (i % 2)
+                                    drawTriangle(surface, rasterVertices[i + 1], rasterVertices[i], rasterVertices[i + 2]);
+                                else
+                                    drawTriangle(surface, rasterVertices[i], rasterVertices[i + 1], rasterVertices[i + 2]);
+                            }
+                        break;
+                    default:
+                        throw DataError("Invalid draw mode");
+                }
+            }
+        }
+
+        void RenderDeviceEmpty::interpolate(const RasterVertex& v0, const RasterVertex& v1,
+                                            float t, float& z, float color[4], float texCoord[2])
+        {
+            z = v0.z + (v1.z - v0.z) * t;
+
+            // perspective correct weights
+            float w0 = (1.0F - t) * v0.w;
+            float w1 = t * v1.w;
+            float sum = w0 + w1;
+            w0 /= sum;
+            w1 /= sum;
+
+            for (size_t c = 0; c < 4; ++c)
+                color[c] = v0.color[c] * w0 + v1.color[c] * w1;
+
+            texCoord[0] = v0.texCoord[0] * w0 + v1.texCoord[0] * w1;
+            texCoord[1] = v0.texCoord[1] * w0 + v1.texCoord[1] * w1;
+        }
+
+        void RenderDeviceEmpty::drawPoint(const Surface& surface, const RasterVertex& v)
+        {
+            int32_t x = static_cast<int32_t>(std::floor(std::max(static_cast<float>(clipMinX - 1), std::min(v.x, static_cast<float>(clipMaxX)))));
+            int32_t y = static_cast<int32_t>(std::floor(std::max(static_cast<float>(clipMinY - 1), std::min(v.y, static_cast<float>(clipMaxY)))));
+
+            if (x >= clipMinX && x < clipMaxX && y >= clipMinY && y < clipMaxY)
+                shadePixel(surface, static_cast<uint32_t>(x), static_cast<uint32_t>(y), v.z, v.color, v.texCoord);
+        }
+
+        void RenderDeviceEmpty::drawLine(const Surface& surface, const RasterVertex& v0, const RasterVertex& v1)
+        {
+            float dx = v1.x - v0.x;
+            float dy = v1.y - v0.y;
+
+            // clip the line to the drawable area (Liang-Barsky), so that the step count stays bounded
+            float t0 = 0.0F;
+            float t1 = 1.0F;
+
+            auto clipEdge = [&t0, &t1](float p, float q) {
+                if (p == 0.0F) return q >= 0.0F;
+
+                float r = q / p;
+
+                if (p < 0.0F)
+                {
+                    if (r > t1) return false;
+                    if (r > t0) t0 = r;
+                }
+                else
+                {
+                    if (r < t0) return false;
+                    if (r < t1) t1 = r;
+                }
+
+                return true;
+            };
+
+            if (!clipEdge(-dx, v0.x - clipMinX) ||
+                !clipEdge(dx, clipMaxX - v0.x) ||
+                !clipEdge(-dy, v0.y - clipMinY) ||
+                !clipEdge(dy, clipMaxY - v0.y))
+                return;
+
+            uint32_t steps = static_cast<uint32_t>(std::ceil(std::max(std::fabs(dx), std::fabs(dy)) * (t1 - t0)));
+            if (steps == 0) steps = 1;
+
+            float z;
+            float color[4];
+            float texCoord[2];
+
+            for (uint32_t step = 0; step <= steps; ++step)
+            {
+                float t = t0 + (t1 - t0) * step / steps;
+
+                int32_t x = static_cast<int32_t>(std::floor(v0.x + dx * t));
+                int32_t y = static_cast<int32_t>(std::floor(v0.y + dy * t));
+
+                if (x >= clipMinX && x < clipMaxX && y >= clipMinY && y < clipMaxY)
+                {
+                    interpolate(v0, v1, t, z, color, texCoord);
+                    shadePixel(surface, static_cast<uint32_t>(x), static_cast<uint32_t>(y), z, color, texCoord);
+                }
+            }
+        }
+
+        float RenderDeviceEmpty::edgeFunction(const RasterVertex& v0, const RasterVertex& v1, float x, float y)
+        {
+            return (v1.x - v0.x) * (y - v0.y) - (v1.y - v0.y) * (x - v0.x);
+        }
+
+        // top-left fill rule for clockwise triangles with the y-axis pointing down
+        bool RenderDeviceEmpty::isTopLeftEdge(const RasterVertex& v0, const RasterVertex& v1)
+        {
+            return (v1.y < v0.y) || (v1.y == v0.y && v1.x > v0.x);
+        }
+
+        void RenderDeviceEmpty::drawTriangle(const Surface& surface, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2)
+        {
+            float area = edgeFunction(v0, v1, v2.x, v2.y);
+
+            if (area == 0.0F) return;
+
+            // clockwise triangles are front facing, like in Direct3D
+            if ((cullMode == CullMode::BACK && area < 0.0F) ||
+                (cullMode == CullMode::FRONT && area > 0.0F))
+                return;
+
+            if (fillMode == FillMode::WIREFRAME)
+            {
+                drawLine(surface, v0, v1);
+                drawLine(surface, v1, v2);
+                drawLine(surface, v2, v0);
+                return;
+            }
+
+            const RasterVertex* a = &v0;
+            const RasterVertex* b = &v1;
+            const RasterVertex* c = &v2;
+
+            if (area < 0.0F)
+            {
+                std::swap(b, c);
+                area = -area;
+            }
+
+            float left = std::min(std::min(a->x, b->x), c->x);
+            float top = std::min(std::min(a->y, b->y), c->y);
+            float right = std::max(std::max(a->x, b->x), c->x);
+            float bottom = std::max(std::max(a->y, b->y), c->y);
+
+            int32_t minX = static_cast<int32_t>(std::floor(std::max(static_cast<float>(clipMinX), left)));
+            int32_t minY = static_cast<int32_t>(std::floor(std::max(static_cast<float>(clipMinY), top)));
+            int32_t maxX = static_cast<int32_t>(std::ceil(std::min(static_cast<float>(clipMaxX), right)));
+            int32_t maxY = static_cast<int32_t>(std::ceil(std::min(static_cast<float>(clipMaxY), bottom)));
+
+            bool topLeftA = isTopLeftEdge(*b, *c);
+            bool topLeftB = isTopLeftEdge(*c, *a);
+            bool topLeftC = isTopLeftEdge(*a, *b);
+
+            float color[4];
+            float texCoord[2];
+
+            for (int32_t y = minY; y < maxY; ++y)
+            {
+                float pixelY = y + 0.5F;
+
+                for (int32_t x = minX; x < maxX; ++x)
+                {
+                    float pixelX = x + 0.5F;
+
+                    float weightA = edgeFunction(*b, *c, pixelX, pixelY);
+                    float weightB = edgeFunction(*c, *a, pixelX, pixelY);
+                    float weightC = edgeFunction(*a, *b, pixelX, pixelY);
+
+                    if (weightA < 0.0F || weightB < 0.0F || weightC < 0.0F) continue;
+                    if ((weightA == 0.0F && !topLeftA) ||
+                        (weightB == 0.0F && !topLeftB) ||
+                        (weightC == 0.0F && !topLeftC)) continue;
+
+                    weightA /= area;
+                    weightB /= area;
+                    weightC /= area;
+
+                    float z = a->z * weightA + b->z * weightB + c->z * weightC;
+
+                    // perspective correct weights
+                    float perspectiveA = weightA * a->w;
+                    float perspectiveB = weightB * b->w;
+                    float perspectiveC = weightC * c->w;
+                    float sum = perspectiveA + perspectiveB + perspectiveC;
+                    perspectiveA /= sum;
+                    perspectiveB /= sum;
+                    perspectiveC /= sum;
+
+                    for (size_t i = 0; i < 4; ++i)
+                        color[i] = a->color[i] * perspectiveA + b->color[i] * perspectiveB + c->color[i] * perspectiveC;
+
+                    for (size_t i = 0; i < 2; ++i)
+                        texCoord[i] = a->texCoord[i] * perspectiveA + b->texCoord[i] * perspectiveB + c->texCoord[i] * perspectiveC;
+
+                    shadePixel(surface, static_cast<uint32_t>(x), static_cast<uint32_t>(y), z, color, texCoord);
+                }
+            }
+        }
+
+        static float getBlendFactor(BlendState::Factor factor, const float source[4], const float destination[4], size_t channel)
+        {
+            switch (factor)
+            {
+                case BlendState::Factor::ZERO: return 0.0F;
+                case BlendState::Factor::ONE: return 1.0F;
+                case BlendState::Factor::SRC_COLOR: return source[channel];
+                case BlendState::Factor::INV_SRC_COLOR: return 1.0F - source[channel];
+                case BlendState::Factor::SRC_ALPHA: return source[3];
+                case BlendState::Factor::INV_SRC_ALPHA: return 1.0F - source[3];
+                case BlendState::Factor::DEST_ALPHA: return destination[3];
+                case BlendState::Factor::INV_DEST_ALPHA: return 1.0F - destination[3];
+                case BlendState::Factor::DEST_COLOR: return destination[channel];
+                case BlendState::Factor::INV_DEST_COLOR: return 1.0F - destination[channel];
+                case BlendState::Factor::SRC_ALPHA_SAT: return (channel == 3) ? 1.0F : std::min(source[3], 1.0F - destination[3]);
+                case BlendState::Factor::BLEND_FACTOR: return 1.0F; // the blend factor is not set, so it is white
+                case BlendState::Factor::INV_BLEND_FACTOR: return 0.0F;
+                default: throw DataError("Unsupported blend factor");
+            }
+        }
+
+        static float blend(BlendState::Operation operation, float source, float sourceFactor, float destination, float destinationFactor)
+        {
+            switch (operation)
+            {
+                case BlendState::Operation::ADD: return source * sourceFactor + destination * destinationFactor;
+                case BlendState::Operation::SUBTRACT: return source * sourceFactor - destination * destinationFactor;
+                case BlendState::Operation::REV_SUBTRACT: return destination * destinationFactor - source * sourceFactor;
+                case BlendState::Operation::MIN: return std::min(source, destination);
+                case BlendState::Operation::MAX: return std::max(source, destination);
+                default: throw DataError("Unsupported blend operation");
+            }
+        }
+
+        void RenderDeviceEmpty::shadePixel(const Surface& surface, uint32_t x, uint32_t y,
+                                           float z, const float color[4], const float texCoord[2])
+        {
+            if (depthStencilState && depthStencilState->getDepthTest() && surface.depthData)
+            {
+                float* depthValue = surface.depthData + y * surface.width + x;
+                z = std::max(0.0F, std::min(z, 1.0F));
+
+                bool passed;
+
+                switch (depthStencilState->getCompareFunction())
+                {
+                    case DepthStencilState::CompareFunction::NEVER: passed = false; break;
+                    case DepthStencilState::CompareFunction::LESS: passed = z < *depthValue; break;
+                    case DepthStencilState::CompareFunction::EQUAL: passed = z == *depthValue; break;
+                    case DepthStencilState::CompareFunction::LESS_EQUAL: passed = z <= *depthValue; break;
+                    case DepthStencilState::CompareFunction::GREATER: passed = z > *depthValue; break;
+                    case DepthStencilState::CompareFunction::NOT_EQUAL: passed = z != *depthValue; break;
+                    case DepthStencilState::CompareFunction::GREATER_EQUAL: passed = z >= *depthValue; break;
+                    case DepthStencilState::CompareFunction::ALWAYS: passed = true; break;
+                    default: throw DataError("Unsupported compare function");
+                }
+
+                if (!passed) return;
+
+                if (depthStencilState->getDepthWrite()) *depthValue = z;
+            }
+
+            float source[4];
+            for (size_t c = 0; c < 4; ++c)
+                source[c] = color[c] * shaderColor[c];
+
+            if (currentTexture)
+            {
+                float sample[4];
+                sampleTexture(*currentTexture, texCoord, sample);
+
+                for (size_t c = 0; c < 4; ++c)
+                    source[c] *= sample[c];
+            }
+
+            uint8_t* pixel = surface.colorData + (y * surface.width + x) * 4;
+            float result[4];
+            uint8_t colorMask = BlendState::COLOR_MASK_ALL;
+
+            if (blendState)
+            {
+                colorMask = blendState->getColorMask();
+
+                if (blendState->isBlendingEnabled())
+                {
+                    float destination[4] = {
+                        pixel[0] / 255.0F,
+                        pixel[1] / 255.0F,
+                        pixel[2] / 255.0F,
+                        pixel[3] / 255.0F
+                    };
+
+                    for (size_t c = 0; c < 3; ++c)
+                        result[c] = blend(blendState->getColorOperation(),
+                                          source[c], getBlendFactor(blendState->getColorBlendSource(), source, destination, c),
+                                          destination[c], getBlendFactor(blendState->getColorBlendDest(), source, destination, c));
+
+                    result[3] = blend(blendState->getAlphaOperation(),
+                                      source[3], getBlendFactor(blendState->getAlphaBlendSource(), source, destination, 3),
+                                      destination[3], getBlendFactor(blendState->getAlphaBlendDest(), source, destination, 3));
+                }
+                else
+                    std::copy(source, source + 4, result);
+            }
+            else
+                std::copy(source, source + 4, result);
+
+            for (size_t c = 0; c < 4; ++c)
+                if (colorMask & (1 << c))
+                    pixel[c] = static_cast<uint8_t>(std::max(0.0F, std::min(result[c], 1.0F)) * 255.0F + 0.5F);
+        }
+
+        static int32_t getTexelCoordinate(int32_t coordinate, int32_t size, Texture::Address address)
+        {
+            switch (address)
+            {
+                case Texture::Address::CLAMP:
+                    return std::max(0, std::min(coordinate, size - 1));
+                case Texture::Address::REPEAT:
+                    return ((coordinate % size) + size) % size;
+                case Texture::Address::MIRROR_REPEAT:
+                {
+                    int32_t period = size * 2;
+                    int32_t result = ((coordinate % period) + period) % period;
+                    return (result < size) ? result : period - 1 - result;
+                }
+                default:
+                    throw DataError("Invalid texture address mode");
+            }
+        }
+
+        void RenderDeviceEmpty::sampleTexture(const TextureResourceEmpty& texture, const float texCoord[2], float result[4]) const
+        {
+            // only the first mip level is sampled
+            const Texture::Level& level = texture.getLevels().front();
+            int32_t width = static_cast<int32_t>(level.size.width);
+            int32_t height = static_cast<int32_t>(level.size.height);
+            uint32_t pitch = level.pitch ? level.pitch : static_cast<uint32_t>(width) * 4;
+
+            Texture::Filter filter = (texture.getFilter() == Texture::Filter::DEFAULT) ? textureFilter : texture.getFilter();
+
+            // keep the coordinates in a range that can be converted to integers
+            float u = std::max(-65536.0F, std::min(texCoord[0], 65536.0F)) * width;
+            float v = std::max(-65536.0F, std::min(texCoord[1], 65536.0F)) * height;
+
+            if (filter == Texture::Filter::DEFAULT || filter == Texture::Filter::POINT)
+            {
+                int32_t x = getTexelCoordinate(static_cast<int32_t>(std::floor(u)), width, texture.getAddressX());
+                int32_t y = getTexelCoordinate(static_cast<int32_t>(std::floor(v)), height, texture.getAddressY());
+
+                const uint8_t* texel = level.data.data() + static_cast<uint32_t>(y) * pitch + static_cast<uint32_t>(x) * 4;
+
+                for (size_t c = 0; c < 4; ++c)
+                    result[c] = texel[c] / 255.0F;
+            }
+            else
+            {
+                u -= 0.5F;
+                v -= 0.5F;
+
+                float floorU = std::floor(u);
+                float floorV = std::floor(v);
+                float fractionU = u - floorU;
+                float fractionV = v - floorV;
+
+                int32_t x0 = getTexelCoordinate(static_cast<int32_t>(floorU), width, texture.getAddressX());
+                int32_t x1 = getTexelCoordinate(static_cast<int32_t>(floorU) + 1, width, texture.getAddressX());
+                int32_t y0 = getTexelCoordinate(static_cast<int32_t>(floorV), height, texture.getAddressY());
+                int32_t y1 = getTexelCoordinate(static_cast<int32_t>(floorV) + 1, height, texture.getAddressY());
+
+                const uint8_t* texel00 = level.data.data() + static_cast<uint32_t>(y0) * pitch + static_cast<uint32_t>(x0) * 4;
+                const uint8_t* texel10 = level.data.data() + static_cast<uint32_t>(y0) * pitch + static_cast<uint32_t>(x1) * 4;
+                const uint8_t* texel01 = level.data.data() + static_cast<uint32_t>(y1) * pitch + static_cast<uint32_t>(x0) * 4;
+                const uint8_t* texel11 = level.data.data() + static_cast<uint32_t>(y1) * pitch + static_cast<uint32_t>(x1) * 4;
+
+                for (size_t c = 0; c < 4; ++c)
+                {
+                    float top = texel00[c] + (texel10[c] - texel00[c]) * fractionU;
+                    float bottom = texel01[c] + (texel11[c] - texel01[c]) * fractionU;
+                    result[c] = (top + (bottom - top) * fractionV) / 255.0F;
+                }
+            }
         }
     } // namespace graphics
 } // namespace ouzel
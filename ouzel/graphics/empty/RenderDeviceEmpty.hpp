@@ -3,19 +3,137 @@
 #ifndef OUZEL_GRAPHICS_RENDERDEVICEEMPTY_HPP
 #define OUZEL_GRAPHICS_RENDERDEVICEEMPTY_HPP
 
+#include "core/Setup.h"
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
 #include "graphics/RenderDevice.hpp"
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "math/Rect.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        class BlendStateResourceEmpty;
+        class BufferResourceEmpty;
+        class DepthStencilStateResourceEmpty;
+        class ShaderResourceEmpty;
+        class TextureResourceEmpty;
+
+        // Headless render device, it executes all the commands without a GPU and can optionally
+        // rasterize the frames on the CPU, so that they can be captured with saveScreenshot
         class RenderDeviceEmpty final: public RenderDevice
         {
             friend Renderer;
+        public:
+            ~RenderDeviceEmpty();
+
+            inline bool isRasterizationEnabled() const { return rasterizationEnabled; }
+            inline void setRasterizationEnabled(bool enabled) { rasterizationEnabled = enabled; }
+
         protected:
             RenderDeviceEmpty(const std::function<void(const Event&)>& initCallback);
 
+            void init(Window* newWindow,
+                      const Size2& newSize,
+                      uint32_t newSampleCount,
+                      Texture::Filter newTextureFilter,
+                      uint32_t newMaxAnisotropy,
+                      bool newVerticalSync,
+                      bool newDepth,
+                      bool newDebugRenderer) override;
+
             void process() override;
+
+            void generateScreenshot(const std::string& filename) override;
+
+        private:
+            // pixels and depth values the rasterizer writes to
+            struct Surface final
+            {
+                uint32_t width = 0;
+                uint32_t height = 0;
+                uint8_t* colorData = nullptr; // RGBA8, rows from top to bottom
+                float* depthData = nullptr; // nullptr if there is no depth buffer
+            };
+
+            struct RasterVertex final
+            {
+                float x;
+                float y;
+                float z;
+                float w; // reciprocal of the clip space w, for perspective correct interpolation
+                float color[4];
+                float texCoord[2];
+            };
+
+#if OUZEL_MULTITHREADED
+            void main();
+#endif
+
+            template<class T> T* getResource(uintptr_t id) const;
+
+            bool getSurface(uintptr_t renderTarget, Surface& surface);
+            void clear(uintptr_t renderTarget);
+            void blit(const BlitCommand& blitCommand);
+            // instanceBuffer is 0 for draws that are not instanced, instanceCount is 1 then
+            void draw(uintptr_t indexBufferId,
+                      uint32_t indexCount,
+                      uint32_t indexSize,
+                      uintptr_t vertexBufferId,
+                      DrawMode drawMode,
+                      uint32_t startIndex,
+                      uintptr_t instanceBufferId,
+                      uint32_t instanceCount);
+            void drawPoint(const Surface& surface, const RasterVertex& v);
+            void drawLine(const Surface& surface, const RasterVertex& v0, const RasterVertex& v1);
+            void drawTriangle(const Surface& surface, const RasterVertex& v0, const RasterVertex& v1, const RasterVertex& v2);
+            void shadePixel(const Surface& surface, uint32_t x, uint32_t y,
+                            float z, const float color[4], const float texCoord[2]);
+            void sampleTexture(const TextureResourceEmpty& texture, const float texCoord[2], float result[4]) const;
+
+            static void readAttribute(const uint8_t* data, DataType dataType, float* result, uint32_t count);
+            static void interpolate(const RasterVertex& v0, const RasterVertex& v1,
+                                    float t, float& z, float color[4], float texCoord[2]);
+            static float edgeFunction(const RasterVertex& v0, const RasterVertex& v1, float x, float y);
+            static bool isTopLeftEdge(const RasterVertex& v0, const RasterVertex& v1);
+
+            std::atomic_bool rasterizationEnabled;
+
+            std::vector<std::unique_ptr<RenderResourceEmpty>> resources;
+
+            std::vector<uint8_t> frameBufferData;
+            std::vector<float> frameBufferDepth;
+            std::vector<RasterVertex> rasterVertices;
+            uint32_t frameDrawCallCount = 0;
+
+            // pipeline state set by the commands
+            uintptr_t renderTarget = 0;
+            Rect viewport;
+            bool scissorTestEnabled = false;
+            Rect scissorRectangle;
+            CullMode cullMode = CullMode::NONE;
+            FillMode fillMode = FillMode::SOLID;
+            DepthStencilStateResourceEmpty* depthStencilState = nullptr;
+            BlendStateResourceEmpty* blendState = nullptr;
+            ShaderResourceEmpty* shader = nullptr;
+            TextureResourceEmpty* textures[Texture::LAYERS] = {};
+
+            // bounds of the current draw call, intersection of the surface, viewport and scissor rectangle
+            int32_t clipMinX = 0;
+            int32_t clipMinY = 0;
+            int32_t clipMaxX = 0;
+            int32_t clipMaxY = 0;
+            float shaderColor[4] = {1.0F, 1.0F, 1.0F, 1.0F};
+            const TextureResourceEmpty* currentTexture = nullptr;
+
+#if OUZEL_MULTITHREADED
+            std::atomic_bool running;
+            std::thread renderThread;
+#endif
         };
     } // namespace graphics
 } // namespace ouzel
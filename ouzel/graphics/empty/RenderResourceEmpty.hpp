@@ -0,0 +1,27 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_RENDERRESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_RENDERRESOURCEEMPTY_HPP
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        class RenderResourceEmpty
+        {
+        public:
+            explicit RenderResourceEmpty(RenderDeviceEmpty& initRenderDevice):
+                renderDevice(initRenderDevice)
+            {
+            }
+            virtual ~RenderResourceEmpty() {}
+
+        protected:
+            RenderDeviceEmpty& renderDevice;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_RENDERRESOURCEEMPTY_HPP
@@ -0,0 +1,64 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "ShaderResourceEmpty.hpp"
+#include "RenderDeviceEmpty.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        static size_t findConstant(const std::vector<Shader::ConstantInfo>& constantInfo, DataType dataType)
+        {
+            for (size_t i = 0; i < constantInfo.size(); ++i)
+                if (constantInfo[i].dataType == dataType) return i;
+
+            return constantInfo.size();
+        }
+
+        ShaderResourceEmpty::ShaderResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                                 const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                                 const std::vector<Vertex::Attribute>& newVertexLayout,
+                                                 const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
+                                                 const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo):
+            RenderResourceEmpty(renderDeviceEmpty),
+            vertexAttributes(newVertexAttributes),
+            vertexLayout(newVertexLayout),
+            vertexSize(Vertex::getSize(newVertexLayout)),
+            fragmentShaderConstantInfo(newFragmentShaderConstantInfo),
+            vertexShaderConstantInfo(newVertexShaderConstantInfo),
+            fragmentShaderConstantValues(newFragmentShaderConstantInfo.size()),
+            vertexShaderConstantValues(newVertexShaderConstantInfo.size()),
+            colorIndex(findConstant(newFragmentShaderConstantInfo, DataType::FLOAT_VECTOR4)),
+            modelViewProjectionIndex(findConstant(newVertexShaderConstantInfo, DataType::FLOAT_MATRIX4))
+        {
+        }
+
+        void ShaderResourceEmpty::setFragmentShaderConstant(size_t index, const float* data, uint32_t size)
+        {
+            fragmentShaderConstantValues[index].assign(data, data + size);
+        }
+
+        void ShaderResourceEmpty::setVertexShaderConstant(size_t index, const float* data, uint32_t size)
+        {
+            vertexShaderConstantValues[index].assign(data, data + size);
+        }
+
+        const float* ShaderResourceEmpty::getColor() const
+        {
+            if (colorIndex >= fragmentShaderConstantValues.size() ||
+                fragmentShaderConstantValues[colorIndex].empty())
+                return nullptr;
+
+            return fragmentShaderConstantValues[colorIndex].data();
+        }
+
+        const float* ShaderResourceEmpty::getModelViewProjection() const
+        {
+            if (modelViewProjectionIndex >= vertexShaderConstantValues.size() ||
+                vertexShaderConstantValues[modelViewProjectionIndex].empty())
+                return nullptr;
+
+            return vertexShaderConstantValues[modelViewProjectionIndex].data();
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,61 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_SHADERRESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_SHADERRESOURCEEMPTY_HPP
+
+#include <cstdint>
+#include <set>
+#include <vector>
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "graphics/Shader.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        // Shader code can not be run on the CPU, the resource only keeps the constant values,
+        // so that the software rasterizer can emulate the engine's built-in shaders
+        class ShaderResourceEmpty final: public RenderResourceEmpty
+        {
+        public:
+            ShaderResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                const std::vector<Vertex::Attribute>& newVertexLayout,
+                                const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
+                                const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo);
+
+            inline const std::set<Vertex::Attribute::Usage>& getVertexAttributes() const { return vertexAttributes; }
+            inline const std::vector<Vertex::Attribute>& getVertexLayout() const { return vertexLayout; }
+            inline uint32_t getVertexSize() const { return vertexSize; }
+
+            inline const std::vector<Shader::ConstantInfo>& getFragmentShaderConstantInfo() const { return fragmentShaderConstantInfo; }
+            inline const std::vector<Shader::ConstantInfo>& getVertexShaderConstantInfo() const { return vertexShaderConstantInfo; }
+
+            void setFragmentShaderConstant(size_t index, const float* data, uint32_t size);
+            void setVertexShaderConstant(size_t index, const float* data, uint32_t size);
+
+            // the first 4-component vector of the fragment shader or nullptr if it was not set
+            const float* getColor() const;
+            // the first 4x4 matrix of the vertex shader or nullptr if it was not set
+            const float* getModelViewProjection() const;
+
+        private:
+            std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::vector<Vertex::Attribute> vertexLayout;
+            uint32_t vertexSize = 0;
+
+            std::vector<Shader::ConstantInfo> fragmentShaderConstantInfo;
+            std::vector<Shader::ConstantInfo> vertexShaderConstantInfo;
+
+            std::vector<std::vector<float>> fragmentShaderConstantValues;
+            std::vector<std::vector<float>> vertexShaderConstantValues;
+
+            size_t colorIndex;
+            size_t modelViewProjectionIndex;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_SHADERRESOURCEEMPTY_HPP
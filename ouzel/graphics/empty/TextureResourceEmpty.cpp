@@ -0,0 +1,95 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include "TextureResourceEmpty.hpp"
+#include "RenderDeviceEmpty.hpp"
+#include "utils/Errors.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        TextureResourceEmpty::TextureResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                                   const std::vector<Texture::Level>& newLevels,
+                                                   uint32_t newFlags,
+                                                   uint32_t newSampleCount,
+                                                   PixelFormat newPixelFormat):
+            RenderResourceEmpty(renderDeviceEmpty),
+            levels(newLevels),
+            flags(newFlags),
+            sampleCount(newSampleCount),
+            pixelFormat(newPixelFormat)
+        {
+            if ((flags & Texture::RENDER_TARGET) && levels.size() != 1)
+                throw DataError("Invalid mip map count");
+
+            if (!levels.empty())
+            {
+                width = static_cast<uint32_t>(levels.front().size.width);
+                height = static_cast<uint32_t>(levels.front().size.height);
+            }
+
+            if (flags & Texture::RENDER_TARGET)
+            {
+                Texture::Level& level = levels.front();
+                level.pitch = width * getPixelSize(pixelFormat);
+                level.data.resize(level.pitch * height);
+
+                if (flags & Texture::DEPTH_BUFFER)
+                    depthBuffer.resize(width * height, clearDepth);
+            }
+        }
+
+        void TextureResourceEmpty::setData(const std::vector<Texture::Level>& newLevels)
+        {
+            if (!(flags & Texture::DYNAMIC) || flags & Texture::RENDER_TARGET)
+                throw DataError("Texture is not dynamic");
+
+            // levels without data keep their previous contents
+            if (newLevels.size() > levels.size()) levels.resize(newLevels.size());
+
+            for (size_t level = 0; level < newLevels.size(); ++level)
+                if (!newLevels[level].data.empty())
+                    levels[level] = newLevels[level];
+        }
+
+        void TextureResourceEmpty::setFilter(Texture::Filter newFilter)
+        {
+            filter = newFilter;
+        }
+
+        void TextureResourceEmpty::setAddressX(Texture::Address newAddressX)
+        {
+            addressX = newAddressX;
+        }
+
+        void TextureResourceEmpty::setAddressY(Texture::Address newAddressY)
+        {
+            addressY = newAddressY;
+        }
+
+        void TextureResourceEmpty::setMaxAnisotropy(uint32_t newMaxAnisotropy)
+        {
+            maxAnisotropy = newMaxAnisotropy;
+        }
+
+        void TextureResourceEmpty::setClearColorBuffer(bool clear)
+        {
+            clearColorBuffer = clear;
+        }
+
+        void TextureResourceEmpty::setClearDepthBuffer(bool clear)
+        {
+            clearDepthBuffer = clear;
+        }
+
+        void TextureResourceEmpty::setClearColor(Color color)
+        {
+            clearColor = color;
+        }
+
+        void TextureResourceEmpty::setClearDepth(float newClearDepth)
+        {
+            clearDepth = newClearDepth;
+        }
+    } // namespace graphics
+} // namespace ouzel
@@ -0,0 +1,81 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_GRAPHICS_TEXTURERESOURCEEMPTY_HPP
+#define OUZEL_GRAPHICS_TEXTURERESOURCEEMPTY_HPP
+
+#include <cstdint>
+#include <vector>
+#include "graphics/empty/RenderResourceEmpty.hpp"
+#include "graphics/Texture.hpp"
+
+namespace ouzel
+{
+    namespace graphics
+    {
+        class RenderDeviceEmpty;
+
+        class TextureResourceEmpty final: public RenderResourceEmpty
+        {
+        public:
+            TextureResourceEmpty(RenderDeviceEmpty& renderDeviceEmpty,
+                                 const std::vector<Texture::Level>& newLevels,
+                                 uint32_t newFlags = 0,
+                                 uint32_t newSampleCount = 1,
+                                 PixelFormat newPixelFormat = PixelFormat::RGBA8_UNORM);
+
+            void setData(const std::vector<Texture::Level>& newLevels);
+            void setFilter(Texture::Filter newFilter);
+            void setAddressX(Texture::Address newAddressX);
+            void setAddressY(Texture::Address newAddressY);
+            void setMaxAnisotropy(uint32_t newMaxAnisotropy);
+            void setClearColorBuffer(bool clear);
+            void setClearDepthBuffer(bool clear);
+            void setClearColor(Color color);
+            void setClearDepth(float newClearDepth);
+
+            inline uint32_t getFlags() const { return flags; }
+            inline uint32_t getMipmaps() const { return static_cast<uint32_t>(levels.size()); }
+
+            inline Texture::Filter getFilter() const { return filter; }
+            inline Texture::Address getAddressX() const { return addressX; }
+            inline Texture::Address getAddressY() const { return addressY; }
+            inline uint32_t getMaxAnisotropy() const { return maxAnisotropy; }
+            inline bool getClearColorBuffer() const { return clearColorBuffer; }
+            inline bool getClearDepthBuffer() const { return clearDepthBuffer; }
+            inline Color getClearColor() const { return clearColor; }
+            inline float getClearDepth() const { return clearDepth; }
+            inline uint32_t getSampleCount() const { return sampleCount; }
+            inline PixelFormat getPixelFormat() const { return pixelFormat; }
+
+            inline uint32_t getWidth() const { return width; }
+            inline uint32_t getHeight() const { return height; }
+
+            inline std::vector<Texture::Level>& getLevels() { return levels; }
+            inline const std::vector<Texture::Level>& getLevels() const { return levels; }
+
+            // depth values of a render target, empty if it was created without a depth buffer
+            inline std::vector<float>& getDepthBuffer() { return depthBuffer; }
+
+        private:
+            bool clearColorBuffer = true;
+            bool clearDepthBuffer = false;
+            Color clearColor;
+            float clearDepth = 1.0F;
+            std::vector<Texture::Level> levels;
+            uint32_t flags = 0;
+            uint32_t sampleCount = 1;
+            PixelFormat pixelFormat = PixelFormat::RGBA8_UNORM;
+            Texture::Filter filter = Texture::Filter::DEFAULT;
+            Texture::Address addressX = Texture::Address::CLAMP;
+            Texture::Address addressY = Texture::Address::CLAMP;
+            uint32_t maxAnisotropy = 0;
+
+            uint32_t width = 0;
+            uint32_t height = 0;
+
+            std::vector<float> depthBuffer;
+        };
+    } // namespace graphics
+} // namespace ouzel
+
+#endif // OUZEL_GRAPHICS_TEXTURERESOURCEEMPTY_HPP
@@ -33,7 +33,7 @@ namespace ouzel
                                 uint32_t newSize);
             ~BufferResourceMetal();
 
-            void setData(const std::vector<uint8_t>& data);
+            void setData(const uint8_t* data, uint32_t dataSize);
 
             inline uint32_t getFlags() const { return flags; }
             inline Buffer::Usage getUsage() const { return usage; }
@@ -32,19 +32,18 @@ namespace ouzel
             if (buffer) [buffer release];
         }
 
-        void BufferResourceMetal::setData(const std::vector<uint8_t>& data)
+        void BufferResourceMetal::setData(const uint8_t* data, uint32_t dataSize)
         {
             if (!(flags & Buffer::DYNAMIC))
                 throw DataError("Buffer is not dynamic");
 
-            if (data.empty())
+            if (!dataSize)
                 throw DataError("Data is empty");
 
-            if (!buffer || data.size() > size)
-                createBuffer(static_cast<uint32_t>(data.size()));
+            if (!buffer || dataSize > size)
+                createBuffer(dataSize);
 
-            if (!data.empty())
-                std::copy(data.begin(), data.end(), static_cast<uint8_t*>([buffer contents]));
+            std::copy(data, data + dataSize, static_cast<uint8_t*>([buffer contents]));
         }
 
         void BufferResourceMetal::createBuffer(NSUInteger newSize)
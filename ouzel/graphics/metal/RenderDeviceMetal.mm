@@ -263,8 +263,6 @@ namespace ouzel
             id<MTLRenderCommandEncoder> currentRenderCommandEncoder = nil;
             PipelineStateDesc currentPipelineStateDesc;
             MTLTexturePtr currentRenderTarget = nil;
-            std::vector<float> shaderData;
-
             if (++shaderConstantBufferIndex >= BUFFER_COUNT) shaderConstantBufferIndex = 0;
             ShaderConstantBuffer& shaderConstantBuffer = shaderConstantBuffers[shaderConstantBufferIndex];
             shaderConstantBuffer.index = 0;
@@ -275,19 +273,14 @@ namespace ouzel
 
             for (;;)
             {
-                std::unique_lock<std::mutex> lock(commandQueueMutex);
-                while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                commandBuffer = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
+                commandBuffer = waitForCommandBuffer();
 
-                std::unique_ptr<Command> command;
+                bool presented = false;
 
-                while (!commandBuffer.commands.empty())
-                {
-                    command = std::move(commandBuffer.commands.front());
-                    commandBuffer.commands.pop();
+                CommandReader commandReader(commandBuffer);
 
+                while (const Command* command = commandReader.next())
+                {
                     switch (command->type)
                     {
                         case Command::Type::PRESENT:
@@ -305,14 +298,14 @@ namespace ouzel
 
                         case Command::Type::DELETE_RESOURCE:
                         {
-                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                             resources[deleteResourceCommand->resource - 1].reset();
                             break;
                         }
 
                         case Command::Type::SET_RENDER_TARGET:
                         {
-                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                             MTLRenderPassDescriptorPtr newRenderPassDescriptor;
 
@@ -358,7 +351,7 @@ namespace ouzel
 
                         case Command::Type::SET_RENDER_TARGET_PARAMETERS:
                         {
-                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command.get());
+                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command);
 
                             if (setRenderTargetParametersCommand->renderTarget)
                             {
@@ -381,7 +374,7 @@ namespace ouzel
 
                         case Command::Type::CLEAR_RENDER_TARGET:
                         {
-                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                             MTLRenderPassDescriptorPtr newRenderPassDescriptor;
                             MTLLoadAction newColorBufferLoadAction = MTLLoadActionLoad;
@@ -451,14 +444,14 @@ namespace ouzel
 
                         case Command::Type::BLIT:
                         {
-                            //const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command.get());
+                            //const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command);
                             //MTLBlitCommandEncoder
                             break;
                         }
 
                         case Command::Type::SET_CULL_MODE:
                         {
-                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command.get());
+                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -480,7 +473,7 @@ namespace ouzel
 
                         case Command::Type::SET_FILL_MODE:
                         {
-                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command.get());
+                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -501,7 +494,7 @@ namespace ouzel
 
                         case Command::Type::SET_SCISSOR_TEST:
                         {
-                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -533,7 +526,7 @@ namespace ouzel
 
                         case Command::Type::SET_VIEWPORT:
                         {
-                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -553,7 +546,7 @@ namespace ouzel
 
                         case Command::Type::INIT_DEPTH_STENCIL_STATE:
                         {
-                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                             std::unique_ptr<DepthStencilStateResourceMetal> depthStencilStateResourceMetal(new DepthStencilStateResourceMetal(*this,
                                                                                                                                               initDepthStencilStateCommand->depthTest,
                                                                                                                                               initDepthStencilStateCommand->depthWrite,
@@ -568,7 +561,7 @@ namespace ouzel
 
                         case Command::Type::SET_DEPTH_STENCIL_STATE:
                         {
-                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -586,7 +579,7 @@ namespace ouzel
 
                         case Command::Type::SET_PIPELINE_STATE:
                         {
-                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -606,7 +599,7 @@ namespace ouzel
 
                         case Command::Type::DRAW:
                         {
-                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command.get());
+                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -659,7 +652,7 @@ namespace ouzel
 
                         case Command::Type::PUSH_DEBUG_MARKER:
                         {
-                            const PushDebugMarkerCommand* pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
+                            const PushDebugMarkerCommand* pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -681,7 +674,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BLEND_STATE:
                         {
-                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                             std::unique_ptr<BlendStateResourceMetal> blendStateResourceMetal(new BlendStateResourceMetal(*this,
                                                                                                                          initBlendStateCommand->enableBlending,
@@ -701,7 +694,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BUFFER:
                         {
-                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                             std::unique_ptr<BufferResourceMetal> bufferResourceMetal(new BufferResourceMetal(*this,
                                                                                                              initBufferCommand->usage,
@@ -717,21 +710,23 @@ namespace ouzel
 
                         case Command::Type::SET_BUFFER_DATA:
                         {
-                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                             BufferResourceMetal* bufferResourceMetal = static_cast<BufferResourceMetal*>(resources[setBufferDataCommand->buffer - 1].get());
-                            bufferResourceMetal->setData(setBufferDataCommand->data);
+                            bufferResourceMetal->setData(commandReader.getCommandBuffer().getBufferData(setBufferDataCommand->dataOffset),
+                                                         setBufferDataCommand->dataSize);
                             break;
                         }
 
                         case Command::Type::INIT_SHADER:
                         {
-                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                             std::unique_ptr<ShaderResourceMetal> shaderResourceMetal(new ShaderResourceMetal(*this,
                                                                                                              initShaderCommand->fragmentShader,
                                                                                                              initShaderCommand->vertexShader,
                                                                                                              initShaderCommand->vertexAttributes,
+                                                                                                             initShaderCommand->vertexLayout,
                                                                                                              initShaderCommand->fragmentShaderConstantInfo,
                                                                                                              initShaderCommand->vertexShaderConstantInfo,
                                                                                                              initShaderCommand->fragmentShaderDataAlignment,
@@ -747,7 +742,7 @@ namespace ouzel
 
                         case Command::Type::SET_SHADER_CONSTANTS:
                         {
-                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -757,27 +752,20 @@ namespace ouzel
 
                             // pixel shader constants
                             const std::vector<ShaderResourceMetal::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
+                            const float* fragmentShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                            uint32_t fragmentShaderConstantSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->fragmentShaderConstantSize);
+                            uint32_t fragmentShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                                throw DataError("Invalid pixel shader constant size");
-
-                            shaderData.clear();
-
-                            for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
-                            {
-                                const ShaderResourceMetal::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
-
-                                if (sizeof(float) * fragmentShaderConstant.size() != fragmentShaderConstantLocation.size)
-                                    throw DataError("Invalid pixel shader constant size");
+                            for (size_t i = 0; i < fragmentShaderConstantLocations.size() && fragmentShaderConstantOffset < fragmentShaderConstantSize; ++i)
+                                fragmentShaderConstantOffset += fragmentShaderConstantLocations[i].size;
 
-                                shaderData.insert(shaderData.end(), fragmentShaderConstant.begin(), fragmentShaderConstant.end());
-                            }
+                            if (fragmentShaderConstantOffset != fragmentShaderConstantSize)
+                                throw DataError("Invalid pixel shader constant size");
 
                             shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + currentShader->getFragmentShaderAlignment() - 1) /
                                                            currentShader->getFragmentShaderAlignment()) * currentShader->getFragmentShaderAlignment(); // round up to nearest aligned pointer
 
-                            if (shaderConstantBuffer.offset + getVectorSize(shaderData) > BUFFER_SIZE)
+                            if (shaderConstantBuffer.offset + fragmentShaderConstantSize > BUFFER_SIZE)
                             {
                                 ++shaderConstantBuffer.index;
                                 shaderConstantBuffer.offset = 0;
@@ -796,39 +784,32 @@ namespace ouzel
 
                             MTLBufferPtr currentBuffer = shaderConstantBuffer.buffers[shaderConstantBuffer.index];
 
-                            std::copy(reinterpret_cast<const char*>(shaderData.data()),
-                                      reinterpret_cast<const char*>(shaderData.data()) + static_cast<uint32_t>(sizeof(float) * shaderData.size()),
+                            std::copy(reinterpret_cast<const char*>(fragmentShaderConstants),
+                                      reinterpret_cast<const char*>(fragmentShaderConstants) + fragmentShaderConstantSize,
                                       static_cast<char*>([currentBuffer contents]) + shaderConstantBuffer.offset);
 
                             [currentRenderCommandEncoder setFragmentBuffer:currentBuffer
                                                                     offset:shaderConstantBuffer.offset
                                                                    atIndex:1];
 
-                            shaderConstantBuffer.offset += static_cast<uint32_t>(getVectorSize(shaderData));
+                            shaderConstantBuffer.offset += fragmentShaderConstantSize;
 
                             // vertex shader constants
                             const std::vector<ShaderResourceMetal::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
+                            const float* vertexShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->vertexShaderConstantOffset);
+                            uint32_t vertexShaderConstantSize = static_cast<uint32_t>(sizeof(float) * setShaderConstantsCommand->vertexShaderConstantSize);
+                            uint32_t vertexShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                                throw DataError("Invalid vertex shader constant size");
-
-                            shaderData.clear();
+                            for (size_t i = 0; i < vertexShaderConstantLocations.size() && vertexShaderConstantOffset < vertexShaderConstantSize; ++i)
+                                vertexShaderConstantOffset += vertexShaderConstantLocations[i].size;
 
-                            for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
-                            {
-                                const ShaderResourceMetal::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
-
-                                if (sizeof(float) * vertexShaderConstant.size() != vertexShaderConstantLocation.size)
-                                    throw DataError("Invalid vertex shader constant size");
-
-                                shaderData.insert(shaderData.end(), vertexShaderConstant.begin(), vertexShaderConstant.end());
-                            }
+                            if (vertexShaderConstantOffset != vertexShaderConstantSize)
+                                throw DataError("Invalid vertex shader constant size");
 
                             shaderConstantBuffer.offset = ((shaderConstantBuffer.offset + currentShader->getVertexShaderAlignment() - 1) /
                                                            currentShader->getVertexShaderAlignment()) * currentShader->getVertexShaderAlignment(); // round up to nearest aligned pointer
 
-                            if (shaderConstantBuffer.offset + getVectorSize(shaderData) > BUFFER_SIZE)
+                            if (shaderConstantBuffer.offset + vertexShaderConstantSize > BUFFER_SIZE)
                             {
                                 ++shaderConstantBuffer.index;
                                 shaderConstantBuffer.offset = 0;
@@ -847,22 +828,22 @@ namespace ouzel
 
                             currentBuffer = shaderConstantBuffer.buffers[shaderConstantBuffer.index];
 
-                            std::copy(reinterpret_cast<const char*>(shaderData.data()),
-                                      reinterpret_cast<const char*>(shaderData.data()) + static_cast<uint32_t>(sizeof(float) * shaderData.size()),
+                            std::copy(reinterpret_cast<const char*>(vertexShaderConstants),
+                                      reinterpret_cast<const char*>(vertexShaderConstants) + vertexShaderConstantSize,
                                       static_cast<char*>([currentBuffer contents]) + shaderConstantBuffer.offset);
 
                             [currentRenderCommandEncoder setVertexBuffer:currentBuffer
                                                                   offset:shaderConstantBuffer.offset
                                                                  atIndex:1];
 
-                            shaderConstantBuffer.offset += static_cast<uint32_t>(getVectorSize(shaderData));
+                            shaderConstantBuffer.offset += vertexShaderConstantSize;
 
                             break;
                         }
 
                         case Command::Type::INIT_TEXTURE:
                         {
-                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                             std::unique_ptr<TextureResourceMetal> textureResourceMetal(new TextureResourceMetal(*this,
                                                                                                                 initTextureCommand->levels,
@@ -878,7 +859,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_DATA:
                         {
-                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                             TextureResourceMetal* textureResourceMetal = static_cast<TextureResourceMetal*>(resources[setTextureDataCommand->texture - 1].get());
                             textureResourceMetal->setData(setTextureDataCommand->levels);
@@ -888,7 +869,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_PARAMETERS:
                         {
-                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                             TextureResourceMetal* textureResourceMetal = static_cast<TextureResourceMetal*>(resources[setTextureParametersCommand->texture - 1].get());
                             textureResourceMetal->setFilter(setTextureParametersCommand->filter);
@@ -901,7 +882,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURES:
                         {
-                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                             if (!currentRenderCommandEncoder)
                                 throw DataError("Metal render command encoder not initialized");
@@ -927,7 +908,19 @@ namespace ouzel
                         default: throw SystemError("Invalid command");
                     }
 
-                    if (command->type == Command::Type::PRESENT) return;
+                    if (command->type == Command::Type::PRESENT)
+                    {
+                        presented = true;
+                        break;
+                    }
+                }
+
+                recycleCommandBuffer(std::move(commandBuffer));
+
+                if (presented)
+                {
+                    finishFrame();
+                    return;
                 }
             }
         }
@@ -33,6 +33,7 @@ namespace ouzel
                                 const std::vector<uint8_t>& fragmentShaderData,
                                 const std::vector<uint8_t>& vertexShaderData,
                                 const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                const std::vector<Vertex::Attribute>& newVertexLayout,
                                 const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                                 const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                                 uint32_t newFragmentShaderDataAlignment,
@@ -48,6 +49,8 @@ namespace ouzel
             };
 
             inline const std::set<Vertex::Attribute::Usage>& getVertexAttributes() const { return vertexAttributes; }
+            inline const std::vector<Vertex::Attribute>& getVertexLayout() const { return vertexLayout; }
+            inline uint32_t getVertexSize() const { return vertexSize; }
 
             inline uint32_t getFragmentShaderAlignment() const { return fragmentShaderAlignment; }
             inline uint32_t getVertexShaderAlignment() const { return vertexShaderAlignment; }
@@ -65,6 +68,8 @@ namespace ouzel
 
         private:
             std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::vector<Vertex::Attribute> vertexLayout;
+            uint32_t vertexSize = 0;
 
             std::vector<Shader::ConstantInfo> fragmentShaderConstantInfo;
             uint32_t fragmentShaderAlignment = 0;
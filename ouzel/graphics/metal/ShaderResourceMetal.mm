@@ -87,6 +87,7 @@ namespace ouzel
                                                  const std::vector<uint8_t>& fragmentShaderData,
                                                  const std::vector<uint8_t>& vertexShaderData,
                                                  const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                                 const std::vector<Vertex::Attribute>& newVertexLayout,
                                                  const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                                                  const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                                                  uint32_t newFragmentShaderDataAlignment,
@@ -95,6 +96,8 @@ namespace ouzel
                                                  const std::string& vertexShaderFunction):
             RenderResourceMetal(renderDeviceMetal),
             vertexAttributes(newVertexAttributes),
+            vertexLayout(newVertexLayout),
+            vertexSize(Vertex::getSize(newVertexLayout)),
             fragmentShaderConstantInfo(newFragmentShaderConstantInfo),
             vertexShaderConstantInfo(newVertexShaderConstantInfo)
         {
@@ -123,7 +126,7 @@ namespace ouzel
 
             vertexDescriptor = [MTLVertexDescriptor new];
 
-            for (const Vertex::Attribute& vertexAttribute : Vertex::ATTRIBUTES)
+            for (const Vertex::Attribute& vertexAttribute : vertexLayout)
             {
                 if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
                 {
@@ -39,7 +39,7 @@ namespace ouzel
         {
             displayLink.stop();
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
         }
 
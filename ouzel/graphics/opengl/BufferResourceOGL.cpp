@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <algorithm>
 #include "BufferResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
 #include "utils/Errors.hpp"
@@ -40,6 +41,9 @@ namespace ouzel
 
                 if ((error = glGetErrorProc()) != GL_NO_ERROR)
                     throw DataError("Failed to create buffer, error: " + std::to_string(error));
+
+                capacity = size;
+                writeOffset = static_cast<GLintptr>(data.size());
             }
         }
 
@@ -52,6 +56,9 @@ namespace ouzel
         void BufferResourceOGL::reload()
         {
             bufferId = 0;
+            capacity = 0;
+            dataOffset = 0;
+            writeOffset = 0;
 
             createBuffer();
 
@@ -70,45 +77,78 @@ namespace ouzel
 
                 if ((error = glGetErrorProc()) != GL_NO_ERROR)
                     throw DataError("Failed to create buffer, error: " + std::to_string(error));
+
+                capacity = size;
+                writeOffset = static_cast<GLintptr>(data.size());
             }
         }
 
-        void BufferResourceOGL::setData(const std::vector<uint8_t>& newData)
+        void BufferResourceOGL::setData(const uint8_t* newData, uint32_t newSize)
         {
             if (!(flags & Buffer::DYNAMIC))
                 throw DataError("Buffer is not dynamic");
 
-            if (newData.empty())
+            if (!newSize)
                 throw DataError("Data is empty");
 
-            data = newData;
-
             if (!bufferId)
                 throw DataError("Buffer not initialized");
 
+            // keep a copy to restore the buffer after a context loss
+            data.assign(newData, newData + newSize);
+
+            if (static_cast<GLsizeiptr>(newSize) > size)
+                size = static_cast<GLsizeiptr>(newSize);
+
+            uploadData(newData, newSize);
+        }
+
+        void BufferResourceOGL::uploadData(const uint8_t* newData, uint32_t newSize)
+        {
             renderDevice.bindBuffer(bufferType, bufferId);
 
-            if (static_cast<GLsizeiptr>(data.size()) > size)
+            GLintptr offset = (writeOffset + DATA_ALIGNMENT - 1) & ~static_cast<GLintptr>(DATA_ALIGNMENT - 1);
+
+            if (offset + static_cast<GLsizeiptr>(newSize) > capacity)
             {
-                size = static_cast<GLsizeiptr>(data.size());
+                // orphan the storage, so that the driver does not have to wait for the draws that still use it
+                if (static_cast<GLsizeiptr>(newSize) * RING_SIZE > capacity)
+                    capacity = static_cast<GLsizeiptr>(newSize) * RING_SIZE;
 
-                glBufferDataProc(bufferType, size, data.data(),
-                                 (flags & Texture::DYNAMIC) ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW);
+                glBufferDataProc(bufferType, capacity, nullptr, GL_DYNAMIC_DRAW);
 
                 GLenum error;
 
                 if ((error = glGetErrorProc()) != GL_NO_ERROR)
                     throw DataError("Failed to create buffer, error: " + std::to_string(error));
+
+                offset = 0;
             }
-            else
-            {
-                glBufferSubDataProc(bufferType, 0, static_cast<GLsizeiptr>(data.size()), data.data());
 
-                GLenum error;
+            void* bufferData = nullptr;
 
-                if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                    throw DataError("Failed to upload buffer, error: " + std::to_string(error));
+            // the range was not written since the storage was orphaned, so it is not used by any pending draw
+            if (glMapBufferRangeProc && glUnmapBufferProc)
+                bufferData = glMapBufferRangeProc(bufferType, offset, static_cast<GLsizeiptr>(newSize),
+                                                  GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+
+            if (bufferData)
+            {
+                std::copy(newData, newData + newSize, static_cast<uint8_t*>(bufferData));
+
+                if (glUnmapBufferProc(bufferType) != GL_TRUE)
+                    throw DataError("Failed to unmap buffer");
             }
+            else
+                glBufferSubDataProc(bufferType, offset, static_cast<GLsizeiptr>(newSize), newData);
+
+            GLenum error;
+
+            if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                throw DataError("Failed to upload buffer, error: " + std::to_string(error));
+
+            dataOffset = offset;
+            writeOffset = offset + static_cast<GLintptr>(newSize);
         }
 
         void BufferResourceOGL::createBuffer()
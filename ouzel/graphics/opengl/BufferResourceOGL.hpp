@@ -29,6 +29,9 @@ namespace ouzel
         class BufferResourceOGL final: public RenderResourceOGL
         {
         public:
+            static const GLintptr DATA_ALIGNMENT = 16;
+            static const GLsizeiptr RING_SIZE = 4; // number of uploads of the same size that fit in the ring
+
             BufferResourceOGL(RenderDeviceOGL& renderDeviceOGL,
                               Buffer::Usage newUsage, uint32_t newFlags,
                               const std::vector<uint8_t>& newData,
@@ -37,17 +40,21 @@ namespace ouzel
 
             void reload() override;
 
-            void setData(const std::vector<uint8_t>& newData);
+            void setData(const uint8_t* newData, uint32_t newSize);
 
             inline uint32_t getFlags() const { return flags; }
             inline Buffer::Usage getUsage() const { return usage; }
             inline GLsizeiptr getSize() const { return size; }
 
+            // offset of the last uploaded data in the buffer, draws must add it to their buffer offsets
+            inline GLintptr getDataOffset() const { return dataOffset; }
+
             inline GLuint getBufferId() const { return bufferId; }
             inline GLuint getBufferType() const { return bufferType; }
 
         private:
             void createBuffer();
+            void uploadData(const uint8_t* newData, uint32_t newSize);
 
             Buffer::Usage usage;
             uint32_t flags = 0;
@@ -56,6 +63,11 @@ namespace ouzel
             GLuint bufferId = 0;
             GLsizeiptr size = 0;
 
+            // dynamic buffers are streamed to a ring that is orphaned when it wraps around
+            GLsizeiptr capacity = 0;
+            GLintptr dataOffset = 0;
+            GLintptr writeOffset = 0;
+
             GLuint bufferType = 0;
         };
     } // namespace graphics
@@ -150,6 +150,8 @@ PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArraysProc;
 PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
+PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
 
 PFNGLGETSTRINGIPROC glGetStringiProc;
 PFNGLPUSHGROUPMARKEREXTPROC glPushGroupMarkerEXTProc;
@@ -367,9 +369,12 @@ namespace ouzel
 
         RenderDeviceOGL::~RenderDeviceOGL()
         {
-            if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
-
             resources.clear();
+
+            for (const auto& vertexArray : vertexArrays)
+                glDeleteVertexArraysProc(1, &vertexArray.second.vertexArrayId);
+
+            if (vertexArrayId) glDeleteVertexArraysProc(1, &vertexArrayId);
         }
 
         void RenderDeviceOGL::init(Window* newWindow,
@@ -599,6 +604,9 @@ namespace ouzel
                 glUniform3uivProc = getExtProcAddress<PFNGLUNIFORM3UIVPROC>("glUniform3uiv");
                 glUniform4uivProc = getExtProcAddress<PFNGLUNIFORM4UIVPROC>("glUniform4uiv");
 
+                glVertexAttribDivisorProc = getExtProcAddress<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisor");
+                glDrawElementsInstancedProc = getExtProcAddress<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstanced");
+
 #if OUZEL_OPENGL_INTERFACE_EAGL
                 glGenVertexArraysProc = getExtProcAddress<PFNGLGENVERTEXARRAYSPROC>("glGenVertexArraysOES");
                 glBindVertexArrayProc = getExtProcAddress<PFNGLBINDVERTEXARRAYPROC>("glBindVertexArrayOES");
@@ -672,6 +680,22 @@ namespace ouzel
 #endif
                 }
 #if OUZEL_SUPPORTS_OPENGLES
+                else if (extension == "GL_EXT_instanced_arrays")
+                {
+                    if (!glVertexAttribDivisorProc)
+                    {
+                        glVertexAttribDivisorProc = getExtProcAddress<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisorEXT");
+                        glDrawElementsInstancedProc = getExtProcAddress<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstancedEXT");
+                    }
+                }
+                else if (extension == "GL_ANGLE_instanced_arrays")
+                {
+                    if (!glVertexAttribDivisorProc)
+                    {
+                        glVertexAttribDivisorProc = getExtProcAddress<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisorANGLE");
+                        glDrawElementsInstancedProc = getExtProcAddress<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstancedANGLE");
+                    }
+                }
                 else if (extension == "GL_APPLE_framebuffer_multisample")
                 {
                     multisamplingSupported = true;
@@ -706,6 +730,16 @@ namespace ouzel
                 }
 #  endif
 #else
+                else if (extension == "GL_ARB_instanced_arrays")
+                {
+                    if (!glVertexAttribDivisorProc)
+                        glVertexAttribDivisorProc = getExtProcAddress<PFNGLVERTEXATTRIBDIVISORPROC>("glVertexAttribDivisorARB");
+                }
+                else if (extension == "GL_ARB_draw_instanced")
+                {
+                    if (!glDrawElementsInstancedProc)
+                        glDrawElementsInstancedProc = getExtProcAddress<PFNGLDRAWELEMENTSINSTANCEDPROC>("glDrawElementsInstancedARB");
+                }
                 else if (extension == "GL_ARB_copy_image")
                     glCopyImageSubDataProc = getExtProcAddress<PFNGLCOPYIMAGESUBDATAPROC>("glCopyImageSubData");
                 else if (extension == "GL_ARB_vertex_array_object")
@@ -741,6 +775,7 @@ namespace ouzel
             }
 
             if (!multisamplingSupported) sampleCount = 1;
+            instancingSupported = glVertexAttribDivisorProc && glDrawElementsInstancedProc;
 
             glDisableProc(GL_DITHER);
 
@@ -770,10 +805,10 @@ namespace ouzel
             {
                 glGenVertexArraysProc(1, &vertexArrayId);
 
-                glBindVertexArrayProc(vertexArrayId);
-
                 if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                    throw DataError("Failed to bind vertex array, error: " + std::to_string(error));
+                    throw DataError("Failed to create vertex array, error: " + std::to_string(error));
+
+                bindVertexArray(vertexArrayId);
             }
         }
 
@@ -876,6 +911,197 @@ namespace ouzel
             }
         }
 
+        void RenderDeviceOGL::setVertexArray(const BufferResourceOGL& indexBuffer,
+                                             const BufferResourceOGL& vertexBuffer,
+                                             const BufferResourceOGL* instanceBuffer,
+                                             const ShaderResourceOGL& shader)
+        {
+            // vertex array objects are not supported, set up the attributes for every draw
+            if (!vertexArrayId)
+            {
+                bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.getBufferId());
+                bindBuffer(GL_ARRAY_BUFFER, vertexBuffer.getBufferId());
+                setVertexAttributes(shader, vertexBuffer.getDataOffset(), true);
+
+                if (instanceBuffer)
+                {
+                    bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+                    setInstanceAttributes(shader, instanceBuffer->getDataOffset(), true);
+                }
+                return;
+            }
+
+            auto key = std::make_tuple(vertexBuffer.getBufferId(),
+                                       indexBuffer.getBufferId(),
+                                       instanceBuffer ? instanceBuffer->getBufferId() : 0,
+                                       shader.getProgramId());
+            auto vertexArrayIterator = vertexArrays.find(key);
+
+            if (vertexArrayIterator == vertexArrays.end())
+            {
+                VertexArray vertexArray;
+                glGenVertexArraysProc(1, &vertexArray.vertexArrayId);
+
+                GLenum error;
+
+                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                    throw DataError("Failed to create vertex array, error: " + std::to_string(error));
+
+                vertexArray.vertexOffset = vertexBuffer.getDataOffset();
+                vertexArray.instanceOffset = instanceBuffer ? instanceBuffer->getDataOffset() : 0;
+                vertexArrays[key] = vertexArray;
+
+                bindVertexArray(vertexArray.vertexArrayId);
+
+                // bypass the state cache, it tracks the element array buffer of the default vertex array
+                glBindBufferProc(GL_ELEMENT_ARRAY_BUFFER, indexBuffer.getBufferId());
+                bindBuffer(GL_ARRAY_BUFFER, vertexBuffer.getBufferId());
+                setVertexAttributes(shader, vertexArray.vertexOffset, true);
+
+                if (instanceBuffer)
+                {
+                    bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+                    setInstanceAttributes(shader, vertexArray.instanceOffset, true);
+                }
+            }
+            else
+            {
+                VertexArray& vertexArray = vertexArrayIterator->second;
+
+                bindVertexArray(vertexArray.vertexArrayId);
+
+                // dynamic buffers move their data on every upload
+                if (vertexArray.vertexOffset != vertexBuffer.getDataOffset())
+                {
+                    vertexArray.vertexOffset = vertexBuffer.getDataOffset();
+                    bindBuffer(GL_ARRAY_BUFFER, vertexBuffer.getBufferId());
+                    setVertexAttributes(shader, vertexArray.vertexOffset, false);
+                }
+
+                if (instanceBuffer && vertexArray.instanceOffset != instanceBuffer->getDataOffset())
+                {
+                    vertexArray.instanceOffset = instanceBuffer->getDataOffset();
+                    bindBuffer(GL_ARRAY_BUFFER, instanceBuffer->getBufferId());
+                    setInstanceAttributes(shader, vertexArray.instanceOffset, false);
+                }
+            }
+        }
+
+        void RenderDeviceOGL::setVertexAttributes(const ShaderResourceOGL& shader,
+                                                  GLintptr vertexOffset,
+                                                  bool enable)
+        {
+            const std::set<Vertex::Attribute::Usage>& vertexAttributes = shader.getVertexAttributes();
+            GLuint index = 0;
+
+            // attribute locations are bound in the order of the vertex layout, skipping the unused attributes
+            for (const Vertex::Attribute& vertexAttribute : shader.getVertexLayout())
+            {
+                if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
+                {
+                    if (enable) glEnableVertexAttribArrayProc(index);
+                    glVertexAttribPointerProc(index,
+                                              getArraySize(vertexAttribute.dataType),
+                                              getVertexFormat(vertexAttribute.dataType),
+                                              isNormalized(vertexAttribute.dataType),
+                                              static_cast<GLsizei>(shader.getVertexSize()),
+                                              static_cast<const GLchar*>(nullptr) + vertexOffset);
+                    ++index;
+                }
+
+                vertexOffset += getDataTypeSize(vertexAttribute.dataType);
+            }
+
+            GLenum error;
+
+            if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                throw DataError("Failed to update vertex attributes, error: " + std::to_string(error));
+        }
+
+        static GLuint getInstanceAttributeIndex(const ShaderResourceOGL& shader)
+        {
+            const std::set<Vertex::Attribute::Usage>& vertexAttributes = shader.getVertexAttributes();
+            GLuint index = 0;
+
+            for (const Vertex::Attribute& vertexAttribute : shader.getVertexLayout())
+                if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
+                    ++index;
+
+            return index;
+        }
+
+        void RenderDeviceOGL::setInstanceAttributes(const ShaderResourceOGL& shader,
+                                                    GLintptr instanceOffset,
+                                                    bool enable)
+        {
+            const std::set<Vertex::Attribute::Usage>& vertexAttributes = shader.getVertexAttributes();
+            GLuint index = getInstanceAttributeIndex(shader);
+
+            // instance attribute locations follow the vertex attribute locations
+            for (const Vertex::Attribute& instanceAttribute : Instance::ATTRIBUTES)
+            {
+                if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+                {
+                    if (enable)
+                    {
+                        glEnableVertexAttribArrayProc(index);
+                        glVertexAttribDivisorProc(index, 1);
+                    }
+
+                    glVertexAttribPointerProc(index,
+                                              getArraySize(instanceAttribute.dataType),
+                                              getVertexFormat(instanceAttribute.dataType),
+                                              isNormalized(instanceAttribute.dataType),
+                                              static_cast<GLsizei>(sizeof(Instance)),
+                                              static_cast<const GLchar*>(nullptr) + instanceOffset);
+                    ++index;
+                }
+
+                instanceOffset += getDataTypeSize(instanceAttribute.dataType);
+            }
+
+            GLenum error;
+
+            if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                throw DataError("Failed to update instance attributes, error: " + std::to_string(error));
+        }
+
+        void RenderDeviceOGL::resetInstanceAttributes(const ShaderResourceOGL& shader)
+        {
+            const std::set<Vertex::Attribute::Usage>& vertexAttributes = shader.getVertexAttributes();
+            GLuint index = getInstanceAttributeIndex(shader);
+
+            for (const Vertex::Attribute& instanceAttribute : Instance::ATTRIBUTES)
+            {
+                if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+                {
+                    glVertexAttribDivisorProc(index, 0);
+                    glDisableVertexAttribArrayProc(index);
+                    ++index;
+                }
+            }
+        }
+
+        void RenderDeviceOGL::deleteVertexArrays(GLuint bufferId, GLuint programId)
+        {
+            for (auto i = vertexArrays.begin(); i != vertexArrays.end();)
+            {
+                if ((bufferId && (std::get<0>(i->first) == bufferId ||
+                                  std::get<1>(i->first) == bufferId ||
+                                  std::get<2>(i->first) == bufferId)) ||
+                    (programId && std::get<3>(i->first) == programId))
+                {
+                    if (stateCache.vertexArrayId == i->second.vertexArrayId)
+                        bindVertexArray(vertexArrayId);
+
+                    glDeleteVertexArraysProc(1, &i->second.vertexArrayId);
+                    i = vertexArrays.erase(i);
+                }
+                else
+                    ++i;
+            }
+        }
+
         void RenderDeviceOGL::process()
         {
             RenderDevice::process();
@@ -887,19 +1113,14 @@ namespace ouzel
 
             for (;;)
             {
-                std::unique_lock<std::mutex> lock(commandQueueMutex);
-                while (commandQueue.empty()) commandQueueCondition.wait(lock);
-                commandBuffer = std::move(commandQueue.front());
-                commandQueue.pop();
-                lock.unlock();
+                commandBuffer = waitForCommandBuffer();
 
-                std::unique_ptr<Command> command;
+                bool presented = false;
 
-                while (!commandBuffer.commands.empty())
-                {
-                    command = std::move(commandBuffer.commands.front());
-                    commandBuffer.commands.pop();
+                CommandReader commandReader(commandBuffer);
 
+                while (const Command* command = commandReader.next())
+                {
                     switch (command->type)
                     {
                         case Command::Type::PRESENT:
@@ -910,14 +1131,14 @@ namespace ouzel
 
                         case Command::Type::DELETE_RESOURCE:
                         {
-                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command.get());
+                            const DeleteResourceCommand* deleteResourceCommand = static_cast<const DeleteResourceCommand*>(command);
                             resources[deleteResourceCommand->resource - 1].reset();
                             break;
                         }
 
                         case Command::Type::SET_RENDER_TARGET:
                         {
-                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command.get());
+                            const SetRenderTargetCommand* setRenderTargetCommand = static_cast<const SetRenderTargetCommand*>(command);
 
                             GLuint newFrameBufferId = 0;
 
@@ -940,7 +1161,7 @@ namespace ouzel
 
                         case Command::Type::SET_RENDER_TARGET_PARAMETERS:
                         {
-                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command.get());
+                            const SetRenderTargetParametersCommand* setRenderTargetParametersCommand = static_cast<const SetRenderTargetParametersCommand*>(command);
 
                             if (setRenderTargetParametersCommand->renderTarget)
                             {
@@ -963,7 +1184,7 @@ namespace ouzel
 
                         case Command::Type::CLEAR_RENDER_TARGET:
                         {
-                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command.get());
+                            const ClearRenderTargetCommand* clearCommand = static_cast<const ClearRenderTargetCommand*>(command);
 
                             GLuint newFrameBufferId = 0;
                             GLbitfield newClearMask = 0;
@@ -1029,7 +1250,7 @@ namespace ouzel
                         case Command::Type::BLIT:
                         {
 #if !OUZEL_SUPPORTS_OPENGLES
-                            const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command.get());
+                            const BlitCommand* blitCommand = static_cast<const BlitCommand*>(command);
 
                             TextureResourceOGL* sourceTextureOGL = static_cast<TextureResourceOGL*>(resources[blitCommand->sourceTexture - 1].get());
                             TextureResourceOGL* destinationTextureOGL = static_cast<TextureResourceOGL*>(resources[blitCommand->destinationTexture - 1].get());
@@ -1057,7 +1278,7 @@ namespace ouzel
 
                         case Command::Type::SET_CULL_MODE:
                         {
-                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command.get());
+                            const SetCullModeCommad* setCullModeCommad = static_cast<const SetCullModeCommad*>(command);
 
                             GLenum cullFace = GL_NONE;
 
@@ -1076,7 +1297,7 @@ namespace ouzel
 
                         case Command::Type::SET_FILL_MODE:
                         {
-                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command.get());
+                            const SetFillModeCommad* setFillModeCommad = static_cast<const SetFillModeCommad*>(command);
 
 #if OUZEL_SUPPORTS_OPENGLES
                             if (setFillModeCommad->fillMode != FillMode::SOLID)
@@ -1098,7 +1319,7 @@ namespace ouzel
 
                         case Command::Type::SET_SCISSOR_TEST:
                         {
-                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command.get());
+                            const SetScissorTestCommand* setScissorTestCommand = static_cast<const SetScissorTestCommand*>(command);
 
                             setScissorTest(setScissorTestCommand->enabled,
                                            static_cast<GLint>(setScissorTestCommand->rectangle.position.x),
@@ -1111,7 +1332,7 @@ namespace ouzel
 
                         case Command::Type::SET_VIEWPORT:
                         {
-                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command.get());
+                            const SetViewportCommand* setViewportCommand = static_cast<const SetViewportCommand*>(command);
 
                             setViewport(static_cast<GLint>(setViewportCommand->viewport.position.x),
                                         static_cast<GLint>(setViewportCommand->viewport.position.y),
@@ -1123,7 +1344,7 @@ namespace ouzel
 
                         case Command::Type::INIT_DEPTH_STENCIL_STATE:
                         {
-                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command.get());
+                            const InitDepthStencilStateCommand* initDepthStencilStateCommand = static_cast<const InitDepthStencilStateCommand*>(command);
                             std::unique_ptr<DepthStencilStateResourceOGL> depthStencilStateResourceOGL(new DepthStencilStateResourceOGL(*this,
                                                                                                                                         initDepthStencilStateCommand->depthTest,
                                                                                                                                         initDepthStencilStateCommand->depthWrite,
@@ -1137,7 +1358,7 @@ namespace ouzel
 
                         case Command::Type::SET_DEPTH_STENCIL_STATE:
                         {
-                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command.get());
+                            const SetDepthStencilStateCommand* setDepthStencilStateCommand = static_cast<const SetDepthStencilStateCommand*>(command);
 
                             if (setDepthStencilStateCommand->depthStencilState)
                             {
@@ -1159,7 +1380,7 @@ namespace ouzel
 
                         case Command::Type::SET_PIPELINE_STATE:
                         {
-                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command.get());
+                            const SetPipelineStateCommand* setPipelineStateCommand = static_cast<const SetPipelineStateCommand*>(command);
 
                             BlendStateResourceOGL* blendStateOGL = static_cast<BlendStateResourceOGL*>(resources[setPipelineStateCommand->blendState - 1].get());
                             ShaderResourceOGL* shaderOGL = static_cast<ShaderResourceOGL*>(resources[setPipelineStateCommand->shader - 1].get());
@@ -1199,7 +1420,7 @@ namespace ouzel
 
                         case Command::Type::DRAW:
                         {
-                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command.get());
+                            const DrawCommand* drawCommand = static_cast<const DrawCommand*>(command);
 
                             // mesh buffer
                             BufferResourceOGL* indexBufferOGL = static_cast<BufferResourceOGL*>(resources[drawCommand->indexBuffer - 1].get());
@@ -1223,30 +1444,10 @@ namespace ouzel
                                 default: throw DataError("Invalid draw mode");
                             }
 
-                            bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBufferOGL->getBufferId());
-                            bindBuffer(GL_ARRAY_BUFFER, vertexBufferOGL->getBufferId());
-
-                            GLuint vertexOffset = 0;
-
-                            for (GLuint index = 0; index < Vertex::ATTRIBUTES.size(); ++index)
-                            {
-                                const Vertex::Attribute& vertexAttribute = Vertex::ATTRIBUTES[index];
-
-                                glEnableVertexAttribArrayProc(index);
-                                glVertexAttribPointerProc(index,
-                                                          getArraySize(vertexAttribute.dataType),
-                                                          getVertexFormat(vertexAttribute.dataType),
-                                                          isNormalized(vertexAttribute.dataType),
-                                                          static_cast<GLsizei>(sizeof(Vertex)),
-                                                          static_cast<const GLchar*>(nullptr) + vertexOffset);
-
-                                vertexOffset += getDataTypeSize(vertexAttribute.dataType);
-                            }
-
-                            GLenum error;
+                            if (!currentShader)
+                                throw DataError("No shader set");
 
-                            if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                                throw DataError("Failed to update vertex attributes, error: " + std::to_string(error));
+                            setVertexArray(*indexBufferOGL, *vertexBufferOGL, nullptr, *currentShader);
 
                             assert(drawCommand->indexCount);
                             assert(indexBufferOGL->getSize());
@@ -1264,17 +1465,86 @@ namespace ouzel
                             glDrawElementsProc(mode,
                                                static_cast<GLsizei>(drawCommand->indexCount),
                                                indexType,
-                                               static_cast<const char*>(nullptr) + (drawCommand->startIndex * drawCommand->indexSize));
+                                               static_cast<const char*>(nullptr) + indexBufferOGL->getDataOffset() + (drawCommand->startIndex * drawCommand->indexSize));
 
-                            if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                                throw DataError("Failed to draw elements, error: " + std::to_string(error));
+                            if (debugRenderer)
+                            {
+                                GLenum error;
+
+                                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                                    throw DataError("Failed to draw elements, error: " + std::to_string(error));
+                            }
+
+                            break;
+                        }
+
+                        case Command::Type::DRAW_INSTANCED:
+                        {
+                            const DrawInstancedCommand* drawInstancedCommand = static_cast<const DrawInstancedCommand*>(command);
+
+                            if (!instancingSupported)
+                                throw DataError("Instanced drawing is not supported");
+
+                            BufferResourceOGL* indexBufferOGL = static_cast<BufferResourceOGL*>(resources[drawInstancedCommand->indexBuffer - 1].get());
+                            BufferResourceOGL* vertexBufferOGL = static_cast<BufferResourceOGL*>(resources[drawInstancedCommand->vertexBuffer - 1].get());
+                            BufferResourceOGL* instanceBufferOGL = static_cast<BufferResourceOGL*>(resources[drawInstancedCommand->instanceBuffer - 1].get());
+
+                            assert(indexBufferOGL);
+                            assert(indexBufferOGL->getBufferId());
+                            assert(vertexBufferOGL);
+                            assert(vertexBufferOGL->getBufferId());
+                            assert(instanceBufferOGL);
+                            assert(instanceBufferOGL->getBufferId());
+
+                            GLenum mode;
+
+                            switch (drawInstancedCommand->drawMode)
+                            {
+                                case DrawMode::POINT_LIST: mode = GL_POINTS; break;
+                                case DrawMode::LINE_LIST: mode = GL_LINES; break;
+                                case DrawMode::LINE_STRIP: mode = GL_LINE_STRIP; break;
+                                case DrawMode::TRIANGLE_LIST: mode = GL_TRIANGLES; break;
+                                case DrawMode::TRIANGLE_STRIP: mode = GL_TRIANGLE_STRIP; break;
+                                default: throw DataError("Invalid draw mode");
+                            }
+
+                            if (!currentShader)
+                                throw DataError("No shader set");
+
+                            setVertexArray(*indexBufferOGL, *vertexBufferOGL, instanceBufferOGL, *currentShader);
+
+                            GLenum indexType;
+
+                            switch (drawInstancedCommand->indexSize)
+                            {
+                                case 2: indexType = GL_UNSIGNED_SHORT; break;
+                                case 4: indexType = GL_UNSIGNED_INT; break;
+                                default: throw DataError("Invalid index size");
+                            }
+
+                            glDrawElementsInstancedProc(mode,
+                                                        static_cast<GLsizei>(drawInstancedCommand->indexCount),
+                                                        indexType,
+                                                        static_cast<const char*>(nullptr) + indexBufferOGL->getDataOffset() + (drawInstancedCommand->startIndex * drawInstancedCommand->indexSize),
+                                                        static_cast<GLsizei>(drawInstancedCommand->instanceCount));
+
+                            if (debugRenderer)
+                            {
+                                GLenum error;
+
+                                if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                                    throw DataError("Failed to draw instanced elements, error: " + std::to_string(error));
+                            }
+
+                            // without vertex arrays the divisors would leak into the following draws
+                            if (!vertexArrayId) resetInstanceAttributes(*currentShader);
 
                             break;
                         }
 
                         case Command::Type::PUSH_DEBUG_MARKER:
                         {
-                            const PushDebugMarkerCommand* pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command.get());
+                            const PushDebugMarkerCommand* pushDebugMarkerCommand = static_cast<const PushDebugMarkerCommand*>(command);
                             if (glPushGroupMarkerEXTProc) glPushGroupMarkerEXTProc(0, pushDebugMarkerCommand->name.c_str());
                             break;
                         }
@@ -1287,7 +1557,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BLEND_STATE:
                         {
-                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command.get());
+                            const InitBlendStateCommand* initBlendStateCommand = static_cast<const InitBlendStateCommand*>(command);
 
                             std::unique_ptr<BlendStateResourceOGL> blendStateResourceOGL(new BlendStateResourceOGL(*this,
                                                                                                                    initBlendStateCommand->enableBlending,
@@ -1307,7 +1577,7 @@ namespace ouzel
 
                         case Command::Type::INIT_BUFFER:
                         {
-                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command.get());
+                            const InitBufferCommand* initBufferCommand = static_cast<const InitBufferCommand*>(command);
 
                             std::unique_ptr<BufferResourceOGL> bufferResourceOGL(new BufferResourceOGL(*this,
                                                                                                        initBufferCommand->usage,
@@ -1323,21 +1593,23 @@ namespace ouzel
 
                         case Command::Type::SET_BUFFER_DATA:
                         {
-                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command.get());
+                            const SetBufferDataCommand* setBufferDataCommand = static_cast<const SetBufferDataCommand*>(command);
 
                             BufferResourceOGL* bufferResourceOGL = static_cast<BufferResourceOGL*>(resources[setBufferDataCommand->buffer - 1].get());
-                            bufferResourceOGL->setData(setBufferDataCommand->data);
+                            bufferResourceOGL->setData(commandReader.getCommandBuffer().getBufferData(setBufferDataCommand->dataOffset),
+                                                       setBufferDataCommand->dataSize);
                             break;
                         }
 
                         case Command::Type::INIT_SHADER:
                         {
-                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command.get());
+                            const InitShaderCommand* initShaderCommand = static_cast<const InitShaderCommand*>(command);
 
                             std::unique_ptr<ShaderResourceOGL> shaderResourceOGL(new ShaderResourceOGL(*this,
                                                                                                        initShaderCommand->fragmentShader,
                                                                                                        initShaderCommand->vertexShader,
                                                                                                        initShaderCommand->vertexAttributes,
+                                                                                                       initShaderCommand->vertexLayout,
                                                                                                        initShaderCommand->fragmentShaderConstantInfo,
                                                                                                        initShaderCommand->vertexShaderConstantInfo,
                                                                                                        initShaderCommand->fragmentShaderDataAlignment,
@@ -1353,49 +1625,69 @@ namespace ouzel
 
                         case Command::Type::SET_SHADER_CONSTANTS:
                         {
-                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command.get());
+                            const SetShaderConstantsCommand* setShaderConstantsCommand = static_cast<const SetShaderConstantsCommand*>(command);
 
                             if (!currentShader)
                                 throw DataError("No shader set");
 
                             // pixel shader constants
                             const std::vector<ShaderResourceOGL::Location>& fragmentShaderConstantLocations = currentShader->getFragmentShaderConstantLocations();
+                            const float* fragmentShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->fragmentShaderConstantOffset);
+                            uint32_t fragmentShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->fragmentShaderConstants.size() > fragmentShaderConstantLocations.size())
-                                throw DataError("Invalid pixel shader constant size");
-
-                            for (size_t i = 0; i < setShaderConstantsCommand->fragmentShaderConstants.size(); ++i)
+                            for (size_t i = 0; i < fragmentShaderConstantLocations.size() &&
+                                 fragmentShaderConstantOffset < setShaderConstantsCommand->fragmentShaderConstantSize; ++i)
                             {
                                 const ShaderResourceOGL::Location& fragmentShaderConstantLocation = fragmentShaderConstantLocations[i];
-                                const std::vector<float>& fragmentShaderConstant = setShaderConstantsCommand->fragmentShaderConstants[i];
+                                uint32_t size = getDataTypeSize(fragmentShaderConstantLocation.dataType) / sizeof(float);
 
-                                setUniform(fragmentShaderConstantLocation.location,
-                                           fragmentShaderConstantLocation.dataType,
-                                           fragmentShaderConstant.data());
+                                if (fragmentShaderConstantOffset + size > setShaderConstantsCommand->fragmentShaderConstantSize)
+                                    throw DataError("Invalid pixel shader constant size");
+
+                                const float* fragmentShaderConstant = fragmentShaderConstants + fragmentShaderConstantOffset;
+                                fragmentShaderConstantOffset += size;
+
+                                if (currentShader->updateFragmentShaderConstant(i, fragmentShaderConstant, size))
+                                    setUniform(fragmentShaderConstantLocation.location,
+                                               fragmentShaderConstantLocation.dataType,
+                                               fragmentShaderConstant);
                             }
 
+                            if (fragmentShaderConstantOffset != setShaderConstantsCommand->fragmentShaderConstantSize)
+                                throw DataError("Invalid pixel shader constant size");
+
                             // vertex shader constants
                             const std::vector<ShaderResourceOGL::Location>& vertexShaderConstantLocations = currentShader->getVertexShaderConstantLocations();
+                            const float* vertexShaderConstants = commandReader.getCommandBuffer().getShaderConstants(setShaderConstantsCommand->vertexShaderConstantOffset);
+                            uint32_t vertexShaderConstantOffset = 0;
 
-                            if (setShaderConstantsCommand->vertexShaderConstants.size() > vertexShaderConstantLocations.size())
-                                throw DataError("Invalid vertex shader constant size");
-
-                            for (size_t i = 0; i < setShaderConstantsCommand->vertexShaderConstants.size(); ++i)
+                            for (size_t i = 0; i < vertexShaderConstantLocations.size() &&
+                                 vertexShaderConstantOffset < setShaderConstantsCommand->vertexShaderConstantSize; ++i)
                             {
                                 const ShaderResourceOGL::Location& vertexShaderConstantLocation = vertexShaderConstantLocations[i];
-                                const std::vector<float>& vertexShaderConstant = setShaderConstantsCommand->vertexShaderConstants[i];
+                                uint32_t size = getDataTypeSize(vertexShaderConstantLocation.dataType) / sizeof(float);
+
+                                if (vertexShaderConstantOffset + size > setShaderConstantsCommand->vertexShaderConstantSize)
+                                    throw DataError("Invalid vertex shader constant size");
+
+                                const float* vertexShaderConstant = vertexShaderConstants + vertexShaderConstantOffset;
+                                vertexShaderConstantOffset += size;
 
-                                setUniform(vertexShaderConstantLocation.location,
-                                           vertexShaderConstantLocation.dataType,
-                                           vertexShaderConstant.data());
+                                if (currentShader->updateVertexShaderConstant(i, vertexShaderConstant, size))
+                                    setUniform(vertexShaderConstantLocation.location,
+                                               vertexShaderConstantLocation.dataType,
+                                               vertexShaderConstant);
                             }
 
+                            if (vertexShaderConstantOffset != setShaderConstantsCommand->vertexShaderConstantSize)
+                                throw DataError("Invalid vertex shader constant size");
+
                             break;
                         }
 
                         case Command::Type::INIT_TEXTURE:
                         {
-                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command.get());
+                            const InitTextureCommand* initTextureCommand = static_cast<const InitTextureCommand*>(command);
 
                             std::unique_ptr<TextureResourceOGL> textureResourceOGL(new TextureResourceOGL(*this,
                                                                                                           initTextureCommand->levels,
@@ -1411,7 +1703,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_DATA:
                         {
-                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command.get());
+                            const SetTextureDataCommand* setTextureDataCommand = static_cast<const SetTextureDataCommand*>(command);
 
                             TextureResourceOGL* textureResourceOGL = static_cast<TextureResourceOGL*>(resources[setTextureDataCommand->texture - 1].get());
                             textureResourceOGL->setData(setTextureDataCommand->levels);
@@ -1421,7 +1713,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURE_PARAMETERS:
                         {
-                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command.get());
+                            const SetTextureParametersCommand* setTextureParametersCommand = static_cast<const SetTextureParametersCommand*>(command);
 
                             TextureResourceOGL* textureResourceOGL = static_cast<TextureResourceOGL*>(resources[setTextureParametersCommand->texture - 1].get());
                             textureResourceOGL->setFilter(setTextureParametersCommand->filter);
@@ -1433,7 +1725,7 @@ namespace ouzel
 
                         case Command::Type::SET_TEXTURES:
                         {
-                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command.get());
+                            const SetTexturesCommand* setTexturesCommand = static_cast<const SetTexturesCommand*>(command);
 
                             for (uint32_t layer = 0; layer < Texture::LAYERS; ++layer)
                             {
@@ -1453,7 +1745,19 @@ namespace ouzel
                             throw SystemError("Invalid command");
                     }
 
-                    if (command->type == Command::Type::PRESENT) return;
+                    if (command->type == Command::Type::PRESENT)
+                    {
+                        presented = true;
+                        break;
+                    }
+                }
+
+                recycleCommandBuffer(std::move(commandBuffer));
+
+                if (presented)
+                {
+                    finishFrame();
+                    return;
                 }
             }
         }
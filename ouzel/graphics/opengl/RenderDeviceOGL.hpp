@@ -13,6 +13,7 @@
 #include <map>
 #include <memory>
 #include <queue>
+#include <tuple>
 #include <utility>
 #include <vector>
 
@@ -133,6 +134,8 @@ extern PFNGLDELETEVERTEXARRAYSPROC glDeleteVertexArraysProc;
 extern PFNGLENABLEVERTEXATTRIBARRAYPROC glEnableVertexAttribArrayProc;
 extern PFNGLDISABLEVERTEXATTRIBARRAYPROC glDisableVertexAttribArrayProc;
 extern PFNGLVERTEXATTRIBPOINTERPROC glVertexAttribPointerProc;
+extern PFNGLVERTEXATTRIBDIVISORPROC glVertexAttribDivisorProc;
+extern PFNGLDRAWELEMENTSINSTANCEDPROC glDrawElementsInstancedProc;
 
 extern PFNGLGETSTRINGIPROC glGetStringiProc;
 extern PFNGLPUSHGROUPMARKEREXTPROC glPushGroupMarkerEXTProc;
@@ -140,12 +143,15 @@ extern PFNGLPOPGROUPMARKEREXTPROC glPopGroupMarkerEXTProc;
 
 #include "graphics/RenderDevice.hpp"
 #include "graphics/opengl/ShaderResourceOGL.hpp"
+#include "graphics/Vertex.hpp"
 #include "utils/Errors.hpp"
 
 namespace ouzel
 {
     namespace graphics
     {
+        class BufferResourceOGL;
+
         class RenderDeviceOGL: public RenderDevice
         {
             friend Renderer;
@@ -163,9 +169,12 @@ namespace ouzel
                     glBindTextureProc(GL_TEXTURE_2D, textureId);
                     stateCache.textureId[layer] = textureId;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to bind texture, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to bind texture, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -176,9 +185,12 @@ namespace ouzel
                     glUseProgramProc(programId);
                     stateCache.programId = programId;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to bind program, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to bind program, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -189,14 +201,38 @@ namespace ouzel
                     glBindFramebufferProc(GL_FRAMEBUFFER, bufferId);
                     stateCache.frameBufferId = bufferId;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to bind frame buffer, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to bind frame buffer, error: " + std::to_string(error));
+                    }
+                }
+            }
+
+            inline void bindVertexArray(GLuint newVertexArrayId)
+            {
+                if (stateCache.vertexArrayId != newVertexArrayId)
+                {
+                    glBindVertexArrayProc(newVertexArrayId);
+                    stateCache.vertexArrayId = newVertexArrayId;
+
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to bind vertex array, error: " + std::to_string(error));
+                    }
                 }
             }
 
             inline void bindBuffer(GLuint bufferType, GLuint bufferId)
             {
+                // the element array buffer binding is a part of the vertex array state, so the cached vertex
+                // arrays are never changed and the state cache tracks only the default vertex array's binding
+                if (bufferType == GL_ELEMENT_ARRAY_BUFFER)
+                    bindVertexArray(vertexArrayId);
+
                 GLuint& currentBufferId = stateCache.bufferId[bufferType];
 
                 if (currentBufferId != bufferId)
@@ -204,9 +240,12 @@ namespace ouzel
                     glBindBufferProc(bufferType, bufferId);
                     currentBufferId = bufferId;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to bind element array buffer, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to bind element array buffer, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -223,9 +262,12 @@ namespace ouzel
                     else
                         glDisableProc(GL_SCISSOR_TEST);
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set scissor test, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set scissor test, error: " + std::to_string(error));
+                    }
 
                     stateCache.scissorTestEnabled = scissorTestEnabled;
                 }
@@ -244,9 +286,12 @@ namespace ouzel
                         stateCache.scissorHeight = height;
                     }
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set scissor test, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set scissor test, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -259,9 +304,12 @@ namespace ouzel
                     else
                         glDisableProc(GL_DEPTH_TEST);
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to change depth test state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to change depth test state, error: " + std::to_string(error));
+                    }
 
                     stateCache.depthTestEnabled = enable;
                 }
@@ -273,9 +321,12 @@ namespace ouzel
                 {
                     glDepthMaskProc(flag);
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to change depth mask state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to change depth mask state, error: " + std::to_string(error));
+                    }
 
                     stateCache.depthMask = flag;
                 }
@@ -287,9 +338,12 @@ namespace ouzel
                 {
                     glDepthFuncProc(depthFunc);
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to change depth test state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to change depth test state, error: " + std::to_string(error));
+                    }
 
                     stateCache.depthFunc = depthFunc;
                 }
@@ -311,9 +365,12 @@ namespace ouzel
                     stateCache.viewportWidth = width;
                     stateCache.viewportHeight = height;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set viewport, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set viewport, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -334,9 +391,12 @@ namespace ouzel
 
                     stateCache.blendEnabled = blendEnabled;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to enable blend state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to enable blend state, error: " + std::to_string(error));
+                    }
                 }
 
                 if (blendEnabled)
@@ -367,9 +427,12 @@ namespace ouzel
                         stateCache.blendDestFactorAlpha = dfactorAlpha;
                     }
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set blend state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set blend state, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -390,9 +453,12 @@ namespace ouzel
                     stateCache.blueMask = blueMask;
                     stateCache.alphaMask = alphaMask;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set color mask, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set color mask, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -408,9 +474,12 @@ namespace ouzel
 
                     stateCache.cullEnabled = cullEnabled;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    }
                 }
 
                 if (cullEnabled)
@@ -421,9 +490,12 @@ namespace ouzel
                         stateCache.cullFace = cullFace;
                     }
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set cull face, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set cull face, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -439,9 +511,12 @@ namespace ouzel
 
                     stateCache.clearDepth = clearDepthValue;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    }
                 }
             }
 
@@ -456,14 +531,22 @@ namespace ouzel
 
                     stateCache.clearColor = clearColorValue;
 
-                    GLenum error;
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to enable cull face, error: " + std::to_string(error));
+                    }
                 }
             }
 
             void deleteBuffer(GLuint bufferId)
             {
+                deleteVertexArrays(bufferId, 0);
+
+                // deleting a buffer detaches it only from the bound vertex array
+                bindVertexArray(vertexArrayId);
+
                 GLuint& elementArrayBufferId = stateCache.bufferId[GL_ELEMENT_ARRAY_BUFFER];
                 if (elementArrayBufferId == bufferId) elementArrayBufferId = 0;
                 GLuint& arrayBufferId = stateCache.bufferId[GL_ARRAY_BUFFER];
@@ -484,6 +567,8 @@ namespace ouzel
 
             void deleteProgram(GLuint programId)
             {
+                deleteVertexArrays(0, programId);
+
                 if (stateCache.programId == programId) stateCache.programId = 0;
                 glDeleteProgramProc(programId);
             }
@@ -507,10 +592,12 @@ namespace ouzel
 
                     stateCache.polygonFillMode = polygonFillMode;
 
-                    GLenum error;
-
-                    if ((error = glGetErrorProc()) != GL_NO_ERROR)
-                        throw SystemError("Failed to set blend state, error: " + std::to_string(error));
+                    if (debugRenderer)
+                    {
+                        GLenum error;
+                        if ((error = glGetErrorProc()) != GL_NO_ERROR)
+                            throw SystemError("Failed to set blend state, error: " + std::to_string(error));
+                    }
                 }
             }
 #endif
@@ -538,10 +625,36 @@ namespace ouzel
             virtual void present();
             void generateScreenshot(const std::string& filename) override;
 
+            // instanceBuffer is nullptr for draws that are not instanced
+            void setVertexArray(const BufferResourceOGL& indexBuffer,
+                                const BufferResourceOGL& vertexBuffer,
+                                const BufferResourceOGL* instanceBuffer,
+                                const ShaderResourceOGL& shader);
+            void setVertexAttributes(const ShaderResourceOGL& shader,
+                                     GLintptr vertexOffset,
+                                     bool enable);
+            void setInstanceAttributes(const ShaderResourceOGL& shader,
+                                       GLintptr instanceOffset,
+                                       bool enable);
+            // restores the per-vertex state of the instance attributes, used when vertex arrays are not supported
+            void resetInstanceAttributes(const ShaderResourceOGL& shader);
+            // deletes the vertex arrays that use the buffer or the program
+            void deleteVertexArrays(GLuint bufferId, GLuint programId);
+
             GLuint frameBufferId = 0;
             GLsizei frameBufferWidth = 0;
             GLsizei frameBufferHeight = 0;
-            GLuint vertexArrayId = 0;
+            GLuint vertexArrayId = 0; // default vertex array, used for buffer uploads
+
+            struct VertexArray
+            {
+                GLuint vertexArrayId;
+                GLintptr vertexOffset; // vertex buffer offset the attribute pointers were set up with
+                GLintptr instanceOffset; // instance buffer offset the attribute pointers were set up with
+            };
+
+            // vertex array objects by vertex buffer, index buffer, instance buffer and program, the program defines the vertex layout
+            std::map<std::tuple<GLuint, GLuint, GLuint, GLuint>, VertexArray> vertexArrays;
 
             GLbitfield clearMask = 0;
             std::array<GLfloat, 4> frameBufferClearColor;
@@ -562,6 +675,7 @@ namespace ouzel
                 GLuint textureId[Texture::LAYERS];
                 GLuint programId = 0;
                 GLuint frameBufferId = 0;
+                GLuint vertexArrayId = 0;
 
                 std::map<GLuint, GLuint> bufferId;
 
@@ -4,6 +4,7 @@
 
 #if OUZEL_COMPILE_OPENGL
 
+#include <cstring>
 #include "ShaderResourceOGL.hpp"
 #include "RenderDeviceOGL.hpp"
 #include "utils/Errors.hpp"
@@ -16,6 +17,7 @@ namespace ouzel
                                              const std::vector<uint8_t>& newFragmentShader,
                                              const std::vector<uint8_t>& newVertexShader,
                                              const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                                             const std::vector<Vertex::Attribute>& newVertexLayout,
                                              const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                                              const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                                              uint32_t,
@@ -26,6 +28,8 @@ namespace ouzel
             fragmentShaderData(newFragmentShader),
             vertexShaderData(newVertexShader),
             vertexAttributes(newVertexAttributes),
+            vertexLayout(newVertexLayout),
+            vertexSize(Vertex::getSize(newVertexLayout)),
             fragmentShaderConstantInfo(newFragmentShaderConstantInfo),
             vertexShaderConstantInfo(newVertexShaderConstantInfo)
         {
@@ -48,6 +52,26 @@ namespace ouzel
             compileShader();
         }
 
+        static bool updateConstantValue(std::vector<float>& value, const float* data, uint32_t size)
+        {
+            if (value.size() == size &&
+                std::memcmp(value.data(), data, size * sizeof(float)) == 0)
+                return false;
+
+            value.assign(data, data + size);
+            return true;
+        }
+
+        bool ShaderResourceOGL::updateFragmentShaderConstant(size_t index, const float* data, uint32_t size)
+        {
+            return updateConstantValue(fragmentShaderConstantValues[index], data, size);
+        }
+
+        bool ShaderResourceOGL::updateVertexShaderConstant(size_t index, const float* data, uint32_t size)
+        {
+            return updateConstantValue(vertexShaderConstantValues[index], data, size);
+        }
+
         std::string ShaderResourceOGL::getShaderMessage(GLuint shaderId)
         {
             GLint logLength = 0;
@@ -119,7 +143,7 @@ namespace ouzel
 
             GLuint index = 0;
 
-            for (const Vertex::Attribute& vertexAttribute : Vertex::ATTRIBUTES)
+            for (const Vertex::Attribute& vertexAttribute : vertexLayout)
             {
                 if (vertexAttributes.find(vertexAttribute.usage) != vertexAttributes.end())
                 {
@@ -169,6 +193,42 @@ namespace ouzel
                 }
             }
 
+            // instance attributes follow the vertex attributes
+            for (const Vertex::Attribute& instanceAttribute : Instance::ATTRIBUTES)
+            {
+                if (vertexAttributes.find(instanceAttribute.usage) != vertexAttributes.end())
+                {
+                    const GLchar* name;
+
+                    switch (instanceAttribute.usage)
+                    {
+                        case Vertex::Attribute::Usage::INSTANCE_TRANSFORM0:
+                            name = "instanceTransform0";
+                            break;
+                        case Vertex::Attribute::Usage::INSTANCE_TRANSFORM1:
+                            name = "instanceTransform1";
+                            break;
+                        case Vertex::Attribute::Usage::INSTANCE_TRANSFORM2:
+                            name = "instanceTransform2";
+                            break;
+                        case Vertex::Attribute::Usage::INSTANCE_TRANSFORM3:
+                            name = "instanceTransform3";
+                            break;
+                        case Vertex::Attribute::Usage::INSTANCE_COLOR:
+                            name = "instanceColor0";
+                            break;
+                        case Vertex::Attribute::Usage::INSTANCE_TEXTURE_RECTANGLE:
+                            name = "instanceTexRect0";
+                            break;
+                        default:
+                            throw DataError("Invalid instance attribute usage");
+                    }
+
+                    glBindAttribLocationProc(programId, index, name);
+                    ++index;
+                }
+            }
+
             glLinkProgramProc(programId);
 
             glGetProgramivProc(programId, GL_LINK_STATUS, &status);
@@ -219,6 +279,10 @@ namespace ouzel
                 }
             }
 
+            // uniforms of a newly linked program have their default values
+            fragmentShaderConstantValues.clear();
+            fragmentShaderConstantValues.resize(fragmentShaderConstantLocations.size());
+
             if (!vertexShaderConstantInfo.empty())
             {
                 vertexShaderConstantLocations.clear();
@@ -237,6 +301,9 @@ namespace ouzel
                     vertexShaderConstantLocations.push_back({location, info.dataType});
                 }
             }
+
+            vertexShaderConstantValues.clear();
+            vertexShaderConstantValues.resize(vertexShaderConstantLocations.size());
         }
     } // namespace graphics
 } // namespace ouzel
@@ -33,6 +33,7 @@ namespace ouzel
                               const std::vector<uint8_t>& newFragmentShader,
                               const std::vector<uint8_t>& newVertexShader,
                               const std::set<Vertex::Attribute::Usage>& newVertexAttributes,
+                              const std::vector<Vertex::Attribute>& newVertexLayout,
                               const std::vector<Shader::ConstantInfo>& newFragmentShaderConstantInfo,
                               const std::vector<Shader::ConstantInfo>& newVertexShaderConstantInfo,
                               uint32_t newFragmentShaderDataAlignment,
@@ -50,12 +51,18 @@ namespace ouzel
             };
 
             inline const std::set<Vertex::Attribute::Usage>& getVertexAttributes() const { return vertexAttributes; }
+            inline const std::vector<Vertex::Attribute>& getVertexLayout() const { return vertexLayout; }
+            inline uint32_t getVertexSize() const { return vertexSize; }
 
             inline const std::vector<Location>& getFragmentShaderConstantLocations() const { return fragmentShaderConstantLocations; }
             inline const std::vector<Location>& getVertexShaderConstantLocations() const { return vertexShaderConstantLocations; }
 
             inline GLuint getProgramId() const { return programId; }
 
+            // stores the value of the constant and returns false if it has not changed since the last call
+            bool updateFragmentShaderConstant(size_t index, const float* data, uint32_t size);
+            bool updateVertexShaderConstant(size_t index, const float* data, uint32_t size);
+
         private:
             void compileShader();
             std::string getShaderMessage(GLuint shaderId);
@@ -65,6 +72,8 @@ namespace ouzel
             std::vector<uint8_t> vertexShaderData;
 
             std::set<Vertex::Attribute::Usage> vertexAttributes;
+            std::vector<Vertex::Attribute> vertexLayout;
+            uint32_t vertexSize = 0;
 
             std::vector<Shader::ConstantInfo> fragmentShaderConstantInfo;
             std::vector<Shader::ConstantInfo> vertexShaderConstantInfo;
@@ -75,6 +84,9 @@ namespace ouzel
 
             std::vector<Location> fragmentShaderConstantLocations;
             std::vector<Location> vertexShaderConstantLocations;
+
+            std::vector<std::vector<float>> fragmentShaderConstantValues;
+            std::vector<std::vector<float>> vertexShaderConstantValues;
         };
     } // namespace graphics
 } // namespace ouzel
@@ -25,7 +25,7 @@ namespace ouzel
         {
             running = false;
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
 
             if (renderThread.joinable()) renderThread.join();
@@ -161,7 +161,7 @@ namespace ouzel
         {
             running = false;
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
 
             if (renderThread.joinable()) renderThread.join();
@@ -245,6 +245,7 @@ namespace ouzel
             frameBufferHeight = surfaceHeight;
 
             stateCache = StateCache();
+            vertexArrays.clear(); // the vertex arrays were destroyed with the context
 
             glDisableProc(GL_DITHER);
             glDepthFunc(GL_LEQUAL);
@@ -271,7 +272,7 @@ namespace ouzel
         {
             running = false;
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
             
             if (renderThread.joinable()) renderThread.join();
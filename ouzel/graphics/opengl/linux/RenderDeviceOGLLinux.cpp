@@ -29,7 +29,7 @@ namespace ouzel
         {
             running = false;
             CommandBuffer commandBuffer;
-            commandBuffer.commands.push(std::unique_ptr<Command>(new PresentCommand()));
+            commandBuffer.pushCommand<PresentCommand>();
             submitCommandBuffer(std::move(commandBuffer));
             
             if (renderThread.joinable()) renderThread.join();
@@ -28,8 +28,9 @@ namespace ouzel
 
             template<typename T> void addWidget(std::unique_ptr<T>&& widget)
             {
-                addWidget(widget.get());
-                ownedChildren.push_back(std::move(widget));
+                Widget* child = widget.release();
+                addWidget(child);
+                takeOwnership(child);
             }
 
             void selectWidget(Widget* widget);
@@ -36,6 +36,7 @@
 #include "audio/Listener.hpp"
 #include "audio/Panner.hpp"
 #include "audio/Pitch.hpp"
+#include "audio/Resampler.hpp"
 #include "audio/SampleFormat.hpp"
 #include "audio/Sound.hpp"
 #include "audio/SoundData.hpp"
@@ -43,6 +44,8 @@
 #include "audio/SoundDataWave.hpp"
 #include "audio/SoundInput.hpp"
 #include "audio/SoundOutput.hpp"
+#include "audio/StreamPrefetcher.hpp"
+#include "audio/VoiceManager.hpp"
 #include "core/Setup.h"
 #include "core/Engine.hpp"
 #include "core/Timer.hpp"
@@ -113,6 +116,7 @@
 #include "scene/Light.hpp"
 #include "scene/ParticleSystemData.hpp"
 #include "scene/ParticleSystem.hpp"
+#include "scene/ParticleWorld.hpp"
 #include "scene/Scene.hpp"
 #include "scene/SceneManager.hpp"
 #include "scene/ShapeRenderer.hpp"
@@ -4,10 +4,13 @@
 #include <algorithm>
 #include "Actor.hpp"
 #include "SceneManager.hpp"
+#include "core/Engine.hpp"
 #include "Layer.hpp"
 #include "Camera.hpp"
 #include "math/MathUtils.hpp"
 #include "Component.hpp"
+#include "Sprite.hpp"
+#include "StaticMeshRenderer.hpp"
 
 namespace ouzel
 {
@@ -15,60 +18,136 @@ namespace ouzel
     {
         Actor::Actor()
         {
+            siblingLink.actor = this;
         }
 
         Actor::~Actor()
         {
+            if (interpolated) engine->getSceneManager().removeInterpolatedActor(this);
+
+            // the actor is already being deleted
+            ownedByParent = false;
             if (parent) parent->removeChild(this);
 
-            for (const auto& component : components)
+            for (Component* component : components)
+            {
                 component->setActor(nullptr);
+                if (component->ownedByActor) delete component;
+            }
         }
 
-        void Actor::visit(std::vector<Actor*>& drawQueue,
-                          const Matrix4& newParentTransform,
-                          bool parentTransformDirty,
-                          Camera* camera,
-                          int32_t parentOrder,
-                          bool parentHidden)
+        void Actor::addToDrawQueue(DrawQueue& drawQueue, Camera* camera)
         {
-            worldOrder = parentOrder + order;
-            worldHidden = parentHidden || hidden;
+            bool materialSorting = layer && layer->isMaterialSortingEnabled();
+            float depth = 0.0F;
 
-            if (parentTransformDirty) updateTransform(newParentTransform);
-            if (transformDirty) calculateTransform();
+            if (materialSorting)
+            {
+                Vector4 clipPosition;
+                camera->getRenderViewProjection().transformVector(Vector4(transform.m[12], transform.m[13], transform.m[14], 1.0F), clipPosition);
+                if (clipPosition.w != 0.0F) depth = (clipPosition.z / clipPosition.w + 1.0F) / 2.0F;
+            }
 
-            if (!worldHidden)
+            for (Component* component : components)
             {
-                Box3 boundingBox = getBoundingBox();
+                if (component->isHidden()) continue;
 
-                if (cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(getTransform(), boundingBox)))
+                const graphics::Material* material = nullptr;
+                if (materialSorting)
                 {
-                    auto upperBound = std::upper_bound(drawQueue.begin(), drawQueue.end(), this,
-                                                       [](Actor* a, Actor* b) {
-                                                           return a->worldOrder > b->worldOrder;
-                                                       });
-
-                    drawQueue.insert(upperBound, this);
+                    if (component->getClass() == Sprite::CLASS)
+                        material = static_cast<Sprite*>(component)->getMaterial().get();
+                    else if (component->getClass() == StaticMeshRenderer::CLASS)
+                        material = static_cast<StaticMeshRenderer*>(component)->getMaterial().get();
                 }
+
+                drawQueue.add(material ? DrawQueue::makeKey(worldOrder, *material, depth) : DrawQueue::makeKey(worldOrder),
+                              this, component);
             }
+        }
+
+        void Actor::updateWorldState(const Matrix4& newParentTransform, int32_t parentOrder, bool parentHidden)
+        {
+            // the transform hierarchy of the layer has already calculated the world transform
+            if (!layer || !layer->isTransformHierarchyEnabled())
+            {
+                updateTransform(newParentTransform);
+                calculateTransform();
+            }
+
+            worldOrder = parentOrder + order;
+            worldHidden = parentHidden || hidden;
+            worldStateDirty = false;
+
+            if (layer) layer->updateProxy(this);
 
             for (Actor* actor : children)
-                actor->visit(drawQueue, transform, updateChildrenTransform, camera, worldOrder, worldHidden);
+                actor->updateWorldState(transform, worldOrder, worldHidden);
 
             updateChildrenTransform = false;
         }
 
-        void Actor::draw(Camera* camera, bool wireframe)
+        void Actor::setWorldTransform(const Matrix4& newParentTransform, const Matrix4& newTransform)
+        {
+            updateTransform(newParentTransform);
+            transform = newTransform;
+            transformDirty = false;
+
+            if (layer) layer->updateProxy(this);
+        }
+
+        void Actor::invalidate()
+        {
+            if (layer && !worldStateDirty)
+            {
+                worldStateDirty = true;
+                layer->addDirtyActor(this);
+            }
+        }
+
+        void Actor::drawComponent(Component* component, Camera* camera, bool wireframe)
         {
             if (transformDirty)
                 calculateTransform();
 
-            for (Component* component : components)
+            if (interpolated)
+                calculateInterpolatedTransform(engine->getFixedUpdateAlpha());
+
+            const Matrix4& drawTransform = interpolated ? interpolatedTransform : transform;
+
+            if (layer && !batchingDisabled && component->getClass() == Sprite::CLASS)
             {
-                if (!component->isHidden())
+                layer->getMeshInstancer().flush();
+                static_cast<Sprite*>(component)->batch(layer->getSpriteBatcher(),
+                                                       drawTransform,
+                                                       opacity,
+                                                       camera->getRenderViewProjection());
+            }
+            else
+            {
+                if (layer) layer->getSpriteBatcher().breakBatch(SpriteBatcher::BreakReason::UNBATCHED_DRAW);
+
+                // identical meshes drawn one after another are merged into instanced draws
+                bool instanced = false;
+                if (layer && !wireframe)
+                {
+                    if (component->getClass() == StaticMeshRenderer::CLASS)
+                        instanced = static_cast<StaticMeshRenderer*>(component)->instance(layer->getMeshInstancer(),
+                                                                                          drawTransform,
+                                                                                          opacity,
+                                                                                          camera->getRenderViewProjection());
+                    else if (component->getClass() == Sprite::CLASS)
+                        instanced = static_cast<Sprite*>(component)->instance(layer->getMeshInstancer(),
+                                                                              drawTransform,
+                                                                              opacity,
+                                                                              camera->getRenderViewProjection());
+                }
+
+                if (!instanced)
                 {
-                    component->draw(transform,
+                    if (layer) layer->getMeshInstancer().flush();
+
+                    component->draw(drawTransform,
                                     opacity,
                                     camera->getRenderViewProjection(),
                                     wireframe);
@@ -140,6 +219,13 @@ namespace ouzel
             updateLocalTransform();
         }
 
+        void Actor::setOrder(int32_t newOrder)
+        {
+            order = newOrder;
+
+            invalidate();
+        }
+
         void Actor::setOpacity(float newOpacity)
         {
             opacity = clamp(newOpacity, 0.0F, 1.0F);
@@ -159,9 +245,18 @@ namespace ouzel
             updateLocalTransform();
         }
 
+        void Actor::setCullDisabled(bool newCullDisabled)
+        {
+            cullDisabled = newCullDisabled;
+
+            invalidate();
+        }
+
         void Actor::setHidden(bool newHidden)
         {
             hidden = newHidden;
+
+            invalidate();
         }
 
         bool Actor::pointOn(const Vector2& worldPosition) const
@@ -206,6 +301,15 @@ namespace ouzel
             localTransformDirty = transformDirty = inverseTransformDirty = true;
             for (Component* component : components)
                 component->updateTransform();
+
+            if (layer && layer->isTransformHierarchyEnabled())
+            {
+                // the new hierarchy will be built from the actor's current values
+                if (!layer->hierarchyDirty)
+                    layer->transformHierarchy.setLocalTransform(hierarchyIndex, position, rotation, getFinalScale());
+            }
+            else
+                invalidate();
         }
 
         void Actor::updateTransform(const Matrix4& newParentTransform)
@@ -254,15 +358,60 @@ namespace ouzel
 
             localTransform *= rotationMatrix;
 
-            Vector3 finalScale = Vector3(scale.x * (flipX ? -1.0F : 1.0F),
-                                         scale.y * (flipY ? -1.0F : 1.0F),
-                                         scale.z);
-
-            localTransform.scale(finalScale);
+            localTransform.scale(getFinalScale());
 
             localTransformDirty = false;
         }
 
+        void Actor::setInterpolated(bool newInterpolated)
+        {
+            if (interpolated == newInterpolated) return;
+
+            interpolated = newInterpolated;
+
+            if (interpolated)
+            {
+                storePreviousState();
+                engine->getSceneManager().addInterpolatedActor(this);
+            }
+            else
+                engine->getSceneManager().removeInterpolatedActor(this);
+        }
+
+        void Actor::storePreviousState()
+        {
+            previousPosition = position;
+            previousRotation = rotation;
+            previousScale = getFinalScale();
+        }
+
+        void Actor::calculateInterpolatedTransform(float alpha) const
+        {
+            // the parent transform is not interpolated, parents that move have to be interpolated themselves
+            Vector3 interpolatedPosition = previousPosition + (position - previousPosition) * alpha;
+            Vector3 finalScale = getFinalScale();
+            Vector3 interpolatedScale = previousScale + (finalScale - previousScale) * alpha;
+
+            // interpolate along the shorter arc
+            float dot = previousRotation.x * rotation.x + previousRotation.y * rotation.y +
+                previousRotation.z * rotation.z + previousRotation.w * rotation.w;
+            Quaternion interpolatedRotation;
+            interpolatedRotation.lerp(previousRotation, (dot < 0.0F) ? -rotation : rotation, alpha);
+            interpolatedRotation.normalize();
+
+            Matrix4 localMatrix;
+            localMatrix.setIdentity();
+            localMatrix.translate(interpolatedPosition);
+
+            Matrix4 rotationMatrix;
+            rotationMatrix.setRotation(interpolatedRotation);
+
+            localMatrix *= rotationMatrix;
+            localMatrix.scale(interpolatedScale);
+
+            interpolatedTransform = parentTransform * localMatrix;
+        }
+
         void Actor::calculateTransform() const
         {
             transform = parentTransform * getLocalTransform();
@@ -288,47 +437,80 @@ namespace ouzel
             assert(component);
 
             if (component->actor)
+            {
+                // an owned component stays owned by its new actor
+                bool owned = component->ownedByActor;
+                component->ownedByActor = false;
                 component->actor->removeComponent(component);
+                component->ownedByActor = owned;
+            }
 
             component->setActor(this);
             components.push_back(component);
+
+            invalidate();
+        }
+
+        void Actor::takeOwnership(Component* component)
+        {
+            assert(component && component->actor == this);
+
+            component->ownedByActor = true;
         }
 
         bool Actor::removeComponent(Component* component)
         {
-            bool result = false;
+            if (!component || component->actor != this)
+                return false;
 
             auto componentIterator = std::find(components.begin(), components.end(), component);
 
             if (componentIterator != components.end())
-            {
-                component->setActor(nullptr);
                 components.erase(componentIterator);
-                result = true;
-            }
 
-            auto ownedIterator = std::find_if(ownedComponents.begin(), ownedComponents.end(), [component](const std::unique_ptr<Component>& other) {
-                return other.get() == component;
-            });
+            component->setActor(nullptr);
+
+            if (component->ownedByActor)
+            {
+                component->ownedByActor = false;
+                delete component;
+            }
 
-            if (ownedIterator != ownedComponents.end())
-                ownedComponents.erase(ownedIterator);
+            invalidate();
 
-            return result;
+            return true;
         }
 
         void Actor::removeAllComponents()
         {
-            components.clear();
-            ownedComponents.clear();
+            std::vector<Component*> removedComponents;
+            removedComponents.swap(components);
+
+            for (Component* component : removedComponents)
+            {
+                component->setActor(nullptr);
+
+                if (component->ownedByActor)
+                {
+                    component->ownedByActor = false;
+                    delete component;
+                }
+            }
+
+            invalidate();
         }
 
         void Actor::setLayer(Layer* newLayer)
         {
+            if (layer && layer != newLayer)
+                layer->removeActor(this);
+
             ActorContainer::setLayer(newLayer);
 
             for (Component* component : components)
                 component->setLayer(newLayer);
+
+            invalidate();
         }
 
         std::vector<Component*> Actor::getComponents(uint32_t cls) const
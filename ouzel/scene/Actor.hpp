@@ -4,6 +4,8 @@
 #define OUZEL_SCENE_ACTOR_HPP
 
 #include "scene/ActorContainer.hpp"
+#include "scene/DrawQueue.hpp"
+#include "scene/SpatialIndex.hpp"
 #include "math/Box3.hpp"
 #include "math/Color.hpp"
 #include "math/Matrix4.hpp"
@@ -11,6 +13,7 @@
 #include "math/Vector2.hpp"
 #include "math/Vector3.hpp"
 #include "events/EventHandler.hpp"
+#include "utils/MemoryPool.hpp"
 
 namespace ouzel
 {
@@ -19,29 +22,32 @@ namespace ouzel
         class Camera;
         class Component;
         class Layer;
+        class SceneManager;
 
         class Actor: public ActorContainer
         {
             friend ActorContainer;
+            friend Component;
             friend Layer;
+            friend SceneManager;
         public:
             Actor();
             virtual ~Actor();
 
-            virtual void visit(std::vector<Actor*>& drawQueue,
-                               const Matrix4& newParentTransform,
-                               bool parentTransformDirty,
-                               Camera* camera,
-                               int32_t parentOrder,
-                               bool parentHidden);
-            virtual void draw(Camera* camera, bool wireframe);
+            // actors are allocated from the memory pool, so that spawning and removing them does not go to the heap
+            static void* operator new(size_t size) { return MemoryPool::allocate(size); }
+            static void operator delete(void* pointer, size_t size) { MemoryPool::deallocate(pointer, size); }
+
+            // the layer draws the visible components one by one in the order of its draw queue,
+            // custom drawing goes into Component::draw
+            void drawComponent(Component* component, Camera* camera, bool wireframe);
 
             virtual const Vector3& getPosition() const { return position; }
             virtual void setPosition(const Vector2& newPosition);
             virtual void setPosition(const Vector3& newPosition);
 
             inline int32_t getOrder() const { return order; }
-            void setOrder(int32_t newOrder) { order = newOrder; }
+            void setOrder(int32_t newOrder);
 
             virtual const Quaternion& getRotation() const { return rotation; }
             virtual void setRotation(const Quaternion& newRotation);
@@ -65,7 +71,14 @@ namespace ouzel
             virtual void setPickable(bool newPickable) { pickable = newPickable; }
 
             virtual bool isCullDisabled() const { return cullDisabled; }
-            virtual void setCullDisabled(bool newCullDisabled) { cullDisabled = newCullDisabled; }
+            virtual void setCullDisabled(bool newCullDisabled);
+
+            virtual bool isBatchingDisabled() const { return batchingDisabled; }
+            virtual void setBatchingDisabled(bool newBatchingDisabled) { batchingDisabled = newBatchingDisabled; }
+
+            // interpolated actors are drawn between their state at the last two fixed updates
+            bool isInterpolated() const { return interpolated; }
+            void setInterpolated(bool newInterpolated);
 
             virtual bool isHidden() const { return hidden; }
             virtual void setHidden(bool newHidden);
@@ -113,10 +126,12 @@ namespace ouzel
                 addComponent(component.get());
             }
 
+            // the actor deletes the component when it is removed
             template<typename T> void addComponent(std::unique_ptr<T>&& component)
             {
-                addComponent(component.get());
-                ownedComponents.push_back(std::move(component));
+                Component* ownedComponent = component.release();
+                addComponent(ownedComponent);
+                takeOwnership(ownedComponent);
             }
 
             bool removeComponent(Component* component);
@@ -138,11 +153,32 @@ namespace ouzel
             void updateLocalTransform();
             void updateTransform(const Matrix4& newParentTransform);
 
+            inline Vector3 getFinalScale() const
+            {
+                return Vector3(scale.x * (flipX ? -1.0F : 1.0F),
+                               scale.y * (flipY ? -1.0F : 1.0F),
+                               scale.z);
+            }
+
+            using ActorContainer::takeOwnership;
+            void takeOwnership(Component* component);
+
+            void addToDrawQueue(DrawQueue& drawQueue, Camera* camera);
+            // recalculates the world transform, order and visibility of the actor and its children
+            void updateWorldState(const Matrix4& newParentTransform, int32_t parentOrder, bool parentHidden);
+            // schedules updateWorldState before the layer is drawn or picked
+            void invalidate();
+            // used by the transform hierarchy of the layer
+            void setWorldTransform(const Matrix4& newParentTransform, const Matrix4& newTransform);
+
             virtual void calculateLocalTransform() const;
             virtual void calculateTransform() const;
 
             virtual void calculateInverseTransform() const;
 
+            void storePreviousState();
+            void calculateInterpolatedTransform(float alpha) const;
+
             Matrix4 parentTransform;
             mutable Matrix4 transform;
             mutable Matrix4 inverseTransform;
@@ -158,6 +194,7 @@ namespace ouzel
 
             bool pickable = false;
             bool cullDisabled = false;
+            bool batchingDisabled = false;
             bool hidden = false;
             bool worldHidden = false;
 
@@ -168,10 +205,21 @@ namespace ouzel
             int32_t order = 0;
             int32_t worldOrder = 0;
 
+            int32_t spatialProxy = SpatialIndex::NULL_PROXY;
+            uint32_t hierarchyIndex = 0;
+            bool worldStateDirty = false;
+
+            bool interpolated = false;
+            Vector3 previousPosition;
+            Quaternion previousRotation = Quaternion::identity();
+            Vector3 previousScale = Vector3(1.0F, 1.0F, 1.0F);
+            mutable Matrix4 interpolatedTransform;
+
             ActorContainer* parent = nullptr;
+            ChildLink siblingLink;
+            bool ownedByParent = false;
 
             std::vector<Component*> components;
-            std::vector<std::unique_ptr<Component>> ownedComponents;
 
             EventHandler animationUpdateHandler;
         };
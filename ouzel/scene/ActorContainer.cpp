@@ -4,22 +4,84 @@
 #include <algorithm>
 #include "ActorContainer.hpp"
 #include "Actor.hpp"
+#include "Layer.hpp"
 
 namespace ouzel
 {
     namespace scene
     {
+        std::vector<Actor*> ChildList::toVector() const
+        {
+            std::vector<Actor*> result;
+            result.reserve(count);
+
+            for (ChildLink* link = first; link; link = link->next)
+                result.push_back(link->actor);
+
+            return result;
+        }
+
+        void ChildList::pushBack(ChildLink& link)
+        {
+            link.previous = last;
+            link.next = nullptr;
+
+            if (last) last->next = &link;
+            else first = &link;
+
+            last = &link;
+            ++count;
+        }
+
+        void ChildList::pushFront(ChildLink& link)
+        {
+            link.previous = nullptr;
+            link.next = first;
+
+            if (first) first->previous = &link;
+            else last = &link;
+
+            first = &link;
+            ++count;
+        }
+
+        void ChildList::remove(ChildLink& link)
+        {
+            if (link.previous) link.previous->next = link.next;
+            else first = link.next;
+
+            if (link.next) link.next->previous = link.previous;
+            else last = link.previous;
+
+            link.previous = nullptr;
+            link.next = nullptr;
+            --count;
+        }
+
         ActorContainer::ActorContainer()
         {
         }
 
         ActorContainer::~ActorContainer()
         {
-            for (auto& actor : children)
+            ChildLink* link = children.first;
+
+            while (link)
             {
+                Actor* actor = link->actor;
+                link = link->next;
+
                 if (entered) actor->leave();
                 actor->parent = nullptr;
                 actor->setLayer(nullptr);
+                actor->siblingLink.previous = nullptr;
+                actor->siblingLink.next = nullptr;
+
+                if (actor->ownedByParent)
+                {
+                    actor->ownedByParent = false;
+                    delete actor;
+                }
             }
         }
 
@@ -28,86 +90,96 @@ namespace ouzel
             assert(actor);
 
             if (actor->parent)
+            {
+                // an owned actor stays owned by its new parent
+                bool owned = actor->ownedByParent;
+                actor->ownedByParent = false;
                 actor->parent->removeChild(actor);
+                actor->ownedByParent = owned;
+            }
 
             actor->parent = this;
             actor->setLayer(layer);
             if (entered) actor->enter();
-            children.push_back(actor);
+            children.pushBack(actor->siblingLink);
+
+            if (layer) layer->invalidateHierarchy();
         }
 
-        bool ActorContainer::removeChild(Actor* actor)
+        void ActorContainer::takeOwnership(Actor* actor)
         {
-            bool result = false;
+            assert(actor && actor->parent == this);
 
-            auto childIterator = std::find(children.begin(), children.end(), actor);
+            actor->ownedByParent = true;
+        }
 
-            if (childIterator != children.end())
-            {
-                if (entered) actor->leave();
-                actor->parent = nullptr;
-                actor->setLayer(nullptr);
-                children.erase(childIterator);
+        bool ActorContainer::removeChild(Actor* actor)
+        {
+            if (!actor || actor->parent != this)
+                return false;
 
-                result = true;
-            }
+            if (entered) actor->leave();
+            actor->parent = nullptr;
+            actor->setLayer(nullptr);
+            releaseChild(actor);
 
-            auto ownedIterator = std::find_if(ownedChildren.begin(), ownedChildren.end(), [actor](const std::unique_ptr<Actor>& other) {
-                return other.get() == actor;
-            });
+            return true;
+        }
 
-            if (ownedIterator != ownedChildren.end())
-                ownedChildren.erase(ownedIterator);
+        void ActorContainer::releaseChild(Actor* actor)
+        {
+            children.remove(actor->siblingLink);
 
-            return result;
+            if (actor->ownedByParent)
+            {
+                actor->ownedByParent = false;
+                delete actor;
+            }
         }
 
         bool ActorContainer::moveChildToBack(Actor* actor)
         {
-            auto i = std::find(children.begin(), children.end(), actor);
+            if (!actor || actor->parent != this)
+                return false;
 
-            if (i != children.end())
-            {
-                std::rotate(children.begin(), i, i + 1);
+            children.remove(actor->siblingLink);
+            children.pushFront(actor->siblingLink);
 
-                return true;
-            }
+            if (layer) layer->invalidateHierarchy();
 
-            return false;
+            return true;
         }
 
         bool ActorContainer::moveChildToFront(Actor* actor)
         {
-            auto i = std::find(children.begin(), children.end(), actor);
+            if (!actor || actor->parent != this)
+                return false;
 
-            if (i != children.end())
-            {
-                std::rotate(i, i + 1, children.end());
+            children.remove(actor->siblingLink);
+            children.pushBack(actor->siblingLink);
 
-                return true;
-            }
+            if (layer) layer->invalidateHierarchy();
 
-            return false;
+            return true;
         }
 
         void ActorContainer::removeAllChildren()
         {
-            for (auto& actor : children)
+            while (!children.empty())
             {
+                Actor* actor = children.first->actor;
+
                 if (entered) actor->leave();
                 actor->parent = nullptr;
+                actor->setLayer(nullptr);
+                releaseChild(actor);
             }
-
-            children.clear();
-            ownedChildren.clear();
         }
 
         bool ActorContainer::hasChild(Actor* actor, bool recursive) const
         {
-            for (auto i = children.cbegin(); i != children.cend(); ++i)
+            for (Actor* child : children)
             {
-                Actor* child = *i;
-
                 if (child == actor || (recursive && child->hasChild(actor, true)))
                     return true;
             }
@@ -3,6 +3,7 @@
 #ifndef OUZEL_SCENE_ACTORCONTAINER_HPP
 #define OUZEL_SCENE_ACTORCONTAINER_HPP
 
+#include <cstddef>
 #include <memory>
 #include <vector>
 #include "math/Vector2.hpp"
@@ -12,8 +13,63 @@ namespace ouzel
     namespace scene
     {
         class Actor;
+        class ActorContainer;
         class Layer;
 
+        // link of an actor in the child list of its parent
+        struct ChildLink final
+        {
+            Actor* actor = nullptr;
+            ChildLink* previous = nullptr;
+            ChildLink* next = nullptr;
+        };
+
+        // Intrusive list of the children of an actor container, adding and removing a child does not allocate.
+        class ChildList final
+        {
+            friend ActorContainer;
+        public:
+            template<bool reverse> class Iterator final
+            {
+            public:
+                explicit Iterator(ChildLink* initLink): link(initLink) {}
+
+                inline Actor* operator*() const { return link->actor; }
+
+                inline Iterator& operator++()
+                {
+                    link = reverse ? link->previous : link->next;
+                    return *this;
+                }
+
+                inline bool operator==(const Iterator& other) const { return link == other.link; }
+                inline bool operator!=(const Iterator& other) const { return link != other.link; }
+
+            private:
+                ChildLink* link;
+            };
+
+            inline Iterator<false> begin() const { return Iterator<false>(first); }
+            inline Iterator<false> end() const { return Iterator<false>(nullptr); }
+            inline Iterator<true> rbegin() const { return Iterator<true>(last); }
+            inline Iterator<true> rend() const { return Iterator<true>(nullptr); }
+
+            inline size_t size() const { return count; }
+            inline bool empty() const { return count == 0; }
+
+            // the actors are in the order they are drawn in
+            std::vector<Actor*> toVector() const;
+
+        private:
+            void pushBack(ChildLink& link);
+            void pushFront(ChildLink& link);
+            void remove(ChildLink& link);
+
+            ChildLink* first = nullptr;
+            ChildLink* last = nullptr;
+            size_t count = 0;
+        };
+
         class ActorContainer
         {
         public:
@@ -33,10 +89,12 @@ namespace ouzel
                 addChild(actor.get());
             }
 
+            // the container deletes the actor when it is removed
             template<typename T> void addChild(std::unique_ptr<T>&& actor)
             {
-                addChild(actor.get());
-                ownedChildren.push_back(std::move(actor));
+                Actor* child = actor.release();
+                addChild(child);
+                takeOwnership(child);
             }
 
             virtual bool removeChild(Actor* actor);
@@ -50,7 +108,7 @@ namespace ouzel
             bool moveChildToFront(Actor* actor);
             virtual void removeAllChildren();
             virtual bool hasChild(Actor* actor, bool recursive = false) const;
-            virtual const std::vector<Actor*>& getChildren() const { return children; }
+            inline const ChildList& getChildren() const { return children; }
 
             inline Layer* getLayer() const { return layer; }
 
@@ -63,8 +121,12 @@ namespace ouzel
             virtual void enter();
             virtual void leave();
 
-            std::vector<Actor*> children;
-            std::vector<std::unique_ptr<Actor>> ownedChildren;
+            // the child is deleted when it is removed from the container
+            void takeOwnership(Actor* actor);
+            // unlinks the child, deleting it if it is owned by the container
+            void releaseChild(Actor* actor);
+
+            ChildList children;
 
             Layer* layer = nullptr;
             bool entered = false;
@@ -2,6 +2,7 @@
 
 #include <cassert>
 #include <algorithm>
+#include <limits>
 #include "Camera.hpp"
 #include "core/Engine.hpp"
 #include "graphics/Renderer.hpp"
@@ -255,6 +256,36 @@ namespace ouzel
             }
         }
 
+        Box3 Camera::getVisibleBox() const
+        {
+            Box3 result;
+
+            for (uint32_t corner = 0; corner < 8; ++corner)
+            {
+                Vector4 clipPosition((corner & 1) ? 1.0F : -1.0F,
+                                     (corner & 2) ? 1.0F : -1.0F,
+                                     (corner & 4) ? 1.0F : -1.0F,
+                                     1.0F);
+
+                Vector4 worldPosition;
+                getInverseViewProjection().transformVector(clipPosition, worldPosition);
+
+                if (worldPosition.w != 0.0F)
+                    result.insertPoint(Vector3(worldPosition.x / worldPosition.w,
+                                               worldPosition.y / worldPosition.w,
+                                               worldPosition.z / worldPosition.w));
+            }
+
+            if (projectionMode == ProjectionMode::ORTHOGRAPHIC)
+            {
+                // checkVisibility ignores the depth of orthographic projections
+                result.min.z = std::numeric_limits<float>::lowest();
+                result.max.z = std::numeric_limits<float>::max();
+            }
+
+            return result;
+        }
+
         void Camera::setViewport(const Rect& newViewport)
         {
             viewport = newViewport;
@@ -65,6 +65,8 @@ namespace ouzel
             Vector2 convertWorldToNormalized(const Vector3& worldPosition) const;
 
             bool checkVisibility(const Matrix4& boxTransform, const Box3& box) const;
+            // world space bounding box of the visible volume, unbounded along the z axis for orthographic cameras
+            Box3 getVisibleBox() const;
 
             inline const Rect& getViewport() const { return viewport; }
             inline const Rect& getRenderViewport() const { return renderViewport; }
@@ -25,6 +25,25 @@ namespace ouzel
         {
         }
 
+        void Component::setBoundingBox(const Box3& newBoundingBox)
+        {
+            boundingBox = newBoundingBox;
+
+            invalidateActor();
+        }
+
+        void Component::setHidden(bool newHidden)
+        {
+            hidden = newHidden;
+
+            invalidateActor();
+        }
+
+        void Component::invalidateActor()
+        {
+            if (actor) actor->invalidate();
+        }
+
         bool Component::pointOn(const Vector2& position) const
         {
             return boundingBox.containsPoint(Vector3(position));
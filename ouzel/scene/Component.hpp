@@ -10,6 +10,7 @@
 #include "math/Color.hpp"
 #include "math/Rect.hpp"
 #include "graphics/Texture.hpp"
+#include "utils/MemoryPool.hpp"
 
 namespace ouzel
 {
@@ -40,6 +41,10 @@ namespace ouzel
             explicit Component(uint32_t initClass);
             virtual ~Component();
 
+            // components are allocated from the memory pool, so that spawning and removing them does not go to the heap
+            static void* operator new(size_t size) { return MemoryPool::allocate(size); }
+            static void operator delete(void* pointer, size_t size) { MemoryPool::deallocate(pointer, size); }
+
             Component(const Component&) = delete;
             Component& operator=(const Component&) = delete;
 
@@ -54,13 +59,13 @@ namespace ouzel
                               bool wireframe);
 
             virtual const Box3& getBoundingBox() const { return boundingBox; }
-            virtual void setBoundingBox(const Box3& newBoundingBox) { boundingBox = newBoundingBox; }
+            virtual void setBoundingBox(const Box3& newBoundingBox);
 
             virtual bool pointOn(const Vector2& position) const;
             virtual bool shapeOverlaps(const std::vector<Vector2>& edges) const;
 
             bool isHidden() const { return hidden; }
-            void setHidden(bool newHidden) { hidden = newHidden; }
+            void setHidden(bool newHidden);
 
             inline Actor* getActor() const { return actor; }
             void removeFromActor();
@@ -69,6 +74,8 @@ namespace ouzel
             virtual void setActor(Actor* newActor);
             virtual void setLayer(Layer* newLayer);
             virtual void updateTransform();
+            // must be called after the bounding box changes, so that the actor is moved in the layer's spatial index
+            void invalidateActor();
 
             uint32_t cls;
 
@@ -77,6 +84,7 @@ namespace ouzel
 
             Layer* layer = nullptr;
             Actor* actor = nullptr;
+            bool ownedByActor = false;
         };
     } // namespace scene
 } // namespace ouzel
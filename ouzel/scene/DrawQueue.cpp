@@ -0,0 +1,85 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "DrawQueue.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        static inline uint64_t orderBits(int32_t worldOrder)
+        {
+            // flip the sign bit to sort signed values as unsigned and invert to draw higher orders first
+            return static_cast<uint64_t>(~(static_cast<uint32_t>(worldOrder) ^ 0x80000000U)) << 32;
+        }
+
+        uint64_t DrawQueue::makeKey(int32_t worldOrder)
+        {
+            return orderBits(worldOrder);
+        }
+
+        uint64_t DrawQueue::makeKey(int32_t worldOrder, const graphics::Material& material, float depth)
+        {
+            uint64_t shader = material.shader ? material.shader->getResource() : 0;
+            uint64_t blendState = material.blendState ? material.blendState->getResource() : 0;
+            uint64_t texture = material.textures[0] ? material.textures[0]->getResource() : 0;
+            uint64_t depthBits = static_cast<uint64_t>(clamp(depth, 0.0F, 1.0F) * 255.0F);
+
+            return orderBits(worldOrder) |
+                ((shader & 0xFF) << 24) |
+                ((blendState & 0x0F) << 20) |
+                ((texture & 0xFFF) << 8) |
+                depthBits;
+        }
+
+        void DrawQueue::sort()
+        {
+            if (items.size() < 2) return;
+
+            if (items.size() <= 32)
+            {
+                // insertion sort is faster than the radix passes for short queues
+                for (size_t i = 1; i < items.size(); ++i)
+                {
+                    Item item = items[i];
+                    size_t j = i;
+                    for (; j > 0 && items[j - 1].key > item.key; --j)
+                        items[j] = items[j - 1];
+                    items[j] = item;
+                }
+                return;
+            }
+
+            uint32_t counts[8][256] = {};
+
+            for (const Item& item : items)
+                for (uint32_t pass = 0; pass < 8; ++pass)
+                    ++counts[pass][(item.key >> (pass * 8)) & 0xFF];
+
+            sortBuffer.resize(items.size());
+
+            for (uint32_t pass = 0; pass < 8; ++pass)
+            {
+                uint32_t* passCounts = counts[pass];
+                uint32_t shift = pass * 8;
+
+                // all keys share this byte, the pass would not move anything
+                if (passCounts[(items.front().key >> shift) & 0xFF] == items.size()) continue;
+
+                uint32_t offset = 0;
+                for (uint32_t bucket = 0; bucket < 256; ++bucket)
+                {
+                    uint32_t count = passCounts[bucket];
+                    passCounts[bucket] = offset;
+                    offset += count;
+                }
+
+                for (const Item& item : items)
+                    sortBuffer[passCounts[(item.key >> shift) & 0xFF]++] = item;
+
+                items.swap(sortBuffer);
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,63 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_DRAWQUEUE_HPP
+#define OUZEL_SCENE_DRAWQUEUE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "graphics/Material.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+        class Component;
+
+        // Collects the visible components of a layer and sorts them by a 64-bit key with a stable radix sort.
+        // The storage is kept between frames, so filling the queue does not allocate in the steady state.
+        class DrawQueue final
+        {
+        public:
+            struct Item final
+            {
+                uint64_t key;
+                Actor* actor;
+                Component* component;
+            };
+
+            // the upper 32 bits hold the world order (higher orders are drawn first),
+            // the lower 32 bits optionally group the items of an order by shader, blend state, texture and depth
+            static uint64_t makeKey(int32_t worldOrder);
+            static uint64_t makeKey(int32_t worldOrder, const graphics::Material& material, float depth);
+
+            DrawQueue() = default;
+
+            DrawQueue(const DrawQueue&) = delete;
+            DrawQueue& operator=(const DrawQueue&) = delete;
+
+            DrawQueue(DrawQueue&&) = delete;
+            DrawQueue& operator=(DrawQueue&&) = delete;
+
+            inline void clear() { items.clear(); }
+            inline void add(uint64_t key, Actor* actor, Component* component)
+            {
+                items.push_back(Item{key, actor, component});
+            }
+
+            // items with equal keys keep the order they were added in
+            void sort();
+
+            inline bool empty() const { return items.empty(); }
+            inline size_t size() const { return items.size(); }
+            inline std::vector<Item>::const_iterator begin() const { return items.begin(); }
+            inline std::vector<Item>::const_iterator end() const { return items.end(); }
+
+        private:
+            std::vector<Item> items;
+            std::vector<Item> sortBuffer;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_DRAWQUEUE_HPP
@@ -0,0 +1,282 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <cmath>
+#include <limits>
+#include "GPUParticleStore.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // the steps are passed to the shader as floats, which represent integers exactly up to 2^24
+        static const uint32_t REBASE_STEP = 1 << 23;
+        static const uint32_t MAX_LIFE_STEPS = 1 << 22;
+
+        const uint32_t GPUParticleStore::CHUNK_SIZE;
+
+        void GPUParticleStore::reserve(uint32_t newCapacity)
+        {
+            capacity = newCapacity;
+            size = 0;
+            currentStep = 0;
+
+            emitted.reserve(capacity);
+
+            vertices.assign(capacity * 4, graphics::ParticleVertex());
+            for (uint32_t slot = 0; slot < capacity; ++slot)
+            {
+                // the corners in the order of the sprite quads
+                vertices[slot * 4 + 0].texCoord[1] = 65535;
+                vertices[slot * 4 + 1].texCoord[0] = 65535;
+                vertices[slot * 4 + 1].texCoord[1] = 65535;
+                vertices[slot * 4 + 3].texCoord[0] = 65535;
+            }
+
+            endSteps.assign(capacity, 0);
+            minX.resize(capacity);
+            minY.resize(capacity);
+            maxX.resize(capacity);
+            maxY.resize(capacity);
+
+            // the lowest slots are used first, so that the particles are packed in as few chunks as possible
+            freeSlots.clear();
+            for (uint32_t slot = capacity; slot > 0; --slot)
+                freeSlots.push_back(slot - 1);
+
+            chunks.assign((capacity + CHUNK_SIZE - 1) / CHUNK_SIZE, Chunk());
+        }
+
+        void GPUParticleStore::clear()
+        {
+            for (uint32_t slot = 0; slot < capacity; ++slot)
+            {
+                if (endSteps[slot])
+                {
+                    // hide the particle in case the chunk is drawn again
+                    for (uint32_t corner = 0; corner < 4; ++corner)
+                        vertices[slot * 4 + corner].life[1] = 0.0F;
+
+                    endSteps[slot] = 0;
+                    chunks[slot / CHUNK_SIZE].dirty = true;
+                }
+            }
+
+            freeSlots.clear();
+            for (uint32_t slot = capacity; slot > 0; --slot)
+                freeSlots.push_back(slot - 1);
+
+            for (Chunk& chunk : chunks)
+                chunk.liveCount = 0;
+
+            size = 0;
+        }
+
+        void GPUParticleStore::beginStep()
+        {
+            if (currentStep >= REBASE_STEP) rebase();
+
+            ++currentStep;
+        }
+
+        void GPUParticleStore::emit(uint32_t count, const ParticleSystemData& particleSystemData,
+                                    const Vector2& position, float step, ParticleRandom& random)
+        {
+            count = std::min(count, capacity - size);
+            if (!count) return;
+
+            emitted.clear();
+            emitted.emit(count, particleSystemData, position, step, random);
+
+            const bool gravity = particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY;
+            const float gravityX = particleSystemData.gravity.x * step;
+            const float gravityY = particleSystemData.gravity.y * step;
+            const float yCoordFlipped = particleSystemData.yCoordFlipped ? 1.0F : 0.0F;
+            const float positionStep = step * yCoordFlipped;
+
+            for (uint32_t i = 0; i < emitted.getSize(); ++i)
+            {
+                float x = emitted.positionX[i];
+                float y = emitted.positionY[i];
+                float directionX = emitted.directionX[i];
+                float directionY = emitted.directionY[i];
+                float angleCos = emitted.angleCos[i];
+                float angleSin = emitted.angleSin[i];
+                float radius = emitted.radius[i];
+
+                float left = std::numeric_limits<float>::max();
+                float bottom = std::numeric_limits<float>::max();
+                float right = std::numeric_limits<float>::lowest();
+                float top = std::numeric_limits<float>::lowest();
+
+                // replay the updates of ParticleStore to find the step the particle dies on and the bounds of its path
+                float life = emitted.life[i];
+                uint32_t lifeSteps = 0;
+
+                for (;;)
+                {
+                    if (gravity)
+                    {
+                        directionX += gravityX;
+                        directionY += gravityY;
+                        x += directionX * positionStep;
+                        y += directionY * positionStep;
+                    }
+                    else
+                    {
+                        float newCos = angleCos * emitted.angleStepCos[i] - angleSin * emitted.angleStepSin[i];
+                        float newSin = angleSin * emitted.angleStepCos[i] + angleCos * emitted.angleStepSin[i];
+                        angleCos = newCos;
+                        angleSin = newSin;
+                        radius += emitted.deltaRadius[i] * step;
+                        x = angleCos * radius * -1.0F;
+                        y = angleSin * radius * -yCoordFlipped;
+                    }
+
+                    life -= step;
+                    ++lifeSteps;
+
+                    if (life < 0.0F || lifeSteps > MAX_LIFE_STEPS) break;
+
+                    left = std::min(left, x);
+                    bottom = std::min(bottom, y);
+                    right = std::max(right, x);
+                    top = std::max(top, y);
+                }
+
+                // the particle is removed by the update of the step it is emitted on
+                if (lifeSteps == 1) continue;
+
+                uint32_t slot = freeSlots.back();
+                freeSlots.pop_back();
+
+                endSteps[slot] = currentStep + lifeSteps - 1;
+                minX[slot] = left;
+                minY[slot] = bottom;
+                maxX[slot] = right;
+                maxY[slot] = top;
+
+                graphics::ParticleVertex vertex;
+
+                vertex.position[0] = emitted.positionX[i];
+                vertex.position[1] = emitted.positionY[i];
+
+                if (gravity)
+                {
+                    vertex.position[2] = emitted.directionX[i];
+                    vertex.position[3] = emitted.directionY[i];
+                }
+                else
+                {
+                    vertex.position[2] = atan2f(emitted.angleSin[i], emitted.angleCos[i]);
+                    vertex.position[3] = emitted.radius[i];
+                    vertex.motion[0] = atan2f(emitted.angleStepSin[i], emitted.angleStepCos[i]);
+                    vertex.motion[1] = emitted.deltaRadius[i] * step;
+                }
+
+                vertex.motion[2] = atan2f(emitted.rotationSin[i], emitted.rotationCos[i]);
+                vertex.motion[3] = atan2f(emitted.rotationStepSin[i], emitted.rotationStepCos[i]);
+
+                vertex.color[0] = emitted.colorRed[i];
+                vertex.color[1] = emitted.colorGreen[i];
+                vertex.color[2] = emitted.colorBlue[i];
+                vertex.color[3] = emitted.colorAlpha[i];
+                vertex.deltaColor[0] = emitted.deltaColorRed[i] * step;
+                vertex.deltaColor[1] = emitted.deltaColorGreen[i] * step;
+                vertex.deltaColor[2] = emitted.deltaColorBlue[i] * step;
+                vertex.deltaColor[3] = emitted.deltaColorAlpha[i] * step;
+
+                vertex.life[0] = static_cast<float>(currentStep);
+                vertex.life[1] = static_cast<float>(endSteps[slot]);
+                vertex.life[2] = emitted.size2[i];
+                vertex.life[3] = emitted.deltaSize2[i] * step;
+
+                for (uint32_t corner = 0; corner < 4; ++corner)
+                {
+                    graphics::ParticleVertex& cornerVertex = vertices[slot * 4 + corner];
+                    uint16_t texCoord[2] = {cornerVertex.texCoord[0], cornerVertex.texCoord[1]};
+                    cornerVertex = vertex;
+                    cornerVertex.texCoord[0] = texCoord[0];
+                    cornerVertex.texCoord[1] = texCoord[1];
+                }
+
+                Chunk& chunk = chunks[slot / CHUNK_SIZE];
+                ++chunk.liveCount;
+                chunk.dirty = true;
+                ++size;
+            }
+        }
+
+        void GPUParticleStore::update()
+        {
+            for (uint32_t slot = 0; slot < capacity && size; ++slot)
+                if (endSteps[slot] && endSteps[slot] <= currentStep)
+                    freeSlot(slot);
+        }
+
+        Box3 GPUParticleStore::getBoundingBox(const Matrix4* transform) const
+        {
+            Box3 result;
+            if (!size) return result;
+
+            float left = std::numeric_limits<float>::max();
+            float bottom = std::numeric_limits<float>::max();
+            float right = std::numeric_limits<float>::lowest();
+            float top = std::numeric_limits<float>::lowest();
+
+            for (uint32_t slot = 0; slot < capacity; ++slot)
+            {
+                if (endSteps[slot])
+                {
+                    left = std::min(left, minX[slot]);
+                    bottom = std::min(bottom, minY[slot]);
+                    right = std::max(right, maxX[slot]);
+                    top = std::max(top, maxY[slot]);
+                }
+            }
+
+            const Vector3 corners[4] = {
+                Vector3(left, bottom, 0.0F),
+                Vector3(right, bottom, 0.0F),
+                Vector3(left, top, 0.0F),
+                Vector3(right, top, 0.0F)
+            };
+
+            for (const Vector3& corner : corners)
+            {
+                Vector3 point = corner;
+                if (transform) transform->transformPoint(point);
+                result.insertPoint(point);
+            }
+
+            return result;
+        }
+
+        void GPUParticleStore::freeSlot(uint32_t slot)
+        {
+            endSteps[slot] = 0;
+            freeSlots.push_back(slot);
+            --chunks[slot / CHUNK_SIZE].liveCount;
+            --size;
+        }
+
+        void GPUParticleStore::rebase()
+        {
+            for (uint32_t slot = 0; slot < capacity; ++slot)
+            {
+                if (endSteps[slot]) endSteps[slot] -= currentStep;
+
+                for (uint32_t corner = 0; corner < 4; ++corner)
+                {
+                    graphics::ParticleVertex& vertex = vertices[slot * 4 + corner];
+                    vertex.life[0] -= static_cast<float>(currentStep);
+                    vertex.life[1] = static_cast<float>(endSteps[slot]);
+                }
+            }
+
+            for (Chunk& chunk : chunks)
+                chunk.dirty = true;
+
+            currentStep = 0;
+        }
+    } // namespace scene
+} // namespace ouzel
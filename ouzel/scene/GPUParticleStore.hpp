@@ -0,0 +1,89 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_GPUPARTICLESTORE_HPP
+#define OUZEL_SCENE_GPUPARTICLESTORE_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+#include "scene/ParticleStore.hpp"
+#include "scene/ParticleSystemData.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Box3.hpp"
+#include "math/Matrix4.hpp"
+#include "math/Vector2.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Particles whose state is evaluated by the particle vertex shader from the state they were emitted with.
+        // Every particle occupies a slot whose vertices are uploaded once, when it is emitted.
+        // The slots are grouped in chunks, only the chunks with new particles are uploaded.
+        // The particles are emitted with the same random values and die on the same step as in ParticleStore.
+        class GPUParticleStore final
+        {
+        public:
+            static const uint32_t CHUNK_SIZE = 256;
+
+            GPUParticleStore() = default;
+
+            GPUParticleStore(const GPUParticleStore&) = delete;
+            GPUParticleStore& operator=(const GPUParticleStore&) = delete;
+
+            GPUParticleStore(GPUParticleStore&&) = delete;
+            GPUParticleStore& operator=(GPUParticleStore&&) = delete;
+
+            void reserve(uint32_t newCapacity);
+            inline uint32_t getCapacity() const { return capacity; }
+            inline uint32_t getSize() const { return size; }
+            void clear();
+
+            // starts the next update step, particles are emitted and killed on the current step
+            void beginStep();
+            inline uint32_t getCurrentStep() const { return currentStep; }
+
+            void emit(uint32_t count, const ParticleSystemData& particleSystemData,
+                      const Vector2& position, float step, ParticleRandom& random);
+            // frees the slots of the particles that died on the current step
+            void update();
+
+            // bounds of the paths of the live particles, transformed by the transform if it is not null
+            Box3 getBoundingBox(const Matrix4* transform) const;
+
+            inline uint32_t getChunkCount() const { return static_cast<uint32_t>(chunks.size()); }
+            inline uint32_t getChunkParticleCount(uint32_t chunk) const { return std::min(capacity - chunk * CHUNK_SIZE, CHUNK_SIZE); }
+            inline uint32_t getChunkLiveCount(uint32_t chunk) const { return chunks[chunk].liveCount; }
+            inline bool isChunkDirty(uint32_t chunk) const { return chunks[chunk].dirty; }
+            inline void setChunkUploaded(uint32_t chunk) { chunks[chunk].dirty = false; }
+            inline const graphics::ParticleVertex* getChunkVertices(uint32_t chunk) const { return vertices.data() + chunk * CHUNK_SIZE * 4; }
+
+        private:
+            void freeSlot(uint32_t slot);
+            void rebase();
+
+            struct Chunk final
+            {
+                uint32_t liveCount = 0;
+                bool dirty = false;
+            };
+
+            uint32_t capacity = 0;
+            uint32_t size = 0;
+            uint32_t currentStep = 0;
+
+            ParticleStore emitted; // the emitted particles before they are converted to vertices
+
+            std::vector<graphics::ParticleVertex> vertices; // four per slot
+            std::vector<uint32_t> endSteps; // the first step the particle in the slot is not drawn on, zero for free slots
+            std::vector<float> minX;
+            std::vector<float> minY;
+            std::vector<float> maxX;
+            std::vector<float> maxY;
+            std::vector<uint32_t> freeSlots;
+            std::vector<Chunk> chunks;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_GPUPARTICLESTORE_HPP
@@ -2,6 +2,8 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include "Layer.hpp"
 #include "core/Engine.hpp"
 #include "Actor.hpp"
@@ -23,16 +25,42 @@ namespace ouzel
         Layer::~Layer()
         {
             if (scene) scene->removeLayer(this);
+
+            // detach the actors while the spatial index still exists
+            for (Actor* actor : children)
+                actor->setLayer(nullptr);
         }
 
         void Layer::draw()
         {
-            for (Camera* camera : cameras)
+            updateActors();
+
+            while (cameraViews.size() < cameras.size())
+                cameraViews.push_back(std::unique_ptr<CameraView>(new CameraView()));
+
+            // calculates the lazily updated camera matrices before the cameras are culled in parallel
+            for (size_t i = 0; i < cameras.size(); ++i)
+                cameraViews[i]->visibleBox = cameras[i]->getVisibleBox();
+
+            if (cameras.size() > 1)
             {
-                std::vector<Actor*> drawQueue;
+                cullJobs.clear();
 
-                for (Actor* actor : children)
-                    actor->visit(drawQueue, Matrix4::identity(), false, camera, 0, false);
+                for (size_t i = 0; i < cameras.size(); ++i)
+                    cullJobs.push_back(std::bind(&Layer::cull, this, cameras[i], std::ref(*cameraViews[i])));
+
+                engine->getJobSystem().run(cullJobs);
+            }
+            else if (!cameras.empty())
+                cull(cameras.front(), *cameraViews.front());
+
+            spriteBatcher.begin();
+            meshInstancer.begin();
+
+            // components update their buffers while they are drawn, so the cameras are recorded one after another
+            for (size_t i = 0; i < cameras.size(); ++i)
+            {
+                Camera* camera = cameras[i];
 
                 engine->getRenderer()->setRenderTarget(camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0);
                 engine->getRenderer()->setViewport(camera->getRenderViewport());
@@ -42,9 +70,37 @@ namespace ouzel
                                                    graphics::FillMode::WIREFRAME :
                                                    graphics::FillMode::SOLID);
 
-                for (Actor* actor : drawQueue)
-                    actor->draw(camera, false);
+                for (const DrawQueue::Item& item : cameraViews[i]->drawQueue)
+                    item.actor->drawComponent(item.component, camera, false);
+
+                spriteBatcher.flush();
+                meshInstancer.flush();
+            }
+        }
+
+        void Layer::cull(Camera* camera, CameraView& cameraView) const
+        {
+            cameraView.drawQueue.clear();
+            cameraView.visibleActors.clear();
+
+            spatialIndex.query(cameraView.visibleBox, cameraView.visibleActors, cameraView.traversalStack);
+
+            // keep the scene graph order for actors with the same order
+            std::sort(cameraView.visibleActors.begin(), cameraView.visibleActors.end(), [](Actor* a, Actor* b) {
+                return a->hierarchyIndex < b->hierarchyIndex;
+            });
+
+            for (Actor* actor : cameraView.visibleActors)
+            {
+                if (actor->worldHidden) continue;
+
+                Box3 boundingBox = actor->getBoundingBox();
+
+                if (actor->cullDisabled || (!boundingBox.isEmpty() && camera->checkVisibility(actor->getTransform(), boundingBox)))
+                    actor->addToDrawQueue(cameraView.drawQueue, camera);
             }
+
+            cameraView.drawQueue.sort();
         }
 
         void Layer::addChild(Actor* actor)
@@ -85,6 +141,58 @@ namespace ouzel
                 lights.erase(i);
         }
 
+        void Layer::findActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const
+        {
+            updateActors();
+
+            queryResult.clear();
+            spatialIndex.query(Box3(Vector3(position.x, position.y, std::numeric_limits<float>::lowest()),
+                                    Vector3(position.x, position.y, std::numeric_limits<float>::max())), queryResult);
+
+            for (Actor* actor : queryResult)
+            {
+                if (!actor->worldHidden && actor->isPickable() && actor->pointOn(position))
+                    actors.push_back(std::make_pair(actor, actor->convertWorldToLocal(Vector3(position))));
+            }
+
+            // actors drawn last come first
+            std::sort(actors.begin(), actors.end(), [](const std::pair<Actor*, Vector3>& a,
+                                                       const std::pair<Actor*, Vector3>& b) {
+                if (a.first->worldOrder != b.first->worldOrder)
+                    return a.first->worldOrder < b.first->worldOrder;
+                return a.first->hierarchyIndex > b.first->hierarchyIndex;
+            });
+        }
+
+        void Layer::findActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const
+        {
+            if (edges.empty()) return;
+
+            updateActors();
+
+            Box3 edgesBox;
+            for (const Vector2& edge : edges)
+                edgesBox.insertPoint(edge);
+
+            edgesBox.min.z = std::numeric_limits<float>::lowest();
+            edgesBox.max.z = std::numeric_limits<float>::max();
+
+            queryResult.clear();
+            spatialIndex.query(edgesBox, queryResult);
+
+            for (Actor* actor : queryResult)
+            {
+                if (!actor->worldHidden && actor->isPickable() && actor->shapeOverlaps(edges))
+                    actors.push_back(actor);
+            }
+
+            std::sort(actors.begin(), actors.end(), [](Actor* a, Actor* b) {
+                if (a->worldOrder != b->worldOrder)
+                    return a->worldOrder < b->worldOrder;
+                return a->hierarchyIndex > b->hierarchyIndex;
+            });
+        }
+
         std::pair<Actor*, Vector3> Layer::pickActor(const Vector2& position, bool renderTargets) const
         {
             for (auto i = cameras.rbegin(); i != cameras.rend(); ++i)
@@ -172,6 +280,158 @@ namespace ouzel
             recalculateProjection();
         }
 
+        void Layer::setTransformHierarchyEnabled(bool newTransformHierarchyEnabled)
+        {
+            if (transformHierarchyEnabled != newTransformHierarchyEnabled)
+            {
+                transformHierarchyEnabled = newTransformHierarchyEnabled;
+                hierarchyDirty = true;
+            }
+        }
+
+        void Layer::addDirtyActor(Actor* actor)
+        {
+            dirtyActors.push_back(actor);
+        }
+
+        void Layer::removeActor(Actor* actor)
+        {
+            if (actor->spatialProxy != SpatialIndex::NULL_PROXY)
+            {
+                spatialIndex.destroyProxy(actor->spatialProxy);
+                actor->spatialProxy = SpatialIndex::NULL_PROXY;
+            }
+
+            if (actor->worldStateDirty)
+            {
+                auto i = std::find(dirtyActors.begin(), dirtyActors.end(), actor);
+                if (i != dirtyActors.end()) dirtyActors.erase(i);
+                actor->worldStateDirty = false;
+            }
+
+            hierarchyDirty = true;
+        }
+
+        static Box3 transformBox(const Matrix4& transform, const Box3& box)
+        {
+            // transform the center and project the extents on the world axes instead of transforming all eight corners
+            const float* m = transform.m;
+
+            Vector3 center((box.min.x + box.max.x) / 2.0F, (box.min.y + box.max.y) / 2.0F, (box.min.z + box.max.z) / 2.0F);
+            Vector3 extents((box.max.x - box.min.x) / 2.0F, (box.max.y - box.min.y) / 2.0F, (box.max.z - box.min.z) / 2.0F);
+
+            Vector3 worldCenter(m[0] * center.x + m[4] * center.y + m[8] * center.z + m[12],
+                                m[1] * center.x + m[5] * center.y + m[9] * center.z + m[13],
+                                m[2] * center.x + m[6] * center.y + m[10] * center.z + m[14]);
+
+            Vector3 worldExtents(fabsf(m[0]) * extents.x + fabsf(m[4]) * extents.y + fabsf(m[8]) * extents.z,
+                                 fabsf(m[1]) * extents.x + fabsf(m[5]) * extents.y + fabsf(m[9]) * extents.z,
+                                 fabsf(m[2]) * extents.x + fabsf(m[6]) * extents.y + fabsf(m[10]) * extents.z);
+
+            return Box3(worldCenter - worldExtents, worldCenter + worldExtents);
+        }
+
+        void Layer::updateProxy(Actor* actor)
+        {
+            Box3 worldBox;
+
+            if (actor->cullDisabled)
+            {
+                // large enough to always be visible, small enough to keep the tree costs finite
+                worldBox = Box3(Vector3(-1e30F, -1e30F, -1e30F), Vector3(1e30F, 1e30F, 1e30F));
+            }
+            else
+            {
+                Box3 boundingBox = actor->getBoundingBox();
+
+                if (boundingBox.isEmpty())
+                {
+                    if (actor->spatialProxy != SpatialIndex::NULL_PROXY)
+                    {
+                        spatialIndex.destroyProxy(actor->spatialProxy);
+                        actor->spatialProxy = SpatialIndex::NULL_PROXY;
+                    }
+                    return;
+                }
+
+                worldBox = transformBox(actor->getTransform(), boundingBox);
+            }
+
+            if (actor->spatialProxy == SpatialIndex::NULL_PROXY)
+                actor->spatialProxy = spatialIndex.createProxy(worldBox, actor);
+            else
+                spatialIndex.moveProxy(actor->spatialProxy, worldBox);
+        }
+
+        void Layer::updateActors() const
+        {
+            if (hierarchyDirty)
+            {
+                transformHierarchy.clear();
+
+                uint32_t index = 0;
+                for (Actor* actor : children)
+                    updateHierarchyIndices(actor, index);
+
+                hierarchyDirty = false;
+            }
+
+            if (transformHierarchyEnabled)
+            {
+                changedTransforms.clear();
+                transformHierarchy.update(changedTransforms);
+
+                for (uint32_t index : changedTransforms)
+                {
+                    int32_t parent = transformHierarchy.getParent(index);
+                    transformHierarchy.getActor(index)->setWorldTransform(parent == TransformHierarchy::NO_PARENT ?
+                                                                          Matrix4::identity() :
+                                                                          transformHierarchy.getWorldTransform(static_cast<uint32_t>(parent)),
+                                                                          transformHierarchy.getWorldTransform(index));
+                }
+            }
+
+            for (size_t i = 0; i < dirtyActors.size(); ++i)
+            {
+                Actor* actor = dirtyActors[i];
+
+                // already updated together with a parent
+                if (!actor->worldStateDirty) continue;
+
+                // start from the topmost invalidated parent, so that every subtree is updated only once
+                Actor* topActor = actor;
+                for (ActorContainer* parent = actor->parent; parent != this; parent = static_cast<Actor*>(parent)->parent)
+                    if (static_cast<Actor*>(parent)->worldStateDirty) topActor = static_cast<Actor*>(parent);
+
+                if (topActor->parent == this)
+                    topActor->updateWorldState(Matrix4::identity(), 0, false);
+                else
+                {
+                    Actor* parent = static_cast<Actor*>(topActor->parent);
+                    topActor->updateWorldState(parent->getTransform(), parent->worldOrder, parent->worldHidden);
+                }
+            }
+
+            dirtyActors.clear();
+        }
+
+        void Layer::updateHierarchyIndices(Actor* actor, uint32_t& index) const
+        {
+            actor->hierarchyIndex = index++;
+
+            if (transformHierarchyEnabled)
+            {
+                int32_t parent = (actor->parent == this) ?
+                    TransformHierarchy::NO_PARENT :
+                    static_cast<int32_t>(static_cast<Actor*>(actor->parent)->hierarchyIndex);
+
+                transformHierarchy.add(actor, parent, actor->position, actor->rotation, actor->getFinalScale());
+            }
+
+            for (Actor* child : actor->children)
+                updateHierarchyIndices(child, index);
+        }
+
         void Layer::removeFromScene()
         {
             if (scene) scene->removeLayer(this);
@@ -4,8 +4,16 @@
 #define OUZEL_SCENE_LAYER_HPP
 
 #include <cstdint>
+#include <functional>
+#include <memory>
 #include <vector>
 #include "scene/ActorContainer.hpp"
+#include "scene/DrawQueue.hpp"
+#include "scene/MeshInstancer.hpp"
+#include "scene/SpatialIndex.hpp"
+#include "scene/TransformHierarchy.hpp"
+#include "scene/SpriteBatcher.hpp"
+#include "math/Box3.hpp"
 #include "math/Vector2.hpp"
 
 namespace ouzel
@@ -19,6 +27,8 @@ namespace ouzel
         class Layer: public ActorContainer
         {
             friend Scene;
+            friend Actor;
+            friend ActorContainer;
             friend Camera;
             friend Light;
         public:
@@ -31,10 +41,31 @@ namespace ouzel
 
             inline const std::vector<Camera*>& getCameras() const { return cameras; }
 
+            inline SpriteBatcher& getSpriteBatcher() { return spriteBatcher; }
+            inline const SpriteBatcher& getSpriteBatcher() const { return spriteBatcher; }
+
+            // groups the actors of the same order by material, which allows more sprites to be batched,
+            // but changes the draw order of overlapping actors with the same order
+            inline bool isMaterialSortingEnabled() const { return materialSorting; }
+            inline void setMaterialSortingEnabled(bool newMaterialSorting) { materialSorting = newMaterialSorting; }
+
+            inline MeshInstancer& getMeshInstancer() { return meshInstancer; }
+            inline const MeshInstancer& getMeshInstancer() const { return meshInstancer; }
+
             std::pair<Actor*, Vector3> pickActor(const Vector2& position, bool renderTargets = false) const;
             std::vector<std::pair<Actor*, Vector3>> pickActors(const Vector2& position, bool renderTargets = false) const;
             std::vector<Actor*> pickActors(const std::vector<Vector2>& edges, bool renderTargets = false) const;
 
+            void findActors(const Vector2& position, std::vector<std::pair<Actor*, Vector3>>& actors) const override;
+            void findActors(const std::vector<Vector2>& edges, std::vector<Actor*>& actors) const override;
+
+            inline const SpatialIndex& getSpatialIndex() const { return spatialIndex; }
+
+            // keeps the transforms of all actors in contiguous arrays and updates them in a single pass,
+            // faster when many actors move every frame
+            inline bool isTransformHierarchyEnabled() const { return transformHierarchyEnabled; }
+            void setTransformHierarchyEnabled(bool newTransformHierarchyEnabled);
+
             inline int32_t getOrder() const { return order; }
             void setOrder(int32_t newOrder);
 
@@ -51,12 +82,46 @@ namespace ouzel
             virtual void recalculateProjection();
             void enter() override;
 
+            void addDirtyActor(Actor* actor);
+            void removeActor(Actor* actor);
+            void updateProxy(Actor* actor);
+            inline void invalidateHierarchy() { hierarchyDirty = true; }
+            // brings the world state of the invalidated actors and the spatial index up to date
+            void updateActors() const;
+            void updateHierarchyIndices(Actor* actor, uint32_t& index) const;
+
+            // actors that are visible to a camera, in draw order
+            struct CameraView final
+            {
+                Box3 visibleBox;
+                std::vector<Actor*> visibleActors;
+                std::vector<int32_t> traversalStack;
+                DrawQueue drawQueue;
+            };
+
+            void cull(Camera* camera, CameraView& cameraView) const;
+
             Scene* scene = nullptr;
 
             std::vector<Camera*> cameras;
             std::vector<Light*> lights;
 
             int32_t order = 0;
+            bool materialSorting = false;
+
+            SpatialIndex spatialIndex;
+            mutable std::vector<Actor*> dirtyActors;
+            mutable bool hierarchyDirty = true;
+            mutable std::vector<Actor*> queryResult;
+
+            bool transformHierarchyEnabled = false;
+            mutable TransformHierarchy transformHierarchy;
+            mutable std::vector<uint32_t> changedTransforms;
+
+            std::vector<std::unique_ptr<CameraView>> cameraViews;
+            std::vector<std::function<void()>> cullJobs;
+            SpriteBatcher spriteBatcher;
+            MeshInstancer meshInstancer;
         };
     } // namespace scene
 } // namespace ouzel
@@ -0,0 +1,118 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <iterator>
+#include "MeshInstancer.hpp"
+#include "core/Engine.hpp"
+#include "graphics/Renderer.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        bool MeshInstancer::isInstanceable(const graphics::Material& material)
+        {
+            return material.shader &&
+                material.shader->getInstancedShader() &&
+                material.blendState &&
+                engine->getRenderer()->getDevice()->isInstancingSupported();
+        }
+
+        void MeshInstancer::begin()
+        {
+            instances.clear();
+            currentBuffer = 0;
+            stats = Stats();
+        }
+
+        void MeshInstancer::addInstance(const graphics::Material& material,
+                                        uintptr_t newIndexBuffer,
+                                        uint32_t newIndexCount,
+                                        uint32_t newIndexSize,
+                                        uintptr_t newVertexBuffer,
+                                        const Matrix4& transformMatrix,
+                                        float opacity,
+                                        const Matrix4& renderViewProjection)
+        {
+            uintptr_t newShader = material.shader->getInstancedShader()->getResource();
+            uintptr_t newBlendState = material.blendState->getResource();
+            uintptr_t newTextures[graphics::Texture::LAYERS];
+            for (uint32_t layer = 0; layer < graphics::Texture::LAYERS; ++layer)
+                newTextures[layer] = material.textures[layer] ? material.textures[layer]->getResource() : 0;
+
+            if (!instances.empty() &&
+                (newIndexBuffer != indexBuffer ||
+                 newIndexCount != indexCount ||
+                 newIndexSize != indexSize ||
+                 newVertexBuffer != vertexBuffer ||
+                 newShader != shader ||
+                 newBlendState != blendState ||
+                 material.cullMode != cullMode ||
+                 !std::equal(std::begin(newTextures), std::end(newTextures), std::begin(textures)) ||
+                 viewProjection != renderViewProjection))
+                flush();
+
+            if (instances.empty())
+            {
+                indexBuffer = newIndexBuffer;
+                indexCount = newIndexCount;
+                indexSize = newIndexSize;
+                vertexBuffer = newVertexBuffer;
+                shader = newShader;
+                blendState = newBlendState;
+                cullMode = material.cullMode;
+                std::copy(std::begin(newTextures), std::end(newTextures), std::begin(textures));
+                viewProjection = renderViewProjection;
+            }
+
+            float alpha = clamp(material.diffuseColor.normA() * opacity * material.opacity, 0.0F, 1.0F);
+
+            instances.push_back(graphics::Instance(transformMatrix,
+                                                   Color(material.diffuseColor.r,
+                                                         material.diffuseColor.g,
+                                                         material.diffuseColor.b,
+                                                         static_cast<uint8_t>(alpha * 255.0F))));
+
+            ++stats.instanceCount;
+        }
+
+        void MeshInstancer::flush()
+        {
+            if (instances.empty()) return;
+
+            if (currentBuffer >= instanceBuffers.size())
+            {
+                std::unique_ptr<graphics::Buffer> instanceBuffer(new graphics::Buffer(*engine->getRenderer()));
+                instanceBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
+                instanceBuffers.push_back(std::move(instanceBuffer));
+            }
+
+            const std::unique_ptr<graphics::Buffer>& instanceBuffer = instanceBuffers[currentBuffer++];
+            instanceBuffer->setData(instances.data(), static_cast<uint32_t>(getVectorSize(instances)));
+
+            float colorVector[] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+            engine->getRenderer()->setCullMode(cullMode);
+            engine->getRenderer()->setPipelineState(blendState, shader);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                      viewProjection.m,
+                                                      static_cast<uint32_t>(sizeof(viewProjection.m) / sizeof(float)));
+            engine->getRenderer()->setTextures(textures, graphics::Texture::LAYERS);
+            engine->getRenderer()->drawInstanced(indexBuffer,
+                                                 indexCount,
+                                                 indexSize,
+                                                 vertexBuffer,
+                                                 instanceBuffer->getResource(),
+                                                 static_cast<uint32_t>(instances.size()),
+                                                 graphics::DrawMode::TRIANGLE_LIST,
+                                                 0);
+
+            ++stats.drawCount;
+
+            instances.clear();
+        }
+    } // namespace scene
+} // namespace ouzel
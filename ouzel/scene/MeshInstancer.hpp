@@ -0,0 +1,77 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_MESHINSTANCER_HPP
+#define OUZEL_SCENE_MESHINSTANCER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "graphics/Buffer.hpp"
+#include "graphics/Material.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix4.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Merges consecutive draws of the same mesh with the same render state into a single instanced draw call.
+        // The transforms and colors are passed in the instance buffer to the instanced variant of the material's shader.
+        class MeshInstancer final
+        {
+        public:
+            struct Stats final
+            {
+                uint32_t instanceCount = 0;
+                uint32_t drawCount = 0;
+            };
+
+            MeshInstancer() = default;
+
+            MeshInstancer(const MeshInstancer&) = delete;
+            MeshInstancer& operator=(const MeshInstancer&) = delete;
+
+            MeshInstancer(MeshInstancer&&) = delete;
+            MeshInstancer& operator=(MeshInstancer&&) = delete;
+
+            // the render device has to support instancing and the shader has to have an instanced variant
+            static bool isInstanceable(const graphics::Material& material);
+
+            void begin();
+
+            void addInstance(const graphics::Material& material,
+                             uintptr_t indexBuffer,
+                             uint32_t indexCount,
+                             uint32_t indexSize,
+                             uintptr_t vertexBuffer,
+                             const Matrix4& transformMatrix,
+                             float opacity,
+                             const Matrix4& renderViewProjection);
+
+            void flush();
+
+            inline const Stats& getStats() const { return stats; }
+
+        private:
+            uintptr_t indexBuffer = 0;
+            uint32_t indexCount = 0;
+            uint32_t indexSize = 0;
+            uintptr_t vertexBuffer = 0;
+            uintptr_t shader = 0;
+            uintptr_t blendState = 0;
+            graphics::CullMode cullMode = graphics::CullMode::NONE;
+            uintptr_t textures[graphics::Texture::LAYERS] = {};
+            Matrix4 viewProjection;
+
+            std::vector<graphics::Instance> instances;
+
+            // every instanced draw of a frame gets its own buffer, so that uploads never overwrite data that is still needed
+            std::vector<std::unique_ptr<graphics::Buffer>> instanceBuffers;
+            size_t currentBuffer = 0;
+
+            Stats stats;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_MESHINSTANCER_HPP
@@ -0,0 +1,581 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include "core/Setup.h"
+#if OUZEL_SUPPORTS_SSE
+#include <xmmintrin.h>
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+#include <arm_neon.h>
+#endif
+#include "ParticleStore.hpp"
+#include "math/MathUtils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // four lanes of floats, comparisons return lanes with all bits set for true
+#if OUZEL_SUPPORTS_SSE
+        typedef __m128 Float4;
+
+        static inline Float4 load4(const float* p) { return _mm_loadu_ps(p); }
+        static inline void store4(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+        static inline Float4 set4(float a) { return _mm_set1_ps(a); }
+        static inline Float4 add4(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+        static inline Float4 sub4(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+        static inline Float4 mul4(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+        static inline Float4 div4(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+        static inline Float4 sqrt4(Float4 a) { return _mm_sqrt_ps(a); }
+        static inline Float4 min4(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+        static inline Float4 max4(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+        static inline Float4 equal4(Float4 a, Float4 b) { return _mm_cmpeq_ps(a, b); }
+        static inline Float4 greater4(Float4 a, Float4 b) { return _mm_cmpgt_ps(a, b); }
+        static inline Float4 or4(Float4 a, Float4 b) { return _mm_or_ps(a, b); }
+        static inline Float4 select4(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+#elif OUZEL_SUPPORTS_NEON && !OUZEL_SUPPORTS_NEON_CHECK
+        typedef float32x4_t Float4;
+
+        static inline Float4 load4(const float* p) { return vld1q_f32(p); }
+        static inline void store4(float* p, Float4 a) { vst1q_f32(p, a); }
+        static inline Float4 set4(float a) { return vdupq_n_f32(a); }
+        static inline Float4 add4(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+        static inline Float4 sub4(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+        static inline Float4 mul4(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+        static inline Float4 div4(Float4 a, Float4 b)
+        {
+            // reciprocal estimate refined with two Newton-Raphson steps
+            float32x4_t r = vrecpeq_f32(b);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            r = vmulq_f32(vrecpsq_f32(b, r), r);
+            return vmulq_f32(a, r);
+        }
+        static inline Float4 sqrt4(Float4 a)
+        {
+            float32x4_t r = vrsqrteq_f32(a);
+            r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+            r = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, r), r), r);
+            // the reciprocal square root of zero is infinite
+            return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.0F)), a, vmulq_f32(a, r));
+        }
+        static inline Float4 min4(Float4 a, Float4 b) { return vminq_f32(a, b); }
+        static inline Float4 max4(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+        static inline Float4 equal4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vceqq_f32(a, b)); }
+        static inline Float4 greater4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+        static inline Float4 or4(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+        static inline Float4 select4(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+#else
+        struct Float4 final
+        {
+            float v[4];
+        };
+
+        static inline Float4 load4(const float* p) { Float4 r; std::copy(p, p + 4, r.v); return r; }
+        static inline void store4(float* p, Float4 a) { std::copy(a.v, a.v + 4, p); }
+        static inline Float4 set4(float a) { Float4 r = {{a, a, a, a}}; return r; }
+        static inline Float4 add4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] += b.v[i]; return a; }
+        static inline Float4 sub4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] -= b.v[i]; return a; }
+        static inline Float4 mul4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] *= b.v[i]; return a; }
+        static inline Float4 div4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] /= b.v[i]; return a; }
+        static inline Float4 sqrt4(Float4 a) { for (int i = 0; i < 4; ++i) a.v[i] = sqrtf(a.v[i]); return a; }
+        static inline Float4 min4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = std::min(a.v[i], b.v[i]); return a; }
+        static inline Float4 max4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = std::max(a.v[i], b.v[i]); return a; }
+        // masks are stored as 1 and 0 in the scalar version
+        static inline Float4 equal4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = (a.v[i] == b.v[i]) ? 1.0F : 0.0F; return a; }
+        static inline Float4 greater4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = (a.v[i] > b.v[i]) ? 1.0F : 0.0F; return a; }
+        static inline Float4 or4(Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = (a.v[i] != 0.0F || b.v[i] != 0.0F) ? 1.0F : 0.0F; return a; }
+        static inline Float4 select4(Float4 mask, Float4 a, Float4 b) { for (int i = 0; i < 4; ++i) a.v[i] = (mask.v[i] != 0.0F) ? a.v[i] : b.v[i]; return a; }
+#endif
+
+        ParticleRandom::ParticleRandom(uint32_t seed)
+        {
+            setSeed(seed);
+        }
+
+        void ParticleRandom::setSeed(uint32_t seed)
+        {
+            // splitmix32 spreads the seed over the lanes, xorshift must not start from zero
+            for (uint32_t lane = 0; lane < 4; ++lane)
+            {
+                uint32_t z = (seed += 0x9E3779B9);
+                z = (z ^ (z >> 16)) * 0x85EBCA6B;
+                z = (z ^ (z >> 13)) * 0xC2B2AE35;
+                z ^= z >> 16;
+                state[lane] = z ? z : 0x6D2B79F5;
+            }
+        }
+
+        void ParticleRandom::generate(float* values, uint32_t count)
+        {
+            for (uint32_t i = 0; i < count; i += 4)
+            {
+                float lanes[4];
+
+                for (uint32_t lane = 0; lane < 4; ++lane)
+                {
+                    uint32_t x = state[lane];
+                    x ^= x << 13;
+                    x ^= x >> 17;
+                    x ^= x << 5;
+                    state[lane] = x;
+
+                    // the upper bits as the mantissa of a float in the range [1, 2)
+                    uint32_t bits = (x >> 9) | 0x3F800000;
+                    memcpy(&lanes[lane], &bits, sizeof(float));
+                }
+
+                uint32_t laneCount = std::min(count - i, 4U);
+                for (uint32_t lane = 0; lane < laneCount; ++lane)
+                    values[i + lane] = lanes[lane] * 2.0F - 3.0F;
+            }
+        }
+
+        std::vector<float> ParticleStore::* const ParticleStore::ARRAYS[ARRAY_COUNT] = {
+            &ParticleStore::life,
+            &ParticleStore::positionX,
+            &ParticleStore::positionY,
+            &ParticleStore::directionX,
+            &ParticleStore::directionY,
+            &ParticleStore::radialAcceleration,
+            &ParticleStore::tangentialAcceleration,
+            &ParticleStore::angleCos,
+            &ParticleStore::angleSin,
+            &ParticleStore::angleStepCos,
+            &ParticleStore::angleStepSin,
+            &ParticleStore::radius,
+            &ParticleStore::deltaRadius,
+            &ParticleStore::colorRed,
+            &ParticleStore::colorGreen,
+            &ParticleStore::colorBlue,
+            &ParticleStore::colorAlpha,
+            &ParticleStore::deltaColorRed,
+            &ParticleStore::deltaColorGreen,
+            &ParticleStore::deltaColorBlue,
+            &ParticleStore::deltaColorAlpha,
+            &ParticleStore::size2,
+            &ParticleStore::deltaSize2,
+            &ParticleStore::rotationCos,
+            &ParticleStore::rotationSin,
+            &ParticleStore::rotationStepCos,
+            &ParticleStore::rotationStepSin
+        };
+
+        void ParticleStore::reserve(uint32_t newCapacity)
+        {
+            capacity = newCapacity;
+            if (size > capacity) size = capacity;
+
+            uint32_t paddedCapacity = (capacity + 3) & ~3U;
+
+            for (std::vector<float> ParticleStore::* array : ARRAYS)
+                (this->*array).resize(paddedCapacity);
+
+            survivors.reserve(capacity);
+        }
+
+        void ParticleStore::emit(uint32_t count, const ParticleSystemData& particleSystemData,
+                                 const Vector2& position, float step, ParticleRandom& random)
+        {
+            count = std::min(count, capacity - size);
+            if (!count) return;
+
+            static const uint32_t RANDOM_VALUES_PER_PARTICLE = 19;
+
+            randomValues.resize(count * RANDOM_VALUES_PER_PARTICLE);
+            random.generate(randomValues.data(), static_cast<uint32_t>(randomValues.size()));
+
+            // every field takes the next count random values, so all loops run over contiguous memory
+            const float* r = randomValues.data();
+            const uint32_t first = size;
+            const uint32_t end = size + count;
+
+            for (uint32_t i = first; i < end; ++i)
+                life[i] = std::max(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * r[i - first], 0.0F);
+            r += count;
+
+            for (uint32_t i = first; i < end; ++i)
+                positionX[i] = particleSystemData.sourcePosition.x + position.x + particleSystemData.sourcePositionVariance.x * r[i - first];
+            r += count;
+
+            for (uint32_t i = first; i < end; ++i)
+                positionY[i] = particleSystemData.sourcePosition.y + position.y + particleSystemData.sourcePositionVariance.y * r[i - first];
+            r += count;
+
+            for (uint32_t i = first; i < end; ++i)
+            {
+                float startSize = std::max(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * r[i - first], 0.0F);
+                float finishSize = std::max(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * r[count + i - first], 0.0F);
+                size2[i] = startSize / 2.0F;
+                deltaSize2[i] = (finishSize - startSize) / life[i] / 2.0F;
+            }
+            r += count * 2;
+
+            struct ColorChannel
+            {
+                float start;
+                float startVariance;
+                float finish;
+                float finishVariance;
+                std::vector<float>* color;
+                std::vector<float>* deltaColor;
+            };
+
+            const ColorChannel channels[] = {
+                {particleSystemData.startColorRed, particleSystemData.startColorRedVariance,
+                    particleSystemData.finishColorRed, particleSystemData.finishColorRedVariance, &colorRed, &deltaColorRed},
+                {particleSystemData.startColorGreen, particleSystemData.startColorGreenVariance,
+                    particleSystemData.finishColorGreen, particleSystemData.finishColorGreenVariance, &colorGreen, &deltaColorGreen},
+                {particleSystemData.startColorBlue, particleSystemData.startColorBlueVariance,
+                    particleSystemData.finishColorBlue, particleSystemData.finishColorBlueVariance, &colorBlue, &deltaColorBlue},
+                {particleSystemData.startColorAlpha, particleSystemData.startColorAlphaVariance,
+                    particleSystemData.finishColorAlpha, particleSystemData.finishColorAlphaVariance, &colorAlpha, &deltaColorAlpha}
+            };
+
+            for (const ColorChannel& channel : channels)
+            {
+                float* color = channel.color->data();
+                float* deltaColor = channel.deltaColor->data();
+
+                for (uint32_t i = first; i < end; ++i)
+                {
+                    float startColor = clamp(channel.start + channel.startVariance * r[i - first], 0.0F, 1.0F);
+                    float finishColor = clamp(channel.finish + channel.finishVariance * r[count + i - first], 0.0F, 1.0F);
+                    color[i] = startColor;
+                    deltaColor[i] = (finishColor - startColor) / life[i];
+                }
+                r += count * 2;
+            }
+
+            const float* startRotations = r;
+            const float* finishRotations = r + count;
+            r += count * 2;
+
+            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
+            {
+                for (uint32_t i = first; i < end; ++i)
+                {
+                    uint32_t n = i - first;
+
+                    radialAcceleration[i] = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * r[n];
+                    tangentialAcceleration[i] = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * r[count + n];
+
+                    float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * r[count * 2 + n]);
+                    float s = particleSystemData.speed + particleSystemData.speedVariance * r[count * 3 + n];
+                    directionX[i] = cosf(a) * s;
+                    directionY[i] = sinf(a) * s;
+
+                    float rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * startRotations[n];
+                    float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * finishRotations[n];
+                    float deltaRotation = (finishRotation - rotation) / life[i];
+
+                    if (particleSystemData.rotationIsDir)
+                        rotation = -radToDeg(atan2f(directionY[i], directionX[i]));
+
+                    float rotationAngle = -degToRad(rotation);
+                    rotationCos[i] = cosf(rotationAngle);
+                    rotationSin[i] = sinf(rotationAngle);
+
+                    float rotationStep = -degToRad(deltaRotation * step);
+                    rotationStepCos[i] = cosf(rotationStep);
+                    rotationStepSin[i] = sinf(rotationStep);
+                }
+            }
+            else
+            {
+                for (uint32_t i = first; i < end; ++i)
+                {
+                    uint32_t n = i - first;
+
+                    radius[i] = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * r[n];
+
+                    float angle = degToRad(particleSystemData.angle + particleSystemData.angleVariance * r[count + n]);
+                    angleCos[i] = cosf(angle);
+                    angleSin[i] = sinf(angle);
+
+                    float degreesPerSecond = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * r[count * 2 + n]);
+                    angleStepCos[i] = cosf(degreesPerSecond * step);
+                    angleStepSin[i] = sinf(degreesPerSecond * step);
+
+                    float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * r[count * 3 + n];
+                    deltaRadius[i] = (endRadius - radius[i]) / life[i];
+
+                    float rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * startRotations[n];
+                    float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * finishRotations[n];
+                    float deltaRotation = (finishRotation - rotation) / life[i];
+
+                    float rotationAngle = -degToRad(rotation);
+                    rotationCos[i] = cosf(rotationAngle);
+                    rotationSin[i] = sinf(rotationAngle);
+
+                    float rotationStep = -degToRad(deltaRotation * step);
+                    rotationStepCos[i] = cosf(rotationStep);
+                    rotationStepSin[i] = sinf(rotationStep);
+                }
+            }
+
+            size = end;
+        }
+
+        void ParticleStore::update(float step, const ParticleSystemData& particleSystemData)
+        {
+            if (!size) return;
+
+            // the flag has always been used as a multiplier of the vertical movement
+            float yCoordFlipped = particleSystemData.yCoordFlipped ? 1.0F : 0.0F;
+
+            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
+                updateGravity(step, particleSystemData.gravity, yCoordFlipped);
+            else
+                updateRadius(step, yCoordFlipped);
+
+            updateCommon(step);
+            removeDead();
+        }
+
+        void ParticleStore::updateGravity(float step, const Vector2& gravity, float yCoordFlipped)
+        {
+            const Float4 zero = set4(0.0F);
+            const Float4 one = set4(1.0F);
+            const Float4 step4 = set4(step);
+            const Float4 gravityX = set4(gravity.x * step);
+            const Float4 gravityY = set4(gravity.y * step);
+            const Float4 positionStep = set4(step * yCoordFlipped);
+
+            for (uint32_t i = 0; i < size; i += 4)
+            {
+                Float4 x = load4(&positionX[i]);
+                Float4 y = load4(&positionY[i]);
+
+                // the radial direction is only used when the particle is on an axis
+                Float4 length = sqrt4(add4(mul4(x, x), mul4(y, y)));
+                Float4 onAxis = or4(equal4(x, zero), equal4(y, zero));
+                Float4 inverseLength = div4(one, select4(greater4(length, zero), length, one));
+                Float4 radialX = select4(onAxis, mul4(x, inverseLength), zero);
+                Float4 radialY = select4(onAxis, mul4(y, inverseLength), zero);
+
+                Float4 radial = load4(&radialAcceleration[i]);
+                Float4 tangential = load4(&tangentialAcceleration[i]);
+
+                // direction += (gravity + radial + tangential) * step
+                Float4 accelerationX = sub4(mul4(radialX, radial), mul4(radialY, tangential));
+                Float4 accelerationY = add4(mul4(radialY, radial), mul4(radialX, tangential));
+
+                Float4 dx = add4(load4(&directionX[i]), add4(mul4(accelerationX, step4), gravityX));
+                Float4 dy = add4(load4(&directionY[i]), add4(mul4(accelerationY, step4), gravityY));
+                store4(&directionX[i], dx);
+                store4(&directionY[i], dy);
+
+                store4(&positionX[i], add4(x, mul4(dx, positionStep)));
+                store4(&positionY[i], add4(y, mul4(dy, positionStep)));
+            }
+        }
+
+        void ParticleStore::updateRadius(float step, float yCoordFlipped)
+        {
+            const Float4 step4 = set4(step);
+            const Float4 flip = set4(-yCoordFlipped);
+            const Float4 minusOne = set4(-1.0F);
+
+            for (uint32_t i = 0; i < size; i += 4)
+            {
+                Float4 c = load4(&angleCos[i]);
+                Float4 s = load4(&angleSin[i]);
+                Float4 stepCos = load4(&angleStepCos[i]);
+                Float4 stepSin = load4(&angleStepSin[i]);
+
+                Float4 newCos = sub4(mul4(c, stepCos), mul4(s, stepSin));
+                Float4 newSin = add4(mul4(s, stepCos), mul4(c, stepSin));
+                store4(&angleCos[i], newCos);
+                store4(&angleSin[i], newSin);
+
+                Float4 r = add4(load4(&radius[i]), mul4(load4(&deltaRadius[i]), step4));
+                store4(&radius[i], r);
+
+                store4(&positionX[i], mul4(mul4(newCos, r), minusOne));
+                store4(&positionY[i], mul4(mul4(newSin, r), flip));
+            }
+        }
+
+        void ParticleStore::updateCommon(float step)
+        {
+            const Float4 zero = set4(0.0F);
+            const Float4 step4 = set4(step);
+
+            for (uint32_t i = 0; i < size; i += 4)
+            {
+                store4(&life[i], sub4(load4(&life[i]), step4));
+
+                store4(&colorRed[i], add4(load4(&colorRed[i]), mul4(load4(&deltaColorRed[i]), step4)));
+                store4(&colorGreen[i], add4(load4(&colorGreen[i]), mul4(load4(&deltaColorGreen[i]), step4)));
+                store4(&colorBlue[i], add4(load4(&colorBlue[i]), mul4(load4(&deltaColorBlue[i]), step4)));
+                store4(&colorAlpha[i], add4(load4(&colorAlpha[i]), mul4(load4(&deltaColorAlpha[i]), step4)));
+
+                store4(&size2[i], max4(zero, add4(load4(&size2[i]), mul4(load4(&deltaSize2[i]), step4))));
+
+                Float4 c = load4(&rotationCos[i]);
+                Float4 s = load4(&rotationSin[i]);
+                Float4 stepCos = load4(&rotationStepCos[i]);
+                Float4 stepSin = load4(&rotationStepSin[i]);
+                store4(&rotationCos[i], sub4(mul4(c, stepCos), mul4(s, stepSin)));
+                store4(&rotationSin[i], add4(mul4(s, stepCos), mul4(c, stepSin)));
+            }
+        }
+
+        void ParticleStore::removeDead()
+        {
+            uint32_t firstDead = 0;
+            while (firstDead < size && life[firstDead] >= 0.0F) ++firstDead;
+
+            if (firstDead == size) return;
+
+            survivors.clear();
+            for (uint32_t i = firstDead + 1; i < size; ++i)
+                if (life[i] >= 0.0F) survivors.push_back(i);
+
+            // the survivors are moved down in one pass per array, keeping their order
+            for (std::vector<float> ParticleStore::* array : ARRAYS)
+            {
+                float* values = (this->*array).data();
+                uint32_t index = firstDead;
+
+                for (uint32_t survivor : survivors)
+                    values[index++] = values[survivor];
+            }
+
+            size = firstDead + static_cast<uint32_t>(survivors.size());
+        }
+
+        Box3 ParticleStore::getBoundingBox(const Matrix4* transform) const
+        {
+            Box3 result;
+            if (!size) return result;
+
+            const Matrix4 identity = Matrix4::identity();
+            const float* m = transform ? transform->m : identity.m;
+
+            const Float4 m0 = set4(m[0]), m1 = set4(m[1]), m2 = set4(m[2]);
+            const Float4 m4 = set4(m[4]), m5 = set4(m[5]), m6 = set4(m[6]);
+            const Float4 m12 = set4(m[12]), m13 = set4(m[13]), m14 = set4(m[14]);
+
+            // the first particle fills the lanes, so that the padding of the last group does not affect the bounds
+            float firstX = positionX[0];
+            float firstY = positionY[0];
+            Float4 minX = set4(m[0] * firstX + m[4] * firstY + m[12]);
+            Float4 minY = set4(m[1] * firstX + m[5] * firstY + m[13]);
+            Float4 minZ = set4(m[2] * firstX + m[6] * firstY + m[14]);
+            Float4 maxX = minX, maxY = minY, maxZ = minZ;
+
+            float paddedX[4];
+            float paddedY[4];
+
+            for (uint32_t i = 0; i < size; i += 4)
+            {
+                Float4 x;
+                Float4 y;
+
+                if (i + 4 <= size)
+                {
+                    x = load4(&positionX[i]);
+                    y = load4(&positionY[i]);
+                }
+                else
+                {
+                    for (uint32_t lane = 0; lane < 4; ++lane)
+                    {
+                        paddedX[lane] = (i + lane < size) ? positionX[i + lane] : firstX;
+                        paddedY[lane] = (i + lane < size) ? positionY[i + lane] : firstY;
+                    }
+
+                    x = load4(paddedX);
+                    y = load4(paddedY);
+                }
+
+                Float4 tx = add4(add4(mul4(m0, x), mul4(m4, y)), m12);
+                Float4 ty = add4(add4(mul4(m1, x), mul4(m5, y)), m13);
+                Float4 tz = add4(add4(mul4(m2, x), mul4(m6, y)), m14);
+
+                minX = min4(minX, tx); maxX = max4(maxX, tx);
+                minY = min4(minY, ty); maxY = max4(maxY, ty);
+                minZ = min4(minZ, tz); maxZ = max4(maxZ, tz);
+            }
+
+            float lanes[6][4];
+            store4(lanes[0], minX);
+            store4(lanes[1], minY);
+            store4(lanes[2], minZ);
+            store4(lanes[3], maxX);
+            store4(lanes[4], maxY);
+            store4(lanes[5], maxZ);
+
+            result.min = Vector3(*std::min_element(lanes[0], lanes[0] + 4),
+                                 *std::min_element(lanes[1], lanes[1] + 4),
+                                 *std::min_element(lanes[2], lanes[2] + 4));
+            result.max = Vector3(*std::max_element(lanes[3], lanes[3] + 4),
+                                 *std::max_element(lanes[4], lanes[4] + 4),
+                                 *std::max_element(lanes[5], lanes[5] + 4));
+
+            return result;
+        }
+
+        void ParticleStore::buildVertices(graphics::SpriteVertex* vertices, const Vector2& offset) const
+        {
+            const graphics::SpriteVertex corners[4] = {
+                graphics::SpriteVertex(Vector3(), Color::WHITE, Vector2(0.0F, 1.0F)),
+                graphics::SpriteVertex(Vector3(), Color::WHITE, Vector2(1.0F, 1.0F)),
+                graphics::SpriteVertex(Vector3(), Color::WHITE, Vector2(0.0F, 0.0F)),
+                graphics::SpriteVertex(Vector3(), Color::WHITE, Vector2(1.0F, 0.0F))
+            };
+
+            const Float4 zero = set4(0.0F);
+            const Float4 colorScale = set4(255.0F);
+            const Float4 offsetX = set4(offset.x);
+            const Float4 offsetY = set4(offset.y);
+
+            // corner positions of four particles in the vertex order, followed by the colors
+            float values[12][4];
+
+            for (uint32_t i = 0; i < size; i += 4)
+            {
+                Float4 halfSize = load4(&size2[i]);
+                Float4 hc = mul4(halfSize, load4(&rotationCos[i]));
+                Float4 hs = mul4(halfSize, load4(&rotationSin[i]));
+                Float4 x = add4(load4(&positionX[i]), offsetX);
+                Float4 y = add4(load4(&positionY[i]), offsetY);
+
+                store4(values[0], add4(x, sub4(hs, hc))); // (-size, -size)
+                store4(values[1], sub4(y, add4(hs, hc)));
+                store4(values[2], add4(x, add4(hc, hs))); // (size, -size)
+                store4(values[3], add4(y, sub4(hs, hc)));
+                store4(values[4], sub4(x, add4(hc, hs))); // (-size, size)
+                store4(values[5], add4(y, sub4(hc, hs)));
+                store4(values[6], add4(x, sub4(hc, hs))); // (size, size)
+                store4(values[7], add4(y, add4(hs, hc)));
+
+                store4(values[8], min4(max4(mul4(load4(&colorRed[i]), colorScale), zero), colorScale));
+                store4(values[9], min4(max4(mul4(load4(&colorGreen[i]), colorScale), zero), colorScale));
+                store4(values[10], min4(max4(mul4(load4(&colorBlue[i]), colorScale), zero), colorScale));
+                store4(values[11], min4(max4(mul4(load4(&colorAlpha[i]), colorScale), zero), colorScale));
+
+                uint32_t laneCount = std::min(size - i, 4U);
+
+                for (uint32_t lane = 0; lane < laneCount; ++lane)
+                {
+                    Color color(static_cast<uint8_t>(values[8][lane]),
+                                static_cast<uint8_t>(values[9][lane]),
+                                static_cast<uint8_t>(values[10][lane]),
+                                static_cast<uint8_t>(values[11][lane]));
+
+                    graphics::SpriteVertex* particleVertices = vertices + (i + lane) * 4;
+
+                    for (uint32_t corner = 0; corner < 4; ++corner)
+                    {
+                        particleVertices[corner] = corners[corner];
+                        particleVertices[corner].position = Vector3(values[corner * 2][lane], values[corner * 2 + 1][lane], 0.0F);
+                        particleVertices[corner].color = color;
+                    }
+                }
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,120 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_PARTICLESTORE_HPP
+#define OUZEL_SCENE_PARTICLESTORE_HPP
+
+#include <cstdint>
+#include <vector>
+#include "scene/ParticleSystemData.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Box3.hpp"
+#include "math/Matrix4.hpp"
+#include "math/Vector2.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Four interleaved xorshift generators, fast enough to generate all the random values of an emitted burst at once
+        class ParticleRandom final
+        {
+        public:
+            explicit ParticleRandom(uint32_t seed = 1);
+
+            void setSeed(uint32_t seed);
+
+            // fills the values with uniformly distributed numbers in the range [-1, 1)
+            void generate(float* values, uint32_t count);
+
+        private:
+            uint32_t state[4];
+        };
+
+        // Particles of a particle system stored as a structure of arrays.
+        // The arrays are padded to a multiple of four, so that the kernels can process four particles at a time.
+        class GPUParticleStore;
+
+        class ParticleStore final
+        {
+            friend GPUParticleStore;
+        public:
+            ParticleStore() = default;
+
+            ParticleStore(const ParticleStore&) = delete;
+            ParticleStore& operator=(const ParticleStore&) = delete;
+
+            ParticleStore(ParticleStore&&) = delete;
+            ParticleStore& operator=(ParticleStore&&) = delete;
+
+            void reserve(uint32_t newCapacity);
+            inline uint32_t getCapacity() const { return capacity; }
+            inline uint32_t getSize() const { return size; }
+            inline void clear() { size = 0; }
+
+            // adds up to count particles at the given position, step is the update step the particles are simulated with
+            void emit(uint32_t count, const ParticleSystemData& particleSystemData,
+                      const Vector2& position, float step, ParticleRandom& random);
+            // advances the particles by the step and removes the dead ones
+            void update(float step, const ParticleSystemData& particleSystemData);
+
+            // bounds of the particle positions, transformed by the transform if it is not null
+            Box3 getBoundingBox(const Matrix4* transform) const;
+            // writes four vertices per particle with the offset added to the particle positions
+            void buildVertices(graphics::SpriteVertex* vertices, const Vector2& offset) const;
+
+        private:
+            void updateGravity(float step, const Vector2& gravity, float yCoordFlipped);
+            void updateRadius(float step, float yCoordFlipped);
+            void updateCommon(float step);
+            void removeDead();
+
+            // all the per particle arrays, for resizing and compacting them
+            static const uint32_t ARRAY_COUNT = 27;
+            static std::vector<float> ParticleStore::* const ARRAYS[ARRAY_COUNT];
+
+            uint32_t capacity = 0;
+            uint32_t size = 0;
+
+            std::vector<float> life;
+            std::vector<float> positionX;
+            std::vector<float> positionY;
+
+            // gravity emitter
+            std::vector<float> directionX;
+            std::vector<float> directionY;
+            std::vector<float> radialAcceleration;
+            std::vector<float> tangentialAcceleration;
+
+            // radius emitter, the angle is kept as a unit vector and rotated by a constant step
+            std::vector<float> angleCos;
+            std::vector<float> angleSin;
+            std::vector<float> angleStepCos;
+            std::vector<float> angleStepSin;
+            std::vector<float> radius;
+            std::vector<float> deltaRadius;
+
+            std::vector<float> colorRed;
+            std::vector<float> colorGreen;
+            std::vector<float> colorBlue;
+            std::vector<float> colorAlpha;
+            std::vector<float> deltaColorRed;
+            std::vector<float> deltaColorGreen;
+            std::vector<float> deltaColorBlue;
+            std::vector<float> deltaColorAlpha;
+
+            std::vector<float> size2; // half of the particle size
+            std::vector<float> deltaSize2;
+
+            // the rotation is kept as a unit vector too, so that building the quads needs no trigonometry
+            std::vector<float> rotationCos;
+            std::vector<float> rotationSin;
+            std::vector<float> rotationStepCos;
+            std::vector<float> rotationStepSin;
+
+            std::vector<float> randomValues;
+            std::vector<uint32_t> survivors;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_PARTICLESTORE_HPP
@@ -1,10 +1,12 @@
 // Copyright 2015-2018 Elviss Strazdins. All rights reserved.
 
+#include <algorithm>
 #include <cstdlib>
 #include "core/Setup.h"
 #include "ParticleSystem.hpp"
 #include "core/Engine.hpp"
 #include "SceneManager.hpp"
+#include "ParticleWorld.hpp"
 #include "files/FileSystem.hpp"
 #include "assets/Cache.hpp"
 #include "Actor.hpp"
@@ -18,14 +20,31 @@ namespace ouzel
 {
     namespace scene
     {
+        // two triangles per particle quad
+        template<class T>
+        static void addQuadIndices(std::vector<T>& indices, uint32_t count)
+        {
+            indices.reserve(count * 6);
+
+            for (uint32_t i = 0; i < count; ++i)
+            {
+                indices.push_back(static_cast<T>(i * 4 + 0));
+                indices.push_back(static_cast<T>(i * 4 + 1));
+                indices.push_back(static_cast<T>(i * 4 + 2));
+                indices.push_back(static_cast<T>(i * 4 + 1));
+                indices.push_back(static_cast<T>(i * 4 + 3));
+                indices.push_back(static_cast<T>(i * 4 + 2));
+            }
+        }
+
         ParticleSystem::ParticleSystem():
-            Component(CLASS)
+            Component(CLASS),
+            random(std::uniform_int_distribution<uint32_t>{}(randomEngine))
         {
-            shader = engine->getCache().getShader(SHADER_TEXTURE);
+            shader = engine->getCache().getShader(SHADER_SPRITE);
             blendState = engine->getCache().getBlendState(BLEND_ALPHA);
             whitePixelTexture = engine->getCache().getTexture(TEXTURE_WHITE_PIXEL);
-
-            updateHandler.updateHandler = std::bind(&ParticleSystem::handleUpdate, this, std::placeholders::_1);
+            particleShader = engine->getCache().getShader(SHADER_PARTICLE);
         }
 
         ParticleSystem::ParticleSystem(const ParticleSystemData& initParticleSystemData):
@@ -40,6 +59,11 @@ namespace ouzel
             init(filename);
         }
 
+        ParticleSystem::~ParticleSystem()
+        {
+            if (active) engine->getSceneManager().getParticleWorld().removeParticleSystem(this);
+        }
+
         void ParticleSystem::draw(const Matrix4& transformMatrix,
                                   float opacity,
                                   const Matrix4& renderViewProjection,
@@ -50,200 +74,172 @@ namespace ouzel
                             renderViewProjection,
                             wireframe);
 
-            if (particleCount)
+            if (getParticleCount())
             {
-                if (needsMeshUpdate)
-                {
-                    updateParticleMesh();
-                    needsMeshUpdate = false;
-                }
-
                 Matrix4 transform;
 
-                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE ||
-                    particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
                     transform = renderViewProjection;
+                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                {
+                    Matrix4 parentTransform;
+                    Matrix4::createTranslation(actor->getPosition(), parentTransform);
+                    transform = renderViewProjection * parentTransform;
+                }
                 else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
                     transform = renderViewProjection * transformMatrix;
 
                 float colorVector[] = {1.0F, 1.0F, 1.0F, opacity};
 
-                std::vector<std::vector<float>> pixelShaderConstants(1);
-                pixelShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(transform.m), std::end(transform.m)};
-
                 engine->getRenderer()->setCullMode(graphics::CullMode::NONE);
-                engine->getRenderer()->setPipelineState(blendState->getResource(), shader->getResource());
-                engine->getRenderer()->setShaderConstants(pixelShaderConstants,
-                                                          vertexShaderConstants);
                 engine->getRenderer()->setTextures({wireframe ? whitePixelTexture->getResource() : texture->getResource()});
-                engine->getRenderer()->draw(indexBuffer->getResource(),
-                                            particleCount * 6,
-                                            sizeof(uint16_t),
-                                            vertexBuffer->getResource(),
-                                            graphics::DrawMode::TRIANGLE_LIST,
-                                            0);
-            }
-        }
-
-        void ParticleSystem::update(float delta)
-        {
-            timeSinceUpdate += delta;
-
-            static const float UPDATE_STEP = 1.0F / 60.0F;
-            bool needsBoundingBoxUpdate = false;
 
-            while (timeSinceUpdate >= UPDATE_STEP)
-            {
-                timeSinceUpdate -= UPDATE_STEP;
-
-                if (running && particleSystemData.emissionRate > 0.0F)
+                if (simulation == Simulation::GPU)
                 {
-                    float rate = 1.0F / particleSystemData.emissionRate;
-
-                    if (particleCount < particleSystemData.maxParticles)
+                    for (uint32_t chunk = 0; chunk < gpuParticles.getChunkCount(); ++chunk)
                     {
-                        emitCounter += UPDATE_STEP;
-                        if (emitCounter < 0.0F)
-                            emitCounter = 0.0F;
+                        if (gpuParticles.getChunkLiveCount(chunk) && gpuParticles.isChunkDirty(chunk))
+                        {
+                            chunkVertexBuffers[chunk]->setData(gpuParticles.getChunkVertices(chunk),
+                                                               gpuParticles.getChunkParticleCount(chunk) * 4 * sizeof(graphics::ParticleVertex));
+                            gpuParticles.setChunkUploaded(chunk);
+                        }
                     }
 
-                    uint32_t emitCount = static_cast<uint32_t>(std::min(static_cast<float>(particleSystemData.maxParticles - particleCount), emitCounter / rate));
-                    emitParticles(emitCount);
-                    emitCounter -= rate * emitCount;
-
-                    elapsed += UPDATE_STEP;
-                    if (elapsed < 0.0F)
-                        elapsed = 0.0F;
-                    if (particleSystemData.duration >= 0.0F && particleSystemData.duration < elapsed)
+                    float yCoordFlipped = particleSystemData.yCoordFlipped ? 1.0F : 0.0F;
+                    float radiusEmitter = (particleSystemData.emitterType == ParticleSystemData::EmitterType::RADIUS) ? 1.0F : 0.0F;
+
+                    // modelViewProj, parameters and gravity
+                    float vertexConstants[24];
+                    std::copy(std::begin(transform.m), std::end(transform.m), vertexConstants);
+                    vertexConstants[16] = static_cast<float>(gpuParticles.getCurrentStep());
+                    vertexConstants[17] = radiusEmitter;
+                    vertexConstants[18] = updateStep * yCoordFlipped;
+                    vertexConstants[19] = yCoordFlipped;
+                    vertexConstants[20] = particleSystemData.gravity.x * updateStep;
+                    vertexConstants[21] = particleSystemData.gravity.y * updateStep;
+                    vertexConstants[22] = 0.0F;
+                    vertexConstants[23] = 0.0F;
+
+                    engine->getRenderer()->setPipelineState(blendState->getResource(), particleShader->getResource());
+                    engine->getRenderer()->setShaderConstants(colorVector,
+                                                              static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                              vertexConstants,
+                                                              static_cast<uint32_t>(sizeof(vertexConstants) / sizeof(float)));
+
+                    for (uint32_t chunk = 0; chunk < gpuParticles.getChunkCount(); ++chunk)
                     {
-                        finished = true;
-                        stop();
+                        if (gpuParticles.getChunkLiveCount(chunk))
+                            engine->getRenderer()->draw(chunkIndexBuffer->getResource(),
+                                                        gpuParticles.getChunkParticleCount(chunk) * 6,
+                                                        sizeof(uint16_t),
+                                                        chunkVertexBuffers[chunk]->getResource(),
+                                                        graphics::DrawMode::TRIANGLE_LIST,
+                                                        0);
                     }
                 }
-                else if (active && !particleCount)
+                else
                 {
-                    active = false;
-                    updateHandler.remove();
-
-                    std::unique_ptr<AnimationEvent> finishEvent(new AnimationEvent());
-                    finishEvent->type = Event::Type::ANIMATION_FINISH;
-                    finishEvent->component = this;
-                    engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+                    if (needsMeshUpdate)
+                    {
+                        // the vertices were built by the particle world, only the live particles are uploaded
+                        vertexBuffer->setData(vertices.data(), particles.getSize() * 4 * sizeof(graphics::SpriteVertex));
+                        needsMeshUpdate = false;
+                    }
 
-                    return;
+                    engine->getRenderer()->setPipelineState(blendState->getResource(), shader->getResource());
+                    engine->getRenderer()->setShaderConstants(colorVector,
+                                                              static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                              transform.m,
+                                                              static_cast<uint32_t>(sizeof(transform.m) / sizeof(float)));
+                    engine->getRenderer()->draw(indexBuffer->getResource(),
+                                                particles.getSize() * 6,
+                                                indexSize,
+                                                vertexBuffer->getResource(),
+                                                graphics::DrawMode::TRIANGLE_LIST,
+                                                0);
                 }
+            }
+        }
 
-                if (active)
-                {
-                    for (uint32_t counter = particleCount; counter > 0; --counter)
-                    {
-                        size_t i = counter - 1;
-
-                        particles[i].life -= UPDATE_STEP;
+        void ParticleSystem::prepareUpdate(float step)
+        {
+            updateStep = step;
+            attached = (actor != nullptr);
 
-                        if (particles[i].life >= 0.0F)
-                        {
-                            if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
-                            {
-                                Vector2 tmp;
-                                Vector2 radial;
-                                Vector2 tangential;
-
-                                // radial acceleration
-                                if (particles[i].position.x == 0.0F || particles[i].position.y == 0.0F)
-                                {
-                                    radial = particles[i].position;
-                                    radial.normalize();
-                                }
-                                tangential = radial;
-                                radial *= particles[i].radialAcceleration;
-
-                                // tangential acceleration
-                                std::swap(tangential.x, tangential.y);
-                                tangential.x *= - particles[i].tangentialAcceleration;
-                                tangential.y *= particles[i].tangentialAcceleration;
-
-                                // (gravity + radial + tangential) * UPDATE_STEP
-                                tmp.x = radial.x + tangential.x + particleSystemData.gravity.x;
-                                tmp.y = radial.y + tangential.y + particleSystemData.gravity.y;
-                                tmp.x *= UPDATE_STEP;
-                                tmp.y *= UPDATE_STEP;
-
-                                particles[i].direction.x += tmp.x;
-                                particles[i].direction.y += tmp.y;
-                                tmp.x = particles[i].direction.x * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                tmp.y = particles[i].direction.y * UPDATE_STEP * particleSystemData.yCoordFlipped;
-                                particles[i].position.x += tmp.x;
-                                particles[i].position.y += tmp.y;
-                            }
-                            else
-                            {
-                                particles[i].angle += particles[i].degreesPerSecond * UPDATE_STEP;
-                                particles[i].radius += particles[i].deltaRadius * UPDATE_STEP;
-                                particles[i].position.x = -cosf(particles[i].angle) * particles[i].radius;
-                                particles[i].position.y = -sinf(particles[i].angle) * particles[i].radius * particleSystemData.yCoordFlipped;
-                            }
-
-                            // color r,g,b,a
-                            particles[i].colorRed += particles[i].deltaColorRed * UPDATE_STEP;
-                            particles[i].colorGreen += particles[i].deltaColorGreen * UPDATE_STEP;
-                            particles[i].colorBlue += particles[i].deltaColorBlue * UPDATE_STEP;
-                            particles[i].colorAlpha += particles[i].deltaColorAlpha * UPDATE_STEP;
-
-                            // size
-                            particles[i].size += (particles[i].deltaSize * UPDATE_STEP);
-                            particles[i].size = std::max(0.0F, particles[i].size);
-
-                            // angle
-                            particles[i].rotation += particles[i].deltaRotation * UPDATE_STEP;
-                        }
-                        else
-                        {
-                            particles[i] = particles[particleCount - 1];
-                            --particleCount;
-                        }
-                    }
+            if (actor)
+            {
+                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
+                    emitPosition = actor->convertLocalToWorld(Vector3());
+                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                    emitPosition = actor->convertLocalToWorld(Vector3()) - actor->getPosition();
+                else
+                    emitPosition = Vector2();
 
-                    needsMeshUpdate = true;
-                    needsBoundingBoxUpdate = true;
-                }
+                boundsTransform = actor->getInverseTransform();
             }
+        }
 
-            if (needsBoundingBoxUpdate)
+        void ParticleSystem::simulate()
+        {
+            if (simulation == Simulation::GPU)
+                gpuParticles.beginStep();
+
+            if (running && particleSystemData.emissionRate > 0.0F)
             {
-                // Update bounding box
-                boundingBox.reset();
+                float rate = 1.0F / particleSystemData.emissionRate;
 
-                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE ||
-                    particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+                if (getParticleCount() < particleSystemData.maxParticles)
                 {
-                    if (actor)
-                    {
-                        const Matrix4& inverseTransform = actor->getInverseTransform();
-
-                        for (uint32_t i = 0; i < particleCount; ++i)
-                        {
-                            Vector3 position = Vector3(particles[i].position);
-                            inverseTransform.transformPoint(position);
-                            boundingBox.insertPoint(position);
-                        }
-                    }
+                    emitCounter += updateStep;
+                    if (emitCounter < 0.0F)
+                        emitCounter = 0.0F;
                 }
-                else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
+
+                uint32_t emitCount = static_cast<uint32_t>(std::min(static_cast<float>(particleSystemData.maxParticles - getParticleCount()), emitCounter / rate));
+                emitParticles(emitCount);
+                emitCounter -= rate * emitCount;
+
+                elapsed += updateStep;
+                if (elapsed < 0.0F)
+                    elapsed = 0.0F;
+                if (particleSystemData.duration >= 0.0F && particleSystemData.duration < elapsed)
                 {
-                    for (uint32_t i = 0; i < particleCount; ++i)
-                        boundingBox.insertPoint(particles[i].position);
+                    finished = true;
+                    stop();
                 }
             }
-        }
+            else if (!getParticleCount())
+            {
+                // the finish event is dispatched by the particle world on the game thread
+                finishPending = true;
+                return;
+            }
 
-        bool ParticleSystem::handleUpdate(const UpdateEvent& event)
-        {
-            update(event.delta);
-            return false;
+            if (simulation == Simulation::GPU)
+                gpuParticles.update();
+            else
+                particles.update(updateStep, particleSystemData);
+
+            // Update bounding box
+            boundingBox.reset();
+
+            if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE ||
+                particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
+            {
+                if (attached)
+                    boundingBox = (simulation == Simulation::GPU) ? gpuParticles.getBoundingBox(&boundsTransform) : particles.getBoundingBox(&boundsTransform);
+            }
+            else if (particleSystemData.positionType == ParticleSystemData::PositionType::GROUPED)
+                boundingBox = (simulation == Simulation::GPU) ? gpuParticles.getBoundingBox(nullptr) : particles.getBoundingBox(nullptr);
+
+            needsBoundingBoxUpdate = true;
+
+            if (attached && simulation == Simulation::CPU && particles.getSize())
+            {
+                updateParticleMesh();
+                needsMeshUpdate = true;
+            }
         }
 
         void ParticleSystem::init(const ParticleSystemData& newParticleSystemData)
@@ -282,10 +278,10 @@ namespace ouzel
                 if (!active)
                 {
                     active = true;
-                    engine->getEventDispatcher().addEventHandler(&updateHandler);
+                    engine->getSceneManager().getParticleWorld().addParticleSystem(this);
                 }
 
-                if (particleCount == 0)
+                if (getParticleCount() == 0)
                 {
                     std::unique_ptr<AnimationEvent> startEvent(new AnimationEvent());
                     startEvent->type = Event::Type::ANIMATION_START;
@@ -304,175 +300,101 @@ namespace ouzel
         {
             emitCounter = 0.0F;
             elapsed = 0.0F;
-            timeSinceUpdate = 0.0F;
-            particleCount = 0;
+            particles.clear();
+            gpuParticles.clear();
             finished = false;
         }
 
         void ParticleSystem::createParticleMesh()
         {
-            indices.reserve(particleSystemData.maxParticles * 6);
             vertices.reserve(particleSystemData.maxParticles * 4);
 
-            for (uint16_t i = 0; i < particleSystemData.maxParticles; ++i)
+            for (uint32_t i = 0; i < particleSystemData.maxParticles; ++i)
             {
-                indices.push_back(i * 4 + 0);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 2);
-                indices.push_back(i * 4 + 1);
-                indices.push_back(i * 4 + 3);
-                indices.push_back(i * 4 + 2);
-
-                vertices.push_back(graphics::Vertex(Vector3(-1.0F, -1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(0.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(1.0F, -1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(1.0F, 1.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(-1.0F, 1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(0.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(1.0F, 1.0F, 0.0F), Color::WHITE,
-                                                    Vector2(1.0F, 0.0F), Vector3(0.0F, 0.0F, -1.0F)));
+                vertices.push_back(graphics::SpriteVertex(Vector3(-1.0F, -1.0F, 0.0F), Color::WHITE, Vector2(0.0F, 1.0F)));
+                vertices.push_back(graphics::SpriteVertex(Vector3(1.0F, -1.0F, 0.0F), Color::WHITE, Vector2(1.0F, 1.0F)));
+                vertices.push_back(graphics::SpriteVertex(Vector3(-1.0F, 1.0F, 0.0F), Color::WHITE, Vector2(0.0F, 0.0F)));
+                vertices.push_back(graphics::SpriteVertex(Vector3(1.0F, 1.0F, 0.0F), Color::WHITE, Vector2(1.0F, 0.0F)));
             }
 
             indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
-            indexBuffer->init(graphics::Buffer::Usage::INDEX, 0, indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+
+            // 16-bit indices can address the vertices of up to 16384 particles
+            if (particleSystemData.maxParticles <= 65536 / 4)
+            {
+                addQuadIndices(indices, particleSystemData.maxParticles);
+                indexSize = sizeof(uint16_t);
+                indexBuffer->init(graphics::Buffer::Usage::INDEX, 0, indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+            }
+            else
+            {
+                std::vector<uint32_t> wideIndices;
+                addQuadIndices(wideIndices, particleSystemData.maxParticles);
+                indexSize = sizeof(uint32_t);
+                indexBuffer->init(graphics::Buffer::Usage::INDEX, 0, wideIndices.data(), static_cast<uint32_t>(getVectorSize(wideIndices)));
+            }
 
             vertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
             vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC, vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
 
-            particles.resize(particleSystemData.maxParticles);
+            particles.reserve(particleSystemData.maxParticles);
+
+            if (simulation == Simulation::GPU)
+                createGPUParticleMesh();
         }
 
-        void ParticleSystem::updateParticleMesh()
+        void ParticleSystem::createGPUParticleMesh()
         {
-            if (actor)
-            {
-                for (uint32_t counter = particleCount; counter > 0; --counter)
-                {
-                    size_t i = counter - 1;
-
-                    Vector2 position;
-
-                    if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
-                        position = particles[i].position;
-                    else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
-                        position = Vector2(actor->getPosition()) + particles[i].position;
+            gpuParticles.reserve(particleSystemData.maxParticles);
 
-                    float size_2 = particles[i].size / 2.0F;
-                    Vector2 v1(-size_2, -size_2);
-                    Vector2 v2(size_2, size_2);
+            // every chunk is drawn with the same indices
+            std::vector<uint16_t> chunkIndices;
+            addQuadIndices(chunkIndices, std::min(particleSystemData.maxParticles, GPUParticleStore::CHUNK_SIZE));
 
-                    float r = -degToRad(particles[i].rotation);
-                    float cr = cosf(r);
-                    float sr = sinf(r);
+            chunkIndexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+            chunkIndexBuffer->init(graphics::Buffer::Usage::INDEX, 0, chunkIndices.data(), static_cast<uint32_t>(getVectorSize(chunkIndices)));
 
-                    Vector2 a(v1.x * cr - v1.y * sr, v1.x * sr + v1.y * cr);
-                    Vector2 b(v2.x * cr - v1.y * sr, v2.x * sr + v1.y * cr);
-                    Vector2 c(v2.x * cr - v2.y * sr, v2.x * sr + v2.y * cr);
-                    Vector2 d(v1.x * cr - v2.y * sr, v1.x * sr + v2.y * cr);
-
-                    Color color(static_cast<uint8_t>(particles[i].colorRed * 255),
-                                static_cast<uint8_t>(particles[i].colorGreen * 255),
-                                static_cast<uint8_t>(particles[i].colorBlue * 255),
-                                static_cast<uint8_t>(particles[i].colorAlpha * 255));
+            chunkVertexBuffers.clear();
+            for (uint32_t chunk = 0; chunk < gpuParticles.getChunkCount(); ++chunk)
+            {
+                std::shared_ptr<graphics::Buffer> chunkVertexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
+                chunkVertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC,
+                                        gpuParticles.getChunkVertices(chunk),
+                                        gpuParticles.getChunkParticleCount(chunk) * 4 * sizeof(graphics::ParticleVertex));
+                gpuParticles.setChunkUploaded(chunk);
+                chunkVertexBuffers.push_back(chunkVertexBuffer);
+            }
+        }
 
-                    vertices[i * 4 + 0].position = a + position;
-                    vertices[i * 4 + 0].color = color;
+        void ParticleSystem::setSimulation(Simulation newSimulation)
+        {
+            if (newSimulation == Simulation::GPU && !particleShader)
+                newSimulation = Simulation::CPU;
 
-                    vertices[i * 4 + 1].position = b + position;
-                    vertices[i * 4 + 1].color = color;
+            if (newSimulation == simulation) return;
 
-                    vertices[i * 4 + 2].position = d + position;
-                    vertices[i * 4 + 2].color = color;
+            particles.clear();
+            gpuParticles.clear();
+            simulation = newSimulation;
 
-                    vertices[i * 4 + 3].position = c + position;
-                    vertices[i * 4 + 3].color = color;
-                }
+            if (simulation == Simulation::GPU && indexBuffer && !chunkIndexBuffer)
+                createGPUParticleMesh();
+        }
 
-                vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
-            }
+        void ParticleSystem::updateParticleMesh()
+        {
+            // parent relative particles are offset by the draw transform, so the vertices do not depend on the actor
+            particles.buildVertices(vertices.data(), Vector2());
         }
 
         void ParticleSystem::emitParticles(uint32_t count)
         {
-            if (particleCount + count > particleSystemData.maxParticles)
-                count = particleSystemData.maxParticles - particleCount;
-
-            if (count && actor)
+            if (count && attached)
             {
-                Vector2 position;
-
-                if (particleSystemData.positionType == ParticleSystemData::PositionType::FREE)
-                    position = actor->convertLocalToWorld(Vector3());
-                else if (particleSystemData.positionType == ParticleSystemData::PositionType::PARENT)
-                    position = actor->convertLocalToWorld(Vector3()) - actor->getPosition();
-
-                for (uint32_t i = particleCount; i < particleCount + count; ++i)
-                {
-                    if (particleSystemData.emitterType == ParticleSystemData::EmitterType::GRAVITY)
-                    {
-                        particles[i].life = fmaxf(particleSystemData.particleLifespan + particleSystemData.particleLifespanVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-
-                        particles[i].position = particleSystemData.sourcePosition + position + Vector2(particleSystemData.sourcePositionVariance.x * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine),
-                                                                                                       particleSystemData.sourcePositionVariance.y * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-
-                        particles[i].size = fmaxf(particleSystemData.startParticleSize + particleSystemData.startParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-
-                        float finishSize = fmaxf(particleSystemData.finishParticleSize + particleSystemData.finishParticleSizeVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F);
-                        particles[i].deltaSize = (finishSize - particles[i].size) / particles[i].life;
-
-                        particles[i].colorRed = clamp(particleSystemData.startColorRed + particleSystemData.startColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorGreen = clamp(particleSystemData.startColorGreen + particleSystemData.startColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorBlue = clamp(particleSystemData.startColorBlue + particleSystemData.startColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        particles[i].colorAlpha = clamp(particleSystemData.startColorAlpha + particleSystemData.startColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-
-                        float finishColorRed = clamp(particleSystemData.finishColorRed + particleSystemData.finishColorRedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        float finishColorGreen = clamp(particleSystemData.finishColorGreen + particleSystemData.finishColorGreenVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        float finishColorBlue = clamp(particleSystemData.finishColorBlue + particleSystemData.finishColorBlueVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-                        float finishColorAlpha = clamp(particleSystemData.finishColorAlpha + particleSystemData.finishColorAlphaVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine), 0.0F, 1.0F);
-
-                        particles[i].deltaColorRed = (finishColorRed - particles[i].colorRed) / particles[i].life;
-                        particles[i].deltaColorGreen = (finishColorGreen - particles[i].colorGreen) / particles[i].life;
-                        particles[i].deltaColorBlue = (finishColorBlue - particles[i].colorBlue) / particles[i].life;
-                        particles[i].deltaColorAlpha = (finishColorAlpha - particles[i].colorAlpha) / particles[i].life;
-
-                        particles[i].rotation = particleSystemData.startRotation + particleSystemData.startRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-
-                        float finishRotation = particleSystemData.finishRotation + particleSystemData.finishRotationVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRotation = (finishRotation - particles[i].rotation) / particles[i].life;
-
-                        particles[i].radialAcceleration = particleSystemData.radialAcceleration + particleSystemData.radialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].tangentialAcceleration = particleSystemData.tangentialAcceleration + particleSystemData.tangentialAcceleration * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-
-                        if (particleSystemData.rotationIsDir)
-                        {
-                            float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                            Vector2 v(cosf(a), sinf(a));
-                            float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                            Vector2 dir = v * s;
-                            particles[i].direction = dir;
-                            particles[i].rotation = -radToDeg(dir.getAngle());
-                        }
-                        else
-                        {
-                            float a = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                            Vector2 v(cosf(a), sinf(a));
-                            float s = particleSystemData.speed + particleSystemData.speedVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                            Vector2 dir = v * s;
-                            particles[i].direction = dir;
-                        }
-                    }
-                    else
-                    {
-                        particles[i].radius = particleSystemData.maxRadius + particleSystemData.maxRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].angle = degToRad(particleSystemData.angle + particleSystemData.angleVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-                        particles[i].degreesPerSecond = degToRad(particleSystemData.rotatePerSecond + particleSystemData.rotatePerSecondVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine));
-
-                        float endRadius = particleSystemData.minRadius + particleSystemData.minRadiusVariance * std::uniform_real_distribution<float>{-1.0F, 1.0F}(randomEngine);
-                        particles[i].deltaRadius = (endRadius - particles[i].radius) / particles[i].life;
-                    }
-                }
-
-                particleCount += count;
+                if (simulation == Simulation::GPU)
+                    gpuParticles.emit(count, particleSystemData, emitPosition, updateStep, random);
+                else
+                    particles.emit(count, particleSystemData, emitPosition, updateStep, random);
             }
         }
     } // namespace scene
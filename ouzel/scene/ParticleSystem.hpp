@@ -7,10 +7,12 @@
 #include <vector>
 #include <functional>
 #include "scene/Component.hpp"
+#include "scene/GPUParticleStore.hpp"
+#include "scene/ParticleStore.hpp"
 #include "scene/ParticleSystemData.hpp"
+#include "math/Matrix4.hpp"
 #include "math/Vector2.hpp"
 #include "math/Color.hpp"
-#include "events/EventHandler.hpp"
 #include "graphics/Vertex.hpp"
 #include "graphics/BlendState.hpp"
 #include "graphics/Buffer.hpp"
@@ -21,14 +23,24 @@ namespace ouzel
 {
     namespace scene
     {
+        class ParticleWorld;
+
         class ParticleSystem: public Component
         {
+            friend ParticleWorld;
         public:
             static const uint32_t CLASS = Component::PARTICLE_SYSTEM;
 
+            enum class Simulation
+            {
+                CPU,
+                GPU // evaluated by the particle vertex shader
+            };
+
             ParticleSystem();
             explicit ParticleSystem(const ParticleSystemData& initParticleSystemData);
             explicit ParticleSystem(const std::string& filename);
+            ~ParticleSystem();
 
             void draw(const Matrix4& transformMatrix,
                       float opacity,
@@ -48,11 +60,23 @@ namespace ouzel
             inline ParticleSystemData::PositionType getPositionType() const { return particleSystemData.positionType; }
             inline void setPositionType(ParticleSystemData::PositionType newPositionType) { particleSystemData.positionType = newPositionType; }
 
+            // the particles of systems with the same seed and data are the same regardless of the thread they are updated on
+            void setRandomSeed(uint32_t seed) { random.setSeed(seed); }
+
+            inline Simulation getSimulation() const { return simulation; }
+            // removes the particles, falls back to the CPU if the render driver has no particle shader
+            void setSimulation(Simulation newSimulation);
+
+            inline uint32_t getParticleCount() const { return (simulation == Simulation::GPU) ? gpuParticles.getSize() : particles.getSize(); }
+
         private:
-            void update(float delta);
-            bool handleUpdate(const UpdateEvent& event);
+            // called by the particle world on the game thread before the systems are simulated in parallel
+            void prepareUpdate(float step);
+            // advances the system by one fixed update step, must not touch other objects
+            void simulate();
 
             void createParticleMesh();
+            void createGPUParticleMesh();
             void updateParticleMesh();
 
             void emitParticles(uint32_t count);
@@ -64,60 +88,37 @@ namespace ouzel
             std::shared_ptr<graphics::Texture> texture;
             std::shared_ptr<graphics::Texture> whitePixelTexture;
 
-            struct Particle final
-            {
-                float life = 0.0F;
-
-                Vector2 position;
-
-                float colorRed = 0.0F;
-                float colorGreen = 0.0F;
-                float colorBlue = 0.0F;
-                float colorAlpha = 0.0F;
-
-                float deltaColorRed = 0.0F;
-                float deltaColorGreen = 0.0F;
-                float deltaColorBlue = 0.0F;
-                float deltaColorAlpha = 0.0F;
-
-                float angle = 0.0F;
-                float speed = 0.0F;
-
-                float size = 0.0F;
-                float deltaSize = 0.0F;
-
-                float rotation = 0.0F;
-                float deltaRotation = 0.0F;
-
-                float radialAcceleration = 0.0F;
-                float tangentialAcceleration = 0.0F;
-
-                Vector2 direction;
-                float radius = 0.0F;
-                float degreesPerSecond = 0.0F;
-                float deltaRadius = 0.0F;
-            };
-
-            std::vector<Particle> particles;
+            Simulation simulation = Simulation::CPU;
+            ParticleStore particles;
+            GPUParticleStore gpuParticles;
+            ParticleRandom random;
 
             std::shared_ptr<graphics::Buffer> indexBuffer;
             std::shared_ptr<graphics::Buffer> vertexBuffer;
 
             std::vector<uint16_t> indices;
-            std::vector<graphics::Vertex> vertices;
+            uint32_t indexSize = sizeof(uint16_t);
+            std::vector<graphics::SpriteVertex> vertices;
 
-            uint32_t particleCount = 0;
+            std::shared_ptr<graphics::Shader> particleShader;
+            std::shared_ptr<graphics::Buffer> chunkIndexBuffer;
+            std::vector<std::shared_ptr<graphics::Buffer>> chunkVertexBuffers;
 
+            float updateStep = 1.0F / 60.0F;
             float emitCounter = 0.0F;
             float elapsed = 0.0F;
-            float timeSinceUpdate = 0.0F;
             bool active = false;
             bool running = false;
             bool finished = false;
 
-            bool needsMeshUpdate = false;
+            // state captured by prepareUpdate, so that simulate does not read the actor
+            bool attached = false;
+            Vector2 emitPosition;
+            Matrix4 boundsTransform;
 
-            EventHandler updateHandler;
+            bool finishPending = false;
+            bool needsBoundingBoxUpdate = false;
+            bool needsMeshUpdate = false;
         };
     } // namespace scene
 } // namespace ouzel
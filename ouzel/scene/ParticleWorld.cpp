@@ -0,0 +1,99 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include "ParticleWorld.hpp"
+#include "ParticleSystem.hpp"
+#include "core/Engine.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        ParticleWorld::ParticleWorld()
+        {
+            updateHandler.fixedUpdateHandler = std::bind(&ParticleWorld::handleFixedUpdate, this, std::placeholders::_1);
+        }
+
+        void ParticleWorld::addParticleSystem(ParticleSystem* particleSystem)
+        {
+            if (std::find(particleSystems.begin(), particleSystems.end(), particleSystem) != particleSystems.end())
+                return;
+
+            if (particleSystems.empty())
+                engine->getEventDispatcher().addEventHandler(&updateHandler);
+
+            particleSystems.push_back(particleSystem);
+        }
+
+        void ParticleWorld::removeParticleSystem(ParticleSystem* particleSystem)
+        {
+            auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+
+            if (i != particleSystems.end())
+            {
+                particleSystems.erase(i);
+                if (particleSystems.empty()) updateHandler.remove();
+            }
+
+            // the system can be deleted by a handler of an earlier finish event
+            auto finishedIterator = std::find(finishedSystems.begin(), finishedSystems.end(), particleSystem);
+            if (finishedIterator != finishedSystems.end()) finishedSystems.erase(finishedIterator);
+        }
+
+        void ParticleWorld::update(float step)
+        {
+            // the transforms of the actors are cached lazily, so they are read before going wide
+            updatedSystems = particleSystems;
+            for (ParticleSystem* particleSystem : updatedSystems)
+                particleSystem->prepareUpdate(step);
+
+            engine->getJobSystem().parallelFor(updatedSystems.size(), 4, [this](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    updatedSystems[i]->simulate();
+            });
+
+            for (ParticleSystem* particleSystem : updatedSystems)
+            {
+                if (particleSystem->finishPending)
+                {
+                    particleSystem->finishPending = false;
+                    particleSystem->active = false;
+                    finishedSystems.push_back(particleSystem);
+                }
+                else if (particleSystem->needsBoundingBoxUpdate)
+                {
+                    particleSystem->needsBoundingBoxUpdate = false;
+                    particleSystem->invalidateActor();
+                }
+            }
+
+            updatedSystems.clear();
+
+            for (ParticleSystem* particleSystem : finishedSystems)
+            {
+                auto i = std::find(particleSystems.begin(), particleSystems.end(), particleSystem);
+                if (i != particleSystems.end()) particleSystems.erase(i);
+            }
+
+            if (particleSystems.empty()) updateHandler.remove();
+
+            // the event handlers can add, remove or delete particle systems
+            while (!finishedSystems.empty())
+            {
+                ParticleSystem* particleSystem = finishedSystems.front();
+                finishedSystems.erase(finishedSystems.begin());
+
+                std::unique_ptr<AnimationEvent> finishEvent(new AnimationEvent());
+                finishEvent->type = Event::Type::ANIMATION_FINISH;
+                finishEvent->component = particleSystem;
+                engine->getEventDispatcher().dispatchEvent(std::move(finishEvent));
+            }
+        }
+
+        bool ParticleWorld::handleFixedUpdate(const UpdateEvent& event)
+        {
+            update(event.delta);
+            return false;
+        }
+    } // namespace scene
+} // namespace ouzel
@@ -0,0 +1,48 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_PARTICLEWORLD_HPP
+#define OUZEL_SCENE_PARTICLEWORLD_HPP
+
+#include <cstdint>
+#include <vector>
+#include "events/EventHandler.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class ParticleSystem;
+
+        // Simulates all the active particle systems on the fixed update events of the engine.
+        // The systems are stepped and their meshes built in parallel on the job system,
+        // everything that touches the actors or dispatches events runs on the game thread.
+        class ParticleWorld final
+        {
+        public:
+            ParticleWorld();
+
+            ParticleWorld(const ParticleWorld&) = delete;
+            ParticleWorld& operator=(const ParticleWorld&) = delete;
+
+            ParticleWorld(ParticleWorld&&) = delete;
+            ParticleWorld& operator=(ParticleWorld&&) = delete;
+
+            void addParticleSystem(ParticleSystem* particleSystem);
+            void removeParticleSystem(ParticleSystem* particleSystem);
+
+            inline const std::vector<ParticleSystem*>& getParticleSystems() const { return particleSystems; }
+
+        private:
+            void update(float step);
+            bool handleFixedUpdate(const UpdateEvent& event);
+
+            std::vector<ParticleSystem*> particleSystems;
+            std::vector<ParticleSystem*> updatedSystems;
+            std::vector<ParticleSystem*> finishedSystems;
+
+            EventHandler updateHandler;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_PARTICLEWORLD_HPP
@@ -38,23 +38,79 @@ namespace ouzel
                 return a->getOrder() > b->getOrder();
             });
 
+            graphics::Renderer* renderer = engine->getRenderer();
+
             std::set<uint64_t> clearedRenderTargets;
 
-            for (Layer* layer : layers)
+            if (layers.size() < 2 || !engine->getJobSystem().getWorkerCount())
             {
-                // clear all the render targets
-                for (Camera* camera : layer->getCameras())
+                for (Layer* layer : layers)
                 {
-                    uintptr_t renderTarget = camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0;
+                    // clear all the render targets
+                    for (Camera* camera : layer->getCameras())
+                    {
+                        uintptr_t renderTarget = camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0;
 
-                    if (clearedRenderTargets.insert(renderTarget).second)
-                        engine->getRenderer()->clearRenderTarget(renderTarget);
+                        if (clearedRenderTargets.insert(renderTarget).second)
+                            renderer->clearRenderTarget(renderTarget);
+                    }
+
+                    layer->draw();
                 }
+            }
+            else
+            {
+                // layers are recorded to separate command buffers in parallel and executed in the layer order
+                layerRecordings.resize(layers.size());
+                recordJobs.clear();
+
+                for (size_t i = 0; i < layers.size(); ++i)
+                {
+                    LayerRecording& layerRecording = layerRecordings[i];
+                    layerRecording.layer = layers[i];
+                    layerRecording.clearedRenderTargets.clear();
+                    layerRecording.commandBuffer = renderer->getCommandBuffer();
+
+                    // the render targets are cleared by the first layer that draws to them
+                    for (Camera* camera : layers[i]->getCameras())
+                    {
+                        uintptr_t renderTarget = camera->getRenderTarget() ? camera->getRenderTarget()->getResource() : 0;
+
+                        if (clearedRenderTargets.insert(renderTarget).second)
+                            layerRecording.clearedRenderTargets.push_back(renderTarget);
+                    }
 
-                layer->draw();
+                    recordJobs.push_back(std::bind(&Scene::recordLayer, this, std::ref(layerRecording)));
+                }
+
+                engine->getJobSystem().run(recordJobs);
+
+                for (size_t i = 0; i < layers.size(); ++i)
+                    renderer->executeCommands(std::move(layerRecordings[i].commandBuffer));
+            }
+
+            renderer->present();
+        }
+
+        void Scene::recordLayer(LayerRecording& layerRecording)
+        {
+            graphics::Renderer* renderer = engine->getRenderer();
+            renderer->beginRecording(layerRecording.commandBuffer);
+
+            try
+            {
+                for (uintptr_t renderTarget : layerRecording.clearedRenderTargets)
+                    renderer->clearRenderTarget(renderTarget);
+
+                layerRecording.layer->draw();
+            }
+            catch (...)
+            {
+                renderer->endRecording();
+                throw;
             }
 
-            engine->getRenderer()->present();
+            renderer->endRecording();
         }
 
         void Scene::addLayer(Layer* layer)
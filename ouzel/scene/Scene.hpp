@@ -3,9 +3,11 @@
 #ifndef OUZEL_SCENE_SCENE_HPP
 #define OUZEL_SCENE_SCENE_HPP
 
+#include <functional>
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include "graphics/Commands.hpp"
 #include "math/Vector2.hpp"
 #include "events/EventHandler.hpp"
 
@@ -76,12 +78,25 @@ namespace ouzel
             void pointerDragActor(uint64_t pointerId, Actor* actor, const Vector2& position,
                                   const Vector2& difference, const Vector3& localPosition);
 
+            // commands of a layer that is recorded on a worker thread
+            struct LayerRecording final
+            {
+                Layer* layer = nullptr;
+                std::vector<uintptr_t> clearedRenderTargets;
+                graphics::CommandBuffer commandBuffer;
+            };
+
+            void recordLayer(LayerRecording& layerRecording);
+
             SceneManager* sceneManger = nullptr;
 
             std::vector<Layer*> layers;
             std::vector<std::unique_ptr<Layer>> ownedLayers;
             EventHandler eventHandler;
 
+            std::vector<LayerRecording> layerRecordings;
+            std::vector<std::function<void()>> recordJobs;
+
             std::unordered_map<uint64_t, std::pair<Actor*, Vector3>> pointerDownOnActors;
 
             bool entered = false;
@@ -34,6 +34,25 @@ namespace ouzel
             scenes.push_back(scene);
         }
 
+        void SceneManager::beginFixedUpdate()
+        {
+            for (Actor* actor : interpolatedActors)
+                actor->storePreviousState();
+        }
+
+        void SceneManager::addInterpolatedActor(Actor* actor)
+        {
+            interpolatedActors.push_back(actor);
+        }
+
+        void SceneManager::removeInterpolatedActor(Actor* actor)
+        {
+            auto i = std::find(interpolatedActors.begin(), interpolatedActors.end(), actor);
+
+            if (i != interpolatedActors.end())
+                interpolatedActors.erase(i);
+        }
+
         bool SceneManager::removeScene(Scene* scene)
         {
             bool result = false;
@@ -9,15 +9,18 @@
 #include <queue>
 #include <set>
 #include <vector>
+#include "scene/ParticleWorld.hpp"
 
 namespace ouzel
 {
     namespace scene
     {
+        class Actor;
         class Scene;
 
         class SceneManager final
         {
+            friend Actor;
         public:
             SceneManager();
             ~SceneManager();
@@ -29,6 +32,8 @@ namespace ouzel
             SceneManager& operator=(SceneManager&&) = delete;
 
             void draw();
+            // stores the state the interpolated actors are drawn from, called before every fixed update
+            void beginFixedUpdate();
 
             void setScene(Scene* scene);
 
@@ -52,9 +57,17 @@ namespace ouzel
 
             inline Scene* getScene() const { return scenes.empty() ? nullptr : scenes.back(); }
 
+            inline ParticleWorld& getParticleWorld() { return particleWorld; }
+
         private:
+            void addInterpolatedActor(Actor* actor);
+            void removeInterpolatedActor(Actor* actor);
+
             std::vector<Scene*> scenes;
             std::vector<std::unique_ptr<Scene>> ownedScenes;
+
+            ParticleWorld particleWorld;
+            std::vector<Actor*> interpolatedActors;
         };
     } // namespace scene
 } // namespace ouzel
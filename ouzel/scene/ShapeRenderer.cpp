@@ -14,7 +14,7 @@ namespace ouzel
         ShapeRenderer::ShapeRenderer():
             Component(CLASS)
         {
-            shader = engine->getCache().getShader(SHADER_COLOR);
+            shader = engine->getCache().getShader(SHADER_SHAPE);
             blendState = engine->getCache().getBlendState(BLEND_ALPHA);
 
             indexBuffer = std::make_shared<graphics::Buffer>(*engine->getRenderer());
@@ -46,16 +46,12 @@ namespace ouzel
 
             for (const DrawCommand& drawCommand : drawCommands)
             {
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
                 engine->getRenderer()->setCullMode(graphics::CullMode::NONE);
                 engine->getRenderer()->setPipelineState(blendState->getResource(), shader->getResource());
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                          modelViewProj.m,
+                                                          static_cast<uint32_t>(sizeof(modelViewProj.m) / sizeof(float)));
                 engine->getRenderer()->draw(indexBuffer->getResource(),
                                             drawCommand.indexCount,
                                             sizeof(uint16_t),
@@ -74,6 +70,7 @@ namespace ouzel
             vertices.clear();
 
             dirty = true;
+            invalidateActor();
         }
 
         void ShapeRenderer::line(const Vector2& start, const Vector2& finish, Color color, float thickness)
@@ -89,8 +86,8 @@ namespace ouzel
             {
                 command.mode = graphics::DrawMode::LINE_LIST;
 
-                vertices.push_back(graphics::Vertex(Vector3(start), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(finish), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                vertices.push_back(graphics::ShapeVertex(Vector3(start), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(finish), color));
 
                 command.indexCount = 2;
 
@@ -110,14 +107,10 @@ namespace ouzel
 
                 float halfThickness = thickness / 2.0F;
 
-                vertices.push_back(graphics::Vertex(Vector3(start - tangent * halfThickness - normal * halfThickness),
-                                                    color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(finish + tangent * halfThickness - normal * halfThickness),
-                                                    color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(start - tangent * halfThickness + normal * halfThickness),
-                                                    color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(finish + tangent * halfThickness + normal * halfThickness),
-                                                    color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                vertices.push_back(graphics::ShapeVertex(Vector3(start - tangent * halfThickness - normal * halfThickness), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(finish + tangent * halfThickness - normal * halfThickness), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(start - tangent * halfThickness + normal * halfThickness), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(finish + tangent * halfThickness + normal * halfThickness), color));
 
                 command.indexCount = 6;
 
@@ -137,6 +130,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            invalidateActor();
         }
 
         void ShapeRenderer::circle(const Vector2& position,
@@ -159,13 +153,13 @@ namespace ouzel
             {
                 command.mode = graphics::DrawMode::TRIANGLE_STRIP;
 
-                vertices.push_back(graphics::Vertex(Vector3(position), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F))); // center
-
-                for (uint32_t i = 0; i <= segments; ++i)
-                {
-                    vertices.push_back(graphics::Vertex(Vector3((position.x + radius * cosf(i * TAU / static_cast<float>(segments))),
-                                                                (position.y + radius * sinf(i * TAU / static_cast<float>(segments))),
-                                                                0.0F), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                vertices.push_back(graphics::ShapeVertex(Vector3(position), color)); // center
+     
+                     for (uint32_t i = 0; i <= segments; ++i)
+                     {
+                         vertices.push_back(graphics::ShapeVertex(Vector3((position.x + radius * cosf(i * TAU / static_cast<float>(segments))),
+                                                                     (position.y + radius * sinf(i * TAU / static_cast<float>(segments))),
+                                                                     0.0F), color));
                 }
 
                 command.indexCount = segments * 2 + 1;
@@ -189,9 +183,9 @@ namespace ouzel
 
                     for (uint32_t i = 0; i <= segments; ++i)
                     {
-                        vertices.push_back(graphics::Vertex(Vector3((position.x + radius * cosf(i * TAU / static_cast<float>(segments))),
-                                                                    (position.y + radius * sinf(i * TAU / static_cast<float>(segments))),
-                                                                    0.0F), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                        vertices.push_back(graphics::ShapeVertex(Vector3((position.x + radius * cosf(i * TAU / static_cast<float>(segments))),
+                                                                         (position.y + radius * sinf(i * TAU / static_cast<float>(segments))),
+                                                                         0.0F), color));
                     }
 
                     command.indexCount = segments + 1;
@@ -212,16 +206,16 @@ namespace ouzel
 
                     for (uint32_t i = 0; i <= segments; ++i)
                     {
-                        vertices.push_back(graphics::Vertex(Vector3((position.x + (radius - halfThickness) * cosf(i * TAU / static_cast<float>(segments))),
-                                                                    (position.y + (radius - halfThickness) * sinf(i * TAU / static_cast<float>(segments))),
-                                                                    0.0F), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                        vertices.push_back(graphics::ShapeVertex(Vector3((position.x + (radius - halfThickness) * cosf(i * TAU / static_cast<float>(segments))),
+                                                                         (position.y + (radius - halfThickness) * sinf(i * TAU / static_cast<float>(segments))),
+                                                                         0.0F), color));
 
-                        vertices.push_back(graphics::Vertex(Vector3((position.x + (radius + halfThickness) * cosf(i * TAU / static_cast<float>(segments))),
-                                                                    (position.y + (radius + halfThickness) * sinf(i * TAU / static_cast<float>(segments))),
-                                                                    0.0F), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                        vertices.push_back(graphics::ShapeVertex(Vector3((position.x + (radius + halfThickness) * cosf(i * TAU / static_cast<float>(segments))),
+                                                                         (position.y + (radius + halfThickness) * sinf(i * TAU / static_cast<float>(segments))),
+                                                                         0.0F), color));
                     }
 
-                    for (const graphics::Vertex& vertex : vertices)
+                    for (const graphics::ShapeVertex& vertex : vertices)
                         boundingBox.insertPoint(vertex.position);
 
                     command.indexCount = segments * 6;
@@ -255,6 +249,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            invalidateActor();
         }
 
         void ShapeRenderer::rectangle(const Rect& rectangle,
@@ -273,14 +268,10 @@ namespace ouzel
             {
                 command.mode = graphics::DrawMode::TRIANGLE_LIST;
 
-                vertices.push_back(graphics::Vertex(Vector3(rectangle.left(), rectangle.bottom(), 0.0F), color,
-                                                    Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(rectangle.right(), rectangle.bottom(), 0.0F), color,
-                                                    Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(rectangle.right(), rectangle.top(), 0.0F), color,
-                                                    Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                vertices.push_back(graphics::Vertex(Vector3(rectangle.left(), rectangle.top(), 0.0F), color,
-                                                    Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left(), rectangle.bottom(), 0.0F), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right(), rectangle.bottom(), 0.0F), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right(), rectangle.top(), 0.0F), color));
+                vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left(), rectangle.top(), 0.0F), color));
 
                 command.indexCount = 6;
 
@@ -301,20 +292,16 @@ namespace ouzel
                     command.mode = graphics::DrawMode::LINE_STRIP;
 
                     // left bottom
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left(), rectangle.bottom(), 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left(), rectangle.bottom(), 0.0F), color));
 
                     // right bottom
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right(), rectangle.bottom(), 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right(), rectangle.bottom(), 0.0F), color));
 
                     // right top
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right(), rectangle.top(), 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right(), rectangle.top(), 0.0F), color));
 
                     // left top
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left(), rectangle.top(), 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left(), rectangle.top(), 0.0F), color));
 
                     command.indexCount = 5;
 
@@ -334,28 +321,20 @@ namespace ouzel
                     float halfThickness = thickness / 2.0F;
 
                     // left bottom
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left() - halfThickness, rectangle.bottom() - halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left() + halfThickness, rectangle.bottom() + halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left() - halfThickness, rectangle.bottom() - halfThickness, 0.0F), color));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left() + halfThickness, rectangle.bottom() + halfThickness, 0.0F), color));
 
                     // right bottom
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right() + halfThickness, rectangle.bottom() - halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right() - halfThickness, rectangle.bottom() + halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right() + halfThickness, rectangle.bottom() - halfThickness, 0.0F), color));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right() - halfThickness, rectangle.bottom() + halfThickness, 0.0F), color));
 
                     // right top
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right() + halfThickness, rectangle.top() + halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.right() - halfThickness, rectangle.top() - halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right() + halfThickness, rectangle.top() + halfThickness, 0.0F), color));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.right() - halfThickness, rectangle.top() - halfThickness, 0.0F), color));
 
                     // left top
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left() - halfThickness, rectangle.top() + halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
-                    vertices.push_back(graphics::Vertex(Vector3(rectangle.left() + halfThickness, rectangle.top() - halfThickness, 0.0F), color,
-                                                        Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left() - halfThickness, rectangle.top() + halfThickness, 0.0F), color));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(rectangle.left() + halfThickness, rectangle.top() - halfThickness, 0.0F), color));
 
                     command.indexCount = 24;
                     // bottom
@@ -402,6 +381,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            invalidateActor();
         }
 
         void ShapeRenderer::polygon(const std::vector<Vector2>& edges,
@@ -422,7 +402,7 @@ namespace ouzel
                 command.mode = graphics::DrawMode::TRIANGLE_LIST;
 
                 for (uint16_t i = 0; i < edges.size(); ++i)
-                    vertices.push_back(graphics::Vertex(Vector3(edges[i]), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                    vertices.push_back(graphics::ShapeVertex(Vector3(edges[i]), color));
 
                 command.indexCount = static_cast<uint32_t>(edges.size() - 2) * 3;
 
@@ -443,7 +423,7 @@ namespace ouzel
                     command.mode = graphics::DrawMode::LINE_STRIP;
 
                     for (uint16_t i = 0; i < edges.size(); ++i)
-                        vertices.push_back(graphics::Vertex(Vector3(edges[i]), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                        vertices.push_back(graphics::ShapeVertex(Vector3(edges[i]), color));
 
                     command.indexCount = static_cast<uint32_t>(edges.size()) + 1;
 
@@ -464,6 +444,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            invalidateActor();
         }
 
         static std::vector<uint32_t> pascalsTriangleRow(uint32_t row)
@@ -500,7 +481,7 @@ namespace ouzel
                     {
                         indices.push_back(startVertex + static_cast<uint16_t>(command.indexCount));
                         ++command.indexCount;
-                        vertices.push_back(graphics::Vertex(Vector3(controlPoints[i]), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F)));
+                        vertices.push_back(graphics::ShapeVertex(Vector3(controlPoints[i]), color));
                         boundingBox.insertPoint(Vector3(controlPoints[i]));
                     }
                 }
@@ -512,7 +493,7 @@ namespace ouzel
                     {
                         float t = static_cast<float>(segment) / static_cast<float>(segments - 1);
 
-                        graphics::Vertex vertex(Vector3(), color, Vector2(), Vector3(0.0F, 0.0F, -1.0F));
+                        graphics::ShapeVertex vertex(Vector3(), color);
 
                         for (uint16_t n = 0; n < controlPoints.size(); ++n)
                             vertex.position += static_cast<float>(binomialCoefficients[n]) * powf(t, n) * powf(1.0F - t, static_cast<float>(controlPoints.size() - n - 1)) * controlPoints[n];
@@ -532,6 +513,7 @@ namespace ouzel
             drawCommands.push_back(command);
 
             dirty = true;
+            invalidateActor();
         }
     } // namespace scene
 } // namespace ouzel
@@ -78,7 +78,7 @@ namespace ouzel
             std::vector<DrawCommand> drawCommands;
 
             std::vector<uint16_t> indices;
-            std::vector<graphics::Vertex> vertices;
+            std::vector<graphics::ShapeVertex> vertices;
             bool dirty = false;
         };
     } // namespace scene
@@ -29,6 +29,8 @@ namespace ouzel
         {
             boundingBox = meshData.boundingBox;
             material = meshData.material;
+
+            invalidateActor();
         }
 
         void SkinnedMeshRenderer::init(const std::string& filename)
@@ -0,0 +1,365 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <cassert>
+#include "SpatialIndex.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // fraction of the box size that leaves are enlarged by
+        static const float BOX_MARGIN = 0.1F;
+
+        static inline Box3 mergeBoxes(const Box3& a, const Box3& b)
+        {
+            return Box3(Vector3(std::min(a.min.x, b.min.x), std::min(a.min.y, b.min.y), std::min(a.min.z, b.min.z)),
+                        Vector3(std::max(a.max.x, b.max.x), std::max(a.max.y, b.max.y), std::max(a.max.z, b.max.z)));
+        }
+
+        // sum of the box extents, works for flat 2D boxes too
+        static inline float getCost(const Box3& box)
+        {
+            return (box.max.x - box.min.x) + (box.max.y - box.min.y) + (box.max.z - box.min.z);
+        }
+
+        static inline bool containsBox(const Box3& outer, const Box3& inner)
+        {
+            return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+                inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+        }
+
+        static inline Box3 enlargeBox(const Box3& box)
+        {
+            Vector3 margin((box.max.x - box.min.x) * BOX_MARGIN,
+                           (box.max.y - box.min.y) * BOX_MARGIN,
+                           (box.max.z - box.min.z) * BOX_MARGIN);
+
+            return Box3(box.min - margin, box.max + margin);
+        }
+
+        int32_t SpatialIndex::createProxy(const Box3& box, Actor* actor)
+        {
+            int32_t proxy = allocateNode();
+            Node& node = nodes[static_cast<size_t>(proxy)];
+            node.box = enlargeBox(box);
+            node.actor = actor;
+            node.height = 0;
+
+            insertLeaf(proxy);
+            ++proxyCount;
+
+            return proxy;
+        }
+
+        void SpatialIndex::destroyProxy(int32_t proxy)
+        {
+            assert(nodes[static_cast<size_t>(proxy)].isLeaf());
+
+            removeLeaf(proxy);
+            freeNode(proxy);
+            --proxyCount;
+        }
+
+        bool SpatialIndex::moveProxy(int32_t proxy, const Box3& box)
+        {
+            assert(nodes[static_cast<size_t>(proxy)].isLeaf());
+
+            if (containsBox(nodes[static_cast<size_t>(proxy)].box, box))
+                return false;
+
+            removeLeaf(proxy);
+            nodes[static_cast<size_t>(proxy)].box = enlargeBox(box);
+            insertLeaf(proxy);
+
+            return true;
+        }
+
+        void SpatialIndex::query(const Box3& box, std::vector<Actor*>& result) const
+        {
+            query(box, result, stack);
+        }
+
+        void SpatialIndex::query(const Box3& box, std::vector<Actor*>& result, std::vector<int32_t>& stack) const
+        {
+            if (root == NULL_PROXY) return;
+
+            stack.clear();
+            stack.push_back(root);
+
+            while (!stack.empty())
+            {
+                const Node& node = nodes[static_cast<size_t>(stack.back())];
+                stack.pop_back();
+
+                if (node.box.intersects(box))
+                {
+                    if (node.isLeaf())
+                        result.push_back(node.actor);
+                    else
+                    {
+                        stack.push_back(node.child1);
+                        stack.push_back(node.child2);
+                    }
+                }
+            }
+        }
+
+        int32_t SpatialIndex::getHeight() const
+        {
+            return (root == NULL_PROXY) ? 0 : nodes[static_cast<size_t>(root)].height;
+        }
+
+        int32_t SpatialIndex::allocateNode()
+        {
+            if (freeList == NULL_PROXY)
+            {
+                nodes.push_back(Node());
+                return static_cast<int32_t>(nodes.size() - 1);
+            }
+
+            int32_t node = freeList;
+            freeList = nodes[static_cast<size_t>(node)].parent;
+            nodes[static_cast<size_t>(node)] = Node();
+            return node;
+        }
+
+        void SpatialIndex::freeNode(int32_t node)
+        {
+            Node& freedNode = nodes[static_cast<size_t>(node)];
+            freedNode.actor = nullptr;
+            freedNode.child1 = NULL_PROXY;
+            freedNode.child2 = NULL_PROXY;
+            freedNode.height = -1;
+            freedNode.parent = freeList;
+            freeList = node;
+        }
+
+        void SpatialIndex::insertLeaf(int32_t leaf)
+        {
+            if (root == NULL_PROXY)
+            {
+                root = leaf;
+                nodes[static_cast<size_t>(root)].parent = NULL_PROXY;
+                return;
+            }
+
+            // find the sibling that grows the tree the least
+            Box3 leafBox = nodes[static_cast<size_t>(leaf)].box;
+            int32_t index = root;
+
+            while (!nodes[static_cast<size_t>(index)].isLeaf())
+            {
+                const Node& node = nodes[static_cast<size_t>(index)];
+                const Node& child1 = nodes[static_cast<size_t>(node.child1)];
+                const Node& child2 = nodes[static_cast<size_t>(node.child2)];
+
+                float area = getCost(node.box);
+                float combinedArea = getCost(mergeBoxes(node.box, leafBox));
+
+                // cost of creating a new parent for this node and the leaf
+                float cost = 2.0F * combinedArea;
+
+                // minimum cost of pushing the leaf further down the tree
+                float inheritanceCost = 2.0F * (combinedArea - area);
+
+                float cost1 = getCost(mergeBoxes(child1.box, leafBox)) + inheritanceCost;
+                if (!child1.isLeaf()) cost1 -= getCost(child1.box);
+
+                float cost2 = getCost(mergeBoxes(child2.box, leafBox)) + inheritanceCost;
+                if (!child2.isLeaf()) cost2 -= getCost(child2.box);
+
+                if (cost < cost1 && cost < cost2) break;
+
+                index = (cost1 < cost2) ? node.child1 : node.child2;
+            }
+
+            int32_t sibling = index;
+            int32_t oldParent = nodes[static_cast<size_t>(sibling)].parent;
+            int32_t newParent = allocateNode(); // may reallocate the nodes
+
+            Node& parentNode = nodes[static_cast<size_t>(newParent)];
+            parentNode.parent = oldParent;
+            parentNode.box = mergeBoxes(leafBox, nodes[static_cast<size_t>(sibling)].box);
+            parentNode.height = nodes[static_cast<size_t>(sibling)].height + 1;
+            parentNode.child1 = sibling;
+            parentNode.child2 = leaf;
+
+            if (oldParent != NULL_PROXY)
+            {
+                Node& oldParentNode = nodes[static_cast<size_t>(oldParent)];
+                if (oldParentNode.child1 == sibling)
+                    oldParentNode.child1 = newParent;
+                else
+                    oldParentNode.child2 = newParent;
+            }
+            else
+                root = newParent;
+
+            nodes[static_cast<size_t>(sibling)].parent = newParent;
+            nodes[static_cast<size_t>(leaf)].parent = newParent;
+
+            refit(nodes[static_cast<size_t>(leaf)].parent);
+        }
+
+        void SpatialIndex::removeLeaf(int32_t leaf)
+        {
+            if (leaf == root)
+            {
+                root = NULL_PROXY;
+                return;
+            }
+
+            int32_t parent = nodes[static_cast<size_t>(leaf)].parent;
+            int32_t grandParent = nodes[static_cast<size_t>(parent)].parent;
+            int32_t sibling = (nodes[static_cast<size_t>(parent)].child1 == leaf) ?
+                nodes[static_cast<size_t>(parent)].child2 :
+                nodes[static_cast<size_t>(parent)].child1;
+
+            if (grandParent != NULL_PROXY)
+            {
+                Node& grandParentNode = nodes[static_cast<size_t>(grandParent)];
+                if (grandParentNode.child1 == parent)
+                    grandParentNode.child1 = sibling;
+                else
+                    grandParentNode.child2 = sibling;
+
+                nodes[static_cast<size_t>(sibling)].parent = grandParent;
+                freeNode(parent);
+
+                refit(grandParent);
+            }
+            else
+            {
+                root = sibling;
+                nodes[static_cast<size_t>(sibling)].parent = NULL_PROXY;
+                freeNode(parent);
+            }
+        }
+
+        void SpatialIndex::refit(int32_t index)
+        {
+            while (index != NULL_PROXY)
+            {
+                index = balance(index);
+
+                Node& node = nodes[static_cast<size_t>(index)];
+                const Node& child1 = nodes[static_cast<size_t>(node.child1)];
+                const Node& child2 = nodes[static_cast<size_t>(node.child2)];
+
+                node.height = 1 + std::max(child1.height, child2.height);
+                node.box = mergeBoxes(child1.box, child2.box);
+
+                index = node.parent;
+            }
+        }
+
+        // rotates the taller child up if the subtree of the node is unbalanced, returns the new subtree root
+        int32_t SpatialIndex::balance(int32_t indexA)
+        {
+            Node& a = nodes[static_cast<size_t>(indexA)];
+            if (a.isLeaf() || a.height < 2) return indexA;
+
+            int32_t indexB = a.child1;
+            int32_t indexC = a.child2;
+            Node& b = nodes[static_cast<size_t>(indexB)];
+            Node& c = nodes[static_cast<size_t>(indexC)];
+
+            int32_t heightDifference = c.height - b.height;
+
+            if (heightDifference > 1)
+            {
+                int32_t indexF = c.child1;
+                int32_t indexG = c.child2;
+                Node& f = nodes[static_cast<size_t>(indexF)];
+                Node& g = nodes[static_cast<size_t>(indexG)];
+
+                c.child1 = indexA;
+                c.parent = a.parent;
+                a.parent = indexC;
+
+                if (c.parent != NULL_PROXY)
+                {
+                    Node& parentNode = nodes[static_cast<size_t>(c.parent)];
+                    if (parentNode.child1 == indexA)
+                        parentNode.child1 = indexC;
+                    else
+                        parentNode.child2 = indexC;
+                }
+                else
+                    root = indexC;
+
+                if (f.height > g.height)
+                {
+                    c.child2 = indexF;
+                    a.child2 = indexG;
+                    g.parent = indexA;
+                    a.box = mergeBoxes(b.box, g.box);
+                    c.box = mergeBoxes(a.box, f.box);
+                    a.height = 1 + std::max(b.height, g.height);
+                    c.height = 1 + std::max(a.height, f.height);
+                }
+                else
+                {
+                    c.child2 = indexG;
+                    a.child2 = indexF;
+                    f.parent = indexA;
+                    a.box = mergeBoxes(b.box, f.box);
+                    c.box = mergeBoxes(a.box, g.box);
+                    a.height = 1 + std::max(b.height, f.height);
+                    c.height = 1 + std::max(a.height, g.height);
+                }
+
+                return indexC;
+            }
+
+            if (heightDifference < -1)
+            {
+                int32_t indexD = b.child1;
+                int32_t indexE = b.child2;
+                Node& d = nodes[static_cast<size_t>(indexD)];
+                Node& e = nodes[static_cast<size_t>(indexE)];
+
+                b.child1 = indexA;
+                b.parent = a.parent;
+                a.parent = indexB;
+
+                if (b.parent != NULL_PROXY)
+                {
+                    Node& parentNode = nodes[static_cast<size_t>(b.parent)];
+                    if (parentNode.child1 == indexA)
+                        parentNode.child1 = indexB;
+                    else
+                        parentNode.child2 = indexB;
+                }
+                else
+                    root = indexB;
+
+                if (d.height > e.height)
+                {
+                    b.child2 = indexD;
+                    a.child1 = indexE;
+                    e.parent = indexA;
+                    a.box = mergeBoxes(c.box, e.box);
+                    b.box = mergeBoxes(a.box, d.box);
+                    a.height = 1 + std::max(c.height, e.height);
+                    b.height = 1 + std::max(a.height, d.height);
+                }
+                else
+                {
+                    b.child2 = indexE;
+                    a.child1 = indexD;
+                    d.parent = indexA;
+                    a.box = mergeBoxes(c.box, d.box);
+                    b.box = mergeBoxes(a.box, e.box);
+                    a.height = 1 + std::max(c.height, d.height);
+                    b.height = 1 + std::max(a.height, e.height);
+                }
+
+                return indexB;
+            }
+
+            return indexA;
+        }
+    } // namespace scene
+} // namespace ouzel
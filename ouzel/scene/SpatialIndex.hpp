@@ -0,0 +1,78 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_SPATIALINDEX_HPP
+#define OUZEL_SCENE_SPATIALINDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include "math/Box3.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+
+        // Dynamic bounding volume tree of actor bounding boxes.
+        // Leaves store enlarged boxes, so actors that move a little do not have to be reinserted.
+        class SpatialIndex final
+        {
+        public:
+            static const int32_t NULL_PROXY = -1;
+
+            SpatialIndex() = default;
+
+            SpatialIndex(const SpatialIndex&) = delete;
+            SpatialIndex& operator=(const SpatialIndex&) = delete;
+
+            SpatialIndex(SpatialIndex&&) = delete;
+            SpatialIndex& operator=(SpatialIndex&&) = delete;
+
+            int32_t createProxy(const Box3& box, Actor* actor);
+            void destroyProxy(int32_t proxy);
+            // returns true if the proxy had to be reinserted
+            bool moveProxy(int32_t proxy, const Box3& box);
+
+            inline Actor* getActor(int32_t proxy) const { return nodes[static_cast<size_t>(proxy)].actor; }
+            inline const Box3& getBox(int32_t proxy) const { return nodes[static_cast<size_t>(proxy)].box; }
+
+            // appends the actors whose enlarged boxes overlap the given box
+            void query(const Box3& box, std::vector<Actor*>& result) const;
+            // can be called from several threads at once, because it does not use the shared traversal stack
+            void query(const Box3& box, std::vector<Actor*>& result, std::vector<int32_t>& traversalStack) const;
+
+            int32_t getHeight() const;
+            inline uint32_t getProxyCount() const { return proxyCount; }
+
+        private:
+            struct Node final
+            {
+                Box3 box;
+                Actor* actor = nullptr;
+                int32_t parent = NULL_PROXY; // next free node for nodes in the free list
+                int32_t child1 = NULL_PROXY;
+                int32_t child2 = NULL_PROXY;
+                int32_t height = -1; // 0 for leaves, -1 for free nodes
+
+                inline bool isLeaf() const { return child1 == NULL_PROXY; }
+            };
+
+            int32_t allocateNode();
+            void freeNode(int32_t node);
+
+            void insertLeaf(int32_t leaf);
+            void removeLeaf(int32_t leaf);
+            int32_t balance(int32_t node);
+            void refit(int32_t node);
+
+            std::vector<Node> nodes;
+            int32_t root = NULL_PROXY;
+            int32_t freeList = NULL_PROXY;
+            uint32_t proxyCount = 0;
+
+            mutable std::vector<int32_t> stack;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_SPATIALINDEX_HPP
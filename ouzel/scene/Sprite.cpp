@@ -216,23 +216,13 @@ namespace ouzel
                             renderViewProjection,
                             wireframe);
 
-            if (currentAnimation != animationQueue.end() &&
-                currentAnimation->animation->frameInterval > 0.0F &&
-                !currentAnimation->animation->frames.empty() &&
-                material)
-            {
-                size_t currentFrame = static_cast<size_t>(currentTime / currentAnimation->animation->frameInterval);
-                if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+            const SpriteData::Frame* frame = getCurrentFrame();
 
+            if (frame && material)
+            {
                 Matrix4 modelViewProj = renderViewProjection * transformMatrix * offsetMatrix;
                 float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity * material->opacity};
 
-                std::vector<std::vector<float>> fragmentShaderConstants(1);
-                fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-                std::vector<std::vector<float>> vertexShaderConstants(1);
-                vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
                 std::vector<uintptr_t> textures;
                 for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
                     textures.push_back(texture ? texture->getResource() : 0);
@@ -240,21 +230,68 @@ namespace ouzel
                 engine->getRenderer()->setCullMode(material->cullMode);
                 engine->getRenderer()->setPipelineState(material->blendState->getResource(),
                                                         material->shader->getResource());
-                engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                          vertexShaderConstants);
+                engine->getRenderer()->setShaderConstants(colorVector,
+                                                          static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                          modelViewProj.m,
+                                                          static_cast<uint32_t>(sizeof(modelViewProj.m) / sizeof(float)));
                 engine->getRenderer()->setTextures(textures);
 
-                const SpriteData::Frame& frame = currentAnimation->animation->frames[currentFrame];
-
-                engine->getRenderer()->draw(frame.getIndexBuffer()->getResource(),
-                                            frame.getIndexCount(),
+                engine->getRenderer()->draw(frame->getIndexBuffer()->getResource(),
+                                            frame->getIndexCount(),
                                             sizeof(uint16_t),
-                                            frame.getVertexBuffer()->getResource(),
+                                            frame->getVertexBuffer()->getResource(),
                                             graphics::DrawMode::TRIANGLE_LIST,
                                             0);
             }
         }
 
+        void Sprite::batch(SpriteBatcher& batcher,
+                           const Matrix4& transformMatrix,
+                           float opacity,
+                           const Matrix4& renderViewProjection)
+        {
+            const SpriteData::Frame* frame = getCurrentFrame();
+
+            if (frame && material)
+                batcher.addSprite(*material, *frame, transformMatrix * offsetMatrix, opacity, renderViewProjection);
+        }
+
+        bool Sprite::instance(MeshInstancer& instancer,
+                              const Matrix4& transformMatrix,
+                              float opacity,
+                              const Matrix4& renderViewProjection)
+        {
+            const SpriteData::Frame* frame = getCurrentFrame();
+
+            if (!frame || !material) return true; // nothing to draw
+            if (!MeshInstancer::isInstanceable(*material)) return false;
+
+            instancer.addInstance(*material,
+                                  frame->getIndexBuffer()->getResource(),
+                                  frame->getIndexCount(),
+                                  sizeof(uint16_t),
+                                  frame->getVertexBuffer()->getResource(),
+                                  transformMatrix * offsetMatrix,
+                                  opacity,
+                                  renderViewProjection);
+            return true;
+        }
+
+        const SpriteData::Frame* Sprite::getCurrentFrame() const
+        {
+            if (currentAnimation != animationQueue.end() &&
+                currentAnimation->animation->frameInterval > 0.0F &&
+                !currentAnimation->animation->frames.empty())
+            {
+                size_t currentFrame = static_cast<size_t>(currentTime / currentAnimation->animation->frameInterval);
+                if (currentFrame >= currentAnimation->animation->frames.size()) currentFrame = currentAnimation->animation->frames.size() - 1;
+
+                return &currentAnimation->animation->frames[currentFrame];
+            }
+
+            return nullptr;
+        }
+
         void Sprite::setOffset(const Vector2& newOffset)
         {
             offset = newOffset;
@@ -384,6 +421,8 @@ namespace ouzel
             }
             else
                 boundingBox.reset();
+
+            invalidateActor();
         }
     } // namespace scene
 } // namespace ouzel
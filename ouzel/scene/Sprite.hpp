@@ -8,6 +8,8 @@
 #include "math/Size2.hpp"
 #include "math/Vector2.hpp"
 #include "scene/SpriteData.hpp"
+#include "scene/MeshInstancer.hpp"
+#include "scene/SpriteBatcher.hpp"
 #include "events/EventHandler.hpp"
 #include "graphics/Material.hpp"
 
@@ -40,6 +42,15 @@ namespace ouzel
                       const Matrix4& renderViewProjection,
                       bool wireframe) override;
 
+            void batch(SpriteBatcher& batcher,
+                       const Matrix4& transformMatrix,
+                       float opacity,
+                       const Matrix4& renderViewProjection);
+            bool instance(MeshInstancer& instancer,
+                          const Matrix4& transformMatrix,
+                          float opacity,
+                          const Matrix4& renderViewProjection);
+
             inline const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
             inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
 
@@ -63,6 +74,7 @@ namespace ouzel
         private:
             bool handleUpdate(const UpdateEvent& event);
             void updateBoundingBox();
+            const SpriteData::Frame* getCurrentFrame() const;
 
             std::shared_ptr<graphics::Material> material;
             std::map<std::string, SpriteData::Animation> animations;
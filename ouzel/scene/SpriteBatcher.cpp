@@ -0,0 +1,139 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include "SpriteBatcher.hpp"
+#include "core/Engine.hpp"
+#include "graphics/Renderer.hpp"
+#include "math/MathUtils.hpp"
+#include "utils/Utils.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        void SpriteBatcher::begin()
+        {
+            indices.clear();
+            vertices.clear();
+            currentBuffer = 0;
+            stats = Stats();
+        }
+
+        void SpriteBatcher::addSprite(const graphics::Material& material,
+                                      const SpriteData::Frame& frame,
+                                      const Matrix4& transformMatrix,
+                                      float opacity,
+                                      const Matrix4& renderViewProjection)
+        {
+            const std::vector<uint16_t>& frameIndices = frame.getIndices();
+            const std::vector<graphics::Vertex>& frameVertices = frame.getVertices();
+
+            if (frameIndices.empty() || frameVertices.empty()) return;
+
+            uintptr_t newShader = material.shader->getResource();
+            uintptr_t newBlendState = material.blendState->getResource();
+            uintptr_t newTextures[graphics::Texture::LAYERS];
+            for (uint32_t layer = 0; layer < graphics::Texture::LAYERS; ++layer)
+                newTextures[layer] = material.textures[layer] ? material.textures[layer]->getResource() : 0;
+
+            if (!indices.empty())
+            {
+                if (newShader != shader)
+                    breakBatch(BreakReason::SHADER);
+                else if (newBlendState != blendState)
+                    breakBatch(BreakReason::BLEND_STATE);
+                else if (material.cullMode != cullMode)
+                    breakBatch(BreakReason::CULL_MODE);
+                else if (!std::equal(std::begin(newTextures), std::end(newTextures), std::begin(textures)))
+                    breakBatch(BreakReason::TEXTURE);
+                else if (vertices.size() + frameVertices.size() > std::numeric_limits<uint16_t>::max() + 1U)
+                    breakBatch(BreakReason::BUFFER_FULL);
+                else if (viewProjection != renderViewProjection)
+                    flush();
+            }
+
+            if (indices.empty())
+            {
+                shader = newShader;
+                blendState = newBlendState;
+                cullMode = material.cullMode;
+                std::copy(std::begin(newTextures), std::end(newTextures), std::begin(textures));
+                viewProjection = renderViewProjection;
+            }
+
+            uint16_t firstVertex = static_cast<uint16_t>(vertices.size());
+
+            for (uint16_t index : frameIndices)
+                indices.push_back(static_cast<uint16_t>(firstVertex + index));
+
+            float colorR = material.diffuseColor.normR();
+            float colorG = material.diffuseColor.normG();
+            float colorB = material.diffuseColor.normB();
+            float colorA = material.diffuseColor.normA() * opacity * material.opacity;
+
+            for (const graphics::Vertex& frameVertex : frameVertices)
+            {
+                graphics::Vertex vertex = frameVertex;
+                transformMatrix.transformPoint(vertex.position);
+                vertex.color = Color(static_cast<uint8_t>(vertex.color.r * colorR),
+                                     static_cast<uint8_t>(vertex.color.g * colorG),
+                                     static_cast<uint8_t>(vertex.color.b * colorB),
+                                     static_cast<uint8_t>(vertex.color.a * clamp(colorA, 0.0F, 1.0F)));
+                vertices.push_back(vertex);
+            }
+
+            ++stats.spriteCount;
+        }
+
+        void SpriteBatcher::breakBatch(BreakReason reason)
+        {
+            if (!indices.empty())
+            {
+                ++stats.breakCount[static_cast<size_t>(reason)];
+                flush();
+            }
+        }
+
+        void SpriteBatcher::flush()
+        {
+            if (indices.empty()) return;
+
+            if (currentBuffer >= buffers.size())
+            {
+                BufferPair bufferPair;
+                bufferPair.indexBuffer.reset(new graphics::Buffer(*engine->getRenderer()));
+                bufferPair.indexBuffer->init(graphics::Buffer::Usage::INDEX, graphics::Buffer::DYNAMIC);
+                bufferPair.vertexBuffer.reset(new graphics::Buffer(*engine->getRenderer()));
+                bufferPair.vertexBuffer->init(graphics::Buffer::Usage::VERTEX, graphics::Buffer::DYNAMIC);
+                buffers.push_back(std::move(bufferPair));
+            }
+
+            const BufferPair& bufferPair = buffers[currentBuffer++];
+            bufferPair.indexBuffer->setData(indices.data(), static_cast<uint32_t>(getVectorSize(indices)));
+            bufferPair.vertexBuffer->setData(vertices.data(), static_cast<uint32_t>(getVectorSize(vertices)));
+
+            float colorVector[] = {1.0F, 1.0F, 1.0F, 1.0F};
+
+            engine->getRenderer()->setCullMode(cullMode);
+            engine->getRenderer()->setPipelineState(blendState, shader);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                      viewProjection.m,
+                                                      static_cast<uint32_t>(sizeof(viewProjection.m) / sizeof(float)));
+            engine->getRenderer()->setTextures(textures, graphics::Texture::LAYERS);
+            engine->getRenderer()->draw(bufferPair.indexBuffer->getResource(),
+                                        static_cast<uint32_t>(indices.size()),
+                                        sizeof(uint16_t),
+                                        bufferPair.vertexBuffer->getResource(),
+                                        graphics::DrawMode::TRIANGLE_LIST,
+                                        0);
+
+            ++stats.batchCount;
+
+            indices.clear();
+            vertices.clear();
+        }
+    } // namespace scene
+} // namespace ouzel
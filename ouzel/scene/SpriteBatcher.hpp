@@ -0,0 +1,89 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_SPRITEBATCHER_HPP
+#define OUZEL_SCENE_SPRITEBATCHER_HPP
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "graphics/Buffer.hpp"
+#include "graphics/Material.hpp"
+#include "graphics/Vertex.hpp"
+#include "math/Matrix4.hpp"
+#include "scene/SpriteData.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        // Merges consecutive sprites that share the same render state into a single draw call.
+        // Vertices are transformed on the CPU, so the shader receives only the view projection.
+        class SpriteBatcher final
+        {
+        public:
+            enum class BreakReason
+            {
+                SHADER,
+                BLEND_STATE,
+                CULL_MODE,
+                TEXTURE,
+                BUFFER_FULL, // 16-bit indices can not address more vertices
+                UNBATCHED_DRAW, // a draw that did not go through the batcher
+                COUNT
+            };
+
+            struct Stats final
+            {
+                uint32_t spriteCount = 0;
+                uint32_t batchCount = 0;
+                uint32_t breakCount[static_cast<size_t>(BreakReason::COUNT)] = {};
+            };
+
+            SpriteBatcher() = default;
+
+            SpriteBatcher(const SpriteBatcher&) = delete;
+            SpriteBatcher& operator=(const SpriteBatcher&) = delete;
+
+            SpriteBatcher(SpriteBatcher&&) = delete;
+            SpriteBatcher& operator=(SpriteBatcher&&) = delete;
+
+            void begin();
+
+            void addSprite(const graphics::Material& material,
+                           const SpriteData::Frame& frame,
+                           const Matrix4& transformMatrix,
+                           float opacity,
+                           const Matrix4& renderViewProjection);
+
+            void breakBatch(BreakReason reason);
+            void flush();
+
+            inline const Stats& getStats() const { return stats; }
+            inline uint32_t getBreakCount(BreakReason reason) const { return stats.breakCount[static_cast<size_t>(reason)]; }
+
+        private:
+            struct BufferPair final
+            {
+                std::unique_ptr<graphics::Buffer> indexBuffer;
+                std::unique_ptr<graphics::Buffer> vertexBuffer;
+            };
+
+            uintptr_t shader = 0;
+            uintptr_t blendState = 0;
+            graphics::CullMode cullMode = graphics::CullMode::NONE;
+            uintptr_t textures[graphics::Texture::LAYERS] = {};
+            Matrix4 viewProjection;
+
+            std::vector<uint16_t> indices;
+            std::vector<graphics::Vertex> vertices;
+
+            // every batch of a frame gets its own buffers, so that uploads never overwrite data that is still needed
+            std::vector<BufferPair> buffers;
+            size_t currentBuffer = 0;
+
+            Stats stats;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_SPRITEBATCHER_HPP
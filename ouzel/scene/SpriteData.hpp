@@ -51,12 +51,17 @@ namespace ouzel
                 inline const std::shared_ptr<graphics::Buffer>& getIndexBuffer() const { return indexBuffer; };
                 inline const std::shared_ptr<graphics::Buffer>& getVertexBuffer() const { return vertexBuffer; };
 
+                inline const std::vector<uint16_t>& getIndices() const { return indices; }
+                inline const std::vector<graphics::Vertex>& getVertices() const { return vertices; }
+
             private:
                 std::string name;
                 Box2 boundingBox;
                 uint32_t indexCount = 0;
                 std::shared_ptr<graphics::Buffer> indexBuffer;
                 std::shared_ptr<graphics::Buffer> vertexBuffer;
+                std::vector<uint16_t> indices;
+                std::vector<graphics::Vertex> vertices;
             };
 
             struct Animation final
@@ -32,6 +32,8 @@ namespace ouzel
             indexSize = meshData.indexSize;
             indexBuffer = meshData.indexBuffer;
             vertexBuffer = meshData.vertexBuffer;
+
+            invalidateActor();
         }
 
         void StaticMeshRenderer::init(const std::string& filename)
@@ -54,12 +56,6 @@ namespace ouzel
             Matrix4 modelViewProj = renderViewProjection * transformMatrix;
             float colorVector[] = {material->diffuseColor.normR(), material->diffuseColor.normG(), material->diffuseColor.normB(), material->diffuseColor.normA() * opacity * material->opacity};
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
             std::vector<uintptr_t> textures;
             for (const std::shared_ptr<graphics::Texture>& texture : material->textures)
                 textures.push_back(texture ? texture->getResource() : 0);
@@ -67,8 +63,10 @@ namespace ouzel
             engine->getRenderer()->setCullMode(material->cullMode);
             engine->getRenderer()->setPipelineState(material->blendState->getResource(),
                                                     material->shader->getResource());
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                      modelViewProj.m,
+                                                      static_cast<uint32_t>(sizeof(modelViewProj.m) / sizeof(float)));
             engine->getRenderer()->setTextures(textures);
             engine->getRenderer()->draw(indexBuffer->getResource(),
                                         indexCount,
@@ -77,5 +75,25 @@ namespace ouzel
                                         graphics::DrawMode::TRIANGLE_LIST,
                                         0);
         }
+
+        bool StaticMeshRenderer::instance(MeshInstancer& instancer,
+                                          const Matrix4& transformMatrix,
+                                          float opacity,
+                                          const Matrix4& renderViewProjection)
+        {
+            if (!MeshInstancer::isInstanceable(*material)) return false;
+
+            material->cullMode = graphics::CullMode::NONE;
+
+            instancer.addInstance(*material,
+                                  indexBuffer->getResource(),
+                                  indexCount,
+                                  indexSize,
+                                  vertexBuffer->getResource(),
+                                  transformMatrix,
+                                  opacity,
+                                  renderViewProjection);
+            return true;
+        }
     } // namespace scene
 } // namespace ouzel
@@ -4,6 +4,7 @@
 #define OUZEL_SCENE_STATICMESHRENDERER_HPP
 
 #include "scene/Component.hpp"
+#include "scene/MeshInstancer.hpp"
 #include "scene/StaticMeshData.hpp"
 
 namespace ouzel
@@ -26,6 +27,10 @@ namespace ouzel
                       float opacity,
                       const Matrix4& renderViewProjection,
                       bool wireframe) override;
+            bool instance(MeshInstancer& instancer,
+                          const Matrix4& transformMatrix,
+                          float opacity,
+                          const Matrix4& renderViewProjection);
 
             inline const std::shared_ptr<graphics::Material>& getMaterial() const { return material; }
             inline void setMaterial(const std::shared_ptr<graphics::Material>& newMaterial) { material = newMaterial; }
@@ -79,16 +79,12 @@ namespace ouzel
             Matrix4 modelViewProj = renderViewProjection * transformMatrix;
             float colorVector[] = {color.normR(), color.normG(), color.normB(), color.normA() * opacity};
 
-            std::vector<std::vector<float>> fragmentShaderConstants(1);
-            fragmentShaderConstants[0] = {std::begin(colorVector), std::end(colorVector)};
-
-            std::vector<std::vector<float>> vertexShaderConstants(1);
-            vertexShaderConstants[0] = {std::begin(modelViewProj.m), std::end(modelViewProj.m)};
-
             engine->getRenderer()->setCullMode(graphics::CullMode::NONE);
             engine->getRenderer()->setPipelineState(blendState->getResource(), shader->getResource());
-            engine->getRenderer()->setShaderConstants(fragmentShaderConstants,
-                                                      vertexShaderConstants);
+            engine->getRenderer()->setShaderConstants(colorVector,
+                                                      static_cast<uint32_t>(sizeof(colorVector) / sizeof(float)),
+                                                      modelViewProj.m,
+                                                      static_cast<uint32_t>(sizeof(modelViewProj.m) / sizeof(float)));
             engine->getRenderer()->setTextures({wireframe ? whitePixelTexture->getResource() : texture->getResource()});
             engine->getRenderer()->draw(indexBuffer->getResource(),
                                         static_cast<uint32_t>(indices.size()),
@@ -128,6 +124,8 @@ namespace ouzel
                 vertices.clear();
                 texture.reset();
             }
+
+            invalidateActor();
         }
     } // namespace scene
 } // namespace ouzel
@@ -0,0 +1,118 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <cassert>
+#include "TransformHierarchy.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        void TransformHierarchy::clear()
+        {
+            actors.clear();
+            parents.clear();
+            positions.clear();
+            rotations.clear();
+            scales.clear();
+            localDirty.clear();
+            localTransforms.clear();
+            worldTransforms.clear();
+            worldChanged.clear();
+        }
+
+        uint32_t TransformHierarchy::add(Actor* actor, int32_t parent,
+                                         const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+        {
+            assert(parent < static_cast<int32_t>(actors.size()));
+
+            actors.push_back(actor);
+            parents.push_back(parent);
+            positions.push_back(position);
+            rotations.push_back(rotation);
+            scales.push_back(scale);
+            localDirty.push_back(1);
+            localTransforms.push_back(Matrix4::identity());
+            worldTransforms.push_back(Matrix4::identity());
+            worldChanged.push_back(0);
+
+            return static_cast<uint32_t>(actors.size() - 1);
+        }
+
+        void TransformHierarchy::setLocalTransform(uint32_t index,
+                                                   const Vector3& position, const Quaternion& rotation, const Vector3& scale)
+        {
+            positions[index] = position;
+            rotations[index] = rotation;
+            scales[index] = scale;
+            localDirty[index] = 1;
+        }
+
+        void TransformHierarchy::update(std::vector<uint32_t>& changed)
+        {
+            const size_t size = actors.size();
+
+            for (size_t i = 0; i < size; ++i)
+            {
+                int32_t parent = parents[i];
+                bool dirty = localDirty[i] != 0;
+
+                if (dirty)
+                {
+                    // translation * rotation * scale, built directly instead of multiplying three matrices
+                    const Quaternion& rotation = rotations[i];
+                    const Vector3& scale = scales[i];
+                    const Vector3& position = positions[i];
+                    float* m = localTransforms[i].m;
+
+                    float wx = rotation.w * rotation.x;
+                    float wy = rotation.w * rotation.y;
+                    float wz = rotation.w * rotation.z;
+                    float xx = rotation.x * rotation.x;
+                    float xy = rotation.x * rotation.y;
+                    float xz = rotation.x * rotation.z;
+                    float yy = rotation.y * rotation.y;
+                    float yz = rotation.y * rotation.z;
+                    float zz = rotation.z * rotation.z;
+
+                    m[0] = (1.0F - 2.0F * (yy + zz)) * scale.x;
+                    m[1] = 2.0F * (xy + wz) * scale.x;
+                    m[2] = 2.0F * (xz - wy) * scale.x;
+                    m[3] = 0.0F;
+
+                    m[4] = 2.0F * (xy - wz) * scale.y;
+                    m[5] = (1.0F - 2.0F * (xx + zz)) * scale.y;
+                    m[6] = 2.0F * (yz + wx) * scale.y;
+                    m[7] = 0.0F;
+
+                    m[8] = 2.0F * (xz + wy) * scale.z;
+                    m[9] = 2.0F * (yz - wx) * scale.z;
+                    m[10] = (1.0F - 2.0F * (xx + yy)) * scale.z;
+                    m[11] = 0.0F;
+
+                    m[12] = position.x;
+                    m[13] = position.y;
+                    m[14] = position.z;
+                    m[15] = 1.0F;
+
+                    localDirty[i] = 0;
+                }
+
+                // parents come first, so their flags are already set for this pass
+                if (parent != NO_PARENT && worldChanged[static_cast<size_t>(parent)])
+                    dirty = true;
+
+                worldChanged[i] = dirty ? 1 : 0;
+
+                if (dirty)
+                {
+                    if (parent == NO_PARENT)
+                        worldTransforms[i] = localTransforms[i];
+                    else
+                        Matrix4::multiply(worldTransforms[static_cast<size_t>(parent)], localTransforms[i], worldTransforms[i]);
+
+                    changed.push_back(static_cast<uint32_t>(i));
+                }
+            }
+        }
+    } // namespace scene
+} // namespace ouzel
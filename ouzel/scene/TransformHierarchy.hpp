@@ -0,0 +1,67 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_SCENE_TRANSFORMHIERARCHY_HPP
+#define OUZEL_SCENE_TRANSFORMHIERARCHY_HPP
+
+#include <cstdint>
+#include <vector>
+#include "math/Matrix4.hpp"
+#include "math/Quaternion.hpp"
+#include "math/Vector3.hpp"
+
+namespace ouzel
+{
+    namespace scene
+    {
+        class Actor;
+
+        // Local and world transforms of a layer's actors stored in contiguous arrays.
+        // Entries are sorted so that parents always come before their children,
+        // which allows all world matrices to be updated in a single linear pass.
+        class TransformHierarchy final
+        {
+        public:
+            static const int32_t NO_PARENT = -1;
+
+            TransformHierarchy() = default;
+
+            TransformHierarchy(const TransformHierarchy&) = delete;
+            TransformHierarchy& operator=(const TransformHierarchy&) = delete;
+
+            TransformHierarchy(TransformHierarchy&&) = delete;
+            TransformHierarchy& operator=(TransformHierarchy&&) = delete;
+
+            void clear();
+
+            // the parent has to be added before its children
+            uint32_t add(Actor* actor, int32_t parent,
+                         const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+
+            void setLocalTransform(uint32_t index,
+                                   const Vector3& position, const Quaternion& rotation, const Vector3& scale);
+
+            // recalculates the dirty local and world matrices and appends the indices of the changed world matrices
+            void update(std::vector<uint32_t>& changed);
+
+            inline size_t getSize() const { return actors.size(); }
+            inline Actor* getActor(uint32_t index) const { return actors[index]; }
+            inline int32_t getParent(uint32_t index) const { return parents[index]; }
+            inline const Matrix4& getWorldTransform(uint32_t index) const { return worldTransforms[index]; }
+
+        private:
+            std::vector<Actor*> actors;
+            std::vector<int32_t> parents;
+
+            std::vector<Vector3> positions;
+            std::vector<Quaternion> rotations;
+            std::vector<Vector3> scales;
+            std::vector<uint8_t> localDirty;
+
+            std::vector<Matrix4> localTransforms;
+            std::vector<Matrix4> worldTransforms;
+            std::vector<uint8_t> worldChanged;
+        };
+    } // namespace scene
+} // namespace ouzel
+
+#endif // OUZEL_SCENE_TRANSFORMHIERARCHY_HPP
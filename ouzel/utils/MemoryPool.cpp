@@ -0,0 +1,141 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#include <new>
+#include "MemoryPool.hpp"
+
+namespace ouzel
+{
+    MemoryPool::SizeClass MemoryPool::sizeClasses[SIZE_CLASS_COUNT];
+    thread_local MemoryPool::ThreadCache MemoryPool::threadCache;
+    thread_local bool MemoryPool::threadCacheDestroyed = false;
+
+    MemoryPool::ThreadCache::~ThreadCache()
+    {
+        // objects deleted later on this thread, for example during static destruction, bypass the cache
+        threadCacheDestroyed = true;
+
+        for (size_t index = 0; index < SIZE_CLASS_COUNT; ++index)
+        {
+            List& list = lists[index];
+
+            if (list.freeBlocks)
+            {
+                Block* last = list.freeBlocks;
+                while (last->next) last = last->next;
+
+                returnBlocks(index, list.freeBlocks, last);
+            }
+        }
+    }
+
+    void* MemoryPool::allocate(size_t size)
+    {
+        if (size == 0 || size > MAX_SIZE) return ::operator new(size);
+
+        size_t index = (size - 1) / GRANULARITY;
+
+        if (threadCacheDestroyed) return takeBlocks(index, 1);
+
+        ThreadCache::List& list = threadCache.lists[index];
+
+        if (!list.freeBlocks)
+        {
+            list.freeBlocks = takeBlocks(index, BATCH_SIZE);
+            list.blockCount = BATCH_SIZE;
+        }
+
+        Block* block = list.freeBlocks;
+        list.freeBlocks = block->next;
+        --list.blockCount;
+
+        return block;
+    }
+
+    void MemoryPool::deallocate(void* pointer, size_t size)
+    {
+        if (!pointer) return;
+
+        if (size == 0 || size > MAX_SIZE)
+        {
+            ::operator delete(pointer);
+            return;
+        }
+
+        size_t index = (size - 1) / GRANULARITY;
+        Block* block = static_cast<Block*>(pointer);
+
+        if (threadCacheDestroyed)
+        {
+            block->next = nullptr;
+            returnBlocks(index, block, block);
+            return;
+        }
+
+        ThreadCache::List& list = threadCache.lists[index];
+
+        block->next = list.freeBlocks;
+        list.freeBlocks = block;
+
+        // a thread that deletes more objects than it creates gives a batch back to the other threads
+        if (++list.blockCount >= BATCH_SIZE * 2)
+        {
+            Block* first = list.freeBlocks;
+            Block* last = first;
+            for (uint32_t i = 1; i < BATCH_SIZE; ++i) last = last->next;
+
+            list.freeBlocks = last->next;
+            list.blockCount -= BATCH_SIZE;
+
+            last->next = nullptr;
+            returnBlocks(index, first, last);
+        }
+    }
+
+    MemoryPool::Block* MemoryPool::takeBlocks(size_t index, uint32_t count)
+    {
+        SizeClass& sizeClass = sizeClasses[index];
+
+        std::unique_lock<std::mutex> lock(sizeClass.mutex);
+
+        Block* first = nullptr;
+        Block* last = nullptr;
+
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            if (!sizeClass.freeBlocks)
+            {
+                // split a new page into blocks, the pages are never freed, so that objects can be deleted during static destruction
+                size_t blockSize = (index + 1) * GRANULARITY;
+                size_t blockCount = PAGE_SIZE / blockSize;
+                char* page = static_cast<char*>(::operator new(blockSize * blockCount));
+
+                for (size_t b = blockCount; b > 0; --b)
+                {
+                    Block* block = reinterpret_cast<Block*>(page + (b - 1) * blockSize);
+                    block->next = sizeClass.freeBlocks;
+                    sizeClass.freeBlocks = block;
+                }
+            }
+
+            Block* block = sizeClass.freeBlocks;
+            sizeClass.freeBlocks = block->next;
+
+            block->next = nullptr;
+            if (last) last->next = block;
+            else first = block;
+            last = block;
+        }
+
+        return first;
+    }
+
+    void MemoryPool::returnBlocks(size_t index, Block* first, Block* last)
+    {
+        SizeClass& sizeClass = sizeClasses[index];
+
+        std::unique_lock<std::mutex> lock(sizeClass.mutex);
+
+        last->next = sizeClass.freeBlocks;
+        sizeClass.freeBlocks = first;
+    }
+}
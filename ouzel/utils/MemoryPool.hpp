@@ -0,0 +1,64 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_MEMORYPOOL_HPP
+#define OUZEL_UTILS_MEMORYPOOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace ouzel
+{
+    // Allocates small objects from free lists of fixed size blocks, one list per size class.
+    // Every thread keeps a cache of free blocks per size class and locks the shared list only to move a batch of blocks,
+    // so that threads that create and delete objects in parallel rarely wait for each other.
+    // Deleted blocks are recycled for the next object of the same size class, the memory is never returned to the heap.
+    class MemoryPool final
+    {
+    public:
+        MemoryPool() = delete;
+
+        static void* allocate(size_t size);
+        static void deallocate(void* pointer, size_t size);
+
+    private:
+        static const size_t GRANULARITY = 16;
+        static const size_t MAX_SIZE = 4096;
+        static const size_t SIZE_CLASS_COUNT = MAX_SIZE / GRANULARITY;
+        static const size_t PAGE_SIZE = 65536;
+        static const uint32_t BATCH_SIZE = 32;
+
+        struct Block final
+        {
+            Block* next;
+        };
+
+        struct SizeClass final
+        {
+            std::mutex mutex;
+            Block* freeBlocks = nullptr;
+        };
+
+        struct ThreadCache final
+        {
+            ~ThreadCache();
+
+            struct List final
+            {
+                Block* freeBlocks = nullptr;
+                uint32_t blockCount = 0;
+            };
+
+            List lists[SIZE_CLASS_COUNT];
+        };
+
+        static Block* takeBlocks(size_t index, uint32_t count);
+        static void returnBlocks(size_t index, Block* first, Block* last);
+
+        static SizeClass sizeClasses[SIZE_CLASS_COUNT];
+        static thread_local ThreadCache threadCache;
+        static thread_local bool threadCacheDestroyed;
+    };
+}
+
+#endif // OUZEL_UTILS_MEMORYPOOL_HPP
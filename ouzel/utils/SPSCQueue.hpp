@@ -0,0 +1,79 @@
+// Copyright 2015-2018 Elviss Strazdins. All rights reserved.
+
+#ifndef OUZEL_UTILS_SPSCQUEUE_HPP
+#define OUZEL_UTILS_SPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace ouzel
+{
+    // Lock-free bounded queue with one producer and one consumer thread.
+    // The items are copied in and out of a preallocated ring, so neither side allocates or blocks.
+    template<class T> class SPSCQueue final
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Queue items must be trivially copyable");
+    public:
+        explicit SPSCQueue(size_t minCapacity)
+        {
+            capacity = 1;
+            while (capacity < minCapacity) capacity <<= 1;
+            items.resize(capacity);
+        }
+
+        SPSCQueue(const SPSCQueue&) = delete;
+        SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+        SPSCQueue(SPSCQueue&&) = delete;
+        SPSCQueue& operator=(SPSCQueue&&) = delete;
+
+        inline size_t getCapacity() const { return capacity; }
+
+        // exact only for the producer, the consumer can make the queue less full at any time
+        bool isFull() const
+        {
+            return tail.load(std::memory_order_relaxed) - head.load(std::memory_order_acquire) == capacity;
+        }
+
+        // called only by the producer, returns false if the queue is full
+        bool push(const T& item)
+        {
+            size_t currentTail = tail.load(std::memory_order_relaxed);
+            if (currentTail - head.load(std::memory_order_acquire) == capacity)
+                return false;
+
+            items[currentTail & (capacity - 1)] = item;
+            tail.store(currentTail + 1, std::memory_order_release);
+
+            return true;
+        }
+
+        // called only by the consumer, returns false if the queue is empty
+        bool pop(T& item)
+        {
+            size_t currentHead = head.load(std::memory_order_relaxed);
+            if (currentHead == tail.load(std::memory_order_acquire))
+                return false;
+
+            item = items[currentHead & (capacity - 1)];
+            head.store(currentHead + 1, std::memory_order_release);
+
+            return true;
+        }
+
+    private:
+        size_t capacity;
+        std::vector<T> items;
+
+        // padded to separate cache lines, so that the producer and the consumer do not invalidate each other's index,
+        // alignas is not used, because C++11 does not guarantee over-aligned heap allocations
+        std::atomic<size_t> head{0};
+        uint8_t padding[64 - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> tail{0};
+    };
+}
+
+#endif // OUZEL_UTILS_SPSCQUEUE_HPP
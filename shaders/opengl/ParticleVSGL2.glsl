@@ -0,0 +1,32 @@
+#version 120
+attribute vec4 position0;
+attribute vec4 normal0;
+attribute vec4 color0;
+attribute vec4 tangent0;
+attribute vec4 binormal0;
+attribute vec2 texCoord0;
+uniform mat4 modelViewProj;
+uniform vec4 parameters;
+uniform vec4 gravity;
+varying vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    float steps = parameters.x - binormal0.x + 1.0;
+    vec2 position;
+    if (parameters.y > 0.5)
+    {
+        float angle = position0.z + normal0.x * steps;
+        float radius = position0.w + normal0.y * steps;
+        position = vec2(-cos(angle) * radius, -sin(angle) * radius * parameters.w);
+    }
+    else
+        position = position0.xy + (position0.zw * steps + gravity.xy * (steps * (steps + 1.0) * 0.5)) * parameters.z;
+    float halfSize = (parameters.x < binormal0.y) ? max(0.0, binormal0.z + binormal0.w * steps) : 0.0;
+    float rotation = normal0.z + normal0.w * steps;
+    vec2 corner = vec2(texCoord0.x * 2.0 - 1.0, 1.0 - texCoord0.y * 2.0) * halfSize;
+    position += vec2(corner.x * cos(rotation) - corner.y * sin(rotation), corner.x * sin(rotation) + corner.y * cos(rotation));
+    gl_Position = modelViewProj * vec4(position, 0.0, 1.0);
+    exColor = clamp(color0 + tangent0 * steps, 0.0, 1.0);
+    exTexCoord = texCoord0;
+}
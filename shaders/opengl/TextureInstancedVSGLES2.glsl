@@ -0,0 +1,20 @@
+precision highp float;
+attribute vec3 position0;
+attribute vec4 color0;
+attribute vec2 texCoord0;
+attribute vec4 instanceTransform0;
+attribute vec4 instanceTransform1;
+attribute vec4 instanceTransform2;
+attribute vec4 instanceTransform3;
+attribute vec4 instanceColor0;
+attribute vec4 instanceTexRect0;
+uniform mat4 viewProj;
+varying lowp vec4 exColor;
+varying vec2 exTexCoord;
+void main()
+{
+    mat4 transform = mat4(instanceTransform0, instanceTransform1, instanceTransform2, instanceTransform3);
+    gl_Position = viewProj * transform * vec4(position0, 1.0);
+    exColor = color0 * instanceColor0;
+    exTexCoord = instanceTexRect0.xy + texCoord0 * instanceTexRect0.zw;
+}
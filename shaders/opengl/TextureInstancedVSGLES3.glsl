@@ -0,0 +1,21 @@
+#version 300 es
+precision highp float;
+in vec3 position0;
+in vec4 color0;
+in vec2 texCoord0;
+in vec4 instanceTransform0;
+in vec4 instanceTransform1;
+in vec4 instanceTransform2;
+in vec4 instanceTransform3;
+in vec4 instanceColor0;
+in vec4 instanceTexRect0;
+uniform mat4 viewProj;
+out lowp vec4 exColor;
+out vec2 exTexCoord;
+void main()
+{
+    mat4 transform = mat4(instanceTransform0, instanceTransform1, instanceTransform2, instanceTransform3);
+    gl_Position = viewProj * transform * vec4(position0, 1.0);
+    exColor = color0 * instanceColor0;
+    exTexCoord = instanceTexRect0.xy + texCoord0 * instanceTexRect0.zw;
+}